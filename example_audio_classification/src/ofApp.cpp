@@ -18,8 +18,8 @@ void ofApp::setup(){
     FFT fft;
     fft.init(FFT_WINDOW_SIZE,FFT_HOP_SIZE,1,FFT::RECTANGULAR_WINDOW,true,false,DATA_TYPE_MATRIX);
 
-    //Setup the classifier
-    RandomForests forest;
+    //Setup the classifier, the trees are trained in parallel
+    ofxGrtRandomForests forest;
     forest.setForestSize( 10 );
     forest.setNumRandomSplits( 100 );
     forest.setMaxDepth( 10 );
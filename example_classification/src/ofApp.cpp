@@ -27,6 +27,9 @@ void ofApp::setup(){
     //set the default classifier
     setClassifier( NAIVE_BAYES );
 
+    //The predictor reuses the same input and result buffers every frame, the input is the [x y] mouse position
+    predictor.setup( pipeline, 2 );
+
     //Setup the colors for the 3 classes
     classColors.resize( 3 );
     classColors[0] = ofColor(255, 0, 0);
@@ -37,8 +40,8 @@ void ofApp::setup(){
 //--------------------------------------------------------------
 void ofApp::update(){
     
-    //Grab the current mouse x and y position
-    GRT::VectorFloat sample(2);
+    //Grab the current mouse x and y position, writing it straight into the predictor's input buffer
+    GRT::VectorFloat &sample = predictor.getInputVector();
     sample[0] = mouseX / double(ofGetWidth());
     sample[1] = mouseY / double(ofGetHeight());
     
@@ -46,11 +49,17 @@ void ofApp::update(){
     if( record ){
         record = false;
         trainingData.addSample( trainingClassLabel, sample );
+
+        //The KD-tree KNN can learn the new sample straight away, without retraining the pipeline
+        ofxGrtKNN *knn = dynamic_cast< ofxGrtKNN* >( pipeline.getClassifier() );
+        if( pipeline.getTrained() && knn != NULL ){
+            knn->addSample( trainingClassLabel, sample );
+        }
     }
     
     //If the pipeline has been trained, then run the prediction
     if( pipeline.getTrained() ){
-        pipeline.predict( sample );
+        predictor.predict();
     }
 }
 
@@ -88,7 +97,7 @@ void ofApp::draw(){
 
         ofFill();
         ofSetColor(100,100,100);
-        ofDrawRectangle( 5, 5, 250, 225 );
+        ofDrawRectangle( 5, 5, 250, 280 );
         ofSetColor( 255, 255, 255 );
 
         largeFont.drawString( "GRT Classifier Example", textX, textY ); textY += textSpacer*2;
@@ -96,6 +105,9 @@ void ofApp::draw(){
         smallFont.drawString( "[i]: Toogle Info", textX, textY ); textY += textSpacer;
         smallFont.drawString( "[r]: Record Sample", textX, textY ); textY += textSpacer;
         smallFont.drawString( "[t]: Train Model", textX, textY ); textY += textSpacer;
+        smallFont.drawString( "[v]: Cross Validate Model", textX, textY ); textY += textSpacer;
+        smallFont.drawString( "[h]: Search Forest Settings", textX, textY ); textY += textSpacer;
+        smallFont.drawString( "[q]: Toggle Int8 Prediction", textX, textY ); textY += textSpacer;
         smallFont.drawString( "[1,2,3]: Set Class Label", textX, textY ); textY += textSpacer;
         smallFont.drawString( "[tab]: Select Classifier", textX, textY ); textY += textSpacer;
 
@@ -133,6 +145,49 @@ void ofApp::keyPressed(int key){
                 buildTexture = true;
             }else infoText = "WARNING: Failed to train pipeline";
             break;
+        case 'v':{
+            //Train and test 5 copies of the pipeline at once, one per fold, the pipeline itself is not changed
+            ofxGrtCrossValidation crossValidation( 5 );
+            ofxGrtCrossValidation::Result result;
+            if( crossValidation.run( pipeline, trainingData, result ) ){
+                infoText = "Accuracy: " + ofToString( result.getAccuracy() * 100, 1 ) + "% (" + ofToString( result.totalTime, 0 ) + "ms)";
+            }else infoText = "WARNING: Failed to cross validate pipeline";
+            }
+            break;
+        case 'h':{
+            //Search the forest size and depth, and pick the fastest forest that is at least 95% accurate
+            ofxGrtParameterSearch search;
+            search.addParameter( "forestSize", { 10, 50, 100, 200 } );
+            search.addParameter( "maxDepth", { 5, 10, 20 } );
+            search.setConfigureFunction( []( GestureRecognitionPipeline &pipeline, const vector< Float > &values ){
+                ofxGrtRandomForests randomForest;
+                randomForest.enableNullRejection( false );
+                randomForest.setForestSize( (UINT)values[0] );
+                randomForest.setNumRandomSplits( 2 );
+                randomForest.setMaxDepth( (UINT)values[1] );
+                randomForest.setMinNumSamplesPerNode( 3 );
+                randomForest.setRemoveFeaturesAtEachSpilt( false );
+                return pipeline.setClassifier( randomForest );
+            } );
+            search.setTargetAccuracy( 0.95 );
+            UINT best = 0;
+            if( search.search( pipeline, trainingData ) && search.getCheapestConfiguration( 0.95, best ) && search.configure( pipeline, best ) && pipeline.train( trainingData ) ){
+                const ofxGrtParameterSearch::Configuration &configuration = search.getConfigurations()[ best ];
+                infoText = "Forest " + ofToString( configuration.values[0] ) + " x " + ofToString( configuration.values[1] ) + ": " + ofToString( configuration.getAccuracy() * 100, 1 ) + "%";
+                buildTexture = true;
+            }else infoText = "WARNING: No forest reached 95% accuracy";
+            }
+            break;
+        case 'q':{
+            //Run an int8 quantized copy of the classifier each frame (Softmax only), and compare it with the float classifier on the training data
+            predictor.setQuantized( !predictor.getIsQuantized() );
+            ofxGrtQuantizedModel quantizedModel = predictor.getQuantizedModel();
+            ofxGrtQuantizedModel::Report report;
+            if( predictor.getIsQuantized() && quantizedModel.evaluate( *pipeline.getClassifier(), trainingData, report ) ){
+                infoText = "Int8 accuracy delta: " + ofToString( report.getAccuracyDelta() * 100, 2 ) + "%";
+            }else infoText = "Float prediction";
+            }
+            break;
         case 's':
             if( trainingData.save( ofToDataPath("TrainingData.grt") ) ){
                 infoText = "Training data saved to file";
@@ -159,60 +214,58 @@ void ofApp::keyPressed(int key){
 
 
     if( buildTexture ){
+        //The predictor keeps a quantized copy of the classifier, so give it the retrained classifier
+        predictor.setup( pipeline );
+
         const unsigned int rows = TEXTURE_RESOLUTION;
         const unsigned int cols = TEXTURE_RESOLUTION;
         const unsigned int size = rows*cols*4;
         vector<float> pixelData( size );
         ofFloatPixels pixels;
 
+        //Evaluate the classifier over the whole texture at once, pixel (i,j) is the input [i/rows j/cols]
+        if( !mapEvaluator.setup( pipeline ) || !mapEvaluator.setGrid( rows, cols ) || !mapEvaluator.evaluate() ){
+            infoText = "WARNING: Failed to build decision map";
+            return;
+        }
+        const vector< UINT > &classLabels = mapEvaluator.getPredictedClassLabels();
+        const vector< float > &maximumLikelihoods = mapEvaluator.getMaximumLikelihoods();
+
         unsigned int index = 0;
-        unsigned int classLabel = 0;
-        VectorFloat featureVector(2);
-        VectorFloat likelihoods;
         float r,g,b,a;
-        float maximumLikelihood;
-        for(unsigned int j=0; j<cols; j++){
-            for(unsigned int i=0; i<rows; i++){
-                featureVector[0] = i/double(rows);
-                featureVector[1] = j/double(cols);
-                if( pipeline.predict( featureVector ) ){
-                    classLabel = pipeline.getPredictedClassLabel();
-                    maximumLikelihood = pipeline.getMaximumLikelihood();
-                    likelihoods = pipeline.getClassLikelihoods();
-                    switch( classLabel ){
-                        case 1:
-                            r = 1.0;
-                            g = 0.0;
-                            b = 0.0;
-                            a = maximumLikelihood;
-                            break;
-                        case 2: 
-                            r = 0.0;
-                            g = 1.0;
-                            b = 0.0;
-                            a = maximumLikelihood;
-                            break;
-                        case 3: 
-                            r = 0.0;
-                            g = 0.0;
-                            b = 1.0;
-                            a = maximumLikelihood;
-                            break;
-                        break;
-                        default:
-                            r = 0;
-                            g = 0;
-                            b = 0;
-                            a = 1;
-                        break;
-                    }
-                    pixelData[ index++ ] = r;
-                    pixelData[ index++ ] = g;
-                    pixelData[ index++ ] = b;
-                    pixelData[ index++ ] = a;
-                }
+        for(unsigned int n=0; n<rows*cols; n++){
+            switch( classLabels[n] ){
+                case 1:
+                    r = 1.0;
+                    g = 0.0;
+                    b = 0.0;
+                    a = maximumLikelihoods[n];
+                    break;
+                case 2: 
+                    r = 0.0;
+                    g = 1.0;
+                    b = 0.0;
+                    a = maximumLikelihoods[n];
+                    break;
+                case 3: 
+                    r = 0.0;
+                    g = 0.0;
+                    b = 1.0;
+                    a = maximumLikelihoods[n];
+                    break;
+                default:
+                    r = 0;
+                    g = 0;
+                    b = 0;
+                    a = 1;
+                break;
             }
+            pixelData[ index++ ] = r;
+            pixelData[ index++ ] = g;
+            pixelData[ index++ ] = b;
+            pixelData[ index++ ] = a;
         }
+        infoText += " (" + mapEvaluator.getModelTypeAsString() + " map: " + ofToString( mapEvaluator.getEvaluationTime(), 1 ) + "ms)";
         pixels.setFromExternalPixels(&pixelData[0],rows,cols,OF_PIXELS_RGBA);
         if(!texture.isAllocated()){
             texture.allocate( pixels, false );
@@ -228,14 +281,14 @@ void ofApp::keyPressed(int key){
 bool ofApp::setClassifier( const int type ){
 
     AdaBoost adaboost;
-    DecisionTree dtree;
-    KNN knn;
+    ofxGrtDecisionTree dtree;
+    ofxGrtKNN knn;
     GMM gmm;
     ANBC naiveBayes;
     MinDist minDist;
-    RandomForests randomForest;
+    ofxGrtRandomForests randomForest;
     Softmax softmax;
-    SVM svm;
+    ofxGrtSVM svm;
 
     this->classifierType = type;
 
@@ -310,13 +363,13 @@ bool ofApp::setClassifier( const int type ){
         break;
         case SVM_LINEAR:
             svm.enableNullRejection( false );
-            svm.setNullRejectionCoeff( 3 );
-            //pipeline.setClassifier( svm );
+            svm.setKernelType( ofxGrtSVM::LINEAR_KERNEL );
+            pipeline.setClassifier( svm );
         break;
         case SVM_RBF:
             svm.enableNullRejection( false );
-            svm.setNullRejectionCoeff( 3 );
-            //pipeline.setClassifier( svm );
+            svm.setKernelType( ofxGrtSVM::RBF_KERNEL );
+            pipeline.setClassifier( svm );
         break;
         default:
             return false;
@@ -40,6 +40,8 @@ public:
     string infoText;                            //This string will be used to draw some info messages to the main app window
     Vector< ofColor > classColors;
     ofTexture texture;
+    ofxGrtMapEvaluator mapEvaluator;            //This evaluates the pipeline over the whole texture
+    ofxGrtPredictor predictor;                  //This runs the pipeline each frame without allocating
     int classifierType;
     ofTrueTypeFont largeFont;
     ofTrueTypeFont smallFont;
@@ -53,7 +55,7 @@ public:
                 return "DECISION_TREE";
             break;
             case KKN:
-                return "KKN";
+                return "KNN (KD-TREE)";
             break;
             case GAUSSIAN_MIXTURE_MODEL:
                 return "GMM";
@@ -58,6 +58,11 @@
    - move your mouse around the screen and you should see the predicted class label change through the various classes you trained the model to predict
    - note that you might also see the predicted class label of 0. This is the special NULL GESTURE LABEL, which is output by the classifier when the 
      likelihood of a gesture is too low. See this tutorial for more info: http://www.nickgillian.com/wiki/pmwiki.php?n=GRT.AutomaticGestureSpotting
+   - press the 'b' key to compare FastDTW with the exact DTW distance on the training data, the info message shows how often both pick the same
+     class and how much faster FastDTW is. For long gestures you can then switch the classifier to FastDTW with setDistanceMode
+   - the spotter also searches the mouse stream for complete gestures, the last one found is shown beside SpottedGesture with its start and end frames
+   - while you record a gesture after training, the early classifier guesses the gesture from the part drawn so far and shows it beside EarlyGesture
+     as soon as it is confident, with the fraction of the gesture that was needed
  */
 
 
@@ -82,8 +87,8 @@ void ofApp::setup(){
     //The input to the training data will be the [x y] from the mouse, so we set the number of dimensions to 2
     trainingData.setNumDimensions( 2 );
     
-    //Initialize the DTW classifier
-    DTW dtw;
+    //Initialize the DTW classifier, this picks its templates in parallel and caches the training distances, so retraining after recording a new sample is fast
+    ofxGrtDTW dtw;
     
     //Turn on null rejection, this lets the classifier output the predicted class label of 0 when the likelihood of a gesture is low
     dtw.enableNullRejection( true );
@@ -93,41 +98,57 @@ void ofApp::setup(){
     //If you are getting too many false positives then you should decrease this value
     dtw.setNullRejectionCoeff( 3 );
     
-    //Turn on the automatic data triming, this will remove any sections of none movement from the start and end of the training samples
-    dtw.enableTrimTrainingData(true, 0.1, 90);
-    
     //Offset the timeseries data by the first sample, this makes your gestures (more) invariant to the location the gesture is performed
     dtw.setOffsetTimeseriesUsingFirstSample(true);
 
-    //Allow the DTW algorithm to search the entire cost matrix
-    dtw.setContrainWarpingPath( true );
+    //Constrain the warping path to a band around the diagonal of the cost matrix, this is faster and stops very unlikely warps
+    dtw.setConstrainWarpingPath( true );
+
+    //Keep one template per class, if you record a gesture in a few different ways you can keep more (each one averaged from its closest samples)
+    dtw.setNumTemplatesPerClass( 1 );
+    dtw.setTemplateAveraging( true );
     
     //Add the classifier to the pipeline (after we do this, we don't need the DTW classifier anymore)
     pipeline.setClassifier( dtw );
+
+    //The predictor reuses the same input and result buffers every frame, the input is the [x y] mouse position
+    predictor.setup( pipeline, 2 );
 }
 
 //--------------------------------------------------------------
 void ofApp::update(){
     
-    //Grab the current mouse x and y position
-    VectorDouble sample(2);
+    //Grab the current mouse x and y position, writing it straight into the predictor's input buffer
+    VectorDouble &sample = predictor.getInputVector();
     sample[0] = mouseX;
     sample[1] = mouseY;
     
     //If we are recording training data, then add the current sample to the training data set
     if( record ){
         timeseries.push_back( sample );
+
+        //Guess the gesture from the frames recorded so far, once the early classifier is confident the guess does not change
+        if( pipeline.getTrained() && !earlyClassifier.getDecided() && earlyClassifier.update( sample ) ){
+            earlyText = ofToString( earlyClassifier.getProvisionalClassLabel() ) + " (after " + ofToString( earlyClassifier.getDecisionFrame() ) + " frames)";
+        }
     }
     
     //If the pipeline has been trained, then run the prediction
     if( pipeline.getTrained() ){
 
         //Run the prediction
-        pipeline.predict( sample );
+        predictor.predict();
 
         //Update the plots
-        predictedClassPlot.update( VectorFloat(1,pipeline.getPredictedClassLabel()) );
-        classLikelihoodsPlot.update( pipeline.getClassLikelihoods() );
+        predictedClassPlot.update( predictor.getPredictedClassLabelVector() );
+        classLikelihoodsPlot.update( predictor.getClassLikelihoods() );
+
+        //Update the spotter with the new frame, it reports each gesture once, shortly after it ends
+        ofxGrtDTWSpotter::Match match;
+        spotter.update( sample );
+        while( spotter.popMatch( match ) ){
+            spottedText = ofToString( match.classLabel ) + " (frames " + ofToString( match.startFrame ) + " to " + ofToString( match.endFrame ) + ")";
+        }
     }
 }
 
@@ -173,11 +194,19 @@ void ofApp::draw(){
     ofDrawBitmapString(text, textX,textY);
     
     textY += 15;
-    text = "PredictedClassLabel: " + ofToString(pipeline.getPredictedClassLabel());
+    text = "PredictedClassLabel: " + ofToString(predictor.getPredictedClassLabel());
     ofDrawBitmapString(text, textX,textY);
     
     textY += 15;
-    text = "Likelihood: " + ofToString(pipeline.getMaximumLikelihood());
+    text = "Likelihood: " + ofToString(predictor.getMaximumLikelihood());
+    ofDrawBitmapString(text, textX,textY);
+
+    textY += 15;
+    text = "SpottedGesture: " + spottedText;
+    ofDrawBitmapString(text, textX,textY);
+
+    textY += 15;
+    text = "EarlyGesture: " + earlyText;
     ofDrawBitmapString(text, textX,textY);
     
     textY += 15;
@@ -193,7 +222,7 @@ void ofApp::draw(){
     if( pipeline.getTrained() ){
         
         //Draw the data in the DTW input buffer
-        DTW *dtw = pipeline.getClassifier< DTW >();
+        ofxGrtDTW *dtw = pipeline.getClassifier< ofxGrtDTW >();
         
         if( dtw != NULL ){
             float x,y,w,h,r,g,b;
@@ -249,7 +278,10 @@ void ofApp::keyPressed(int key){
     switch ( key) {
         case 'r':
             record = !record;
-            if( !record ){
+            if( record ){
+                earlyClassifier.reset();
+                earlyText = "";
+            }else{
                 trainingData.addSample(trainingClassLabel, timeseries);
 
                 //Update the training data plot
@@ -302,7 +334,15 @@ void ofApp::keyPressed(int key){
         break;
         case 't':
             if( pipeline.train( trainingData ) ){
-                infoText = "Pipeline Trained";
+                infoText = "Pipeline Trained in " + ofToString( pipeline.getClassifier< ofxGrtDTW >()->getTrainingTime(), 1 ) + "ms";
+
+                //Setup the spotter with the new templates
+                spotter.setup( *pipeline.getClassifier< ofxGrtDTW >() );
+                spottedText = "";
+
+                //Setup the early classifier, it decides once the closest class is 30% closer than the next one
+                earlyClassifier.setup( *pipeline.getClassifier< ofxGrtDTW >(), 0.3 );
+                earlyText = "";
 
                 //Setup the distance matrix
                 distanceMatrixPlots.resize( pipeline.getNumClasses() );
@@ -318,6 +358,14 @@ void ofApp::keyPressed(int key){
 
             }else infoText = "WARNING: Failed to train pipeline";
             break;
+        case 'b':
+            if( pipeline.getTrained() ){
+                ofxGrtDTW::BenchmarkResult result;
+                if( pipeline.getClassifier< ofxGrtDTW >()->benchmarkFastDTW( trainingData, 10, result ) ){
+                    infoText = "FastDTW agreement: " + ofToString( result.getAgreement() * 100, 1 ) + "% Exact: " + ofToString( result.exactTime, 3 ) + "ms FastDTW: " + ofToString( result.fastTime, 3 ) + "ms";
+                }else infoText = "WARNING: Failed to run the FastDTW benchmark";
+            }else infoText = "WARNING: Train the pipeline before running the FastDTW benchmark";
+            break;
         case 's':
             if( trainingData.saveDatasetToFile("TrainingData.txt") ){
                 infoText = "Training data saved to file";
@@ -375,7 +423,7 @@ void ofApp::drawTrainingData(){
 void ofApp::drawDistanceMatrix(){
 
     //Get a pointer to the DTW classifier
-    DTW *dtw = pipeline.getClassifier< DTW >();
+    ofxGrtDTW *dtw = pipeline.getClassifier< ofxGrtDTW >();
 
     if( dtw == NULL ) return;
 
@@ -389,7 +437,7 @@ void ofApp::drawDistanceMatrix(){
     float y = 10 + bounds.height;
     font.drawString( "Distance Matrix", x, y );
     
-     //Draw the DTW cost matrix for each class
+     //Draw the DTW distances between the training samples of each class
     const Vector< MatrixFloat > &distanceMatrix = dtw->getDistanceMatrices();
 
     if( distanceMatrixPlots.getSize() != distanceMatrix.getSize() ){
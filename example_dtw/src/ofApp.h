@@ -35,6 +35,11 @@ public:
     TimeSeriesClassificationData trainingData;      		//This will store our training data
     MatrixFloat timeseries;                                 //This will store a single training sample
     GestureRecognitionPipeline pipeline;                    //This is a wrapper for our classifier and any pre/post processing modules 
+    ofxGrtPredictor predictor;                              //This runs the pipeline each frame without allocating
+    ofxGrtDTWSpotter spotter;                               //This spots complete gestures in the mouse stream, one frame at a time
+    string spottedText;                                     //This describes the last gesture found by the spotter
+    ofxGrtDTWEarlyClassifier earlyClassifier;               //This guesses the gesture being recorded before it is finished
+    string earlyText;                                       //This describes the guess of the early classifier
     bool record;                                            //This is a flag that keeps track of when we should record training data
     UINT trainingClassLabel;                                //This will hold the current label for when we are training the classifier
     string infoText;                                        //This string will be used to draw some info messages to the main app window
@@ -2,54 +2,98 @@
 
 #include "ofMain.h"
 #include "ofxGrt.h"
-#include "ofxOsc.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 class Gyrosc{
 public:
 	Gyrosc(){
 
 		newData = false;
+		alignmentEnabled = false;
+		stopping = true;
 		acc.resize( 3, 0 );
 		grav.resize( 3, 0 );
 
 	}
 
 	~Gyrosc(){
-
+		stop();
 	}
 
 	bool setup( int listenerPort ){
 
-		oscReceiver.setup( listenerPort );
+		stop();
 		newData = false;
+		if( !socket.bindUdp( (unsigned short)listenerPort ) ) return false;
+
+		//The messages are received on their own thread, so each one is stamped with the time it arrived rather than the time of the frame that reads it
+		stopping = false;
+		receiveThread = std::thread( &Gyrosc::receiveFunction, this );
 
 		return true;
 	}
 
+	void stop(){
+		stopping = true;
+		if( receiveThread.joinable() ) receiveThread.join();
+		socket.close();
+	}
+
 	bool update(){
 
 		newData = false;
-		ofxOscMessage msg;
-		while( oscReceiver.hasWaitingMessages() ){
-			if( oscReceiver.getNextMessage( msg ) ){
-				if( msg.getAddress() == "/gyrosc/accel" ){
-					newData = true;
-					acc[0] = msg.getArgAsFloat( 0 );
-					acc[1] = msg.getArgAsFloat( 1 );
-					acc[2] = msg.getArgAsFloat( 2 );
-				}
-				else if( msg.getAddress() == "/gyrosc/grav" ){
-					newData = true;
-					grav[0] = msg.getArgAsFloat( 0 );
-					grav[1] = msg.getArgAsFloat( 1 );
-					grav[2] = msg.getArgAsFloat( 2 );
-				}
+		{
+			std::unique_lock< std::mutex > lock( messageMutex );
+			messages.swap( pendingMessages );
+		}
+
+		for(size_t i=0; i<messages.size(); i++){
+			const ofxGrtOscReader::Message &msg = messages[i].message;
+			if( msg.getNumArguments() < 3 ) continue;
+			if( msg.address == "/gyrosc/accel" ){
+				newData = true;
+				acc[0] = msg.getNumber( 0 );
+				acc[1] = msg.getNumber( 1 );
+				acc[2] = msg.getNumber( 2 );
+				if( alignmentEnabled ) aligner.push( accStream, messages[i].timestamp, acc );
+			}
+			else if( msg.address == "/gyrosc/grav" ){
+				newData = true;
+				grav[0] = msg.getNumber( 0 );
+				grav[1] = msg.getNumber( 1 );
+				grav[2] = msg.getNumber( 2 );
+				if( alignmentEnabled ) aligner.push( gravStream, messages[i].timestamp, grav );
 			}
 		}
+		messages.clear();
+
+		if( alignmentEnabled ) aligner.update( ofGetElapsedTimef() );
+
+		return true;
+	}
 
+	//Buffers the accel and grav messages with the time they arrived on the receive thread, and resamples them together at a fixed rate.
+	//The fused samples are [accX accY accZ gravX gravY gravZ] and can be read with getFusedSample.
+	bool enableStreamAlignment( double sampleRate, double latency, ofxGrtStreamAligner::InterpolationMode mode = ofxGrtStreamAligner::LINEAR_INTERPOLATION ){
+		aligner.clear();
+		if( !aligner.setup( sampleRate, latency, mode ) ) return false;
+		accStream = aligner.addStream( "acc", 3 );
+		gravStream = aligner.addStream( "grav", 3 );
+		alignmentEnabled = true;
 		return true;
 	}
 
+	bool getFusedSample( GRT::VectorFloat &sample ){
+		double timestamp = 0;
+		return alignmentEnabled && aligner.popSample( sample, timestamp );
+	}
+
+	const ofxGrtStreamAligner &getStreamAligner() const {
+		return aligner;
+	}
+
 	bool draw(float x,float y,float w,float h){
 
 
@@ -60,17 +104,64 @@ public:
 		return newData;
 	}
 
-	GRT::VectorFloat getAcc() const {
+	const GRT::VectorFloat &getAcc() const {
 		return acc;
 	}
 
-	GRT::VectorFloat getGrav() const {
+	const GRT::VectorFloat &getGrav() const {
 		return grav;
 	}
 
+	//Registers the accelerometer and gravity data as feature schema sources, named "acc" and "grav"
+	bool addFeatureSources( ofxGrtFeatureSchema &schema ) const {
+		if( !schema.addSource( "acc", &acc[0], acc.getSize() ) ) return false;
+		if( !schema.addSource( "grav", &grav[0], grav.getSize() ) ) return false;
+		return true;
+	}
+
 protected:
+	struct TimedMessage{
+		ofxGrtOscReader::Message message;
+		double timestamp;
+	};
+
+	void receiveFunction(){
+		vector< uint8_t > buffer( 65536 );
+		vector< ofxGrtOscReader::Message > packetMessages;
+		ofxGrtOscReader reader;
+		ofxGrtDatagramSocket::Address from;
+
+		//The timeout only bounds how long stop() waits for this thread
+		while( !stopping ){
+			const int size = socket.receive( &buffer[0], buffer.size(), from, 50 );
+			if( size <= 0 ) continue;
+
+			const double timestamp = ofGetElapsedTimef();
+			packetMessages.clear();
+			reader.parse( &buffer[0], (size_t)size, packetMessages );
+
+			//Drop messages if update is not being called, rather than growing without limit
+			std::unique_lock< std::mutex > lock( messageMutex );
+			for(size_t i=0; i<packetMessages.size() && pendingMessages.size() < 4096; i++){
+				TimedMessage timedMessage;
+				timedMessage.message = packetMessages[i];
+				timedMessage.timestamp = timestamp;
+				pendingMessages.push_back( timedMessage );
+			}
+		}
+	}
+
 	bool newData;
+	bool alignmentEnabled;
+	int accStream;
+	int gravStream;
+	ofxGrtStreamAligner aligner;
 	GRT::VectorFloat acc;
 	GRT::VectorFloat grav;
-	ofxOscReceiver oscReceiver;
+	ofxGrtDatagramSocket socket;
+	std::thread receiveThread;
+	std::atomic< bool > stopping;
+	std::mutex messageMutex;
+	vector< TimedMessage > pendingMessages;		//Received but not yet read by update, guarded by messageMutex
+	vector< TimedMessage > messages;
 };
\ No newline at end of file
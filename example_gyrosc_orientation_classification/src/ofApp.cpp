@@ -23,6 +23,9 @@ void ofApp::setup(){
     
     //The input to the training data will be the [x y z] from the accelerometer, so we set the number of dimensions to 3
     trainingData.setNumDimensions( 3 );
+
+    //Holding a pose while recording gives thousands of near identical samples, so keep at most 100 well spread samples per class
+    coresetSampler.setup( 3, 100, ofxGrtCoresetSampler::K_CENTER_SAMPLING );
     
     //set the default classifier
     ANBC naiveBayes;
@@ -33,6 +36,14 @@ void ofApp::setup(){
     //Setup the gyro osc
     gyrosc.setup( 5000 );
 
+    //The accel and grav messages arrive separately, so also resample them together at 60Hz into one [acc grav] stream, 50ms behind real time
+    gyrosc.enableStreamAlignment( 60, 0.05 );
+
+    //The feature vector is the [x y z] gravity data, gathered straight from the gyro osc buffers
+    gyrosc.addFeatureSources( featureSchema );
+    featureSchema.addFeature( "grav" );
+    featureSchema.compile();
+
     accDataPlot.setup( 500, 3, "acc" );
     accDataPlot.setDrawGrid( true );
     accDataPlot.setDrawInfoText( true );
@@ -43,6 +54,11 @@ void ofApp::setup(){
     gravDataPlot.setDrawInfoText( true );
     gravDataPlot.setFont( smallFont );
 
+    alignedDataPlot.setup( 500, 6, "aligned acc + grav" );
+    alignedDataPlot.setDrawGrid( true );
+    alignedDataPlot.setDrawInfoText( true );
+    alignedDataPlot.setFont( smallFont );
+
 }
 
 //--------------------------------------------------------------
@@ -51,22 +67,31 @@ void ofApp::update(){
     //Update the gyro osc module
     gyrosc.update();
 
+    //Plot the aligned samples that are ready
+    while( gyrosc.getFusedSample( alignedSample ) ){
+        alignedDataPlot.update( alignedSample );
+    }
+
     if( gyrosc.getNewDataReady() ){
-        GRT::VectorFloat acc = gyrosc.getAcc();
-        GRT::VectorFloat grav = gyrosc.getGrav();
+        const GRT::VectorFloat &acc = gyrosc.getAcc();
+        const GRT::VectorFloat &grav = gyrosc.getGrav();
 
         //Update the data graph
         accDataPlot.update( acc );
         gravDataPlot.update( grav );
 
+        //Gather the feature vector from the latest gyro data
+        featureSchema.update();
+        const GRT::VectorFloat &featureVector = featureSchema.getFeatureVector();
+
         //If we are recording training data, then add the current sample to the training data set
         if( record ){
-            trainingData.addSample( trainingClassLabel, grav );
+            coresetSampler.addSample( trainingClassLabel, featureVector );
         }
         
         //If the pipeline has been trained, then run the prediction
         if( pipeline.getTrained() ){
-            pipeline.predict( grav );
+            pipeline.predict( featureVector );
             predictionPlot.update( pipeline.getClassLikelihoods() );
         }
     }
@@ -107,7 +132,7 @@ void ofApp::draw(){
         textY += textSpacer;
         smallFont.drawString( "Class Label: " + ofToString( trainingClassLabel ), textX, textY ); textY += textSpacer;
         smallFont.drawString( "Recording: " + ofToString( record ), textX, textY ); textY += textSpacer;
-        smallFont.drawString( "Num Samples: " + ofToString( trainingData.getNumSamples() ), textX, textY ); textY += textSpacer;
+        smallFont.drawString( "Num Samples: " + ofToString( trainingData.getNumSamples() + coresetSampler.getNumSamples() ), textX, textY ); textY += textSpacer;
         smallFont.drawString( infoText, textX, textY ); textY += textSpacer;
 
         //Update the graph position
@@ -118,6 +143,7 @@ void ofApp::draw(){
     //Draw the data graph
     accDataPlot.draw( graphX, graphY, graphW, graphH ); graphY += graphH * 1.1;
     gravDataPlot.draw( graphX, graphY, graphW, graphH ); graphY += graphH * 1.1;
+    alignedDataPlot.draw( graphX, graphY, graphW, graphH ); graphY += graphH * 1.1;
 
     //If the model has been trained, then draw the texture
     if( pipeline.getTrained() ){
@@ -135,6 +161,7 @@ void ofApp::keyPressed(int key){
     switch ( key) {
         case 'r':
             record = !record;
+            if( !record ) coresetSampler.flush( trainingData );
             break;
         case '1':
             trainingClassLabel = 1;
@@ -166,6 +193,7 @@ void ofApp::keyPressed(int key){
             break;
         case 'c':
             trainingData.clear();
+            coresetSampler.clear();
             infoText = "Training data cleared";
             break;
         case 'i':
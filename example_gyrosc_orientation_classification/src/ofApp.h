@@ -38,8 +38,12 @@ public:
     ofTrueTypeFont largeFont;
     ofTrueTypeFont smallFont;
     Gyrosc gyrosc;
+    ofxGrtFeatureSchema featureSchema;
+    ofxGrtCoresetSampler coresetSampler;
     ofxGrtTimeseriesPlot accDataPlot;
     ofxGrtTimeseriesPlot gravDataPlot;
+    ofxGrtTimeseriesPlot alignedDataPlot;
+    GRT::VectorFloat alignedSample;
     ofxGrtTimeseriesPlot predictionPlot;
 
 };
@@ -34,6 +34,11 @@ void ofApp::setup(){
     //Setup the gyro osc
     gyrosc.setup( 5000 );
 
+    //The feature vector is the [x y z] accelerometer data, gathered straight from the gyro osc buffers
+    gyrosc.addFeatureSources( featureSchema );
+    featureSchema.addFeature( "acc" );
+    featureSchema.compile();
+
     accDataPlot.setup( 500, 3, "acc" );
     accDataPlot.setDrawGrid( true );
     accDataPlot.setDrawInfoText( true );
@@ -55,22 +60,28 @@ void ofApp::update(){
     gyrosc.update();
 
     if( gyrosc.getNewDataReady() ){
-        GRT::VectorFloat acc = gyrosc.getAcc();
+        const GRT::VectorFloat &acc = gyrosc.getAcc();
 
         //Update the data graph
         accDataPlot.update( acc );
 
+        //Gather the feature vector from the latest gyro data
+        featureSchema.update();
+        const GRT::VectorFloat &featureVector = featureSchema.getFeatureVector();
+
         //If we are recording training data, then add the current sample to the training data set
         if( record ){
-            trainingData.addSample( trainingClassLabel, acc );
+            trainingData.addSample( trainingClassLabel, featureVector );
         }
         
-        //If the pipeline has been trained, then run the prediction
+        //If the pipeline has been trained, then run the prediction through the profiler so each module is timed
         if( pipeline.getTrained() ){
-            pipeline.predict( acc );
-            predictionPlot.update( pipeline.getClassLikelihoods() );
+            //The likelihoods are empty until the feature extraction has gathered enough samples for the classifier to run
+            if( profiler.predict( pipeline, featureVector ) && profiler.getClassLikelihoods().size() == pipeline.getNumClasses() ){
+                predictionPlot.update( profiler.getClassLikelihoods() );
+            }
         }else{
-            pipeline.preProcessData( acc );
+            pipeline.preProcessData( featureVector );
         }
 
         //Update the feature plot
@@ -101,7 +112,7 @@ void ofApp::draw(){
 
         ofFill();
         ofSetColor(100,100,100);
-        ofDrawRectangle( infoX, 5, infoW, 225 );
+        ofDrawRectangle( infoX, 5, infoW, 240 );
         ofSetColor( 255, 255, 255 );
 
         largeFont.drawString( "Gyrosc Shake Detection Example", textX, textY ); textY += textSpacer*2;
@@ -109,6 +120,7 @@ void ofApp::draw(){
         smallFont.drawString( "[i]: Toogle Info", textX, textY ); textY += textSpacer;
         smallFont.drawString( "[r]: Toggle Recording", textX, textY ); textY += textSpacer;
         smallFont.drawString( "[t]: Train Model", textX, textY ); textY += textSpacer;
+        smallFont.drawString( "[p]: Save Profiler Trace", textX, textY ); textY += textSpacer;
         smallFont.drawString( "[1,2,3]: Toggle Class Label", textX, textY ); textY += textSpacer;
 
         textY += textSpacer;
@@ -130,6 +142,10 @@ void ofApp::draw(){
     if( pipeline.getTrained() ){
         predictionPlot.draw( graphX, graphY, graphW, graphH ); graphY += graphH * 1.1;
     }
+
+    //Draw the profiler report, with one line per pipeline stage
+    ofSetColor( 0, 0, 0 );
+    smallFont.drawString( profiler.getReport(), graphX, graphY + smallFont.getLineHeight() );
     
 }
 
@@ -156,7 +172,7 @@ void ofApp::keyPressed(int key){
             else trainingClassLabel = 0;
             break;
         case 't':
-            if( pipeline.train( trainingData ) ){
+            if( profiler.train( pipeline, trainingData ) ){
                 infoText = "Pipeline Trained";
                 predictionPlot.setup( 500, pipeline.getNumClasses(), "prediction likelihoods" );
                 predictionPlot.setDrawGrid( true );
@@ -165,6 +181,11 @@ void ofApp::keyPressed(int key){
                 predictionPlot.setBackgroundColor( backgroundPlotColor );
             }else infoText = "WARNING: Failed to train pipeline";
             break;
+        case 'p':
+            if( profiler.saveTrace( ofToDataPath("ProfilerTrace.json") ) ){
+                infoText = "Profiler trace saved to file";
+            }else infoText = "WARNING: Failed to save profiler trace to file";
+            break;
         case 's':
             if( trainingData.save( ofToDataPath("TrainingData.grt") ) ){
                 infoText = "Training data saved to file";
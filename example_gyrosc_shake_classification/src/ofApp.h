@@ -38,6 +38,8 @@ public:
     ofTrueTypeFont largeFont;
     ofTrueTypeFont smallFont;
     Gyrosc gyrosc;
+    ofxGrtFeatureSchema featureSchema;
+    ofxGrtPipelineProfiler profiler;
     ofxGrtTimeseriesPlot accDataPlot;
     ofxGrtTimeseriesPlot featurePlot;
     ofxGrtTimeseriesPlot predictionPlot;
@@ -779,6 +779,26 @@ void SynapseStreamer::sendJointRequests(){
     }
 }
 
+bool SynapseStreamer::addFeatureSources(ofxGrtFeatureSchema &schema){
+    const unsigned int numJoints = 14;
+    Joint *joints[ numJoints ] = {&head,&torso,&rightShoulder,&leftShoulder,&rightElbow,&leftElbow,&rightHand,&leftHand,&rightHip,&leftHip,&rightKnee,&leftKnee,&rightFoot,&leftFoot};
+    const string names[ numJoints ] = {"head","torso","rightShoulder","leftShoulder","rightElbow","leftElbow","rightHand","leftHand","rightHip","leftHip","rightKnee","leftKnee","rightFoot","leftFoot"};
+    
+    for(unsigned int i=0; i<numJoints; i++){
+        vector< const double* > world(3);
+        world[0] = &joints[i]->worldX;
+        world[1] = &joints[i]->worldY;
+        world[2] = &joints[i]->worldZ;
+        vector< const double* > body(3);
+        body[0] = &joints[i]->localX;
+        body[1] = &joints[i]->localY;
+        body[2] = &joints[i]->localZ;
+        if( !schema.addSource( names[i] + ".world", world ) ) return false;
+        if( !schema.addSource( names[i] + ".body", body ) ) return false;
+    }
+    return true;
+}
+
 double SynapseStreamer::euclideanDistance(vector< double > a,vector< double > b){
     double d = 0;
     if( a.size() != b.size() ) return 0;
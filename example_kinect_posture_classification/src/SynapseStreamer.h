@@ -2,6 +2,7 @@
 
 #include "ofMain.h"
 #include "ofxOsc.h"
+#include "ofxGrt.h"
 
 #define LOCAL_HOST "127.0.0.1"
 #define INCOMING_SYNAPSE_DATA_PORT 12345
@@ -94,6 +95,9 @@ public:
 
     
     double getHandDistFeature(){ return handDistFeature; }
+
+    //Registers the world and body coordinates of each joint as feature schema sources, named "<joint>.world" and "<joint>.body" (e.g. "leftHand.body")
+    bool addFeatureSources(ofxGrtFeatureSchema &schema);
     
     //Setters
     void trackAllJoints(bool trackStatus,unsigned int jointPos = ALL_JOINT_POSITIONS);
@@ -31,6 +31,9 @@ void ofApp::setup(){
     
     //The input to the training data will be the [x y z] from the left and right hand, so we set the number of dimensions to 6
     trainingData.setNumDimensions( 6 );
+
+    //Each recording gives thousands of near identical frames, so only the samples that add coverage of the input space are kept
+    coresetSampler.setup( 6, 100, ofxGrtCoresetSampler::K_CENTER_SAMPLING );
     
     //set the default classifier
     ANBC naiveBayes;
@@ -58,6 +61,17 @@ void ofApp::setup(){
     synapseStreamer.trackLeftHand(true);
     synapseStreamer.trackRightHand(true);
 
+    //Describe the feature vector, the [x y z] body coordinates of the left hand followed by the right hand
+    synapseStreamer.addFeatureSources( featureSchema );
+    featureSchema.addFeature( "leftHand.body" );
+    featureSchema.addFeature( "rightHand.body" );
+    featureSchema.compile();
+
+    //Stream the predictions to other applications on the outgoing streaming port, only when they change and at most 60 times a second
+    predictionOutput.setup( LOCAL_HOST, OUTGOING_STREAMING_DATA_PORT, "/grt/posture" );
+    predictionOutput.setChangeOnly( true, 0.01 );
+    predictionOutput.setMaxRate( 60 );
+
 }
 
 //--------------------------------------------------------------
@@ -66,6 +80,9 @@ void ofApp::update(){
     synapseStreamer.update();
     
     if( synapseStreamer.getNewMessage() ){
+        //Gather the feature vector straight from the joint data
+        featureSchema.update();
+
         leftHand = synapseStreamer.getLeftHandJointBody();
         rightHand = synapseStreamer.getRightHandJointBody();
         
@@ -87,35 +104,23 @@ void ofApp::update(){
                 if( trainingTimer.timerReached() ){
                     trainingModeActive = false;
                     recordTrainingData = false;
+                    coresetSampler.flush( trainingData );
                 }
             }
                         
             if( recordTrainingData ){
-                //Add the current sample to the training data
-                VectorFloat trainingSample(6);
-                trainingSample[0] = leftHand[0];
-                trainingSample[1] = leftHand[1];
-                trainingSample[2] = leftHand[2];
-                trainingSample[3] = rightHand[0];
-                trainingSample[4] = rightHand[1];
-                trainingSample[5] = rightHand[2];
+                //Add the current sample to the coreset sampler, which is flushed to the training data when the recording stops
+                const VectorFloat &trainingSample = featureSchema.getFeatureVector();
                 
-                if( !trainingData.addSample(trainingClassLabel, trainingSample) ){
-                    infoText = "WARNING: Failed to add training sample to training data!";
-                }
+                coresetSampler.addSample( trainingClassLabel, trainingSample );
             }
         }
         
         //Update the prediction mode if active
         if( predictionModeActive ){
-            VectorFloat inputVector(6);
-            inputVector[0] = leftHand[0];
-            inputVector[1] = leftHand[1];
-            inputVector[2] = leftHand[2];
-            inputVector[3] = rightHand[0];
-            inputVector[4] = rightHand[1];
-            inputVector[5] = rightHand[2];
+            const VectorFloat &inputVector = featureSchema.getFeatureVector();
             if( pipeline.predict( inputVector ) ){
+                predictionOutput.update( pipeline );
                 predictedClassLabel = pipeline.getPredictedClassLabel();
                 predictionPlot.update( pipeline.getClassLikelihoods() );
                 
@@ -162,7 +167,7 @@ void ofApp::draw(){
         textY += textSpacer;
         smallFont.drawString( "Class Label: " + ofToString( trainingClassLabel ), textX, textY ); textY += textSpacer;
         smallFont.drawString( "Recording: " + ofToString( recordTrainingData ), textX, textY ); textY += textSpacer;
-        smallFont.drawString( "Num Samples: " + ofToString( trainingData.getNumSamples() ), textX, textY ); textY += textSpacer;
+        smallFont.drawString( "Num Samples: " + ofToString( trainingData.getNumSamples() + coresetSampler.getNumSamples() ), textX, textY ); textY += textSpacer;
         smallFont.drawString( infoText, textX, textY ); textY += textSpacer;
 
         //Update the graph position
@@ -208,6 +213,7 @@ void ofApp::keyPressed(int key){
     
     switch ( key) {
         case 'r':
+            coresetSampler.flush( trainingData );
             predictionModeActive = false;
             trainingModeActive = true;
             recordTrainingData = false;
@@ -246,6 +252,7 @@ void ofApp::keyPressed(int key){
             break;
         case 'c':
             trainingData.clear();
+            coresetSampler.clear();
             infoText = "Training data cleared";
             break;
         case 'i':
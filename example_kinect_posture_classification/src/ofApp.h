@@ -48,6 +48,9 @@ public:
     ofTrueTypeFont smallFont;
     ofTrueTypeFont hugeFont;
     SynapseStreamer synapseStreamer;
+    ofxGrtFeatureSchema featureSchema;
+    ofxGrtCoresetSampler coresetSampler;
+    ofxGrtOscOutput predictionOutput;
     ofxGrtTimeseriesPlot leftHandPlot;
     ofxGrtTimeseriesPlot rightHandPlot;
     ofxGrtTimeseriesPlot predictionPlot;
@@ -34,6 +34,9 @@ void ofApp::setup(){
     
     //The input to the training data will be the [x y z] from the left and right hand, so we set the number of dimensions to 6
     trainingData.setInputAndTargetDimensions( 6, 1 );
+
+    //Each recording gives thousands of near identical frames, so only the samples that add coverage of the input space are kept
+    coresetSampler.setup( 6, 300, ofxGrtCoresetSampler::K_CENTER_SAMPLING, 0, 1 );
     
     //setup the pipeline
     pipeline << LinearRegression( true );
@@ -46,6 +49,17 @@ void ofApp::setup(){
     synapseStreamer.trackLeftHand(true);
     synapseStreamer.trackRightHand(true);
 
+    //Describe the feature vector, the [x y z] body coordinates of the left hand followed by the right hand
+    synapseStreamer.addFeatureSources( featureSchema );
+    featureSchema.addFeature( "leftHand.body" );
+    featureSchema.addFeature( "rightHand.body" );
+    featureSchema.compile();
+
+    //Stream the predictions to other applications on the outgoing streaming port, only when they change and at most 60 times a second
+    predictionOutput.setup( LOCAL_HOST, OUTGOING_STREAMING_DATA_PORT, "/grt/roll" );
+    predictionOutput.setChangeOnly( true, 0.01 );
+    predictionOutput.setMaxRate( 60 );
+
     ofSetVerticalSync(true);
     
     //some model / light stuff
@@ -81,6 +95,9 @@ void ofApp::update(){
     //spacecraft.setRotation(1, 270 + ofGetElapsedTimef() * 60, 0, 0, 1);
     
     if( synapseStreamer.getNewMessage() ){
+        //Gather the feature vector straight from the joint data
+        featureSchema.update();
+
         leftHand = synapseStreamer.getLeftHandJointBody();
         rightHand = synapseStreamer.getRightHandJointBody();
         
@@ -102,35 +119,23 @@ void ofApp::update(){
                 if( trainingTimer.timerReached() ){
                     trainingModeActive = false;
                     recordTrainingData = false;
+                    coresetSampler.flush( trainingData );
                 }
             }
                         
             if( recordTrainingData ){
-                //Add the current sample to the training data
-                VectorFloat trainingSample(6);
-                trainingSample[0] = leftHand[0];
-                trainingSample[1] = leftHand[1];
-                trainingSample[2] = leftHand[2];
-                trainingSample[3] = rightHand[0];
-                trainingSample[4] = rightHand[1];
-                trainingSample[5] = rightHand[2];
+                //Add the current sample to the coreset sampler, which is flushed to the training data when the recording stops
+                const VectorFloat &trainingSample = featureSchema.getFeatureVector();
                 
-                if( !trainingData.addSample(trainingSample,VectorFloat(1,rollRotationAngle)) ){
-                    infoText = "WARNING: Failed to add training sample to training data!";
-                }
+                coresetSampler.addSample( trainingSample, VectorFloat(1,rollRotationAngle) );
             }
         }
         
         //Update the prediction mode if active
         if( predictionModeActive ){
-            VectorFloat inputVector(6);
-            inputVector[0] = leftHand[0];
-            inputVector[1] = leftHand[1];
-            inputVector[2] = leftHand[2];
-            inputVector[3] = rightHand[0];
-            inputVector[4] = rightHand[1];
-            inputVector[5] = rightHand[2];
+            const VectorFloat &inputVector = featureSchema.getFeatureVector();
             if( pipeline.predict( inputVector ) ){
+                predictionOutput.update( pipeline );
                 rollRotationAngle = pipeline.getRegressionData()[0];
             }else{
                 infoText = "ERROR: Failed to run prediction!";
@@ -187,6 +192,7 @@ void ofApp::keyPressed(int key){
     
     switch ( key) {
         case 'r':
+            coresetSampler.flush( trainingData );
             predictionModeActive = false;
             trainingModeActive = true;
             recordTrainingData = false;
@@ -210,6 +216,7 @@ void ofApp::keyPressed(int key){
             break;
         case 'c':
             trainingData.clear();
+            coresetSampler.clear();
             infoText = "Training data cleared";
             break;
         case 'i':
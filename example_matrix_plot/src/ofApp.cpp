@@ -15,6 +15,12 @@ void ofApp::setup(){
     font.load("verdana.ttf", 12, true, true);
     font.setLineHeight(14.0f);
 
+    //Keep a CPU copy of the data in each plot, so we can show the value under the mouse
+    plot1.setShadowCopyEnabled( true );
+    plot2.setShadowCopyEnabled( true );
+    plot3.setShadowCopyEnabled( true );
+    plot4.setShadowCopyEnabled( true );
+
     //Setup the first matrix, this will plot a sigmoid function
     {
         const unsigned int numRows = 100;
@@ -61,6 +67,26 @@ void ofApp::setup(){
 
 //--------------------------------------------------------------
 void ofApp::update(){
+
+    //Update the fourth matrix, this plots a moving wave inside a diagonal band (like a constrained DTW cost matrix)
+    //Only the cells inside the band are stored and uploaded to the plot, the rest of the matrix stays empty
+    const unsigned int numRows = 100;
+    const unsigned int numCols = 50;
+    const unsigned int radius = 4;
+    const float t = ofGetElapsedTimef();
+    vector< unsigned int > bandStart( numRows );
+    vector< unsigned int > bandLength( numRows );
+    vector< float > values;
+    for(unsigned int i=0; i<numRows; i++){
+        const int center = i * numCols / numRows;
+        bandStart[i] = MAX( 0, center - (int)radius );
+        bandLength[i] = MIN( (int)numCols, center + (int)radius + 1 ) - bandStart[i];
+        for(unsigned int j=0; j<bandLength[i]; j++){
+            values.push_back( 0.5f + 0.5f * sin( t * 2.0f - i * 0.1f ) );
+        }
+    }
+    bandedMatrix.setBanded( numRows, numCols, bandStart, bandLength, values );
+    plot4.update( bandedMatrix );
 }
 
 //--------------------------------------------------------------
@@ -78,6 +104,7 @@ void ofApp::draw(){
     ofSetColor(255,0,0);
     ofNoFill();
     ofDrawRectangle( plotX, plotY, plotW, plotH );
+    drawHoverValue( plot1, plotX, plotY, plotW, plotH );
     plotX += 25 + plotW;
 
     plotW = plot2.getWidth() * zoom;
@@ -88,6 +115,7 @@ void ofApp::draw(){
     ofSetColor(255,0,0);
     ofNoFill();
     ofDrawRectangle( plotX, plotY, plotW, plotH );
+    drawHoverValue( plot2, plotX, plotY, plotW, plotH );
     plotX += 25 + plotW;
 
     plotW = plot3.getWidth() * zoom;
@@ -98,6 +126,37 @@ void ofApp::draw(){
     ofSetColor(255,0,0);
     ofNoFill();
     ofDrawRectangle( plotX, plotY, plotW, plotH );
+    drawHoverValue( plot3, plotX, plotY, plotW, plotH );
+    plotX += 25 + plotW;
+
+    plotW = plot4.getWidth() * zoom;
+    plotH = plot4.getHeight() * zoom;
+    ofSetColor(255,255,255);
+    ofFill();
+    plot4.draw( plotX, plotY, plotW, plotH );
+    ofSetColor(255,0,0);
+    ofNoFill();
+    ofDrawRectangle( plotX, plotY, plotW, plotH );
+    drawHoverValue( plot4, plotX, plotY, plotW, plotH );
+}
+
+//--------------------------------------------------------------
+void ofApp::drawHoverValue( const ofxGrtMatrixPlot &plot, float x, float y, float w, float h ){
+
+    //Look up the value under the mouse from the plot's CPU copy, this does not touch the texture
+    unsigned int row = 0;
+    unsigned int col = 0;
+    float value = 0;
+    if( !plot.getCellAt( mouseX, mouseY, x, y, w, h, row, col ) ) return;
+    if( !plot.getValue( row, col, value ) ) return;
+
+    string text = "[" + ofToString( row ) + " " + ofToString( col ) + "]: " + ofToString( value, 3 );
+    ofRectangle bounds = font.getStringBoundingBox( text, 0, 0 );
+    ofFill();
+    ofSetColor(0,0,0,200);
+    ofDrawRectangle( mouseX + 10, mouseY - bounds.height - 10, bounds.width + 10, bounds.height + 10 );
+    ofSetColor(255,255,255);
+    font.drawString( text, mouseX + 15, mouseY - 5 );
 }
 
 //--------------------------------------------------------------
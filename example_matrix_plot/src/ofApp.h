@@ -28,6 +28,7 @@ public:
 	void windowResized(int w, int h);
 	void dragEvent(ofDragInfo dragInfo);
 	void gotMessage(ofMessage msg);
+	void drawHoverValue( const ofxGrtMatrixPlot &plot, float x, float y, float w, float h );
 
 	float gauss(float x,float mu,float sigma){
         return exp( -SQR(x-mu)/(2.0*SQR(sigma)) );
@@ -37,4 +38,6 @@ public:
 	ofxGrtMatrixPlot plot1;
 	ofxGrtMatrixPlot plot2;
 	ofxGrtMatrixPlot plot3;
+	ofxGrtMatrixPlot plot4;
+	ofxGrtSparseMatrix bandedMatrix;
 };
@@ -181,28 +181,22 @@ void ofApp::keyPressed(int key){
         vector<float> pixelData( size );
         ofFloatPixels pixels;
 
+        //Evaluate the regressifier over the whole texture at once, pixel (i,j) is the input [i/rows j/cols]
+        if( !mapEvaluator.setup( pipeline ) || !mapEvaluator.setGrid( rows, cols ) || !mapEvaluator.evaluate() ){
+            infoText = "WARNING: Failed to build regression map";
+            return;
+        }
+        const vector< float > &regressionData = mapEvaluator.getRegressionData();
+        const unsigned int numOutputs = mapEvaluator.getNumOutputDimensions();
+
         unsigned int index = 0;
-        unsigned int classLabel = 0;
-        VectorFloat inputVector(2);
-        VectorFloat regressionData;
-        float r,g,b,a;
-        for(unsigned int j=0; j<cols; j++){
-            for(unsigned int i=0; i<rows; i++){
-                inputVector[0] = i/double(rows);
-                inputVector[1] = j/double(cols);
-                if( pipeline.predict( inputVector ) ){
-                    regressionData = pipeline.getRegressionData();
-                    r = GRT::Util::limit(regressionData[0],0.0,1.0);
-                    g = GRT::Util::limit(regressionData[1],0.0,1.0);
-                    b = GRT::Util::limit(regressionData[2],0.0,1.0);
-                    a = 1.0;
-                    pixelData[ index++ ] = r;
-                    pixelData[ index++ ] = g;
-                    pixelData[ index++ ] = b;
-                    pixelData[ index++ ] = a;
-                }
-            }
+        for(unsigned int n=0; n<rows*cols; n++){
+            pixelData[ index++ ] = GRT::Util::limit(regressionData[n*numOutputs],0.0,1.0);
+            pixelData[ index++ ] = GRT::Util::limit(regressionData[n*numOutputs+1],0.0,1.0);
+            pixelData[ index++ ] = GRT::Util::limit(regressionData[n*numOutputs+2],0.0,1.0);
+            pixelData[ index++ ] = 1.0;
         }
+        infoText += " (" + mapEvaluator.getModelTypeAsString() + " map: " + ofToString( mapEvaluator.getEvaluationTime(), 1 ) + "ms)";
         pixels.setFromExternalPixels(&pixelData[0],rows,cols,OF_PIXELS_RGBA);
         if(!texture.isAllocated()){
             texture.allocate( pixels, false );
@@ -219,7 +213,7 @@ bool ofApp::setRegressifier( const int type ){
 
     LinearRegression linearRegression;
     LogisticRegression logisticRegression;
-    MLP mlp;
+    ofxGrtMLP mlp;
 
     this->regressifierType = type;
 
@@ -239,12 +233,13 @@ bool ofApp::setRegressifier( const int type ){
                 unsigned int numOutputNeurons = 1; //1 as we are using multidimensional regression
                 
                 //Initialize the MLP
-                mlp.init(numInputNeurons, numHiddenNeurons, numOutputNeurons, Neuron::LINEAR, Neuron::SIGMOID, Neuron::SIGMOID );
+                mlp.init(numInputNeurons, numHiddenNeurons, numOutputNeurons, ofxGrtMLP::SIGMOID, ofxGrtMLP::SIGMOID );
                 
                 //Set the training settings
                 mlp.setMaxNumEpochs( 1000 ); //This sets the maximum number of epochs (1 epoch is 1 complete iteration of the training data) that are allowed
                 mlp.setMinChange( 1.0e-10 ); //This sets the minimum change allowed in training error between any two epochs
-                mlp.setLearningRate( 0.001 ); //This sets the rate at which the learning algorithm updates the weights of the neural network
+                mlp.setLearningRate( 0.1 ); //This sets the rate at which the learning algorithm updates the weights of the neural network
+                mlp.setBatchSize( 16 ); //This sets the number of samples used for each weight update, the gradient of each batch is averaged
                 mlp.setNumRandomTrainingIterations( 5 ); //This sets the number of times the MLP will be trained, each training iteration starts with new random values
                 mlp.setUseValidationSet( true ); //This sets aside a small portiion of the training data to be used as a validation set to mitigate overfitting
                 mlp.setValidationSetSize( 20 ); //Use 20% of the training data for validation during the training phase
@@ -39,6 +39,7 @@ public:
     GRT::VectorFloat targetVector;              //This will hold the current label for when we are training the classifier
     string infoText;                            //This string will be used to draw some info messages to the main app window
     ofTexture texture;
+    ofxGrtMapEvaluator mapEvaluator;            //This evaluates the pipeline over the whole texture
     int regressifierType;
     ofTrueTypeFont largeFont;
     ofTrueTypeFont smallFont;
@@ -21,6 +21,38 @@
 #pragma once
 #include "ofMain.h"
 #include "GRT/GRT.h"
+#include "ofxGrtThreadPool.h"
+#include "ofxGrtSimd.h"
+#include "ofxGrtOsc.h"
+#include "ofxGrtDatagramSocket.h"
+#include "ofxGrtModelAccess.h"
+#include "ofxGrtSnapshot.h"
+#include "ofxGrtMapEvaluator.h"
+#include "ofxGrtPredictor.h"
+#include "ofxGrtInferenceServer.h"
+#include "ofxGrtOscOutput.h"
+#include "ofxGrtFeatureSchema.h"
+#include "ofxGrtStreamAligner.h"
+#include "ofxGrtPipelineProfiler.h"
+#include "ofxGrtCrossValidation.h"
+#include "ofxGrtParameterSearch.h"
+#include "ofxGrtCoresetSampler.h"
+#include "ofxGrtKNN.h"
+#include "ofxGrtCompiledForest.h"
+#include "ofxGrtGaussianEvaluator.h"
+#include "ofxGrtForestTrainer.h"
+#include "ofxGrtRandomForests.h"
+#include "ofxGrtDecisionTree.h"
+#include "ofxGrtMLP.h"
+#include "ofxGrtQuantizedModel.h"
+#include "ofxGrtSVM.h"
+#include "ofxGrtDTWDistance.h"
+#include "ofxGrtDTWTrainer.h"
+#include "ofxGrtDTWAverager.h"
+#include "ofxGrtDTW.h"
+#include "ofxGrtDTWSpotter.h"
+#include "ofxGrtDTWEarlyClassifier.h"
+#include "ofxGrtSparseMatrix.h"
 #include "ofxGrtMatrixPlot.h"
 #include "ofxGrtTimeseriesPlot.h"
  #include "ofxGrtBarPlot.h"
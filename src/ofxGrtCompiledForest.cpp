@@ -0,0 +1,420 @@
+
+#include "ofxGrtCompiledForest.h"
+#include <cmath>
+#include <cstring>
+
+using namespace GRT;
+
+ofxGrtCompiledForest::ofxGrtCompiledForest(){
+    errorLog.setProceedingText("[ERROR ofxGrtCompiledForest]");
+    clear();
+}
+
+ofxGrtCompiledForest::~ofxGrtCompiledForest(){
+}
+
+bool ofxGrtCompiledForest::setup( const RandomForests &forest ){
+
+    clear();
+
+    if( !forest.getTrained() ){
+        errorLog << "setup(const RandomForests &forest) - The forest has not been trained!" << endl;
+        return false;
+    }
+
+    if( forest.getNullRejectionEnabled() ){
+        errorLog << "setup(const RandomForests &forest) - Forests with null rejection are not supported!" << endl;
+        return false;
+    }
+
+    const Vector< DecisionTreeNode* > trees = forest.getForest();
+    if( trees.size() == 0 ){
+        errorLog << "setup(const RandomForests &forest) - The forest has no trees!" << endl;
+        return false;
+    }
+
+    numInputDimensions = forest.getNumInputDimensions();
+    numClasses = forest.getNumClasses();
+    classLabels = forest.getClassLabels();
+    useScaling = forest.getScalingEnabled();
+    ranges = forest.getRanges();
+
+    const Float leafThreshold = std::numeric_limits< Float >::quiet_NaN();
+
+    for(size_t t=0; t<trees.size(); t++){
+        if( trees[t] == NULL ){
+            errorLog << "setup(const RandomForests &forest) - Tree " << t << " is empty!" << endl;
+            clear();
+            return false;
+        }
+
+        //Walk the tree breadth first, so the children of each node are added next to each other
+        const UINT root = (UINT)nodes.size();
+        vector< const DecisionTreeNode* > queue( 1, trees[t] );
+        vector< UINT > depths( 1, 0 );
+        UINT depth = 0;
+        for(size_t i=0; i<queue.size(); i++){
+            const DecisionTreeNode *node = queue[i];
+            const UINT index = root + (UINT)i;
+            CompiledNode compiled;
+            UINT leafOffset = 0;
+
+            if( node->getIsLeafNode() ){
+                const VectorFloat probabilities = node->getClassProbabilities();
+                if( probabilities.size() != numClasses ){
+                    errorLog << "setup(const RandomForests &forest) - A leaf of tree " << t << " has " << probabilities.size() << " class probabilities, expected " << numClasses << endl;
+                    clear();
+                    return false;
+                }
+                compiled.threshold = leafThreshold;
+                compiled.feature = 0;
+                compiled.child = index;
+                leafOffset = (UINT)leafProbabilities.size();
+                leafProbabilities.insert( leafProbabilities.end(), probabilities.begin(), probabilities.end() );
+            }else{
+                const DecisionTreeNode *left = dynamic_cast< const DecisionTreeNode* >( node->getLeftChild() );
+                const DecisionTreeNode *right = dynamic_cast< const DecisionTreeNode* >( node->getRightChild() );
+                const DecisionTreeClusterNode *clusterNode = dynamic_cast< const DecisionTreeClusterNode* >( node );
+                const DecisionTreeThresholdNode *thresholdNode = dynamic_cast< const DecisionTreeThresholdNode* >( node );
+
+                if( clusterNode ){
+                    compiled.feature = clusterNode->getFeatureIndex();
+                    compiled.threshold = clusterNode->getThreshold();
+                }else if( thresholdNode ){
+                    compiled.feature = thresholdNode->getFeatureIndex();
+                    compiled.threshold = thresholdNode->getThreshold();
+                }
+
+                if( left == NULL || right == NULL || (clusterNode == NULL && thresholdNode == NULL) || compiled.feature >= numInputDimensions ){
+                    errorLog << "setup(const RandomForests &forest) - Tree " << t << " has a node type that is not supported!" << endl;
+                    clear();
+                    return false;
+                }
+
+                compiled.child = root + (UINT)queue.size();
+                queue.push_back( left );
+                queue.push_back( right );
+                depths.push_back( depths[i] + 1 );
+                depths.push_back( depths[i] + 1 );
+            }
+
+            nodes.push_back( compiled );
+            leafOffsets.push_back( leafOffset );
+            depth = std::max( depth, depths[i] );
+        }
+
+        treeRoots.push_back( root );
+        treeDepths.push_back( depth );
+    }
+
+    classNorm = 1.0 / Float( trees.size() );
+    scaledInput.resize( numInputDimensions );
+    classLikelihoods.resize( numClasses, 0 );
+    classDistances.resize( numClasses, 0 );
+    trained = true;
+
+    return true;
+}
+
+bool ofxGrtCompiledForest::predict( const VectorFloat &inputVector ){
+
+    predictedClassLabel = 0;
+    maximumLikelihood = 0;
+
+    if( !trained ){
+        errorLog << "predict(const VectorFloat &inputVector) - The forest has not been setup!" << endl;
+        return false;
+    }
+
+    if( inputVector.size() != numInputDimensions ){
+        errorLog << "predict(const VectorFloat &inputVector) - The size of the input vector (" << inputVector.size() << ") does not match the forest (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    const Float *x = &inputVector[0];
+    if( useScaling ){
+        scale( x, &scaledInput[0] );
+        x = &scaledInput[0];
+    }
+
+    //Sum the leaf probabilities of each tree, in the same order as the GRT
+    std::fill( classDistances.begin(), classDistances.end(), 0 );
+    const Arrays arrays = getArrays();
+    const CompiledNode *nodeData = arrays.nodes;
+    for(UINT t=0; t<arrays.numTrees; t++){
+        UINT node = arrays.treeRoots[t];
+        for(UINT step=0; step<arrays.treeDepths[t]; step++){
+            const CompiledNode &n = nodeData[ node ];
+            node = n.child + (x[ n.feature ] >= n.threshold ? 1 : 0);
+        }
+        const Float *probabilities = &arrays.leafProbabilities[ arrays.leafOffsets[ node ] ];
+        for(UINT k=0; k<numClasses; k++){
+            classDistances[k] += probabilities[k];
+        }
+    }
+
+    for(UINT k=0; k<numClasses; k++){
+        classLikelihoods[k] = classDistances[k] * classNorm;
+    }
+    predictedClassLabel = classLabels[ getLabelIndex( &classDistances[0], maximumLikelihood ) ];
+
+    return true;
+}
+
+bool ofxGrtCompiledForest::predict( const Float *inputs, const UINT numSamples, UINT *predictedClassLabels, Float *maximumLikelihoods, Float *classLikelihoods ) const {
+
+    if( !trained ){
+        errorLog << "predict(const Float *inputs, ...) - The forest has not been setup!" << endl;
+        return false;
+    }
+
+    if( inputs == NULL || predictedClassLabels == NULL ){
+        errorLog << "predict(const Float *inputs, ...) - The inputs and predicted class labels can not be NULL!" << endl;
+        return false;
+    }
+
+    const UINT N = numInputDimensions;
+    const UINT K = numClasses;
+    const Arrays arrays = getArrays();
+    const CompiledNode *nodeData = arrays.nodes;
+    vector< Float > scaledInputs( useScaling ? BATCH_SIZE*N : 0 );
+    vector< Float > sums( BATCH_SIZE*K );
+    const Float *x[ BATCH_SIZE ];
+    UINT node[ BATCH_SIZE ];
+
+    for(UINT begin=0; begin<numSamples; begin+=BATCH_SIZE){
+        const UINT batchSize = std::min( (UINT)BATCH_SIZE, numSamples - begin );
+
+        for(UINT s=0; s<batchSize; s++){
+            x[s] = inputs + (size_t)(begin + s) * N;
+            if( useScaling ){
+                scale( x[s], &scaledInputs[ s*N ] );
+                x[s] = &scaledInputs[ s*N ];
+            }
+        }
+        std::fill( sums.begin(), sums.end(), 0 );
+
+        //Walk the batch through each tree together, one level at a time
+        for(UINT t=0; t<arrays.numTrees; t++){
+            for(UINT s=0; s<batchSize; s++) node[s] = arrays.treeRoots[t];
+            for(UINT step=0; step<arrays.treeDepths[t]; step++){
+                for(UINT s=0; s<batchSize; s++){
+                    const CompiledNode &n = nodeData[ node[s] ];
+                    node[s] = n.child + (x[s][ n.feature ] >= n.threshold ? 1 : 0);
+                }
+            }
+            for(UINT s=0; s<batchSize; s++){
+                const Float *probabilities = &arrays.leafProbabilities[ arrays.leafOffsets[ node[s] ] ];
+                Float *sum = &sums[ s*K ];
+                for(UINT k=0; k<K; k++){
+                    sum[k] += probabilities[k];
+                }
+            }
+        }
+
+        for(UINT s=0; s<batchSize; s++){
+            const Float *sum = &sums[ s*K ];
+            Float maxLikelihood = 0;
+            predictedClassLabels[ begin + s ] = classLabels[ getLabelIndex( sum, maxLikelihood ) ];
+            if( maximumLikelihoods ) maximumLikelihoods[ begin + s ] = maxLikelihood;
+            if( classLikelihoods ){
+                for(UINT k=0; k<K; k++){
+                    classLikelihoods[ (size_t)(begin + s) * K + k ] = sum[k] * classNorm;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+bool ofxGrtCompiledForest::clear(){
+    trained = false;
+    useScaling = false;
+    numInputDimensions = 0;
+    numClasses = 0;
+    classNorm = 0;
+    ranges.clear();
+    classLabels.clear();
+    nodes.clear();
+    leafOffsets.clear();
+    leafProbabilities.clear();
+    treeRoots.clear();
+    treeDepths.clear();
+    snapshot.reset();
+    memset( &mappedArrays, 0, sizeof( mappedArrays ) );
+    predictedClassLabel = 0;
+    maximumLikelihood = 0;
+    scaledInput.clear();
+    classLikelihoods.clear();
+    classDistances.clear();
+    return true;
+}
+
+UINT ofxGrtCompiledForest::getMaxDepth() const {
+    const Arrays arrays = getArrays();
+    UINT depth = 0;
+    for(UINT t=0; t<arrays.numTrees; t++){
+        depth = std::max( depth, arrays.treeDepths[t] );
+    }
+    return depth;
+}
+
+bool ofxGrtCompiledForest::saveSnapshot( const std::string &filename ) const {
+
+    if( !trained ){
+        errorLog << "saveSnapshot(const std::string &filename) - The forest has not been setup!" << endl;
+        return false;
+    }
+
+    SnapshotInfo info;
+    memset( &info, 0, sizeof( info ) );
+    info.numInputDimensions = numInputDimensions;
+    info.numClasses = numClasses;
+    info.useScaling = useScaling ? 1 : 0;
+    info.nodeSize = sizeof( CompiledNode );
+    info.classNorm = classNorm;
+
+    vector< Float > rangeValues( numInputDimensions * 2 );
+    for(UINT j=0; j<numInputDimensions; j++){
+        rangeValues[ j*2 ] = ranges[j].minValue;
+        rangeValues[ j*2+1 ] = ranges[j].maxValue;
+    }
+    const vector< UINT > labels( classLabels.begin(), classLabels.end() );
+
+    const Arrays arrays = getArrays();
+    ofxGrtSnapshotWriter writer;
+    writer.addValue( "forest.info", info );
+    writer.addArray( "forest.ranges", rangeValues );
+    writer.addArray( "forest.classLabels", labels );
+    writer.addArray( "forest.nodes", arrays.nodes, arrays.numNodes );
+    writer.addArray( "forest.leafOffsets", arrays.leafOffsets, arrays.numNodes );
+    writer.addArray( "forest.leafProbabilities", arrays.leafProbabilities, arrays.numLeafProbabilities );
+    writer.addArray( "forest.treeRoots", arrays.treeRoots, arrays.numTrees );
+    writer.addArray( "forest.treeDepths", arrays.treeDepths, arrays.numTrees );
+
+    return writer.save( filename );
+}
+
+bool ofxGrtCompiledForest::loadSnapshot( const std::string &filename ){
+    std::shared_ptr< const ofxGrtSnapshot > snapshot = ofxGrtSnapshot::load( filename );
+    if( !snapshot ){
+        errorLog << "loadSnapshot(const std::string &filename) - Failed to open snapshot: " << filename << endl;
+        clear();
+        return false;
+    }
+    return loadSnapshot( snapshot );
+}
+
+bool ofxGrtCompiledForest::loadSnapshot( const std::shared_ptr< const ofxGrtSnapshot > &snapshot ){
+
+    clear();
+
+    if( !snapshot || !snapshot->getIsOpen() ){
+        errorLog << "loadSnapshot(...) - The snapshot is not open!" << endl;
+        return false;
+    }
+
+    SnapshotInfo info;
+    const Float *rangeValues = NULL;
+    const UINT *labels = NULL;
+    size_t numRangeValues = 0, numLabels = 0, numLeafOffsets = 0, numTreeDepths = 0, numNodes = 0, numTrees = 0, numLeafProbabilities = 0;
+    Arrays arrays;
+    if( !snapshot->getValue( "forest.info", info ) ||
+        !snapshot->getArray( "forest.ranges", rangeValues, numRangeValues ) ||
+        !snapshot->getArray( "forest.classLabels", labels, numLabels ) ||
+        !snapshot->getArray( "forest.nodes", arrays.nodes, numNodes ) ||
+        !snapshot->getArray( "forest.leafOffsets", arrays.leafOffsets, numLeafOffsets ) ||
+        !snapshot->getArray( "forest.leafProbabilities", arrays.leafProbabilities, numLeafProbabilities ) ||
+        !snapshot->getArray( "forest.treeRoots", arrays.treeRoots, numTrees ) ||
+        !snapshot->getArray( "forest.treeDepths", arrays.treeDepths, numTreeDepths ) ){
+        errorLog << "loadSnapshot(...) - The snapshot does not contain a compiled forest!" << endl;
+        return false;
+    }
+
+    if( info.nodeSize != sizeof( CompiledNode ) || info.numClasses == 0 || numLabels != info.numClasses || numRangeValues != (size_t)info.numInputDimensions * 2 ||
+        numTrees == 0 || numTreeDepths != numTrees || numLeafOffsets != numNodes ){
+        errorLog << "loadSnapshot(...) - The sizes of the forest arrays in the snapshot do not match!" << endl;
+        return false;
+    }
+
+    //Check every index once here, so predict can walk the arrays without checks. A leaf points at itself and keeps its walk there with a
+    //NaN threshold (every comparison with NaN is false), so a leaf with any other threshold would step to the next node.
+    for(size_t i=0; i<numNodes; i++){
+        const CompiledNode &node = arrays.nodes[i];
+        const bool isLeaf = node.child == i;
+        if( (isLeaf && !std::isnan( node.threshold )) || (!isLeaf && (size_t)node.child + 1 >= numNodes) || node.feature >= info.numInputDimensions ||
+            (size_t)arrays.leafOffsets[i] + info.numClasses > numLeafProbabilities ){
+            errorLog << "loadSnapshot(...) - Node " << i << " of the snapshot is invalid!" << endl;
+            return false;
+        }
+    }
+    for(size_t t=0; t<numTrees; t++){
+        if( arrays.treeRoots[t] >= numNodes ){
+            errorLog << "loadSnapshot(...) - Tree " << t << " of the snapshot is invalid!" << endl;
+            return false;
+        }
+    }
+
+    arrays.numNodes = (UINT)numNodes;
+    arrays.numTrees = (UINT)numTrees;
+    arrays.numLeafProbabilities = (UINT)numLeafProbabilities;
+
+    numInputDimensions = info.numInputDimensions;
+    numClasses = info.numClasses;
+    useScaling = info.useScaling != 0;
+    classNorm = info.classNorm;
+    ranges.resize( numInputDimensions );
+    for(UINT j=0; j<numInputDimensions; j++){
+        ranges[j].minValue = rangeValues[ j*2 ];
+        ranges[j].maxValue = rangeValues[ j*2+1 ];
+    }
+    classLabels.resize( numClasses );
+    for(UINT k=0; k<numClasses; k++) classLabels[k] = labels[k];
+
+    this->snapshot = snapshot;
+    mappedArrays = arrays;
+    scaledInput.resize( numInputDimensions );
+    classLikelihoods.resize( numClasses, 0 );
+    classDistances.resize( numClasses, 0 );
+    trained = true;
+
+    return true;
+}
+
+ofxGrtCompiledForest::Arrays ofxGrtCompiledForest::getArrays() const {
+    if( snapshot ) return mappedArrays;
+    Arrays arrays;
+    arrays.nodes = nodes.size() > 0 ? &nodes[0] : NULL;
+    arrays.leafOffsets = leafOffsets.size() > 0 ? &leafOffsets[0] : NULL;
+    arrays.leafProbabilities = leafProbabilities.size() > 0 ? &leafProbabilities[0] : NULL;
+    arrays.treeRoots = treeRoots.size() > 0 ? &treeRoots[0] : NULL;
+    arrays.treeDepths = treeDepths.size() > 0 ? &treeDepths[0] : NULL;
+    arrays.numNodes = (UINT)nodes.size();
+    arrays.numTrees = (UINT)treeRoots.size();
+    arrays.numLeafProbabilities = (UINT)leafProbabilities.size();
+    return arrays;
+}
+
+void ofxGrtCompiledForest::scale( const Float *input, Float *scaledInput ) const {
+    //The same arithmetic as MLBase::scale, so the splits see exactly the same values
+    for(UINT d=0; d<numInputDimensions; d++){
+        const Float minValue = ranges[d].minValue;
+        const Float maxValue = ranges[d].maxValue;
+        scaledInput[d] = minValue == maxValue ? 0 : (((input[d]-minValue)*(1.0-0.0))/(maxValue-minValue))+0.0;
+    }
+}
+
+UINT ofxGrtCompiledForest::getLabelIndex( const Float *classDistances, Float &maximumLikelihood ) const {
+    //The first class with the highest likelihood wins, as in the GRT
+    UINT bestIndex = 0;
+    maximumLikelihood = 0;
+    for(UINT k=0; k<numClasses; k++){
+        const Float likelihood = classDistances[k] * classNorm;
+        if( likelihood > maximumLikelihood ){
+            maximumLikelihood = likelihood;
+            bestIndex = k;
+        }
+    }
+    return bestIndex;
+}
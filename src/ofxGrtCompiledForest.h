@@ -0,0 +1,169 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <memory>
+
+#include "ofMain.h"
+#include "ofxGrtSnapshot.h"
+
+using namespace GRT;
+
+/**
+ @brief a compiled copy of a trained RandomForests model for fast prediction. The GRT stores each decision tree as linked nodes spread across
+ the heap, the compiled forest stores every node of every tree in one contiguous array in breadth first order, with the split feature, the
+ threshold and the offset of the children. The two children of a node are stored next to each other, so each step down a tree is
+ child + (x[feature] >= threshold) with no branch. Leaves point back at themselves (with a threshold that no input passes), so each tree is
+ walked for a fixed number of steps. In batch mode several samples are walked through each tree together, so their memory accesses overlap.
+
+ The splits, leaf probabilities and the way the trees are combined match the GRT, so the compiled forest gives exactly the same class labels and
+ likelihoods as the original model. The compiled forest is independent of the original model, so it needs to be setup again if the model is retrained.
+
+ The compiled forest can be saved as a binary ofxGrtSnapshot. A forest loaded from a snapshot walks the node and leaf arrays straight from the
+ read-only mapping of the file, so loading does not parse or copy the trees, and processes that load the same file share its memory.
+*/
+class ofxGrtCompiledForest {
+public:
+    ofxGrtCompiledForest();
+    ~ofxGrtCompiledForest();
+
+    /**
+     @brief compiles a trained forest, forests with null rejection or tree nodes other than cluster or threshold nodes are not supported
+     @param forest: the trained forest
+     @return returns true if the forest was compiled successfully, false otherwise
+    */
+    bool setup( const RandomForests &forest );
+
+    /**
+     @brief predicts the class of one sample, the results can be accessed with getPredictedClassLabel, getClassLikelihoods and getClassDistances
+     @param inputVector: the input sample, the size must match the number of input dimensions
+     @return returns true if the prediction was successful, false otherwise
+    */
+    bool predict( const VectorFloat &inputVector );
+
+    /**
+     @brief predicts the class of a batch of samples. This does not change the compiled forest, so it can be called from several threads at once.
+     @param inputs: the samples, stored sample by sample with getNumInputDimensions() values per sample
+     @param numSamples: the number of samples
+     @param predictedClassLabels: the predicted class label of each sample, this must have room for numSamples values
+     @param maximumLikelihoods: the likelihood of the predicted class of each sample, this must have room for numSamples values (or be NULL)
+     @param classLikelihoods: the likelihood of each class for each sample, stored sample by sample, this must have room for numSamples*getNumClasses() values (or be NULL)
+     @return returns true if the predictions were successful, false otherwise
+    */
+    bool predict( const Float *inputs, const UINT numSamples, UINT *predictedClassLabels, Float *maximumLikelihoods = NULL, Float *classLikelihoods = NULL ) const;
+
+    /**
+     @brief removes the compiled forest
+     @return returns true if the forest was cleared successfully, false otherwise
+    */
+    bool clear();
+
+    /**
+     @brief saves the compiled forest as a binary snapshot
+     @param filename: the snapshot file to write
+     @return returns true if the snapshot was saved successfully, false otherwise
+    */
+    bool saveSnapshot( const std::string &filename ) const;
+
+    /**
+     @brief loads a compiled forest from a binary snapshot, the forest uses the arrays in the snapshot without copying them
+     @param filename: the snapshot file to map
+     @return returns true if the snapshot was loaded successfully, false otherwise
+    */
+    bool loadSnapshot( const std::string &filename );
+
+    /**
+     @brief loads a compiled forest from a snapshot that is already open, so several models can share one mapping
+     @param snapshot: the open snapshot, the forest keeps a reference to it
+     @return returns true if the snapshot was loaded successfully, false otherwise
+    */
+    bool loadSnapshot( const std::shared_ptr< const ofxGrtSnapshot > &snapshot );
+
+    bool getTrained() const { return trained; }
+    UINT getNumInputDimensions() const { return numInputDimensions; }
+    UINT getNumClasses() const { return numClasses; }
+    UINT getNumTrees() const { return getArrays().numTrees; }
+    UINT getNumNodes() const { return getArrays().numNodes; }
+    bool getIsMapped() const { return snapshot != NULL; }
+    UINT getMaxDepth() const;
+    UINT getPredictedClassLabel() const { return predictedClassLabel; }
+    Float getMaximumLikelihood() const { return maximumLikelihood; }
+    const VectorFloat &getClassLikelihoods() const { return classLikelihoods; }
+    const VectorFloat &getClassDistances() const { return classDistances; }
+
+protected:
+    //The number of samples walked through each tree together in batch mode
+    static const UINT BATCH_SIZE = 8;
+
+    struct CompiledNode{
+        Float threshold;    ///< NaN for leaves, so the comparison is always false
+        UINT feature;
+        UINT child;         ///< The index of the left child, the right child is at child+1, leaves point at themselves
+    };
+
+    //The node and leaf arrays, either owned by the forest or in a snapshot
+    struct Arrays{
+        const CompiledNode *nodes;
+        const UINT *leafOffsets;
+        const Float *leafProbabilities;
+        const UINT *treeRoots;
+        const UINT *treeDepths;
+        UINT numNodes;
+        UINT numTrees;
+        UINT numLeafProbabilities;
+    };
+
+    //The settings stored in the snapshot
+    struct SnapshotInfo{
+        uint32_t numInputDimensions;
+        uint32_t numClasses;
+        uint32_t useScaling;
+        uint32_t nodeSize;          ///< sizeof( CompiledNode ), checked on load
+        Float classNorm;
+    };
+
+    Arrays getArrays() const;
+    void scale( const Float *input, Float *scaledInput ) const;
+    UINT getLabelIndex( const Float *classDistances, Float &maximumLikelihood ) const;
+
+    bool trained;
+    bool useScaling;
+    UINT numInputDimensions;
+    UINT numClasses;
+    Float classNorm;
+    Vector< MinMax > ranges;
+    Vector< UINT > classLabels;
+    vector< CompiledNode > nodes;
+    vector< UINT > leafOffsets;         ///< The offset of each leaf's class probabilities in leafProbabilities
+    vector< Float > leafProbabilities;
+    vector< UINT > treeRoots;
+    vector< UINT > treeDepths;
+    std::shared_ptr< const ofxGrtSnapshot > snapshot;
+    Arrays mappedArrays;                ///< The arrays in the snapshot, if the forest was loaded from one
+
+    UINT predictedClassLabel;
+    Float maximumLikelihood;
+    VectorFloat scaledInput;
+    VectorFloat classLikelihoods;
+    VectorFloat classDistances;
+
+    ErrorLog errorLog;
+};
@@ -0,0 +1,347 @@
+
+#include "ofxGrtCoresetSampler.h"
+
+using namespace GRT;
+
+ofxGrtCoresetSampler::ofxGrtCoresetSampler(){
+    errorLog.setProceedingText("[ERROR ofxGrtCoresetSampler]");
+    numDimensions = 0;
+    numTargetDimensions = 0;
+    stride = 0;
+    maxSamplesPerClass = 0;
+    mode = K_CENTER_SAMPLING;
+    cellSize = 0.05;
+}
+
+ofxGrtCoresetSampler::~ofxGrtCoresetSampler(){
+}
+
+bool ofxGrtCoresetSampler::setup( const UINT numDimensions, const UINT maxSamplesPerClass, const SamplingMode mode, const Float cellSize, const UINT numTargetDimensions ){
+
+    if( numDimensions == 0 || maxSamplesPerClass == 0 ){
+        errorLog << "setup(...) - The number of dimensions and the maximum number of samples per class must be greater than zero!" << endl;
+        return false;
+    }
+
+    if( mode == GRID_DEDUPLICATION && cellSize <= 0 ){
+        errorLog << "setup(...) - The cell size must be greater than zero!" << endl;
+        return false;
+    }
+
+    this->numDimensions = numDimensions;
+    this->numTargetDimensions = numTargetDimensions;
+    this->stride = numDimensions + numTargetDimensions;
+    this->maxSamplesPerClass = maxSamplesPerClass;
+    this->mode = mode;
+    this->cellSize = cellSize;
+    sample.resize( stride );
+    randomGenerator.seed( 5489u );
+
+    return clear();
+}
+
+bool ofxGrtCoresetSampler::addSample( const UINT classLabel, const VectorFloat &sample ){
+
+    if( numTargetDimensions != 0 ){
+        errorLog << "addSample(const UINT classLabel, const VectorFloat &sample) - The sampler has been setup for regression data!" << endl;
+        return false;
+    }
+
+    return add( classLabel, sample, NULL );
+}
+
+bool ofxGrtCoresetSampler::addSample( const VectorFloat &inputVector, const VectorFloat &targetVector ){
+
+    if( numTargetDimensions == 0 || targetVector.size() != numTargetDimensions ){
+        errorLog << "addSample(const VectorFloat &inputVector, const VectorFloat &targetVector) - The size of the target vector (" << targetVector.size() << ") does not match the sampler (" << numTargetDimensions << ")" << endl;
+        return false;
+    }
+
+    return add( 0, inputVector, &targetVector );
+}
+
+bool ofxGrtCoresetSampler::flush( ClassificationData &trainingData ){
+
+    if( numTargetDimensions != 0 ){
+        errorLog << "flush(ClassificationData &trainingData) - The sampler has been setup for regression data!" << endl;
+        return false;
+    }
+
+    bool success = true;
+    VectorFloat inputVector( numDimensions );
+    vector< Float > recorded;
+    for(size_t k=0; k<classes.size(); k++){
+        ClassBuffer &buffer = classes[k];
+        if( buffer.numSamples == 0 ) continue;
+
+        //Reduce the samples the class already has in the training data together with the new ones, and replace the class with the result,
+        //so the class stays within maxSamplesPerClass however many times it is recorded
+        recorded.assign( buffer.values.begin(), buffer.values.begin() + buffer.numSamples * stride );
+        resetClassBuffer( buffer );
+        for(UINT i=0; i<trainingData.getNumSamples(); i++){
+            if( trainingData[i].getClassLabel() != buffer.classLabel ) continue;
+            const VectorFloat &existing = trainingData[i].getSample();
+            std::copy( existing.begin(), existing.end(), sample.begin() );
+            insert( buffer, &sample[0] );
+        }
+        for(size_t i=0; i<recorded.size(); i+=stride){
+            insert( buffer, &recorded[i] );
+        }
+
+        trainingData.eraseAllSamplesWithClassLabel( buffer.classLabel );
+        for(UINT i=0; i<buffer.numSamples; i++){
+            const Float *values = &buffer.values[ i * stride ];
+            std::copy( values, values + numDimensions, inputVector.begin() );
+            if( !trainingData.addSample( buffer.classLabel, inputVector ) ) success = false;
+        }
+    }
+
+    if( !success ){
+        errorLog << "flush(ClassificationData &trainingData) - Failed to add some of the samples to the training data!" << endl;
+    }
+
+    clear();
+
+    return success;
+}
+
+bool ofxGrtCoresetSampler::flush( RegressionData &trainingData ){
+
+    if( numTargetDimensions == 0 ){
+        errorLog << "flush(RegressionData &trainingData) - The sampler has been setup for classification data!" << endl;
+        return false;
+    }
+
+    bool success = true;
+    VectorFloat inputVector( numDimensions );
+    VectorFloat targetVector( numTargetDimensions );
+    vector< Float > recorded;
+    for(size_t k=0; k<classes.size(); k++){
+        ClassBuffer &buffer = classes[k];
+        if( buffer.numSamples == 0 ) continue;
+
+        //Regression samples all share one buffer, so reduce the whole training set together with the new samples and replace it
+        recorded.assign( buffer.values.begin(), buffer.values.begin() + buffer.numSamples * stride );
+        resetClassBuffer( buffer );
+        for(UINT i=0; i<trainingData.getNumSamples(); i++){
+            const VectorFloat &existingInput = trainingData[i].getInputVector();
+            const VectorFloat &existingTarget = trainingData[i].getTargetVector();
+            if( existingInput.size() != numDimensions || existingTarget.size() != numTargetDimensions ) continue;
+            std::copy( existingInput.begin(), existingInput.end(), sample.begin() );
+            std::copy( existingTarget.begin(), existingTarget.end(), sample.begin() + numDimensions );
+            insert( buffer, &sample[0] );
+        }
+        for(size_t i=0; i<recorded.size(); i+=stride){
+            insert( buffer, &recorded[i] );
+        }
+
+        trainingData.clear();
+        for(UINT i=0; i<buffer.numSamples; i++){
+            const Float *values = &buffer.values[ i * stride ];
+            std::copy( values, values + numDimensions, inputVector.begin() );
+            std::copy( values + numDimensions, values + stride, targetVector.begin() );
+            if( !trainingData.addSample( inputVector, targetVector ) ) success = false;
+        }
+    }
+
+    if( !success ){
+        errorLog << "flush(RegressionData &trainingData) - Failed to add some of the samples to the training data!" << endl;
+    }
+
+    clear();
+
+    return success;
+}
+
+bool ofxGrtCoresetSampler::clear(){
+    classes.clear();
+    return true;
+}
+
+UINT ofxGrtCoresetSampler::getNumSamples() const {
+    UINT numSamples = 0;
+    for(size_t k=0; k<classes.size(); k++){
+        numSamples += classes[k].numSamples;
+    }
+    return numSamples;
+}
+
+UINT ofxGrtCoresetSampler::getNumSamplesSeen() const {
+    UINT numSeen = 0;
+    for(size_t k=0; k<classes.size(); k++){
+        numSeen += classes[k].numSeen;
+    }
+    return numSeen;
+}
+
+bool ofxGrtCoresetSampler::add( const UINT classLabel, const VectorFloat &inputVector, const VectorFloat *targetVector ){
+
+    if( numDimensions == 0 ){
+        errorLog << "addSample(...) - The sampler has not been setup!" << endl;
+        return false;
+    }
+
+    if( inputVector.size() != numDimensions ){
+        errorLog << "addSample(...) - The size of the sample (" << inputVector.size() << ") does not match the sampler (" << numDimensions << ")" << endl;
+        return false;
+    }
+
+    std::copy( inputVector.begin(), inputVector.end(), sample.begin() );
+    if( targetVector != NULL ){
+        std::copy( targetVector->begin(), targetVector->end(), sample.begin() + numDimensions );
+    }
+
+    return insert( getClassBuffer( classLabel ), &sample[0] );
+}
+
+bool ofxGrtCoresetSampler::insert( ClassBuffer &buffer, const Float *sample ){
+    switch( mode ){
+        case RESERVOIR_SAMPLING:
+            return addReservoir( buffer, sample );
+        case GRID_DEDUPLICATION:
+            return addGrid( buffer, sample );
+        case K_CENTER_SAMPLING:
+            return addKCenter( buffer, sample );
+    }
+
+    return false;
+}
+
+bool ofxGrtCoresetSampler::addReservoir( ClassBuffer &buffer, const Float *sample ){
+
+    buffer.numSeen++;
+
+    UINT slot = buffer.numSamples;
+    if( buffer.numSamples < maxSamplesPerClass ){
+        buffer.numSamples++;
+    }else{
+        //Replace a random kept sample with probability maxSamplesPerClass / numSeen, so the kept set stays a uniform sample
+        slot = std::uniform_int_distribution< UINT >( 0, buffer.numSeen-1 )( randomGenerator );
+        if( slot >= maxSamplesPerClass ) return false;
+    }
+
+    std::copy( sample, sample + stride, buffer.values.begin() + slot * stride );
+
+    return true;
+}
+
+bool ofxGrtCoresetSampler::addGrid( ClassBuffer &buffer, const Float *sample ){
+
+    const unsigned long long key = getCellKey( sample );
+    if( buffer.cells.count( key ) > 0 ) return false;
+
+    //This is a new cell, so run reservoir sampling over the distinct cells
+    buffer.numSeen++;
+
+    UINT slot = buffer.numSamples;
+    if( buffer.numSamples < maxSamplesPerClass ){
+        buffer.numSamples++;
+    }else{
+        slot = std::uniform_int_distribution< UINT >( 0, buffer.numSeen-1 )( randomGenerator );
+        if( slot >= maxSamplesPerClass ) return false;
+        buffer.cells.erase( buffer.cellKeys[ slot ] );
+    }
+
+    std::copy( sample, sample + stride, buffer.values.begin() + slot * stride );
+    buffer.cellKeys[ slot ] = key;
+    buffer.cells.insert( key );
+
+    return true;
+}
+
+bool ofxGrtCoresetSampler::addKCenter( ClassBuffer &buffer, const Float *sample ){
+
+    buffer.numSeen++;
+
+    //Reject the sample if it is already covered by a kept sample
+    const Float radiusSquared = buffer.radius * buffer.radius;
+    for(UINT i=0; i<buffer.numSamples; i++){
+        if( getSquaredDistance( sample, &buffer.values[ i * stride ] ) <= radiusSquared ) return false;
+    }
+
+    //The buffer has room for one extra sample, so the new sample can take part in the thinning
+    std::copy( sample, sample + stride, buffer.values.begin() + buffer.numSamples * stride );
+    buffer.numSamples++;
+
+    if( buffer.numSamples > maxSamplesPerClass ){
+        thin( buffer );
+    }
+
+    return true;
+}
+
+void ofxGrtCoresetSampler::thin( ClassBuffer &buffer ){
+
+    while( buffer.numSamples > maxSamplesPerClass ){
+
+        //Grow the radius to at least the closest pair, so every pass removes at least one sample
+        Float minDistance = grt_numeric_limits< Float >::max();
+        for(UINT i=0; i<buffer.numSamples; i++){
+            for(UINT j=i+1; j<buffer.numSamples; j++){
+                minDistance = std::min( minDistance, getSquaredDistance( &buffer.values[ i * stride ], &buffer.values[ j * stride ] ) );
+            }
+        }
+        buffer.radius = std::max( buffer.radius * 2, (Float)sqrt( minDistance ) );
+
+        //Greedily keep the samples that are further than the new radius from every sample kept so far
+        const Float radiusSquared = buffer.radius * buffer.radius;
+        UINT numKept = 0;
+        for(UINT i=0; i<buffer.numSamples; i++){
+            const Float *candidate = &buffer.values[ i * stride ];
+            bool covered = false;
+            for(UINT j=0; j<numKept && !covered; j++){
+                covered = getSquaredDistance( candidate, &buffer.values[ j * stride ] ) <= radiusSquared;
+            }
+            if( covered ) continue;
+            if( numKept != i ){
+                std::copy( candidate, candidate + stride, buffer.values.begin() + numKept * stride );
+            }
+            numKept++;
+        }
+        buffer.numSamples = numKept;
+    }
+}
+
+ofxGrtCoresetSampler::ClassBuffer &ofxGrtCoresetSampler::getClassBuffer( const UINT classLabel ){
+
+    for(size_t k=0; k<classes.size(); k++){
+        if( classes[k].classLabel == classLabel ) return classes[k];
+    }
+
+    ClassBuffer buffer;
+    buffer.classLabel = classLabel;
+    buffer.values.resize( (maxSamplesPerClass+1) * stride, 0 );
+    if( mode == GRID_DEDUPLICATION ) buffer.cellKeys.resize( maxSamplesPerClass, 0 );
+    resetClassBuffer( buffer );
+    classes.push_back( buffer );
+
+    return classes.back();
+}
+
+void ofxGrtCoresetSampler::resetClassBuffer( ClassBuffer &buffer ){
+    buffer.numSamples = 0;
+    buffer.numSeen = 0;
+    buffer.radius = 0;
+    buffer.cells.clear();
+}
+
+Float ofxGrtCoresetSampler::getSquaredDistance( const Float *a, const Float *b ) const {
+    Float sum = 0;
+    for(UINT j=0; j<numDimensions; j++){
+        const Float d = a[j] - b[j];
+        sum += d * d;
+    }
+    return sum;
+}
+
+unsigned long long ofxGrtCoresetSampler::getCellKey( const Float *sample ) const {
+
+    //FNV-1a hash of the integer cell coordinates
+    unsigned long long key = 14695981039346656037ULL;
+    for(UINT j=0; j<numDimensions; j++){
+        const long long cell = (long long)floor( sample[j] / cellSize );
+        key ^= (unsigned long long)cell;
+        key *= 1099511628211ULL;
+    }
+    return key;
+}
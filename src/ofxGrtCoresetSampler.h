@@ -0,0 +1,142 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <random>
+#include <unordered_set>
+
+#include "ofMain.h"
+
+using namespace GRT;
+
+/**
+ @brief reduces a stream of recorded training samples to a small, bounded set that still covers the input space. Recording every frame
+ while a key is held fills the training data with thousands of near identical samples, which makes training slow and instance based
+ classifiers (such as KNN) slower still. Samples are passed to addSample() while recording, and flush() merges them into the training data
+ when the recording stops: the samples a class already has are reduced together with the new ones, and replace them. Each class keeps at
+ most maxSamplesPerClass samples over all its recordings, using one of three strategies:
+
+ RESERVOIR_SAMPLING keeps a uniform random subset of the recorded samples.
+ GRID_DEDUPLICATION keeps one sample per grid cell of size cellSize, and a uniform random subset of the occupied cells once the class is full.
+ K_CENTER_SAMPLING keeps samples that are at least a coverage radius apart, doubling the radius and thinning the set whenever it overflows,
+ so every recorded sample stays within a small multiple of the radius of a kept sample. This gives the best coverage, but keeps outliers.
+
+ For regression data the samples are reduced using the input vector only, with the target vector stored alongside it, and the whole training set
+ is treated as one class. RESERVOIR_SAMPLING only sees the samples already kept when it merges, so it favours the latest recording over the
+ earlier ones.
+*/
+class ofxGrtCoresetSampler {
+public:
+    enum SamplingMode{ RESERVOIR_SAMPLING=0, GRID_DEDUPLICATION, K_CENTER_SAMPLING };
+
+    ofxGrtCoresetSampler();
+    ~ofxGrtCoresetSampler();
+
+    /**
+     @brief sets up the sampler, this also removes any samples
+     @param numDimensions: the number of input dimensions of each sample
+     @param maxSamplesPerClass: the maximum number of samples kept for each class
+     @param mode: the sampling mode, RESERVOIR_SAMPLING, GRID_DEDUPLICATION or K_CENTER_SAMPLING
+     @param cellSize: the size of each grid cell, only used by GRID_DEDUPLICATION
+     @param numTargetDimensions: the number of target dimensions for regression data, this should be zero for classification data
+     @return returns true if the sampler was setup successfully, false otherwise
+    */
+    bool setup( const UINT numDimensions, const UINT maxSamplesPerClass, const SamplingMode mode = K_CENTER_SAMPLING, const Float cellSize = 0.05, const UINT numTargetDimensions = 0 );
+
+    /**
+     @brief adds a classification sample to the sampler
+     @param classLabel: the class label of the sample
+     @param sample: the sample, the size must match the number of dimensions
+     @return returns true if the sample was kept, false if it was rejected or invalid
+    */
+    bool addSample( const UINT classLabel, const VectorFloat &sample );
+
+    /**
+     @brief adds a regression sample to the sampler
+     @param inputVector: the input vector, the size must match the number of dimensions
+     @param targetVector: the target vector, the size must match the number of target dimensions
+     @return returns true if the sample was kept, false if it was rejected or invalid
+    */
+    bool addSample( const VectorFloat &inputVector, const VectorFloat &targetVector );
+
+    /**
+     @brief reduces the kept samples together with the samples of the same classes in the training data, replaces those classes in the
+     training data with the result, and removes the samples from the sampler
+     @param trainingData: the training data the samples are merged into
+     @return returns true if the samples were added successfully, false otherwise
+    */
+    bool flush( ClassificationData &trainingData );
+    bool flush( RegressionData &trainingData );
+
+    /**
+     @brief removes all the samples but keeps the settings
+     @return returns true if the sampler was cleared successfully, false otherwise
+    */
+    bool clear();
+
+    UINT getNumDimensions() const { return numDimensions; }
+    UINT getMaxSamplesPerClass() const { return maxSamplesPerClass; }
+    SamplingMode getSamplingMode() const { return mode; }
+
+    /**
+     @brief gets the number of samples currently kept, over all the classes
+    */
+    UINT getNumSamples() const;
+
+    /**
+     @brief gets the number of samples passed to addSample since the last flush or clear
+    */
+    UINT getNumSamplesSeen() const;
+
+protected:
+    struct ClassBuffer{
+        UINT classLabel;
+        UINT numSamples;
+        UINT numSeen;               ///< The number of samples (or new grid cells for GRID_DEDUPLICATION) seen by the class
+        Float radius;               ///< The coverage radius for K_CENTER_SAMPLING
+        vector< Float > values;     ///< The kept samples, each stored as the input vector followed by the target vector
+        vector< unsigned long long > cellKeys;
+        std::unordered_set< unsigned long long > cells;
+    };
+
+    bool add( const UINT classLabel, const VectorFloat &inputVector, const VectorFloat *targetVector );
+    bool insert( ClassBuffer &buffer, const Float *sample );
+    bool addReservoir( ClassBuffer &buffer, const Float *sample );
+    bool addGrid( ClassBuffer &buffer, const Float *sample );
+    bool addKCenter( ClassBuffer &buffer, const Float *sample );
+    void thin( ClassBuffer &buffer );
+    ClassBuffer &getClassBuffer( const UINT classLabel );
+    void resetClassBuffer( ClassBuffer &buffer );
+    Float getSquaredDistance( const Float *a, const Float *b ) const;
+    unsigned long long getCellKey( const Float *sample ) const;
+
+    UINT numDimensions;
+    UINT numTargetDimensions;
+    UINT stride;
+    UINT maxSamplesPerClass;
+    SamplingMode mode;
+    Float cellSize;
+    vector< ClassBuffer > classes;
+    vector< Float > sample;
+    std::mt19937 randomGenerator;
+
+    ErrorLog errorLog;
+};
@@ -0,0 +1,281 @@
+
+#include "ofxGrtCrossValidation.h"
+#include <chrono>
+#include <random>
+
+using namespace GRT;
+
+double ofxGrtCrossValidation::Result::getAccuracyStdDev() const {
+    if( foldAccuracies.size() < 2 ) return 0;
+    double mean = 0, variance = 0;
+    for(size_t k=0; k<foldAccuracies.size(); k++) mean += foldAccuracies[k];
+    mean /= foldAccuracies.size();
+    for(size_t k=0; k<foldAccuracies.size(); k++) variance += (foldAccuracies[k] - mean) * (foldAccuracies[k] - mean);
+    return sqrt( variance / (foldAccuracies.size() - 1) );
+}
+
+double ofxGrtCrossValidation::Result::getMeanTrainingTime() const {
+    double sum = 0;
+    for(size_t k=0; k<trainingTimes.size(); k++) sum += trainingTimes[k];
+    return trainingTimes.size() > 0 ? sum / trainingTimes.size() : 0;
+}
+
+double ofxGrtCrossValidation::Result::getMeanPredictionTime() const {
+    double sum = 0;
+    for(size_t k=0; k<predictionTimes.size(); k++) sum += predictionTimes[k];
+    return predictionTimes.size() > 0 ? sum / predictionTimes.size() : 0;
+}
+
+ofxGrtCrossValidation::ofxGrtCrossValidation( const UINT numFolds, const uint64_t seed ){
+    this->numFolds = numFolds >= 2 ? numFolds : 2;
+    this->seed = seed;
+    errorLog.setProceedingText("[ERROR ofxGrtCrossValidation]");
+}
+
+ofxGrtCrossValidation::~ofxGrtCrossValidation(){
+}
+
+bool ofxGrtCrossValidation::setNumFolds( const UINT numFolds ){
+    if( numFolds < 2 ){
+        errorLog << "setNumFolds(const UINT numFolds) - The number of folds must be at least 2!" << endl;
+        return false;
+    }
+    this->numFolds = numFolds;
+    return true;
+}
+
+bool ofxGrtCrossValidation::setSeed( const uint64_t seed ){
+    this->seed = seed;
+    return true;
+}
+
+bool ofxGrtCrossValidation::run( const GestureRecognitionPipeline &pipeline, const ClassificationData &data, Result &result ){
+    return runFolds( pipeline, data, result );
+}
+
+bool ofxGrtCrossValidation::run( const GestureRecognitionPipeline &pipeline, const TimeSeriesClassificationData &data, Result &result ){
+    return runFolds( pipeline, data, result );
+}
+
+bool ofxGrtCrossValidation::split( const ClassificationData &data ){
+    return splitData( data );
+}
+
+bool ofxGrtCrossValidation::split( const TimeSeriesClassificationData &data ){
+    return splitData( data );
+}
+
+bool ofxGrtCrossValidation::runFold( const GestureRecognitionPipeline &pipeline, const ClassificationData &data, const UINT fold, FoldResult &result, GestureRecognitionPipeline *trainedPipeline ) const {
+    return runFoldData( pipeline, data, fold, result, trainedPipeline );
+}
+
+bool ofxGrtCrossValidation::runFold( const GestureRecognitionPipeline &pipeline, const TimeSeriesClassificationData &data, const UINT fold, FoldResult &result, GestureRecognitionPipeline *trainedPipeline ) const {
+    return runFoldData( pipeline, data, fold, result, trainedPipeline );
+}
+
+bool ofxGrtCrossValidation::timeFold( GestureRecognitionPipeline &pipeline, const ClassificationData &data, const UINT fold, double &predictionTime ) const {
+    return timeFoldData( pipeline, data, fold, predictionTime );
+}
+
+bool ofxGrtCrossValidation::timeFold( GestureRecognitionPipeline &pipeline, const TimeSeriesClassificationData &data, const UINT fold, double &predictionTime ) const {
+    return timeFoldData( pipeline, data, fold, predictionTime );
+}
+
+template< class Data >
+bool ofxGrtCrossValidation::runFolds( const GestureRecognitionPipeline &pipeline, const Data &data, Result &result ){
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if( !pipeline.getIsClassifierSet() ){
+        errorLog << "run(...) - The pipeline does not have a classifier!" << endl;
+        return false;
+    }
+
+    if( !splitData( data ) ){
+        return false;
+    }
+
+    //Train and test each fold on its own copy of the pipeline, the dataset is only read
+    vector< FoldResult > foldResults( numFolds );
+    ofxGrtThreadPool::getSharedPool().parallelFor( 0, numFolds, 1, [&]( const size_t k, const unsigned int threadIndex ){
+        runFoldData( pipeline, data, (UINT)k, foldResults[k], NULL );
+    } );
+
+    if( !buildResult( foldResults, result ) ){
+        return false;
+    }
+
+    result.totalTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+
+    return true;
+}
+
+template< class Data >
+bool ofxGrtCrossValidation::splitData( const Data &data ){
+
+    const UINT numSamples = data.getNumSamples();
+    if( numSamples < numFolds ){
+        errorLog << "split(...) - There are fewer samples (" << numSamples << ") than folds (" << numFolds << ")!" << endl;
+        labels.clear();
+        foldIndices.clear();
+        return false;
+    }
+
+    labels.resize( numSamples );
+    for(UINT i=0; i<numSamples; i++) labels[i] = data[i].getClassLabel();
+    classLabels = labels;
+    std::sort( classLabels.begin(), classLabels.end() );
+    classLabels.erase( std::unique( classLabels.begin(), classLabels.end() ), classLabels.end() );
+
+    //Group the samples by class and shuffle each class
+    vector< vector< UINT > > classIndices( classLabels.size() );
+    for(UINT i=0; i<numSamples; i++){
+        const size_t k = std::lower_bound( classLabels.begin(), classLabels.end(), labels[i] ) - classLabels.begin();
+        classIndices[k].push_back( i );
+    }
+
+    std::mt19937 randomGenerator( (std::mt19937::result_type)seed );
+    for(size_t k=0; k<classIndices.size(); k++){
+        std::shuffle( classIndices[k].begin(), classIndices[k].end(), randomGenerator );
+    }
+
+    //Deal the samples of each class across the folds, carrying on from where the previous class stopped so the folds have the same size
+    foldIndices.assign( numFolds, vector< UINT >() );
+    sampleFolds.assign( numSamples, 0 );
+    UINT nextFold = 0;
+    for(size_t k=0; k<classIndices.size(); k++){
+        for(size_t i=0; i<classIndices[k].size(); i++){
+            const UINT index = classIndices[k][i];
+            sampleFolds[ index ] = nextFold;
+            foldIndices[ nextFold ].push_back( index );
+            nextFold = (nextFold + 1) % numFolds;
+        }
+    }
+
+    for(UINT k=0; k<numFolds; k++){
+        std::sort( foldIndices[k].begin(), foldIndices[k].end() );
+    }
+
+    return true;
+}
+
+template< class Data >
+bool ofxGrtCrossValidation::runFoldData( const GestureRecognitionPipeline &pipeline, const Data &data, const UINT fold, FoldResult &result, GestureRecognitionPipeline *trainedPipeline ) const {
+
+    result.numCorrect = 0;
+    result.trained = false;
+    result.trainingTime = 0;
+    result.predictionTime = 0;
+    result.predictedClassLabels.clear();
+
+    if( fold >= foldIndices.size() || data.getNumSamples() != labels.size() ){
+        errorLog << "runFold(...) - The fold index is invalid or the dataset does not match the last call to split!" << endl;
+        return false;
+    }
+
+    const vector< UINT > &testIndices = foldIndices[ fold ];
+    GestureRecognitionPipeline foldPipeline( pipeline );
+
+    //The training set only lives while the fold is trained
+    auto trainingStart = std::chrono::high_resolution_clock::now();
+    {
+        Data trainingData;
+        trainingData.setNumDimensions( data.getNumDimensions() );
+        for(UINT i=0; i<labels.size(); i++){
+            if( sampleFolds[i] != fold ) addSample( trainingData, data[i] );
+        }
+        trainingStart = std::chrono::high_resolution_clock::now();
+        result.trained = foldPipeline.train( trainingData );
+    }
+    auto trainingEnd = std::chrono::high_resolution_clock::now();
+    result.trainingTime = std::chrono::duration< double, std::milli >( trainingEnd - trainingStart ).count();
+
+    result.predictedClassLabels.assign( testIndices.size(), 0 );
+    if( !result.trained ) return true;
+
+    for(size_t i=0; i<testIndices.size(); i++){
+        if( predict( foldPipeline, data[ testIndices[i] ] ) ){
+            result.predictedClassLabels[i] = foldPipeline.getPredictedClassLabel();
+        }
+        if( result.predictedClassLabels[i] == labels[ testIndices[i] ] ) result.numCorrect++;
+    }
+    if( testIndices.size() > 0 ){
+        result.predictionTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - trainingEnd ).count() / testIndices.size();
+    }
+
+    if( trainedPipeline ) *trainedPipeline = foldPipeline;
+
+    return true;
+}
+
+template< class Data >
+bool ofxGrtCrossValidation::timeFoldData( GestureRecognitionPipeline &pipeline, const Data &data, const UINT fold, double &predictionTime ) const {
+
+    predictionTime = 0;
+
+    if( fold >= foldIndices.size() || data.getNumSamples() != labels.size() || !pipeline.getTrained() ){
+        errorLog << "timeFold(...) - The fold index is invalid, the dataset does not match the last call to split, or the pipeline is not trained!" << endl;
+        return false;
+    }
+
+    const vector< UINT > &testIndices = foldIndices[ fold ];
+    if( testIndices.size() == 0 ) return true;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for(size_t i=0; i<testIndices.size(); i++){
+        predict( pipeline, data[ testIndices[i] ] );
+    }
+    predictionTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count() / testIndices.size();
+
+    return true;
+}
+
+bool ofxGrtCrossValidation::buildResult( const vector< FoldResult > &foldResults, Result &result ) const {
+
+    const UINT numClasses = (UINT)classLabels.size();
+
+    result.numFolds = numFolds;
+    result.numSamples = 0;
+    result.numCorrect = 0;
+    result.numFailedFolds = 0;
+    result.classResults.resize( numClasses );
+    for(UINT k=0; k<numClasses; k++){
+        result.classResults[k].classLabel = classLabels[k];
+        result.classResults[k].numSamples = 0;
+        result.classResults[k].numCorrect = 0;
+        result.classResults[k].numPredicted = 0;
+    }
+    result.confusionMatrix.assign( numClasses, vector< UINT >( numClasses + 1, 0 ) );
+    result.foldAccuracies.assign( numFolds, 0 );
+    result.trainingTimes.assign( numFolds, 0 );
+    result.predictionTimes.assign( numFolds, 0 );
+
+    for(UINT f=0; f<numFolds; f++){
+        const vector< UINT > &testIndices = foldIndices[f];
+        const FoldResult &fold = foldResults[f];
+        if( !fold.trained ) result.numFailedFolds++;
+
+        for(size_t i=0; i<testIndices.size(); i++){
+            const UINT actual = (UINT)(std::lower_bound( classLabels.begin(), classLabels.end(), labels[ testIndices[i] ] ) - classLabels.begin());
+            UINT predicted = (UINT)(std::lower_bound( classLabels.begin(), classLabels.end(), fold.predictedClassLabels[i] ) - classLabels.begin());
+            if( predicted == numClasses || classLabels[ predicted ] != fold.predictedClassLabels[i] ) predicted = numClasses;
+
+            result.confusionMatrix[ actual ][ predicted ]++;
+            result.classResults[ actual ].numSamples++;
+            if( predicted < numClasses ) result.classResults[ predicted ].numPredicted++;
+            if( predicted == actual ) result.classResults[ actual ].numCorrect++;
+        }
+
+        result.numSamples += (UINT)testIndices.size();
+        result.numCorrect += fold.numCorrect;
+        result.foldAccuracies[f] = testIndices.size() > 0 ? (double)fold.numCorrect / testIndices.size() : 0;
+        result.trainingTimes[f] = fold.trainingTime;
+        result.predictionTimes[f] = fold.predictionTime;
+    }
+
+    if( result.numFailedFolds > 0 ){
+        errorLog << "run(...) - The pipeline failed to train on " << result.numFailedFolds << " of the " << numFolds << " folds!" << endl;
+    }
+
+    return true;
+}
@@ -0,0 +1,171 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <stdint.h>
+
+#include "ofMain.h"
+#include "ofxGrtThreadPool.h"
+
+using namespace GRT;
+
+/**
+ @brief runs k-fold cross validation of a classification pipeline, training and testing the folds concurrently. The samples of each class
+ are shuffled (with random numbers seeded from setSeed) and dealt across the folds, so every fold has about the same class balance. Each
+ fold is a task on the shared ofxGrtThreadPool: it copies the pipeline (a GestureRecognitionPipeline copy is a deep copy of its modules),
+ trains the copy on the other folds and predicts the samples of its own fold.
+
+ The folds only keep the indices of their samples, and test samples are read straight from the caller's dataset, which is shared read-only
+ by every fold. The training set of a fold is built from these indices when its task starts, as pipeline.train needs a dataset, and freed
+ when the task ends. Classifiers that use the shared pool themselves (such as ofxGrtRandomForests or ofxGrtDTW) only call parallelFor, which
+ runs its range in order on the calling thread when called from inside a pool task. They therefore train on the thread running their fold
+ without waiting on other tasks, so nested training can not deadlock and the folds are the unit of parallelism.
+
+ The pipeline, and any GRT modules it uses, must be safe to train and run on several threads at once as long as each thread has its own copy.
+*/
+class ofxGrtCrossValidation {
+public:
+    struct ClassResult{
+        UINT classLabel;
+        UINT numSamples;        ///< The number of test samples of this class
+        UINT numCorrect;        ///< The number of test samples of this class that were predicted correctly
+        UINT numPredicted;      ///< The number of test samples (of any class) that were predicted as this class
+
+        double getPrecision() const { return numPredicted > 0 ? (double)numCorrect / numPredicted : 0; }
+        double getRecall() const { return numSamples > 0 ? (double)numCorrect / numSamples : 0; }
+        double getFMeasure() const { const double p = getPrecision(), r = getRecall(); return p + r > 0 ? 2 * p * r / (p + r) : 0; }
+    };
+
+    struct Result{
+        UINT numFolds;
+        UINT numSamples;
+        UINT numCorrect;
+        UINT numFailedFolds;                ///< The number of folds whose pipeline failed to train, their samples are counted as wrong
+        vector< ClassResult > classResults;
+        vector< vector< UINT > > confusionMatrix;   ///< [numClasses x numClasses+1], row i counts the samples of class i by predicted class, the last column counts other labels (such as the null label)
+        vector< double > foldAccuracies;
+        vector< double > trainingTimes;     ///< The training time of each fold in milliseconds
+        vector< double > predictionTimes;   ///< The mean prediction time of each fold in milliseconds per sample
+        double totalTime;                   ///< The wall clock time of the whole cross validation in milliseconds
+
+        double getAccuracy() const { return numSamples > 0 ? (double)numCorrect / numSamples : 0; }
+        double getAccuracyStdDev() const;
+        double getMeanTrainingTime() const;
+        double getMeanPredictionTime() const;
+    };
+
+    struct FoldResult{
+        vector< UINT > predictedClassLabels;    ///< The predicted label of each test sample of the fold, 0 if the pipeline failed to train
+        UINT numCorrect;
+        bool trained;
+        double trainingTime;                    ///< The training time in milliseconds
+        double predictionTime;                  ///< The mean prediction time in milliseconds per sample
+    };
+
+    /**
+     @brief creates the cross validation runner
+     @param numFolds: the number of folds, at least 2
+     @param seed: the seed used to shuffle the samples into folds
+    */
+    ofxGrtCrossValidation( const UINT numFolds = 10, const uint64_t seed = 0 );
+    ~ofxGrtCrossValidation();
+
+    bool setNumFolds( const UINT numFolds );
+    bool setSeed( const uint64_t seed );
+
+    UINT getNumFolds() const { return numFolds; }
+    uint64_t getSeed() const { return seed; }
+
+    /**
+     @brief cross validates a pipeline on a dataset, the pipeline itself is not trained or changed
+     @param pipeline: the pipeline to copy for each fold, it must have a classifier
+     @param data: the dataset, it must have at least numFolds samples
+     @param result: the results of the cross validation
+     @return returns true if the cross validation was run successfully, false otherwise
+    */
+    bool run( const GestureRecognitionPipeline &pipeline, const ClassificationData &data, Result &result );
+
+    /**
+     @brief cross validates a pipeline on a time series dataset, each test sample is predicted as a whole matrix (as with a DTW classifier)
+    */
+    bool run( const GestureRecognitionPipeline &pipeline, const TimeSeriesClassificationData &data, Result &result );
+
+    /**
+     @brief splits a dataset into folds without running them, so the folds can be run one at a time with runFold (run() calls this itself)
+     @param data: the dataset, it must have at least numFolds samples
+     @return returns true if the dataset was split successfully, false otherwise
+    */
+    bool split( const ClassificationData &data );
+    bool split( const TimeSeriesClassificationData &data );
+
+    /**
+     @brief trains a copy of the pipeline on every fold but one and predicts the samples of that fold. This is const and can be called for
+     different folds (or pipelines) on several threads at once.
+     @param pipeline: the pipeline to copy
+     @param data: the dataset that was passed to split
+     @param fold: the index of the test fold
+     @param result: the predictions and timings of the fold
+     @param trainedPipeline: if not NULL, the trained copy of the pipeline is copied into this (for example to time it again with timeFold)
+     @return returns true if the fold was run, false if the arguments were invalid (a pipeline that fails to train still returns true, with result.trained false)
+    */
+    bool runFold( const GestureRecognitionPipeline &pipeline, const ClassificationData &data, const UINT fold, FoldResult &result, GestureRecognitionPipeline *trainedPipeline = NULL ) const;
+    bool runFold( const GestureRecognitionPipeline &pipeline, const TimeSeriesClassificationData &data, const UINT fold, FoldResult &result, GestureRecognitionPipeline *trainedPipeline = NULL ) const;
+
+    /**
+     @brief predicts the samples of a fold with a pipeline that is already trained, and measures the mean prediction time
+     @param pipeline: the trained pipeline, such as the trained pipeline of runFold
+     @param data: the dataset that was passed to split
+     @param fold: the index of the test fold
+     @param predictionTime: set to the mean prediction time in milliseconds per sample
+     @return returns true if the fold was timed, false if the arguments were invalid or the pipeline is not trained
+    */
+    bool timeFold( GestureRecognitionPipeline &pipeline, const ClassificationData &data, const UINT fold, double &predictionTime ) const;
+    bool timeFold( GestureRecognitionPipeline &pipeline, const TimeSeriesClassificationData &data, const UINT fold, double &predictionTime ) const;
+
+    UINT getNumSamples() const { return (UINT)labels.size(); }
+    UINT getNumFoldSamples( const UINT fold ) const { return fold < foldIndices.size() ? (UINT)foldIndices[ fold ].size() : 0; }
+
+protected:
+    template< class Data >
+    bool runFolds( const GestureRecognitionPipeline &pipeline, const Data &data, Result &result );
+    template< class Data >
+    bool splitData( const Data &data );
+    template< class Data >
+    bool runFoldData( const GestureRecognitionPipeline &pipeline, const Data &data, const UINT fold, FoldResult &result, GestureRecognitionPipeline *trainedPipeline ) const;
+    template< class Data >
+    bool timeFoldData( GestureRecognitionPipeline &pipeline, const Data &data, const UINT fold, double &predictionTime ) const;
+    bool buildResult( const vector< FoldResult > &foldResults, Result &result ) const;
+
+    //Copy a sample into a training set and predict a sample, for either type of dataset
+    static bool addSample( ClassificationData &data, const ClassificationSample &sample ){ return data.addSample( sample.getClassLabel(), sample.getSample() ); }
+    static bool addSample( TimeSeriesClassificationData &data, const TimeSeriesClassificationSample &sample ){ return data.addSample( sample.getClassLabel(), sample.getData() ); }
+    static bool predict( GestureRecognitionPipeline &pipeline, const ClassificationSample &sample ){ return pipeline.predict( sample.getSample() ); }
+    static bool predict( GestureRecognitionPipeline &pipeline, const TimeSeriesClassificationSample &sample ){ return pipeline.predict( sample.getData() ); }
+
+    UINT numFolds;
+    uint64_t seed;
+    vector< UINT > labels;                  ///< The class label of each sample of the split dataset
+    vector< UINT > classLabels;             ///< The sorted class labels of the split dataset
+    vector< vector< UINT > > foldIndices;   ///< The sorted indices of the samples in each fold
+    vector< UINT > sampleFolds;             ///< The fold of each sample
+
+    mutable ErrorLog errorLog;
+};
@@ -0,0 +1,896 @@
+
+#include "ofxGrtDTW.h"
+#include <chrono>
+#include <cstring>
+
+using namespace GRT;
+
+//Register the classifier with the classifier base class, so pipelines can create and copy it
+RegisterClassifierModule< ofxGrtDTW > ofxGrtDTW::registerModule("ofxGrtDTW");
+
+ofxGrtDTW::ofxGrtDTW( const bool useScaling, const bool useNullRejection, const Float nullRejectionCoeff, const bool constrainWarpingPath, const Float warpingRadius, const bool offsetUsingFirstSample ){
+    this->useScaling = useScaling;
+    this->useNullRejection = useNullRejection;
+    this->nullRejectionCoeff = nullRejectionCoeff;
+    this->constrainWarpingPath = constrainWarpingPath;
+    this->warpingRadius = warpingRadius;
+    this->offsetUsingFirstSample = offsetUsingFirstSample;
+    distanceMode = ofxGrtDTWDistance::EXACT_DTW;
+    fastRadius = 10;
+    numTemplatesPerClass = 1;
+    useTemplateAveraging = false;
+    maxNumAveragingIterations = 10;
+    averagingTolerance = 0.001;
+    trainingTime = 0;
+    bufferLength = 0;
+    bufferHead = 0;
+    bufferCount = 0;
+    supportsNullRejection = true;
+    classType = "ofxGrtDTW";
+    classifierType = classType;
+    classifierMode = TIMESERIES_CLASSIFIER_MODE;
+    debugLog.setProceedingText("[DEBUG ofxGrtDTW]");
+    errorLog.setProceedingText("[ERROR ofxGrtDTW]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtDTW]");
+    warningLog.setProceedingText("[WARNING ofxGrtDTW]");
+}
+
+ofxGrtDTW::ofxGrtDTW( const ofxGrtDTW &rhs ){
+    classType = "ofxGrtDTW";
+    classifierType = classType;
+    classifierMode = TIMESERIES_CLASSIFIER_MODE;
+    debugLog.setProceedingText("[DEBUG ofxGrtDTW]");
+    errorLog.setProceedingText("[ERROR ofxGrtDTW]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtDTW]");
+    warningLog.setProceedingText("[WARNING ofxGrtDTW]");
+    *this = rhs;
+}
+
+ofxGrtDTW::~ofxGrtDTW(){
+}
+
+ofxGrtDTW &ofxGrtDTW::operator=( const ofxGrtDTW &rhs ){
+    if( this != &rhs ){
+        this->constrainWarpingPath = rhs.constrainWarpingPath;
+        this->warpingRadius = rhs.warpingRadius;
+        this->offsetUsingFirstSample = rhs.offsetUsingFirstSample;
+        this->distanceMode = rhs.distanceMode;
+        this->fastRadius = rhs.fastRadius;
+        this->numTemplatesPerClass = rhs.numTemplatesPerClass;
+        this->useTemplateAveraging = rhs.useTemplateAveraging;
+        this->maxNumAveragingIterations = rhs.maxNumAveragingIterations;
+        this->averagingTolerance = rhs.averagingTolerance;
+        this->trainingTime = rhs.trainingTime;
+        this->templates = rhs.templates;
+        this->snapshot = rhs.snapshot;
+        this->bufferLength = rhs.bufferLength;
+        this->trainer = rhs.trainer;
+        this->averager = rhs.averager;
+        this->distance = rhs.distance;
+        this->inputBuffer = rhs.inputBuffer;
+        this->bufferHead = rhs.bufferHead;
+        this->bufferCount = rhs.bufferCount;
+        this->series = rhs.series;
+
+        //Copy the base classifier variables
+        copyBaseVariables( (Classifier*)&rhs );
+    }
+    return *this;
+}
+
+bool ofxGrtDTW::deepCopyFrom( const Classifier *classifier ){
+
+    if( classifier == NULL ) return false;
+
+    const ofxGrtDTW *ptr = dynamic_cast< const ofxGrtDTW* >( classifier );
+    if( ptr == NULL ) return false;
+
+    *this = *ptr;
+
+    return true;
+}
+
+bool ofxGrtDTW::train_( TimeSeriesClassificationData &trainingData ){
+
+    //Clear any previous model, the cached distances are kept
+    clear();
+
+    const UINT M = trainingData.getNumSamples();
+    const UINT N = trainingData.getNumDimensions();
+    const UINT K = trainingData.getNumClasses();
+
+    if( M == 0 ){
+        errorLog << "train_(TimeSeriesClassificationData &trainingData) - Training data has zero samples!" << endl;
+        return false;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    numInputDimensions = N;
+    numClasses = K;
+    ranges = trainingData.getRanges();
+
+    const Vector< ClassTracker > classTracker = trainingData.getClassTracker();
+    vector< UINT > labels( K );
+    classLabels.resize( K );
+    for(UINT k=0; k<K; k++){
+        labels[k] = classLabels[k] = classTracker[k].classLabel;
+    }
+
+    //Scale and offset every sample once, grouped by class
+    vector< vector< vector< float > > > classSamples( K );
+    for(UINT i=0; i<M; i++){
+        const UINT classLabel = trainingData[i].getClassLabel();
+        UINT classIndex = 0;
+        while( classIndex < K && classLabels[ classIndex ] != classLabel ) classIndex++;
+        if( classIndex == K ) continue;
+        classSamples[ classIndex ].push_back( vector< float >() );
+        preprocess( trainingData[i].getData(), classSamples[ classIndex ].back() );
+    }
+
+    if( !trainer.setup( N, constrainWarpingPath, warpingRadius, distanceMode, fastRadius ) || !trainer.train( labels, classSamples, numTemplatesPerClass ) ){
+        errorLog << "train_(TimeSeriesClassificationData &trainingData) - Failed to find the class templates!" << endl;
+        clear();
+        return false;
+    }
+
+    //The buffer used for continuous prediction is as long as the mean training sample, averaged over the classes as the GRT DTW does
+    if( useTemplateAveraging ){
+        averager.setup( N, constrainWarpingPath, warpingRadius );
+        averager.setMaxNumIterations( maxNumAveragingIterations );
+        averager.setTolerance( averagingTolerance );
+    }
+
+    Float meanLength = 0;
+    vector< UINT > members;
+    vector< float > memberDistances;
+    for(UINT k=0; k<K; k++){
+        for(UINT m=0; m<trainer.getNumTemplates( k ); m++){
+            Template t;
+            t.classLabel = classLabels[k];
+            t.classIndex = k;
+            t.data = classSamples[k][ trainer.getTemplateIndex( k, m ) ];
+            t.mappedData = NULL;
+            t.length = (UINT)(t.data.size() / N);
+            t.trainingMu = trainer.getTrainingMu( k, m );
+            t.trainingSigma = trainer.getTrainingSigma( k, m );
+            t.threshold = 0;
+
+            members.clear();
+            for(UINT i=0; i<classSamples[k].size(); i++){
+                if( trainer.getCluster( k, i ) == m ) members.push_back( i );
+            }
+
+            //Average clusters of two or more samples from their medoid, the statistics then come from the distances to every member
+            if( useTemplateAveraging && members.size() > 1 && averager.average( classSamples[k], members, t.data, memberDistances ) ){
+                t.trainingMu = 0;
+                t.trainingSigma = 0;
+                for(size_t i=0; i<members.size(); i++) t.trainingMu += memberDistances[i];
+                t.trainingMu /= members.size();
+                for(size_t i=0; i<members.size(); i++) t.trainingSigma += (memberDistances[i] - t.trainingMu) * (memberDistances[i] - t.trainingMu);
+                t.trainingSigma = sqrt( t.trainingSigma / (members.size()-1) );
+            }
+
+            templates.push_back( t );
+        }
+
+        Float classLength = 0;
+        for(size_t i=0; i<classSamples[k].size(); i++) classLength += classSamples[k][i].size() / N;
+        meanLength += classLength / classSamples[k].size();
+    }
+    bufferLength = (UINT)std::max( 1.0, floor( meanLength / K + 0.5 ) );
+
+    distance.setup( N, constrainWarpingPath, warpingRadius );
+    distance.setMode( distanceMode, fastRadius );
+    inputBuffer.assign( (size_t)bufferLength * N, 0 );
+    bufferHead = 0;
+    bufferCount = 0;
+    classLikelihoods.resize( K, 0 );
+    classDistances.resize( K, 0 );
+    trained = true;
+    recomputeNullRejectionThresholds();
+
+    trainingTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+    trainingLog << "Trained " << templates.size() << " templates for " << K << " classes in " << trainingTime << "ms, computed " << trainer.getNumComputedDistances() << " distances (" << trainer.getNumAbandonedDistances() << " abandoned), reused " << trainer.getNumCachedDistances() << endl;
+
+    return true;
+}
+
+bool ofxGrtDTW::predict_( VectorFloat &inputVector ){
+
+    predictedClassLabel = 0;
+    maxLikelihood = 0;
+
+    if( !trained ){
+        errorLog << "predict_(VectorFloat &inputVector) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    if( inputVector.size() != numInputDimensions ){
+        errorLog << "predict_(VectorFloat &inputVector) - The size of the input vector (" << inputVector.size() << ") does not match the num features in the model (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    //Add the sample to the ring buffer, overwriting the oldest sample once it is full
+    const UINT N = numInputDimensions;
+    const UINT tail = (bufferHead + bufferCount) % bufferLength;
+    for(UINT j=0; j<N; j++) inputBuffer[ (size_t)tail*N + j ] = (float)inputVector[j];
+    if( bufferCount < bufferLength ) bufferCount++;
+    else bufferHead = (bufferHead + 1) % bufferLength;
+
+    if( bufferCount < bufferLength ){
+        std::fill( classLikelihoods.begin(), classLikelihoods.end(), 0 );
+        std::fill( classDistances.begin(), classDistances.end(), 0 );
+        return true;
+    }
+
+    series.resize( (size_t)bufferLength * N );
+    for(UINT i=0; i<bufferLength; i++){
+        const UINT index = (bufferHead + i) % bufferLength;
+        std::copy( inputBuffer.begin() + (size_t)index*N, inputBuffer.begin() + (size_t)(index+1)*N, series.begin() + (size_t)i*N );
+    }
+    preprocess( series, bufferLength );
+
+    return predictSeries( &series[0], bufferLength );
+}
+
+bool ofxGrtDTW::predict_( MatrixFloat &inputMatrix ){
+
+    predictedClassLabel = 0;
+    maxLikelihood = 0;
+
+    if( !trained ){
+        errorLog << "predict_(MatrixFloat &inputMatrix) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    if( inputMatrix.getNumCols() != numInputDimensions ){
+        errorLog << "predict_(MatrixFloat &inputMatrix) - The number of columns in the input matrix (" << inputMatrix.getNumCols() << ") does not match the num features in the model (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    if( inputMatrix.getNumRows() == 0 ){
+        errorLog << "predict_(MatrixFloat &inputMatrix) - The input matrix is empty!" << endl;
+        return false;
+    }
+
+    preprocess( inputMatrix, series );
+
+    return predictSeries( &series[0], inputMatrix.getNumRows() );
+}
+
+bool ofxGrtDTW::predictSeries( const float *series, const UINT length ){
+
+    //The distance to a class is the distance to its nearest template
+    std::fill( classDistances.begin(), classDistances.end(), grt_numeric_limits< Float >::max() );
+    UINT bestTemplate = 0;
+    Float nearestDistance = grt_numeric_limits< Float >::max();
+    for(UINT i=0; i<templates.size(); i++){
+        const Template &t = templates[i];
+        const Float d = distance.compute( t.getData(), t.length, series, length );
+        if( d < classDistances[ t.classIndex ] ) classDistances[ t.classIndex ] = d;
+        if( d < nearestDistance ){
+            nearestDistance = d;
+            bestTemplate = i;
+        }
+    }
+
+    //The likelihoods are the normalized inverse distances, a template at zero distance takes all the likelihood
+    const UINT bestIndex = templates[ bestTemplate ].classIndex;
+    Float sum = 0;
+    bool exactMatch = false;
+    for(UINT k=0; k<numClasses; k++){
+        if( classDistances[k] <= 0 ) exactMatch = true;
+        classLikelihoods[k] = classDistances[k] > 0 ? 1.0 / classDistances[k] : 0;
+        sum += classLikelihoods[k];
+    }
+
+    for(UINT k=0; k<numClasses; k++){
+        if( exactMatch ) classLikelihoods[k] = k == bestIndex ? 1 : 0;
+        else classLikelihoods[k] = sum > 0 ? classLikelihoods[k] / sum : 0;
+    }
+
+    maxLikelihood = classLikelihoods[ bestIndex ];
+    bestDistance = classDistances[ bestIndex ];
+    predictedClassLabel = classLabels[ bestIndex ];
+
+    if( useNullRejection && bestDistance > templates[ bestTemplate ].threshold ){
+        predictedClassLabel = GRT_DEFAULT_NULL_CLASS_LABEL;
+    }
+
+    return true;
+}
+
+bool ofxGrtDTW::reset(){
+
+    //Empty the continuous prediction buffer
+    bufferHead = 0;
+    bufferCount = 0;
+
+    return Classifier::reset();
+}
+
+bool ofxGrtDTW::clear(){
+
+    //Clear the base class
+    Classifier::clear();
+
+    templates.clear();
+    snapshot.reset();
+    bufferLength = 0;
+    inputBuffer.clear();
+    bufferHead = 0;
+    bufferCount = 0;
+    series.clear();
+
+    return true;
+}
+
+bool ofxGrtDTW::clearTrainingCache(){
+    return trainer.clear();
+}
+
+bool ofxGrtDTW::recomputeNullRejectionThresholds(){
+
+    if( !trained ) return false;
+
+    //Each class reports the largest threshold of its templates
+    nullRejectionThresholds.assign( numClasses, 0 );
+    for(size_t i=0; i<templates.size(); i++){
+        Template &t = templates[i];
+        t.threshold = t.trainingMu + t.trainingSigma * nullRejectionCoeff;
+        nullRejectionThresholds[ t.classIndex ] = std::max( nullRejectionThresholds[ t.classIndex ], t.threshold );
+    }
+
+    return true;
+}
+
+bool ofxGrtDTW::save( std::fstream &file ) const {
+
+    if( !file.is_open() ){
+        errorLog << "save(fstream &file) - Could not open file to save model!" << endl;
+        return false;
+    }
+
+    file << "GRT_OFXGRTDTW_MODEL_FILE_V1.2\n";
+
+    if( !Classifier::saveBaseSettingsToFile( file ) ){
+        errorLog << "save(fstream &file) - Failed to save classifier base settings to file!" << endl;
+        return false;
+    }
+
+    file << "ConstrainWarpingPath: " << constrainWarpingPath << endl;
+    file << "WarpingRadius: " << warpingRadius << endl;
+    file << "OffsetUsingFirstSample: " << offsetUsingFirstSample << endl;
+    file << "DistanceMode: " << distanceMode << endl;
+    file << "FastRadius: " << fastRadius << endl;
+    file << "NumTemplatesPerClass: " << numTemplatesPerClass << endl;
+    file << "UseTemplateAveraging: " << useTemplateAveraging << endl;
+    file << "MaxNumAveragingIterations: " << maxNumAveragingIterations << endl;
+    file << "AveragingTolerance: " << averagingTolerance << endl;
+
+    if( trained ){
+        //Write the templates with enough digits to read back the exact float values
+        const std::streamsize precision = file.precision( 9 );
+
+        file << "BufferLength: " << bufferLength << endl;
+        file << "NumTemplates: " << templates.size() << endl;
+        file << "Templates:\n";
+        for(size_t k=0; k<templates.size(); k++){
+            const Template &t = templates[k];
+            file << "ClassLabel: " << t.classLabel << endl;
+            file << "TrainingMu: " << t.trainingMu << endl;
+            file << "TrainingSigma: " << t.trainingSigma << endl;
+            file << "Length: " << t.length << endl;
+            const float *data = t.getData();
+            for(UINT i=0; i<t.length; i++){
+                for(UINT j=0; j<numInputDimensions; j++) file << data[ (size_t)i*numInputDimensions + j ] << " ";
+                file << endl;
+            }
+        }
+
+        file.precision( precision );
+    }
+
+    return true;
+}
+
+bool ofxGrtDTW::load( std::fstream &file ){
+
+    clear();
+
+    if( !file.is_open() ){
+        errorLog << "load(fstream &file) - Could not open file to load model!" << endl;
+        return false;
+    }
+
+    std::string word;
+    file >> word;
+    //Version 1.0 files were always saved with the exact distance, and before version 1.2 there was one template per class
+    const bool hasTemplateSettings = word == "GRT_OFXGRTDTW_MODEL_FILE_V1.2";
+    const bool hasDistanceMode = word == "GRT_OFXGRTDTW_MODEL_FILE_V1.1" || hasTemplateSettings;
+    if( word != "GRT_OFXGRTDTW_MODEL_FILE_V1.0" && !hasDistanceMode ){
+        errorLog << "load(fstream &file) - Could not find Model File Header!" << endl;
+        return false;
+    }
+
+    if( !Classifier::loadBaseSettingsFromFile( file ) ){
+        errorLog << "load(fstream &file) - Failed to load base settings from file!" << endl;
+        return false;
+    }
+
+    file >> word;
+    if( word != "ConstrainWarpingPath:" ){ errorLog << "load(fstream &file) - Could not find ConstrainWarpingPath!" << endl; return false; }
+    file >> constrainWarpingPath;
+    file >> word;
+    if( word != "WarpingRadius:" ){ errorLog << "load(fstream &file) - Could not find WarpingRadius!" << endl; return false; }
+    file >> warpingRadius;
+    file >> word;
+    if( word != "OffsetUsingFirstSample:" ){ errorLog << "load(fstream &file) - Could not find OffsetUsingFirstSample!" << endl; return false; }
+    file >> offsetUsingFirstSample;
+
+    distanceMode = ofxGrtDTWDistance::EXACT_DTW;
+    if( hasDistanceMode ){
+        UINT mode = 0;
+        file >> word;
+        if( word != "DistanceMode:" ){ errorLog << "load(fstream &file) - Could not find DistanceMode!" << endl; return false; }
+        file >> mode;
+        distanceMode = mode == ofxGrtDTWDistance::FAST_DTW ? ofxGrtDTWDistance::FAST_DTW : ofxGrtDTWDistance::EXACT_DTW;
+        file >> word;
+        if( word != "FastRadius:" ){ errorLog << "load(fstream &file) - Could not find FastRadius!" << endl; return false; }
+        file >> fastRadius;
+    }
+
+    numTemplatesPerClass = 1;
+    useTemplateAveraging = false;
+    if( hasTemplateSettings ){
+        file >> word;
+        if( word != "NumTemplatesPerClass:" ){ errorLog << "load(fstream &file) - Could not find NumTemplatesPerClass!" << endl; return false; }
+        file >> numTemplatesPerClass;
+        file >> word;
+        if( word != "UseTemplateAveraging:" ){ errorLog << "load(fstream &file) - Could not find UseTemplateAveraging!" << endl; return false; }
+        file >> useTemplateAveraging;
+        file >> word;
+        if( word != "MaxNumAveragingIterations:" ){ errorLog << "load(fstream &file) - Could not find MaxNumAveragingIterations!" << endl; return false; }
+        file >> maxNumAveragingIterations;
+        file >> word;
+        if( word != "AveragingTolerance:" ){ errorLog << "load(fstream &file) - Could not find AveragingTolerance!" << endl; return false; }
+        file >> averagingTolerance;
+    }
+
+    if( !trained ) return true;
+
+    file >> word;
+    if( word != "BufferLength:" ){ errorLog << "load(fstream &file) - Could not find BufferLength!" << endl; clear(); return false; }
+    file >> bufferLength;
+    UINT numTemplates = numClasses;
+    if( hasTemplateSettings ){
+        file >> word;
+        if( word != "NumTemplates:" ){ errorLog << "load(fstream &file) - Could not find NumTemplates!" << endl; clear(); return false; }
+        file >> numTemplates;
+    }
+    file >> word;
+    if( word != "Templates:" ){ errorLog << "load(fstream &file) - Could not find Templates!" << endl; clear(); return false; }
+
+    templates.resize( numTemplates );
+    for(UINT k=0; k<numTemplates; k++){
+        Template &t = templates[k];
+        file >> word;
+        if( word != "ClassLabel:" ){ errorLog << "load(fstream &file) - Could not find ClassLabel!" << endl; clear(); return false; }
+        file >> t.classLabel;
+        t.classIndex = 0;
+        while( t.classIndex < numClasses && classLabels[ t.classIndex ] != t.classLabel ) t.classIndex++;
+        if( t.classIndex == numClasses ){ errorLog << "load(fstream &file) - Template " << k << " has an unknown class label!" << endl; clear(); return false; }
+        t.threshold = 0;
+        file >> word;
+        if( word != "TrainingMu:" ){ errorLog << "load(fstream &file) - Could not find TrainingMu!" << endl; clear(); return false; }
+        file >> t.trainingMu;
+        file >> word;
+        if( word != "TrainingSigma:" ){ errorLog << "load(fstream &file) - Could not find TrainingSigma!" << endl; clear(); return false; }
+        file >> t.trainingSigma;
+        file >> word;
+        if( word != "Length:" ){ errorLog << "load(fstream &file) - Could not find Length!" << endl; clear(); return false; }
+        file >> t.length;
+        t.data.resize( (size_t)t.length * numInputDimensions );
+        t.mappedData = NULL;
+        for(size_t i=0; i<t.data.size(); i++) file >> t.data[i];
+    }
+
+    if( bufferLength == 0 || !distance.setup( numInputDimensions, constrainWarpingPath, warpingRadius ) ){
+        errorLog << "load(fstream &file) - The model settings are not valid!" << endl;
+        clear();
+        return false;
+    }
+    distance.setMode( distanceMode, fastRadius );
+
+    inputBuffer.assign( (size_t)bufferLength * numInputDimensions, 0 );
+    bufferHead = 0;
+    bufferCount = 0;
+    classLikelihoods.resize( numClasses, 0 );
+    classDistances.resize( numClasses, 0 );
+
+    return recomputeNullRejectionThresholds();
+}
+
+bool ofxGrtDTW::saveSnapshot( const std::string &filename ) const {
+
+    if( !trained ){
+        errorLog << "saveSnapshot(const std::string &filename) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    SnapshotInfo info;
+    memset( &info, 0, sizeof( info ) );
+    info.numInputDimensions = numInputDimensions;
+    info.numClasses = numClasses;
+    info.numTemplates = (uint32_t)templates.size();
+    info.bufferLength = bufferLength;
+    info.useScaling = useScaling ? 1 : 0;
+    info.useNullRejection = useNullRejection ? 1 : 0;
+    info.constrainWarpingPath = constrainWarpingPath ? 1 : 0;
+    info.offsetUsingFirstSample = offsetUsingFirstSample ? 1 : 0;
+    info.distanceMode = distanceMode;
+    info.fastRadius = fastRadius;
+    info.numTemplatesPerClass = numTemplatesPerClass;
+    info.useTemplateAveraging = useTemplateAveraging ? 1 : 0;
+    info.maxNumAveragingIterations = maxNumAveragingIterations;
+    info.warpingRadius = warpingRadius;
+    info.nullRejectionCoeff = nullRejectionCoeff;
+    info.averagingTolerance = averagingTolerance;
+
+    vector< Float > rangeValues( numInputDimensions * 2 );
+    for(UINT j=0; j<numInputDimensions; j++){
+        rangeValues[ j*2 ] = ranges[j].minValue;
+        rangeValues[ j*2+1 ] = ranges[j].maxValue;
+    }
+    const vector< UINT > labels( classLabels.begin(), classLabels.end() );
+
+    //The templates are stored one after another in one float array
+    vector< SnapshotTemplate > headers( templates.size() );
+    vector< float > data;
+    for(size_t k=0; k<templates.size(); k++){
+        const Template &t = templates[k];
+        const size_t size = (size_t)t.length * numInputDimensions;
+        memset( &headers[k], 0, sizeof( SnapshotTemplate ) );
+        headers[k].classLabel = t.classLabel;
+        headers[k].length = t.length;
+        headers[k].offset = data.size();
+        headers[k].trainingMu = t.trainingMu;
+        headers[k].trainingSigma = t.trainingSigma;
+        data.insert( data.end(), t.getData(), t.getData() + size );
+    }
+
+    ofxGrtSnapshotWriter writer;
+    writer.addValue( "dtw.info", info );
+    writer.addArray( "dtw.ranges", rangeValues );
+    writer.addArray( "dtw.classLabels", labels );
+    writer.addArray( "dtw.templates", headers );
+    writer.addArray( "dtw.data", data );
+
+    return writer.save( filename );
+}
+
+bool ofxGrtDTW::loadSnapshot( const std::string &filename ){
+    std::shared_ptr< const ofxGrtSnapshot > snapshot = ofxGrtSnapshot::load( filename );
+    if( !snapshot ){
+        errorLog << "loadSnapshot(const std::string &filename) - Failed to open snapshot: " << filename << endl;
+        clear();
+        return false;
+    }
+    return loadSnapshot( snapshot );
+}
+
+bool ofxGrtDTW::loadSnapshot( const std::shared_ptr< const ofxGrtSnapshot > &snapshot ){
+
+    clear();
+
+    if( !snapshot || !snapshot->getIsOpen() ){
+        errorLog << "loadSnapshot(...) - The snapshot is not open!" << endl;
+        return false;
+    }
+
+    SnapshotInfo info;
+    const Float *rangeValues = NULL;
+    const UINT *labels = NULL;
+    const SnapshotTemplate *headers = NULL;
+    const float *data = NULL;
+    size_t numRangeValues = 0, numLabels = 0, numTemplates = 0, dataSize = 0;
+    if( !snapshot->getValue( "dtw.info", info ) ||
+        !snapshot->getArray( "dtw.ranges", rangeValues, numRangeValues ) ||
+        !snapshot->getArray( "dtw.classLabels", labels, numLabels ) ||
+        !snapshot->getArray( "dtw.templates", headers, numTemplates ) ||
+        !snapshot->getArray( "dtw.data", data, dataSize ) ){
+        errorLog << "loadSnapshot(...) - The snapshot does not contain a DTW model!" << endl;
+        return false;
+    }
+
+    if( info.numInputDimensions == 0 || info.numClasses == 0 || numLabels != info.numClasses || numRangeValues != (size_t)info.numInputDimensions * 2 ||
+        numTemplates == 0 || numTemplates != info.numTemplates || info.bufferLength == 0 ){
+        errorLog << "loadSnapshot(...) - The sizes of the DTW arrays in the snapshot do not match!" << endl;
+        return false;
+    }
+
+    numInputDimensions = info.numInputDimensions;
+    numClasses = info.numClasses;
+    useScaling = info.useScaling != 0;
+    useNullRejection = info.useNullRejection != 0;
+    nullRejectionCoeff = info.nullRejectionCoeff;
+    constrainWarpingPath = info.constrainWarpingPath != 0;
+    warpingRadius = info.warpingRadius;
+    offsetUsingFirstSample = info.offsetUsingFirstSample != 0;
+    distanceMode = info.distanceMode == ofxGrtDTWDistance::FAST_DTW ? ofxGrtDTWDistance::FAST_DTW : ofxGrtDTWDistance::EXACT_DTW;
+    fastRadius = info.fastRadius;
+    numTemplatesPerClass = info.numTemplatesPerClass;
+    useTemplateAveraging = info.useTemplateAveraging != 0;
+    maxNumAveragingIterations = info.maxNumAveragingIterations;
+    averagingTolerance = info.averagingTolerance;
+    bufferLength = info.bufferLength;
+
+    ranges.resize( numInputDimensions );
+    for(UINT j=0; j<numInputDimensions; j++){
+        ranges[j].minValue = rangeValues[ j*2 ];
+        ranges[j].maxValue = rangeValues[ j*2+1 ];
+    }
+    classLabels.resize( numClasses );
+    for(UINT k=0; k<numClasses; k++) classLabels[k] = labels[k];
+
+    //Point each template at its data in the snapshot
+    templates.resize( numTemplates );
+    for(size_t k=0; k<numTemplates; k++){
+        const SnapshotTemplate &header = headers[k];
+        Template &t = templates[k];
+        t.classLabel = header.classLabel;
+        t.classIndex = 0;
+        while( t.classIndex < numClasses && classLabels[ t.classIndex ] != t.classLabel ) t.classIndex++;
+        t.length = header.length;
+        if( t.classIndex == numClasses || t.length == 0 || header.offset > dataSize || (uint64_t)t.length * numInputDimensions > dataSize - header.offset ){
+            errorLog << "loadSnapshot(...) - Template " << k << " of the snapshot is invalid!" << endl;
+            clear();
+            return false;
+        }
+        t.mappedData = data + header.offset;
+        t.trainingMu = header.trainingMu;
+        t.trainingSigma = header.trainingSigma;
+        t.threshold = 0;
+    }
+
+    if( !distance.setup( numInputDimensions, constrainWarpingPath, warpingRadius ) ){
+        errorLog << "loadSnapshot(...) - The model settings are not valid!" << endl;
+        clear();
+        return false;
+    }
+    distance.setMode( distanceMode, fastRadius );
+
+    this->snapshot = snapshot;
+    inputBuffer.assign( (size_t)bufferLength * numInputDimensions, 0 );
+    bufferHead = 0;
+    bufferCount = 0;
+    classLikelihoods.resize( numClasses, 0 );
+    classDistances.resize( numClasses, 0 );
+    trained = true;
+
+    return recomputeNullRejectionThresholds();
+}
+
+bool ofxGrtDTW::setConstrainWarpingPath( const bool constrainWarpingPath ){
+    this->constrainWarpingPath = constrainWarpingPath;
+    if( numInputDimensions > 0 ) distance.setup( numInputDimensions, constrainWarpingPath, warpingRadius );
+    return true;
+}
+
+bool ofxGrtDTW::setWarpingRadius( const Float warpingRadius ){
+    if( warpingRadius < 0 || warpingRadius > 1 ){
+        errorLog << "setWarpingRadius(const Float warpingRadius) - The warping radius must be in the range [0 1]!" << endl;
+        return false;
+    }
+    this->warpingRadius = warpingRadius;
+    if( numInputDimensions > 0 ) distance.setup( numInputDimensions, constrainWarpingPath, warpingRadius );
+    return true;
+}
+
+bool ofxGrtDTW::setDistanceMode( const ofxGrtDTWDistance::Mode distanceMode, const UINT fastRadius ){
+    if( distanceMode != ofxGrtDTWDistance::EXACT_DTW && distanceMode != ofxGrtDTWDistance::FAST_DTW ){
+        errorLog << "setDistanceMode(...) - Unknown distance mode!" << endl;
+        return false;
+    }
+    this->distanceMode = distanceMode;
+    this->fastRadius = fastRadius;
+    distance.setMode( distanceMode, fastRadius );
+    return true;
+}
+
+bool ofxGrtDTW::setNumTemplatesPerClass( const UINT numTemplatesPerClass ){
+    this->numTemplatesPerClass = numTemplatesPerClass;
+    return true;
+}
+
+bool ofxGrtDTW::setTemplateAveraging( const bool useTemplateAveraging, const UINT maxNumIterations, const Float tolerance ){
+    if( maxNumIterations == 0 || tolerance < 0 ){
+        errorLog << "setTemplateAveraging(...) - The number of iterations must be greater than zero and the tolerance must be positive!" << endl;
+        return false;
+    }
+    this->useTemplateAveraging = useTemplateAveraging;
+    this->maxNumAveragingIterations = maxNumIterations;
+    this->averagingTolerance = tolerance;
+    return true;
+}
+
+bool ofxGrtDTW::setOffsetTimeseriesUsingFirstSample( const bool offsetUsingFirstSample ){
+    this->offsetUsingFirstSample = offsetUsingFirstSample;
+    return true;
+}
+
+bool ofxGrtDTW::benchmarkFastDTW( const TimeSeriesClassificationData &testData, const UINT fastRadius, BenchmarkResult &result ) const {
+
+    result.numSamples = 0;
+    result.numAgreements = 0;
+    result.exactTime = 0;
+    result.fastTime = 0;
+    result.meanDistanceError = 0;
+
+    if( !trained ){
+        errorLog << "benchmarkFastDTW(...) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    if( testData.getNumDimensions() != numInputDimensions ){
+        errorLog << "benchmarkFastDTW(...) - The number of dimensions of the test data (" << testData.getNumDimensions() << ") does not match the model (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    ofxGrtDTWDistance exact;
+    ofxGrtDTWDistance fast;
+    exact.setup( numInputDimensions, constrainWarpingPath, warpingRadius );
+    fast.setup( numInputDimensions, constrainWarpingPath, warpingRadius );
+    fast.setMode( ofxGrtDTWDistance::FAST_DTW, fastRadius );
+
+    vector< float > sample;
+    for(UINT i=0; i<testData.getNumSamples(); i++){
+        const MatrixFloat &data = testData[i].getData();
+        const UINT length = data.getNumRows();
+        if( length == 0 ) continue;
+        preprocess( data, sample );
+
+        //Time each distance on its own so the two are measured on the same samples and templates
+        float exactBest = 0, fastBest = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        const UINT exactIndex = findNearestTemplate( exact, &sample[0], length, exactBest );
+        auto middle = std::chrono::high_resolution_clock::now();
+        const UINT fastIndex = findNearestTemplate( fast, &sample[0], length, fastBest );
+        auto end = std::chrono::high_resolution_clock::now();
+
+        result.exactTime += std::chrono::duration< double, std::milli >( middle - start ).count();
+        result.fastTime += std::chrono::duration< double, std::milli >( end - middle ).count();
+        if( templates[ exactIndex ].classIndex == templates[ fastIndex ].classIndex ) result.numAgreements++;
+        if( exactBest > 0 ) result.meanDistanceError += (fastBest - exactBest) / exactBest;
+        result.numSamples++;
+    }
+
+    if( result.numSamples > 0 ){
+        result.exactTime /= result.numSamples;
+        result.fastTime /= result.numSamples;
+        result.meanDistanceError /= result.numSamples;
+    }
+
+    return true;
+}
+
+bool ofxGrtDTW::benchmarkTemplates( const TimeSeriesClassificationData &testData, TemplateBenchmarkResult &result ) const {
+
+    result.numSamples = 0;
+    result.numCorrect = 0;
+    result.numTemplates = (UINT)templates.size();
+    result.meanTime = 0;
+
+    if( !trained ){
+        errorLog << "benchmarkTemplates(...) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    if( testData.getNumDimensions() != numInputDimensions ){
+        errorLog << "benchmarkTemplates(...) - The number of dimensions of the test data (" << testData.getNumDimensions() << ") does not match the model (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    ofxGrtDTWDistance benchmarkDistance = distance;
+    vector< float > sample;
+    for(UINT i=0; i<testData.getNumSamples(); i++){
+        const MatrixFloat &data = testData[i].getData();
+        const UINT length = data.getNumRows();
+        if( length == 0 ) continue;
+        preprocess( data, sample );
+
+        float nearestDistance = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        const UINT nearest = findNearestTemplate( benchmarkDistance, &sample[0], length, nearestDistance );
+        result.meanTime += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+
+        if( templates[ nearest ].classLabel == testData[i].getClassLabel() ) result.numCorrect++;
+        result.numSamples++;
+    }
+
+    if( result.numSamples > 0 ) result.meanTime /= result.numSamples;
+
+    return true;
+}
+
+UINT ofxGrtDTW::findNearestTemplate( ofxGrtDTWDistance &distance, const float *series, const UINT length, float &nearestDistance ) const {
+
+    UINT nearest = 0;
+    nearestDistance = grt_numeric_limits< float >::max();
+    for(UINT i=0; i<templates.size(); i++){
+        const float d = distance.compute( templates[i].getData(), templates[i].length, series, length );
+        if( d < nearestDistance ){
+            nearestDistance = d;
+            nearest = i;
+        }
+    }
+
+    return nearest;
+}
+
+MatrixFloat ofxGrtDTW::getTemplate( const UINT index ) const {
+
+    if( index >= templates.size() ) return MatrixFloat();
+
+    const Template &t = templates[ index ];
+    const float *data = t.getData();
+    MatrixFloat matrix( t.length, numInputDimensions );
+    for(UINT i=0; i<t.length; i++){
+        for(UINT j=0; j<numInputDimensions; j++) matrix[i][j] = data[ (size_t)i*numInputDimensions + j ];
+    }
+
+    return matrix;
+}
+
+Vector< VectorFloat > ofxGrtDTW::getInputDataBuffer() const {
+
+    Vector< VectorFloat > buffer( bufferCount, VectorFloat( numInputDimensions ) );
+    for(UINT i=0; i<bufferCount; i++){
+        const UINT index = (bufferHead + i) % bufferLength;
+        for(UINT j=0; j<numInputDimensions; j++) buffer[i][j] = inputBuffer[ (size_t)index*numInputDimensions + j ];
+    }
+
+    return buffer;
+}
+
+Vector< MatrixFloat > ofxGrtDTW::getDistanceMatrices() const {
+
+    Vector< MatrixFloat > matrices( trainer.getNumClasses() );
+    for(UINT k=0; k<trainer.getNumClasses(); k++){
+        matrices[k] = trainer.getDistanceMatrix( k );
+    }
+
+    return matrices;
+}
+
+void ofxGrtDTW::preprocess( const MatrixFloat &input, vector< float > &series ) const {
+
+    const UINT length = input.getNumRows();
+    series.resize( (size_t)length * numInputDimensions );
+    for(UINT i=0; i<length; i++){
+        for(UINT j=0; j<numInputDimensions; j++) series[ (size_t)i*numInputDimensions + j ] = (float)input[i][j];
+    }
+
+    preprocess( series, length );
+}
+
+void ofxGrtDTW::preprocess( vector< float > &series, const UINT length ) const {
+
+    const UINT N = numInputDimensions;
+
+    if( useScaling ){
+        for(UINT i=0; i<length; i++){
+            for(UINT j=0; j<N; j++){
+                float &x = series[ (size_t)i*N + j ];
+                x = (float)(ranges[j].minValue == ranges[j].maxValue ? 0 : (x - ranges[j].minValue) / (ranges[j].maxValue - ranges[j].minValue));
+            }
+        }
+    }
+
+    if( offsetUsingFirstSample && length > 0 ){
+        for(UINT i=length; i-- > 0;){
+            for(UINT j=0; j<N; j++) series[ (size_t)i*N + j ] -= series[j];
+        }
+    }
+}
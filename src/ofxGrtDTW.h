@@ -0,0 +1,303 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <memory>
+
+#include "ofMain.h"
+#include "ofxGrtSnapshot.h"
+#include "ofxGrtDTWDistance.h"
+#include "ofxGrtDTWTrainer.h"
+#include "ofxGrtDTWAverager.h"
+
+using namespace GRT;
+
+/**
+ @brief a dynamic time warping classifier that can be used in a GestureRecognitionPipeline (like the GRT DTW). By default each class is represented
+ by one template, the training sample with the smallest sum of DTW distances to the other samples of the class, and a series is classified as the
+ class of the nearest template. The templates are picked by ofxGrtDTWTrainer, which computes the pairwise distances in parallel with early abandoning and
+ caches them, so retraining after adding a sample (for example with the same pipeline) only computes the distances of the new sample.
+
+ The DTW distance is the accumulated euclidean cost of the warping path divided by the sum of the two lengths (see ofxGrtDTWDistance). The class
+ likelihoods are the normalized inverse distances. If null rejection is enabled, a prediction is rejected if its distance is above the class
+ threshold of its nearest template, which is the mean plus nullRejectionCoeff standard deviations of the distances between the template and the
+ other training samples (of its cluster).
+
+ A class recorded many times can be compacted into a few templates rather than one (see setNumTemplatesPerClass): the samples of the class are
+ clustered with k-medoids, and each template is the medoid of a cluster or, with template averaging enabled, the DTW barycenter average (DBA)
+ of the cluster started from its medoid. The distance to a class is the distance to its nearest template, and benchmarkTemplates reports the
+ accuracy and prediction time of the templates, so a few templates per class can be compared with keeping every sample.
+
+ For long gestures the distances can be approximated with FastDTW (see setDistanceMode), which is used for training and prediction. The
+ approximation can be checked with benchmarkFastDTW, which reports how often it picks the same class as the exact distance and how much faster it is.
+
+ predict_(MatrixFloat) classifies a whole series. predict_(VectorFloat) adds the sample to a buffer of the most recent samples (as long as the mean
+ training sample) and classifies the buffer once it is full.
+
+ A trained template library can be saved as a binary ofxGrtSnapshot with saveSnapshot. A model loaded with loadSnapshot reads its templates
+ straight from the read-only mapping of the file, so a large library loads without parsing and is shared by every process that loads it.
+*/
+class ofxGrtDTW : public Classifier {
+public:
+    struct BenchmarkResult{
+        UINT numSamples;
+        UINT numAgreements;         ///< The number of samples where FastDTW predicted the same class as the exact distance
+        double exactTime;           ///< The mean time to classify a sample with the exact distance, in milliseconds
+        double fastTime;            ///< The mean time to classify a sample with FastDTW, in milliseconds
+        double meanDistanceError;   ///< The mean of (fast - exact) / exact for the distance to the nearest template
+
+        double getAgreement() const { return numSamples > 0 ? (double)numAgreements / numSamples : 0; }
+        double getSpeedup() const { return fastTime > 0 ? exactTime / fastTime : 0; }
+    };
+
+    struct TemplateBenchmarkResult{
+        UINT numSamples;
+        UINT numCorrect;            ///< The number of samples whose nearest template has the class of the sample
+        UINT numTemplates;
+        double meanTime;            ///< The mean time to classify a sample, in milliseconds
+
+        double getAccuracy() const { return numSamples > 0 ? (double)numCorrect / numSamples : 0; }
+    };
+
+    /**
+     @brief creates the classifier
+     @param useScaling: if true the training and input data are scaled to [0 1] using the training data ranges
+     @param useNullRejection: if true predictions too far from the templates are rejected
+     @param nullRejectionCoeff: the number of standard deviations above the mean training distance used for the rejection thresholds
+     @param constrainWarpingPath: if true the warping path is constrained to a band around the diagonal
+     @param warpingRadius: the half width of the band, as a fraction of the length of the longer series
+     @param offsetUsingFirstSample: if true the first sample of each series is subtracted from the series
+    */
+    ofxGrtDTW( const bool useScaling = false, const bool useNullRejection = false, const Float nullRejectionCoeff = 3.0, const bool constrainWarpingPath = true, const Float warpingRadius = 0.2, const bool offsetUsingFirstSample = false );
+    ofxGrtDTW( const ofxGrtDTW &rhs );
+    virtual ~ofxGrtDTW();
+
+    ofxGrtDTW &operator=( const ofxGrtDTW &rhs );
+
+    virtual bool deepCopyFrom( const Classifier *classifier );
+    virtual bool train_( TimeSeriesClassificationData &trainingData );
+    virtual bool predict_( VectorFloat &inputVector );
+    virtual bool predict_( MatrixFloat &inputMatrix );
+    virtual bool reset();
+    virtual bool clear();
+    virtual bool save( std::fstream &file ) const;
+    virtual bool load( std::fstream &file );
+    virtual bool recomputeNullRejectionThresholds();
+
+    /**
+     @brief removes the cached training distances, clear() keeps them so the next training can reuse them
+     @return returns true if the cache was cleared successfully, false otherwise
+    */
+    bool clearTrainingCache();
+
+    /**
+     @brief saves the trained model (its settings and templates) as a binary snapshot
+     @param filename: the snapshot file to write
+     @return returns true if the snapshot was saved successfully, false otherwise
+    */
+    bool saveSnapshot( const std::string &filename ) const;
+
+    /**
+     @brief loads a trained model from a binary snapshot, the templates are used from the snapshot without copying them
+     @param filename: the snapshot file to map
+     @return returns true if the snapshot was loaded successfully, false otherwise
+    */
+    bool loadSnapshot( const std::string &filename );
+
+    /**
+     @brief loads a trained model from a snapshot that is already open, so several models can share one mapping
+     @param snapshot: the open snapshot, the model (and any copy of it) keeps a reference to it
+     @return returns true if the snapshot was loaded successfully, false otherwise
+    */
+    bool loadSnapshot( const std::shared_ptr< const ofxGrtSnapshot > &snapshot );
+
+    bool setConstrainWarpingPath( const bool constrainWarpingPath );
+    bool setWarpingRadius( const Float warpingRadius );
+    bool setOffsetTimeseriesUsingFirstSample( const bool offsetUsingFirstSample );
+
+    /**
+     @brief sets how the DTW distances are computed, the model must be retrained after changing this
+     @param distanceMode: ofxGrtDTWDistance::EXACT_DTW or ofxGrtDTWDistance::FAST_DTW
+     @param fastRadius: the FastDTW radius in frames, a larger radius is closer to the exact distance but slower
+     @return returns true if the mode was set successfully, false otherwise
+    */
+    bool setDistanceMode( const ofxGrtDTWDistance::Mode distanceMode, const UINT fastRadius = 10 );
+
+    /**
+     @brief sets the number of templates kept for each class, the model must be retrained after changing this
+     @param numTemplatesPerClass: the number of templates (limited to the number of samples of the class), or zero to keep every training sample
+     @return returns true if the number of templates was set successfully, false otherwise
+    */
+    bool setNumTemplatesPerClass( const UINT numTemplatesPerClass );
+
+    /**
+     @brief sets if each template is averaged from its cluster with DBA, rather than being the medoid of the cluster
+     @param useTemplateAveraging: if true the templates are averaged
+     @param maxNumIterations: the maximum number of DBA iterations
+     @param tolerance: DBA stops when the mean distance from the cluster to the average improves by less than this fraction
+     @return returns true if the settings were set successfully, false otherwise
+    */
+    bool setTemplateAveraging( const bool useTemplateAveraging, const UINT maxNumIterations = 10, const Float tolerance = 0.001 );
+
+    bool getConstrainWarpingPath() const { return constrainWarpingPath; }
+    Float getWarpingRadius() const { return warpingRadius; }
+    bool getOffsetTimeseriesUsingFirstSample() const { return offsetUsingFirstSample; }
+    ofxGrtDTWDistance::Mode getDistanceMode() const { return distanceMode; }
+    UINT getFastRadius() const { return fastRadius; }
+    UINT getNumTemplatesPerClass() const { return numTemplatesPerClass; }
+    bool getTemplateAveraging() const { return useTemplateAveraging; }
+    UINT getNumTemplates() const { return (UINT)templates.size(); }
+
+    /**
+     @brief gets a (scaled and offset) template, the templates of each class are stored next to each other
+    */
+    MatrixFloat getTemplate( const UINT index ) const;
+    UINT getTemplateClassLabel( const UINT index ) const { return templates[ index ].classLabel; }
+
+    /**
+     @brief gets the null rejection threshold of a template, a prediction is rejected if its distance is above the threshold of its nearest template
+    */
+    Float getTemplateThreshold( const UINT index ) const { return templates[ index ].threshold; }
+
+    /**
+     @brief gets the number of samples buffered by predict_(VectorFloat) before it starts classifying
+    */
+    UINT getBufferLength() const { return bufferLength; }
+
+    /**
+     @brief gets the samples in the buffer used by predict_(VectorFloat), oldest first and unscaled
+    */
+    Vector< VectorFloat > getInputDataBuffer() const;
+
+    /**
+     @brief gets the cached DTW distances between the training samples of each class, see ofxGrtDTWTrainer::getDistanceMatrix
+    */
+    Vector< MatrixFloat > getDistanceMatrices() const;
+
+    /**
+     @brief gets the trainer, which holds the distance cache and the statistics of the last training
+    */
+    const ofxGrtDTWTrainer &getTrainer() const { return trainer; }
+
+    /**
+     @brief gets the time taken by the last call to train
+     @return returns the training time in milliseconds
+    */
+    double getTrainingTime() const { return trainingTime; }
+
+    /**
+     @brief classifies every sample of a dataset against the templates with both the exact distance and FastDTW, and compares the labels and times.
+     The null rejection is not applied, so only the nearest template is compared
+     @param testData: the samples to classify, with the same number of dimensions as the model
+     @param fastRadius: the FastDTW radius to test
+     @param result: the agreement and timings
+     @return returns true if the benchmark was run successfully, false otherwise
+    */
+    bool benchmarkFastDTW( const TimeSeriesClassificationData &testData, const UINT fastRadius, BenchmarkResult &result ) const;
+
+    /**
+     @brief classifies every sample of a dataset with the nearest template and measures the accuracy and time. Train with different numbers of
+     templates per class (and with or without averaging) to compare the accuracy and latency
+     @param testData: the labelled samples to classify, with the same number of dimensions as the model
+     @param result: the accuracy and timing
+     @return returns true if the benchmark was run successfully, false otherwise
+    */
+    bool benchmarkTemplates( const TimeSeriesClassificationData &testData, TemplateBenchmarkResult &result ) const;
+
+    using MLBase::save;
+    using MLBase::load;
+    using MLBase::train_;
+    using MLBase::predict_;
+
+protected:
+    struct Template{
+        UINT classLabel;
+        UINT classIndex;
+        UINT length;
+        vector< float > data;           ///< [length x numInputDimensions], empty if the template is in a snapshot
+        const float *mappedData;        ///< The template in the snapshot, or NULL
+        Float trainingMu;
+        Float trainingSigma;
+        Float threshold;
+
+        const float *getData() const { return mappedData != NULL ? mappedData : &data[0]; }
+    };
+
+    //The settings and template headers stored in a snapshot
+    struct SnapshotInfo{
+        uint32_t numInputDimensions;
+        uint32_t numClasses;
+        uint32_t numTemplates;
+        uint32_t bufferLength;
+        uint32_t useScaling;
+        uint32_t useNullRejection;
+        uint32_t constrainWarpingPath;
+        uint32_t offsetUsingFirstSample;
+        uint32_t distanceMode;
+        uint32_t fastRadius;
+        uint32_t numTemplatesPerClass;
+        uint32_t useTemplateAveraging;
+        uint32_t maxNumAveragingIterations;
+        uint32_t reserved;
+        Float warpingRadius;
+        Float nullRejectionCoeff;
+        Float averagingTolerance;
+    };
+
+    struct SnapshotTemplate{
+        uint32_t classLabel;
+        uint32_t length;
+        uint64_t offset;                ///< The offset of the template in the data section, in floats
+        Float trainingMu;
+        Float trainingSigma;
+    };
+
+    void preprocess( const MatrixFloat &input, vector< float > &series ) const;
+    void preprocess( vector< float > &series, const UINT length ) const;
+    bool predictSeries( const float *series, const UINT length );
+    UINT findNearestTemplate( ofxGrtDTWDistance &distance, const float *series, const UINT length, float &nearestDistance ) const;
+
+    bool constrainWarpingPath;
+    Float warpingRadius;
+    bool offsetUsingFirstSample;
+    ofxGrtDTWDistance::Mode distanceMode;
+    UINT fastRadius;
+    UINT numTemplatesPerClass;
+    bool useTemplateAveraging;
+    UINT maxNumAveragingIterations;
+    Float averagingTolerance;
+    double trainingTime;
+    vector< Template > templates;
+    std::shared_ptr< const ofxGrtSnapshot > snapshot;      ///< The snapshot holding the templates, if the model was loaded from one
+    UINT bufferLength;
+    ofxGrtDTWTrainer trainer;
+    ofxGrtDTWAverager averager;
+    ofxGrtDTWDistance distance;
+
+    //The buffer of the most recent samples used by predict_(VectorFloat), as a ring [bufferLength x numInputDimensions]
+    vector< float > inputBuffer;
+    UINT bufferHead;
+    UINT bufferCount;
+    vector< float > series;
+
+private:
+    static RegisterClassifierModule< ofxGrtDTW > registerModule;
+};
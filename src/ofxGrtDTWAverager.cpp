@@ -0,0 +1,134 @@
+
+#include "ofxGrtDTWAverager.h"
+
+using namespace GRT;
+
+ofxGrtDTWAverager::ofxGrtDTWAverager(){
+    numDimensions = 0;
+    constrainWarpingPath = true;
+    warpingRadius = 0.2;
+    maxNumIterations = 10;
+    tolerance = 0.001;
+    numIterations = 0;
+    errorLog.setProceedingText("[ERROR ofxGrtDTWAverager]");
+}
+
+ofxGrtDTWAverager::~ofxGrtDTWAverager(){
+}
+
+bool ofxGrtDTWAverager::setup( const UINT numDimensions, const bool constrainWarpingPath, const Float warpingRadius ){
+
+    if( numDimensions == 0 ){
+        errorLog << "setup(...) - The number of dimensions must be greater than zero!" << endl;
+        return false;
+    }
+
+    if( warpingRadius < 0 || warpingRadius > 1 ){
+        errorLog << "setup(...) - The warping radius must be in the range [0 1]!" << endl;
+        return false;
+    }
+
+    this->numDimensions = numDimensions;
+    this->constrainWarpingPath = constrainWarpingPath;
+    this->warpingRadius = warpingRadius;
+
+    const UINT numThreads = ofxGrtThreadPool::getSharedPool().getNumThreads();
+    distances.resize( numThreads );
+    accumulators.resize( numThreads );
+    for(UINT t=0; t<numThreads; t++){
+        distances[t].setup( numDimensions, constrainWarpingPath, warpingRadius );
+    }
+
+    return true;
+}
+
+bool ofxGrtDTWAverager::setMaxNumIterations( const UINT maxNumIterations ){
+    if( maxNumIterations == 0 ){
+        errorLog << "setMaxNumIterations(const UINT maxNumIterations) - The number of iterations must be greater than zero!" << endl;
+        return false;
+    }
+    this->maxNumIterations = maxNumIterations;
+    return true;
+}
+
+bool ofxGrtDTWAverager::setTolerance( const Float tolerance ){
+    if( tolerance < 0 ){
+        errorLog << "setTolerance(const Float tolerance) - The tolerance must be positive!" << endl;
+        return false;
+    }
+    this->tolerance = tolerance;
+    return true;
+}
+
+bool ofxGrtDTWAverager::average( const vector< vector< float > > &samples, const vector< UINT > &members, vector< float > &average, vector< float > &memberDistances ){
+
+    numIterations = 0;
+
+    if( numDimensions == 0 ){
+        errorLog << "average(...) - The averager has not been setup!" << endl;
+        return false;
+    }
+
+    if( members.size() == 0 || average.size() == 0 || average.size() % numDimensions != 0 ){
+        errorLog << "average(...) - There must be at least one member and the initial average must have a whole number of frames!" << endl;
+        return false;
+    }
+
+    const UINT N = numDimensions;
+    const UINT length = (UINT)(average.size() / N);
+    vector< float > best = average;
+    vector< float > bestDistances;
+    double bestMean = grt_numeric_limits< double >::max();
+    memberDistances.resize( members.size() );
+
+    for(UINT iter=0; iter<maxNumIterations; iter++){
+        for(size_t t=0; t<accumulators.size(); t++){
+            accumulators[t].sums.assign( (size_t)length * N, 0 );
+            accumulators[t].counts.assign( length, 0 );
+        }
+
+        //Align every member to the current average, each thread sums the aligned frames into its own accumulator
+        ofxGrtThreadPool::getSharedPool().parallelFor( 0, members.size(), 1, [&]( const size_t m, const unsigned int threadIndex ){
+            Accumulator &accumulator = accumulators[ threadIndex ];
+            const vector< float > &sample = samples[ members[m] ];
+            memberDistances[m] = distances[ threadIndex ].computePath( &average[0], length, &sample[0], (UINT)(sample.size() / N), accumulator.pathA, accumulator.pathB );
+            for(size_t p=0; p<accumulator.pathA.size(); p++){
+                const UINT i = accumulator.pathA[p];
+                const float *x = &sample[ (size_t)accumulator.pathB[p] * N ];
+                for(UINT j=0; j<N; j++) accumulator.sums[ (size_t)i*N + j ] += x[j];
+                accumulator.counts[i]++;
+            }
+        });
+        numIterations++;
+
+        double mean = 0;
+        for(size_t m=0; m<members.size(); m++) mean += memberDistances[m];
+        mean /= members.size();
+
+        const bool improved = mean < bestMean;
+        const bool converged = bestMean < grt_numeric_limits< double >::max() && bestMean - mean <= tolerance * bestMean;
+        if( improved ){
+            bestMean = mean;
+            best = average;
+            bestDistances = memberDistances;
+        }
+        if( converged || !improved ) break;
+
+        //Move each frame of the average to the mean of the frames aligned with it
+        for(UINT i=0; i<length; i++){
+            double count = 0;
+            for(size_t t=0; t<accumulators.size(); t++) count += accumulators[t].counts[i];
+            if( count == 0 ) continue;
+            for(UINT j=0; j<N; j++){
+                double sum = 0;
+                for(size_t t=0; t<accumulators.size(); t++) sum += accumulators[t].sums[ (size_t)i*N + j ];
+                average[ (size_t)i*N + j ] = (float)(sum / count);
+            }
+        }
+    }
+
+    average = best;
+    memberDistances = bestDistances;
+
+    return true;
+}
@@ -0,0 +1,86 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+#include "ofxGrtDTWDistance.h"
+#include "ofxGrtThreadPool.h"
+
+using namespace GRT;
+
+/**
+ @brief averages a set of time series with DTW Barycenter Averaging (DBA, Petitjean et al., 2011), this is used by ofxGrtDTW to merge the
+ samples of a cluster into one template. Starting from an initial average (such as the medoid of the samples), each iteration aligns every
+ sample to the average with DTW, and moves each frame of the average to the mean of the sample frames aligned with it. The samples are
+ aligned in parallel on the shared ofxGrtThreadPool. The iterations stop when the mean distance from the samples to the average improves by
+ less than the tolerance (relative to the mean distance), and the best average found is kept.
+*/
+class ofxGrtDTWAverager {
+public:
+    ofxGrtDTWAverager();
+    ~ofxGrtDTWAverager();
+
+    /**
+     @brief sets the size of the frames and the warping constraint used to align the samples
+     @return returns true if the averager was setup successfully, false otherwise
+    */
+    bool setup( const UINT numDimensions, const bool constrainWarpingPath, const Float warpingRadius );
+
+    bool setMaxNumIterations( const UINT maxNumIterations );
+    bool setTolerance( const Float tolerance );
+
+    /**
+     @brief averages some of the samples
+     @param samples: the samples, each stored row by row [length x numDimensions]
+     @param members: the indices of the samples to average
+     @param average: the initial average, which is replaced by the final average (with the same length)
+     @param memberDistances: the distances from each member to the final average
+     @return returns true if the samples were averaged successfully, false otherwise
+    */
+    bool average( const vector< vector< float > > &samples, const vector< UINT > &members, vector< float > &average, vector< float > &memberDistances );
+
+    UINT getMaxNumIterations() const { return maxNumIterations; }
+    Float getTolerance() const { return tolerance; }
+
+    /**
+     @brief gets the number of iterations run by the last call to average
+    */
+    UINT getNumIterations() const { return numIterations; }
+
+protected:
+    struct Accumulator{
+        vector< double > sums;      ///< The sum of the sample frames aligned with each frame of the average
+        vector< UINT > counts;
+        vector< UINT > pathA;
+        vector< UINT > pathB;
+    };
+
+    UINT numDimensions;
+    bool constrainWarpingPath;
+    Float warpingRadius;
+    UINT maxNumIterations;
+    Float tolerance;
+    UINT numIterations;
+    vector< ofxGrtDTWDistance > distances;  ///< One per thread
+    vector< Accumulator > accumulators;     ///< One per thread
+    ErrorLog errorLog;
+};
@@ -0,0 +1,289 @@
+
+#include "ofxGrtDTWDistance.h"
+#include "ofxGrtSimd.h"
+
+using namespace GRT;
+
+ofxGrtDTWDistance::ofxGrtDTWDistance(){
+    numDimensions = 0;
+    constrainWarpingPath = true;
+    warpingRadius = 0.2;
+    mode = EXACT_DTW;
+    fastRadius = 10;
+}
+
+ofxGrtDTWDistance::~ofxGrtDTWDistance(){
+}
+
+bool ofxGrtDTWDistance::setup( const UINT numDimensions, const bool constrainWarpingPath, const Float warpingRadius ){
+
+    if( numDimensions == 0 || warpingRadius < 0 || warpingRadius > 1 ){
+        return false;
+    }
+
+    this->numDimensions = numDimensions;
+    this->constrainWarpingPath = constrainWarpingPath;
+    this->warpingRadius = warpingRadius;
+
+    return true;
+}
+
+bool ofxGrtDTWDistance::setMode( const Mode mode, const UINT fastRadius ){
+
+    if( mode != EXACT_DTW && mode != FAST_DTW ){
+        return false;
+    }
+
+    this->mode = mode;
+    this->fastRadius = fastRadius;
+
+    return true;
+}
+
+void ofxGrtDTWDistance::getBand( const UINT i, const UINT lengthA, const UINT lengthB, UINT &first, UINT &last ) const {
+
+    if( !constrainWarpingPath || lengthA <= 1 || lengthB <= 1 ){
+        first = 0;
+        last = lengthB-1;
+        return;
+    }
+
+    //The band follows the diagonal from (0,0) to (lengthA-1,lengthB-1), and is at least as wide as one step of the diagonal so the path stays connected
+    const double slope = (double)(lengthB-1) / (lengthA-1);
+    const double halfWidth = std::max( std::ceil( warpingRadius * std::max( lengthA, lengthB ) ), std::ceil( slope ) );
+    const double center = i * slope;
+    first = (UINT)std::max( 0.0, std::floor( center - halfWidth ) );
+    last = (UINT)std::min( (double)(lengthB-1), std::ceil( center + halfWidth ) );
+}
+
+float ofxGrtDTWDistance::compute( const float *a, const UINT lengthA, const float *b, const UINT lengthB, const float abandonThreshold, bool *abandoned ){
+
+    if( abandoned ) *abandoned = false;
+
+    if( lengthA == 0 || lengthB == 0 || numDimensions == 0 ){
+        return grt_numeric_limits< float >::max();
+    }
+
+    //Short series are not worth coarsening, and the exact distance is cheaper than the windows
+    const UINT minLength = fastRadius + 2;
+    if( mode == EXACT_DTW || lengthA <= minLength || lengthB <= minLength ){
+        return accumulate( a, lengthA, b, lengthB, NULL, NULL, abandonThreshold, abandoned );
+    }
+
+    //Build the pyramid, halving both series until one of them is short enough to be aligned without a window
+    UINT numLevels = 1;
+    if( levels.size() < 1 ) levels.resize( 1 );
+    levels[0].lengthA = lengthA;
+    levels[0].lengthB = lengthB;
+    while( levels[numLevels-1].lengthA > minLength && levels[numLevels-1].lengthB > minLength ){
+        if( levels.size() <= numLevels ) levels.resize( numLevels+1 );
+        const Level &fine = levels[numLevels-1];
+        Level &coarse = levels[numLevels];
+        coarsen( numLevels == 1 ? a : &fine.a[0], fine.lengthA, coarse.a );
+        coarsen( numLevels == 1 ? b : &fine.b[0], fine.lengthB, coarse.b );
+        coarse.lengthA = (fine.lengthA+1) / 2;
+        coarse.lengthB = (fine.lengthB+1) / 2;
+        numLevels++;
+    }
+
+    //The coarsest level uses the full cost matrix
+    Level &coarsest = levels[numLevels-1];
+    coarsest.first.assign( coarsest.lengthA, 0 );
+    coarsest.last.assign( coarsest.lengthA, coarsest.lengthB-1 );
+
+    //Find the path at each coarse level and project it to the next finer level
+    for(UINT k=numLevels-1; k>0; k--){
+        const Level &level = levels[k];
+        if( !findPath( &level.a[0], level.lengthA, &level.b[0], level.lengthB, &level.first[0], &level.last[0] ) ){
+            return accumulate( a, lengthA, b, lengthB, NULL, NULL, abandonThreshold, abandoned );
+        }
+        projectPath( levels[k-1] );
+    }
+
+    return accumulate( a, lengthA, b, lengthB, &levels[0].first[0], &levels[0].last[0], abandonThreshold, abandoned );
+}
+
+float ofxGrtDTWDistance::computePath( const float *a, const UINT lengthA, const float *b, const UINT lengthB, vector< UINT > &pathA, vector< UINT > &pathB ){
+
+    pathA.clear();
+    pathB.clear();
+
+    if( lengthA == 0 || lengthB == 0 || numDimensions == 0 ){
+        return grt_numeric_limits< float >::max();
+    }
+
+    bandFirst.resize( lengthA );
+    bandLast.resize( lengthA );
+    for(UINT i=0; i<lengthA; i++){
+        getBand( i, lengthA, lengthB, bandFirst[i], bandLast[i] );
+    }
+
+    if( !findPath( a, lengthA, b, lengthB, &bandFirst[0], &bandLast[0] ) ){
+        return grt_numeric_limits< float >::max();
+    }
+
+    //The path was found from the end, so reverse it
+    pathA.assign( pathRows.rbegin(), pathRows.rend() );
+    pathB.assign( pathColumns.rbegin(), pathColumns.rend() );
+
+    return costs[ rowOffsets[lengthA]-1 ] / (lengthA + lengthB);
+}
+
+float ofxGrtDTWDistance::accumulate( const float *a, const UINT lengthA, const float *b, const UINT lengthB, const UINT *windowFirst, const UINT *windowLast, const float abandonThreshold, bool *abandoned ){
+
+    const float INF = grt_numeric_limits< float >::max();
+    const float norm = (float)(lengthA + lengthB);
+    const float abandonCost = abandonThreshold < INF / norm ? abandonThreshold * norm : INF;
+
+    if( previousRow.size() < lengthB ){
+        previousRow.resize( lengthB );
+        currentRow.resize( lengthB );
+    }
+
+    //The columns of the previous row outside [previousFirst previousLast] are treated as infinite
+    UINT previousFirst = 1;
+    UINT previousLast = 0;
+
+    for(UINT i=0; i<lengthA; i++){
+        UINT first = 0, last = 0;
+        if( windowFirst ){
+            first = windowFirst[i];
+            last = windowLast[i];
+        }else getBand( i, lengthA, lengthB, first, last );
+
+        const float *x = a + (size_t)i * numDimensions;
+        float rowMin = INF;
+        float left = INF;
+        for(UINT j=first; j<=last; j++){
+            const float cost = sqrt( ofxGrtSimd::squaredDistance( x, b + (size_t)j * numDimensions, numDimensions ) );
+            const float up = j >= previousFirst && j <= previousLast ? previousRow[j] : INF;
+            const float diagonal = j > 0 && j-1 >= previousFirst && j-1 <= previousLast ? previousRow[j-1] : INF;
+            float best = std::min( left, std::min( up, diagonal ) );
+            if( i == 0 && j == 0 ) best = 0;
+            const float value = best < INF ? best + cost : INF;
+            currentRow[j] = value;
+            left = value;
+            if( value < rowMin ) rowMin = value;
+        }
+
+        //Every path crosses this row, so its smallest cost is a lower bound of the final cost
+        if( rowMin > abandonCost ){
+            if( abandoned ) *abandoned = true;
+            return rowMin / norm;
+        }
+
+        std::swap( previousRow, currentRow );
+        previousFirst = first;
+        previousLast = last;
+    }
+
+    const float cost = previousLast == lengthB-1 ? previousRow[ lengthB-1 ] : INF;
+    return cost < INF ? cost / norm : INF;
+}
+
+bool ofxGrtDTWDistance::findPath( const float *a, const UINT lengthA, const float *b, const UINT lengthB, const UINT *first, const UINT *last ){
+
+    const float INF = grt_numeric_limits< float >::max();
+
+    //Store the accumulated cost of every cell in the window, row by row
+    rowOffsets.resize( lengthA+1 );
+    rowOffsets[0] = 0;
+    for(UINT i=0; i<lengthA; i++){
+        rowOffsets[i+1] = rowOffsets[i] + (last[i] - first[i] + 1);
+    }
+    costs.resize( rowOffsets[lengthA] );
+
+    for(UINT i=0; i<lengthA; i++){
+        const float *x = a + (size_t)i * numDimensions;
+        float *row = &costs[ rowOffsets[i] ] - first[i];
+        const float *previous = i > 0 ? &costs[ rowOffsets[i-1] ] - first[i-1] : NULL;
+        float left = INF;
+        for(UINT j=first[i]; j<=last[i]; j++){
+            const float cost = sqrt( ofxGrtSimd::squaredDistance( x, b + (size_t)j * numDimensions, numDimensions ) );
+            float best = left;
+            if( previous ){
+                if( j >= first[i-1] && j <= last[i-1] ) best = std::min( best, previous[j] );
+                if( j > 0 && j-1 >= first[i-1] && j-1 <= last[i-1] ) best = std::min( best, previous[j-1] );
+            }
+            if( i == 0 && j == 0 ) best = 0;
+            row[j] = best < INF ? best + cost : INF;
+            left = row[j];
+        }
+    }
+
+    if( last[lengthA-1] != lengthB-1 || costs[ rowOffsets[lengthA]-1 ] >= INF ){
+        return false;
+    }
+
+    //Walk back from the end, preferring the diagonal when steps tie
+    pathRows.clear();
+    pathColumns.clear();
+    UINT i = lengthA-1;
+    UINT j = lengthB-1;
+    while( true ){
+        pathRows.push_back( i );
+        pathColumns.push_back( j );
+        if( i == 0 && j == 0 ) break;
+
+        float diagonal = INF, up = INF, left = INF;
+        if( i > 0 && j > 0 && j-1 >= first[i-1] && j-1 <= last[i-1] ) diagonal = costs[ rowOffsets[i-1] + j-1 - first[i-1] ];
+        if( i > 0 && j >= first[i-1] && j <= last[i-1] ) up = costs[ rowOffsets[i-1] + j - first[i-1] ];
+        if( j > first[i] ) left = costs[ rowOffsets[i] + j-1 - first[i] ];
+
+        if( diagonal <= up && diagonal <= left ){ i--; j--; }
+        else if( up <= left ){ i--; }
+        else j--;
+    }
+
+    return true;
+}
+
+void ofxGrtDTWDistance::projectPath( Level &level ){
+
+    const UINT lengthA = level.lengthA;
+    const UINT lengthB = level.lengthB;
+
+    //Each coarse cell covers a 2x2 block of the finer level
+    level.first.assign( lengthA, lengthB );
+    level.last.assign( lengthA, 0 );
+    for(size_t k=0; k<pathRows.size(); k++){
+        const UINT firstColumn = std::min( 2*pathColumns[k], lengthB-1 );
+        const UINT lastColumn = std::min( 2*pathColumns[k]+1, lengthB-1 );
+        for(UINT i=2*pathRows[k]; i<=2*pathRows[k]+1 && i<lengthA; i++){
+            level.first[i] = std::min( level.first[i], firstColumn );
+            level.last[i] = std::max( level.last[i], lastColumn );
+        }
+    }
+
+    //Widen the window by the radius in both directions
+    if( fastRadius == 0 ) return;
+
+    projectedFirst = level.first;
+    projectedLast = level.last;
+    for(UINT i=0; i<lengthA; i++){
+        const UINT begin = i > fastRadius ? i - fastRadius : 0;
+        const UINT end = std::min( i + fastRadius, lengthA-1 );
+        UINT first = lengthB;
+        UINT last = 0;
+        for(UINT k=begin; k<=end; k++){
+            first = std::min( first, projectedFirst[k] );
+            last = std::max( last, projectedLast[k] );
+        }
+        level.first[i] = first > fastRadius ? first - fastRadius : 0;
+        level.last[i] = std::min( last + fastRadius, lengthB-1 );
+    }
+}
+
+void ofxGrtDTWDistance::coarsen( const float *x, const UINT length, vector< float > &coarse ) const {
+
+    const UINT coarseLength = (length+1) / 2;
+    coarse.resize( (size_t)coarseLength * numDimensions );
+    for(UINT i=0; i<coarseLength; i++){
+        const float *x0 = x + (size_t)(2*i) * numDimensions;
+        const float *x1 = 2*i+1 < length ? x0 + numDimensions : x0;
+        float *y = &coarse[ (size_t)i * numDimensions ];
+        for(UINT n=0; n<numDimensions; n++){
+            y[n] = 0.5f * (x0[n] + x1[n]);
+        }
+    }
+}
@@ -0,0 +1,134 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+
+using namespace GRT;
+
+/**
+ @brief computes the dynamic time warping distance between two multidimensional time series, each stored row by row (one frame of
+ numDimensions values per row) in a float array. The local cost is the euclidean distance between two frames, and the distance is the minimum
+ accumulated cost of a warping path divided by the sum of the two lengths, so series of different lengths can be compared. The warping path
+ can be constrained to a band around the diagonal (a Sakoe-Chiba band) whose half width is a fraction of the longer series.
+
+ The cost is accumulated one row of the cost matrix at a time, keeping only two rows, and because every warping path crosses every row
+ the smallest accumulated cost in a row is a lower bound of the distance. If an abandon threshold is given, the computation stops as soon as this
+ lower bound is above the threshold, which is much faster when the caller only needs to know whether the distance is below a bound.
+
+ For long series the distance can be approximated with FastDTW (Salvador and Chan, 2007): both series are repeatedly halved in length by
+ averaging neighbouring frames, the warping path is found at the lowest resolution, and at each finer resolution the cost is only accumulated
+ inside a window around the projected path, widened by fastRadius frames. This takes time linear in the length of the series rather than
+ quadratic, and the result is never below the exact (unconstrained) distance. A larger radius gives a closer approximation but is slower.
+ FastDTW uses its own window, so the band constraint is not used in FAST_DTW mode.
+
+ The rows are reused between calls, so use one ofxGrtDTWDistance per thread.
+*/
+class ofxGrtDTWDistance {
+public:
+    enum Mode{ EXACT_DTW=0, FAST_DTW };
+
+    ofxGrtDTWDistance();
+    ~ofxGrtDTWDistance();
+
+    /**
+     @brief sets the size of the frames and the warping constraint
+     @param numDimensions: the number of values in each frame
+     @param constrainWarpingPath: if true the warping path is constrained to a band around the diagonal
+     @param warpingRadius: the half width of the band, as a fraction of the length of the longer series, in the range [0 1]
+     @return returns true if the distance was setup successfully, false otherwise
+    */
+    bool setup( const UINT numDimensions, const bool constrainWarpingPath = true, const Float warpingRadius = 0.2 );
+
+    /**
+     @brief sets how the distance is computed
+     @param mode: EXACT_DTW computes the exact (banded) distance, FAST_DTW approximates it with FastDTW
+     @param fastRadius: the number of frames the FastDTW window is widened by at each resolution
+     @return returns true if the mode was set successfully, false otherwise
+    */
+    bool setMode( const Mode mode, const UINT fastRadius = 10 );
+
+    /**
+     @brief computes the distance between two series
+     @param a: the first series [lengthA x numDimensions]
+     @param lengthA: the number of frames in the first series
+     @param b: the second series [lengthB x numDimensions]
+     @param lengthB: the number of frames in the second series
+     @param abandonThreshold: if the distance is found to be above this value the computation stops early
+     @param abandoned: if not NULL this is set to true if the computation stopped early, in which case the returned value is a lower bound of the distance (above the threshold)
+     @return returns the distance, or the largest float value if either series is empty
+    */
+    float compute( const float *a, const UINT lengthA, const float *b, const UINT lengthB, const float abandonThreshold = grt_numeric_limits< float >::max(), bool *abandoned = NULL );
+
+    /**
+     @brief computes the exact (banded) distance between two series and its warping path, this ignores the mode and can not be abandoned
+     @param pathA: the frames of the first series along the path, from the first frame to the last
+     @param pathB: the matching frames of the second series
+     @return returns the distance, or the largest float value if either series is empty
+    */
+    float computePath( const float *a, const UINT lengthA, const float *b, const UINT lengthB, vector< UINT > &pathA, vector< UINT > &pathB );
+
+    UINT getNumDimensions() const { return numDimensions; }
+    bool getConstrainWarpingPath() const { return constrainWarpingPath; }
+    Float getWarpingRadius() const { return warpingRadius; }
+    Mode getMode() const { return mode; }
+    UINT getFastRadius() const { return fastRadius; }
+
+    /**
+     @brief gets the range of columns of the cost matrix that row i may use
+    */
+    void getBand( const UINT i, const UINT lengthA, const UINT lengthB, UINT &first, UINT &last ) const;
+
+protected:
+    struct Level{
+        UINT lengthA;
+        UINT lengthB;
+        vector< float > a;          ///< The coarse series, empty for the full resolution level which uses the inputs
+        vector< float > b;
+        vector< UINT > first;       ///< The first column of the window in each row
+        vector< UINT > last;        ///< The last column of the window in each row
+    };
+
+    float accumulate( const float *a, const UINT lengthA, const float *b, const UINT lengthB, const UINT *first, const UINT *last, const float abandonThreshold, bool *abandoned );
+    bool findPath( const float *a, const UINT lengthA, const float *b, const UINT lengthB, const UINT *first, const UINT *last );
+    void projectPath( Level &level );
+    void coarsen( const float *x, const UINT length, vector< float > &coarse ) const;
+
+    UINT numDimensions;
+    bool constrainWarpingPath;
+    Float warpingRadius;
+    Mode mode;
+    UINT fastRadius;
+    vector< float > previousRow;
+    vector< float > currentRow;
+
+    //The FastDTW levels (finest first), the cost of the window of one level and the path found in it
+    vector< Level > levels;
+    vector< float > costs;
+    vector< size_t > rowOffsets;
+    vector< UINT > pathRows;
+    vector< UINT > pathColumns;
+    vector< UINT > projectedFirst;
+    vector< UINT > projectedLast;
+    vector< UINT > bandFirst;
+    vector< UINT > bandLast;
+};
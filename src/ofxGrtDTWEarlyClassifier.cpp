@@ -0,0 +1,241 @@
+
+#include "ofxGrtDTWEarlyClassifier.h"
+#include "ofxGrtSimd.h"
+
+using namespace GRT;
+
+ofxGrtDTWEarlyClassifier::ofxGrtDTWEarlyClassifier(){
+    numDimensions = 0;
+    numClasses = 0;
+    useScaling = false;
+    offsetUsingFirstSample = false;
+    marginThreshold = 0.3;
+    minPrefixFraction = 0.2;
+    minNumFrames = 1;
+    numFrames = 0;
+    decided = false;
+    provisionalClassLabel = 0;
+    decisionFrame = 0;
+    margin = 0;
+    errorLog.setProceedingText("[ERROR ofxGrtDTWEarlyClassifier]");
+}
+
+ofxGrtDTWEarlyClassifier::~ofxGrtDTWEarlyClassifier(){
+}
+
+bool ofxGrtDTWEarlyClassifier::setup( const ofxGrtDTW &dtw, const Float marginThreshold, const Float minPrefixFraction ){
+
+    templates.clear();
+    numDimensions = 0;
+
+    if( !dtw.getTrained() || dtw.getNumTemplates() == 0 ){
+        errorLog << "setup(const ofxGrtDTW &dtw, ...) - The classifier has not been trained!" << endl;
+        return false;
+    }
+
+    if( !setMarginThreshold( marginThreshold ) || !setMinPrefixFraction( minPrefixFraction ) ){
+        return false;
+    }
+
+    numDimensions = dtw.getNumInputDimensions();
+    classLabels = dtw.getClassLabels();
+    numClasses = (UINT)classLabels.size();
+    useScaling = dtw.getScalingEnabled();
+    offsetUsingFirstSample = dtw.getOffsetTimeseriesUsingFirstSample();
+    ranges = dtw.getRanges();
+
+    templates.resize( dtw.getNumTemplates() );
+    for(UINT k=0; k<templates.size(); k++){
+        const MatrixFloat data = dtw.getTemplate( k );
+        Template &t = templates[k];
+        t.classIndex = 0;
+        while( t.classIndex < numClasses && classLabels[ t.classIndex ] != dtw.getTemplateClassLabel( k ) ) t.classIndex++;
+        t.length = data.getNumRows();
+        if( t.classIndex == numClasses || t.length == 0 ){
+            errorLog << "setup(const ofxGrtDTW &dtw, ...) - Template " << k << " is empty or has an unknown class label!" << endl;
+            templates.clear();
+            numDimensions = 0;
+            return false;
+        }
+        t.data.resize( (size_t)t.length * numDimensions );
+        for(UINT i=0; i<t.length; i++){
+            for(UINT j=0; j<numDimensions; j++) t.data[ (size_t)i*numDimensions + j ] = (float)data[i][j];
+        }
+    }
+
+    firstFrame.resize( numDimensions );
+    frame.resize( numDimensions );
+
+    return reset();
+}
+
+bool ofxGrtDTWEarlyClassifier::update( const VectorFloat &sample ){
+
+    if( templates.size() == 0 ){
+        errorLog << "update(const VectorFloat &sample) - The classifier has not been setup!" << endl;
+        return false;
+    }
+
+    if( sample.size() != numDimensions ){
+        errorLog << "update(const VectorFloat &sample) - The size of the sample (" << sample.size() << ") does not match the number of dimensions (" << numDimensions << ")" << endl;
+        return false;
+    }
+
+    //Scale the frame and offset it by the first frame of the gesture, as the classifier does with whole series
+    for(UINT j=0; j<numDimensions; j++){
+        Float value = sample[j];
+        if( useScaling ){
+            value = ranges[j].minValue == ranges[j].maxValue ? 0 : (value - ranges[j].minValue) / (ranges[j].maxValue - ranges[j].minValue);
+        }
+        frame[j] = (float)value;
+    }
+    if( offsetUsingFirstSample ){
+        if( numFrames == 0 ) firstFrame = frame;
+        for(UINT j=0; j<numDimensions; j++) frame[j] -= firstFrame[j];
+    }
+
+    //Add one column to the cost matrix of each template, keeping the best prefix of each class
+    const float INF = grt_numeric_limits< float >::max();
+    std::fill( classDistances.begin(), classDistances.end(), grt_numeric_limits< Float >::max() );
+    for(size_t k=0; k<templates.size(); k++){
+        Template &t = templates[k];
+        float diagonal = 0;
+        float left = INF;
+        float bestPrefix = INF;
+        for(UINT i=0; i<t.length; i++){
+            const float up = t.costs[i];
+            float best = std::min( left, up );
+            if( i > 0 || numFrames == 0 ) best = std::min( best, diagonal );
+            const float cost = sqrt( ofxGrtSimd::squaredDistance( &frame[0], &t.data[ (size_t)i * numDimensions ], numDimensions ) );
+            const float value = best < INF ? best + cost : INF;
+            diagonal = up;
+            t.costs[i] = value;
+            left = value;
+            if( value < INF ) bestPrefix = std::min( bestPrefix, value / (numFrames + 1 + i + 1) );
+        }
+        if( bestPrefix < classDistances[ t.classIndex ] ) classDistances[ t.classIndex ] = bestPrefix;
+    }
+    numFrames++;
+
+    //The relative margin between the two closest classes, two classes that both match exactly are tied rather than far apart
+    UINT best = 0, second = numClasses > 1 ? 1 : 0;
+    if( numClasses > 1 && classDistances[ second ] < classDistances[ best ] ) std::swap( best, second );
+    for(UINT k=2; k<numClasses; k++){
+        if( classDistances[k] < classDistances[ best ] ){ second = best; best = k; }
+        else if( classDistances[k] < classDistances[ second ] ) second = k;
+    }
+    if( numClasses > 1 ) margin = classDistances[ second ] > 0 ? (classDistances[ second ] - classDistances[ best ]) / classDistances[ second ] : 0;
+    else margin = 1;
+
+    if( !decided && numFrames >= minNumFrames && margin >= marginThreshold ){
+        decided = true;
+        provisionalClassLabel = classLabels[ best ];
+        decisionFrame = numFrames;
+    }
+
+    return decided;
+}
+
+bool ofxGrtDTWEarlyClassifier::reset(){
+
+    const float INF = grt_numeric_limits< float >::max();
+    Float meanLength = 0;
+    for(size_t k=0; k<templates.size(); k++){
+        templates[k].costs.assign( templates[k].length, INF );
+        meanLength += templates[k].length;
+    }
+    if( templates.size() > 0 ) meanLength /= templates.size();
+    minNumFrames = std::max( 1u, (UINT)ceil( minPrefixFraction * meanLength ) );
+
+    classDistances.assign( numClasses, 0 );
+    numFrames = 0;
+    decided = false;
+    provisionalClassLabel = 0;
+    decisionFrame = 0;
+    margin = 0;
+
+    return true;
+}
+
+UINT ofxGrtDTWEarlyClassifier::getFinalClassLabel() const {
+
+    if( numFrames == 0 || templates.size() == 0 ) return 0;
+
+    UINT best = 0;
+    float bestDistance = grt_numeric_limits< float >::max();
+    for(size_t k=0; k<templates.size(); k++){
+        const Template &t = templates[k];
+        const float cost = t.costs[ t.length-1 ];
+        if( cost < grt_numeric_limits< float >::max() && cost / (numFrames + t.length) < bestDistance ){
+            bestDistance = cost / (numFrames + t.length);
+            best = t.classIndex;
+        }
+    }
+
+    return classLabels[ best ];
+}
+
+bool ofxGrtDTWEarlyClassifier::evaluate( const TimeSeriesClassificationData &data, EvaluationResult &result ){
+
+    result.numSamples = 0;
+    result.numEarlyDecisions = 0;
+    result.numEarlyCorrect = 0;
+    result.numFinalCorrect = 0;
+    result.meanDecisionFraction = 0;
+
+    if( templates.size() == 0 ){
+        errorLog << "evaluate(...) - The classifier has not been setup!" << endl;
+        return false;
+    }
+
+    if( data.getNumDimensions() != numDimensions ){
+        errorLog << "evaluate(...) - The number of dimensions of the data (" << data.getNumDimensions() << ") does not match the classifier (" << numDimensions << ")" << endl;
+        return false;
+    }
+
+    VectorFloat sample( numDimensions );
+    for(UINT i=0; i<data.getNumSamples(); i++){
+        const MatrixFloat &series = data[i].getData();
+        const UINT length = series.getNumRows();
+        if( length == 0 ) continue;
+
+        reset();
+        for(UINT n=0; n<length; n++){
+            for(UINT j=0; j<numDimensions; j++) sample[j] = series[n][j];
+            update( sample );
+        }
+
+        const UINT classLabel = data[i].getClassLabel();
+        const UINT finalClassLabel = getFinalClassLabel();
+        const bool early = decided && decisionFrame < length;
+        if( early ) result.numEarlyDecisions++;
+        if( (early ? provisionalClassLabel : finalClassLabel) == classLabel ) result.numEarlyCorrect++;
+        if( finalClassLabel == classLabel ) result.numFinalCorrect++;
+        result.meanDecisionFraction += early ? (double)decisionFrame / length : 1.0;
+        result.numSamples++;
+    }
+
+    if( result.numSamples > 0 ) result.meanDecisionFraction /= result.numSamples;
+
+    reset();
+
+    return true;
+}
+
+bool ofxGrtDTWEarlyClassifier::setMarginThreshold( const Float marginThreshold ){
+    if( marginThreshold < 0 || marginThreshold > 1 ){
+        errorLog << "setMarginThreshold(const Float marginThreshold) - The margin threshold must be in the range [0 1]!" << endl;
+        return false;
+    }
+    this->marginThreshold = marginThreshold;
+    return true;
+}
+
+bool ofxGrtDTWEarlyClassifier::setMinPrefixFraction( const Float minPrefixFraction ){
+    if( minPrefixFraction < 0 ){
+        errorLog << "setMinPrefixFraction(const Float minPrefixFraction) - The fraction must be positive!" << endl;
+        return false;
+    }
+    this->minPrefixFraction = minPrefixFraction;
+    return true;
+}
@@ -0,0 +1,151 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+#include "ofxGrtDTW.h"
+
+using namespace GRT;
+
+/**
+ @brief gives an early, provisional label for a gesture while it is still being performed, using the templates of a trained ofxGrtDTW.
+ Call reset() when a gesture starts and update() with each new frame. Each frame extends the DTW alignment between the gesture so far and
+ every template by one column of the cost matrix (in O(template length)), so the cost of aligning the gesture so far with every prefix of
+ every template is known. The partial distance of a template is the smallest of these costs divided by the sum of the two lengths, and the
+ partial distance of a class is the smallest of its templates.
+
+ Once at least minPrefixFraction of the mean template length has been seen, the classifier decides as soon as the relative margin between the
+ best and second best classes, (second - best) / second, reaches marginThreshold. The decision is kept until the next reset, while
+ getFinalClassLabel gives the label of the full alignment (with the end of every template) for the frames so far. evaluate() runs every
+ sample of a dataset through the early classifier and reports how much of each gesture was needed and how often the early label was right.
+
+ The partial alignments are always exact and unconstrained, so they can differ from the distances of the ofxGrtDTW they were setup from. The
+ classifier's warping band follows the diagonal from the start to the end of both series, and FastDTW coarsens the whole series, so neither
+ can be applied before the gesture has ended and its length is known. getFinalClassLabel can therefore differ from the label ofxGrtDTW gives
+ the whole gesture when the classifier constrains the warping path or uses FastDTW.
+*/
+class ofxGrtDTWEarlyClassifier {
+public:
+    struct EvaluationResult{
+        UINT numSamples;
+        UINT numEarlyDecisions;         ///< The number of samples that were decided before their last frame
+        UINT numEarlyCorrect;           ///< The number of samples whose early label (or final label, if there was no early decision) was right
+        UINT numFinalCorrect;           ///< The number of samples whose label after the last frame was right
+        double meanDecisionFraction;    ///< The mean fraction of each sample seen when it was decided, 1 for samples decided at the end
+
+        double getEarlyAccuracy() const { return numSamples > 0 ? (double)numEarlyCorrect / numSamples : 0; }
+        double getFinalAccuracy() const { return numSamples > 0 ? (double)numFinalCorrect / numSamples : 0; }
+    };
+
+    ofxGrtDTWEarlyClassifier();
+    ~ofxGrtDTWEarlyClassifier();
+
+    /**
+     @brief copies the templates and scaling of a trained classifier and resets the gesture
+     @param dtw: the trained classifier
+     @param marginThreshold: the relative margin between the best and second best classes needed to decide, in the range [0 1]
+     @param minPrefixFraction: the fraction of the mean template length that must be seen before deciding
+     @return returns true if the classifier was setup successfully, false otherwise
+    */
+    bool setup( const ofxGrtDTW &dtw, const Float marginThreshold = 0.3, const Float minPrefixFraction = 0.2 );
+
+    /**
+     @brief adds the next frame of the current gesture
+     @param sample: the new frame, the size must match the number of dimensions of the classifier
+     @return returns true if the gesture has been decided (on this or an earlier frame), false otherwise
+    */
+    bool update( const VectorFloat &sample );
+
+    /**
+     @brief starts a new gesture
+     @return returns true if the classifier was reset successfully, false otherwise
+    */
+    bool reset();
+
+    /**
+     @brief classifies every sample of a dataset frame by frame, and compares the early labels with the labels of the whole samples
+     @param data: the labelled samples, with the same number of dimensions as the classifier
+     @param result: the decision times and accuracies
+     @return returns true if the evaluation was run successfully, false otherwise
+    */
+    bool evaluate( const TimeSeriesClassificationData &data, EvaluationResult &result );
+
+    bool setMarginThreshold( const Float marginThreshold );
+    bool setMinPrefixFraction( const Float minPrefixFraction );
+
+    Float getMarginThreshold() const { return marginThreshold; }
+    Float getMinPrefixFraction() const { return minPrefixFraction; }
+    bool getDecided() const { return decided; }
+
+    /**
+     @brief gets the early label, or zero if the gesture has not been decided yet
+    */
+    UINT getProvisionalClassLabel() const { return decided ? provisionalClassLabel : 0; }
+
+    /**
+     @brief gets the number of frames that had been seen when the gesture was decided
+    */
+    UINT getDecisionFrame() const { return decisionFrame; }
+
+    /**
+     @brief gets the label of the class whose templates best match the frames so far from start to end
+    */
+    UINT getFinalClassLabel() const;
+
+    UINT getNumFrames() const { return numFrames; }
+    Float getMargin() const { return margin; }
+
+    /**
+     @brief gets the partial distance of each class (in the order of the classifier's class labels)
+    */
+    const VectorFloat &getClassDistances() const { return classDistances; }
+
+protected:
+    struct Template{
+        UINT classIndex;
+        UINT length;
+        vector< float > data;       ///< [length x numDimensions]
+        vector< float > costs;      ///< The accumulated cost of aligning the frames so far with each prefix of the template
+    };
+
+    UINT numDimensions;
+    UINT numClasses;
+    Vector< UINT > classLabels;
+    bool useScaling;
+    bool offsetUsingFirstSample;
+    Vector< MinMax > ranges;
+    Float marginThreshold;
+    Float minPrefixFraction;
+    UINT minNumFrames;
+    vector< Template > templates;
+
+    UINT numFrames;
+    bool decided;
+    UINT provisionalClassLabel;
+    UINT decisionFrame;
+    Float margin;
+    VectorFloat classDistances;
+    vector< float > firstFrame;
+    vector< float > frame;
+
+    ErrorLog errorLog;
+};
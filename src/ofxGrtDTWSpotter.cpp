@@ -0,0 +1,210 @@
+
+#include "ofxGrtDTWSpotter.h"
+#include "ofxGrtSimd.h"
+
+using namespace GRT;
+
+ofxGrtDTWSpotter::ofxGrtDTWSpotter(){
+    numDimensions = 0;
+    maxMatchLength = 0;
+    useScaling = false;
+    offsetUsingFirstSample = false;
+    frameCount = 0;
+    nextMatch = 0;
+    errorLog.setProceedingText("[ERROR ofxGrtDTWSpotter]");
+}
+
+ofxGrtDTWSpotter::~ofxGrtDTWSpotter(){
+}
+
+bool ofxGrtDTWSpotter::setup( const ofxGrtDTW &dtw, const UINT maxMatchLength ){
+
+    clear();
+
+    if( !dtw.getTrained() ){
+        errorLog << "setup(const ofxGrtDTW &dtw, const UINT maxMatchLength) - The classifier has not been trained!" << endl;
+        return false;
+    }
+
+    const UINT K = dtw.getNumTemplates();
+    numDimensions = dtw.getNumInputDimensions();
+    useScaling = dtw.getScalingEnabled();
+    offsetUsingFirstSample = dtw.getOffsetTimeseriesUsingFirstSample();
+    ranges = dtw.getRanges();
+
+    UINT maxLength = 0;
+    templates.resize( K );
+    for(UINT k=0; k<K; k++){
+        const MatrixFloat data = dtw.getTemplate( k );
+        Template &t = templates[k];
+        t.classLabel = dtw.getTemplateClassLabel( k );
+        t.length = data.getNumRows();
+        if( t.length == 0 ){
+            errorLog << "setup(const ofxGrtDTW &dtw, const UINT maxMatchLength) - The template of class " << t.classLabel << " is empty!" << endl;
+            clear();
+            return false;
+        }
+        t.data.resize( (size_t)t.length * numDimensions );
+        for(UINT i=0; i<t.length; i++){
+            for(UINT j=0; j<numDimensions; j++) t.data[ (size_t)i*numDimensions + j ] = (float)data[i][j];
+        }
+
+        t.threshold = (float)dtw.getTemplateThreshold( k );
+        maxLength = std::max( maxLength, t.length );
+    }
+
+    this->maxMatchLength = maxMatchLength > 0 ? maxMatchLength : 2 * maxLength;
+
+    history.assign( (size_t)this->maxMatchLength * numDimensions, 0 );
+    offsetFrame.resize( numDimensions );
+
+    return reset();
+}
+
+UINT ofxGrtDTWSpotter::update( const VectorFloat &sample ){
+
+    if( templates.size() == 0 ){
+        errorLog << "update(const VectorFloat &sample) - The spotter has not been setup!" << endl;
+        return 0;
+    }
+
+    if( sample.size() != numDimensions ){
+        errorLog << "update(const VectorFloat &sample) - The size of the sample (" << sample.size() << ") does not match the number of dimensions (" << numDimensions << ")" << endl;
+        return 0;
+    }
+
+    //Drop the matches that have been read
+    if( nextMatch == matches.size() ){
+        matches.clear();
+        nextMatch = 0;
+    }
+    const size_t numMatches = matches.size();
+
+    //Scale the frame into the history, the paths read their first frame from here
+    float *x = &history[ (size_t)(frameCount % maxMatchLength) * numDimensions ];
+    for(UINT j=0; j<numDimensions; j++){
+        Float value = sample[j];
+        if( useScaling ){
+            value = ranges[j].minValue == ranges[j].maxValue ? 0 : (value - ranges[j].minValue) / (ranges[j].maxValue - ranges[j].minValue);
+        }
+        x[j] = (float)value;
+    }
+
+    for(size_t k=0; k<templates.size(); k++){
+        updateTemplate( templates[k], x );
+    }
+
+    frameCount++;
+
+    return (UINT)(matches.size() - numMatches);
+}
+
+void ofxGrtDTWSpotter::updateTemplate( Template &t, const float *x ){
+
+    const float INF = grt_numeric_limits< float >::max();
+    const uint64_t frame = frameCount;
+    const UINT N = numDimensions;
+
+    //Update the column in place, a path can start at this frame from any template frame before the first (with zero cost)
+    float left = 0, diagonal = 0;
+    uint64_t leftStart = frame, diagonalStart = frame;
+    for(UINT i=0; i<t.length; i++){
+        const float up = t.costs[i];
+        const uint64_t upStart = t.starts[i];
+
+        float best = diagonal;
+        uint64_t bestStart = diagonalStart;
+        if( left < best ){ best = left; bestStart = leftStart; }
+        if( up < best ){ best = up; bestStart = upStart; }
+
+        float value = INF;
+        if( best < INF && frame - bestStart < maxMatchLength ){
+            const float *y = &t.data[ (size_t)i * N ];
+            float squaredCost = 0;
+            if( offsetUsingFirstSample ){
+                const float *first = &history[ (size_t)(bestStart % maxMatchLength) * N ];
+                for(UINT j=0; j<N; j++) offsetFrame[j] = x[j] - first[j];
+                squaredCost = ofxGrtSimd::squaredDistance( &offsetFrame[0], y, N );
+            }else squaredCost = ofxGrtSimd::squaredDistance( x, y, N );
+            value = best + sqrt( squaredCost );
+        }
+
+        diagonal = up;
+        diagonalStart = upStart;
+        t.costs[i] = value;
+        t.starts[i] = bestStart;
+        left = value;
+        leftStart = bestStart;
+    }
+
+    //Report the best match once no growing path that overlaps it can beat it, and stop those paths so the match is only reported once
+    if( t.bestCost < INF ){
+        bool finished = true;
+        for(UINT i=0; i<t.length && finished; i++){
+            if( t.costs[i] < t.bestCost && t.starts[i] <= t.bestEnd ) finished = false;
+        }
+        if( finished ){
+            Match match;
+            match.classLabel = t.classLabel;
+            match.startFrame = t.bestStart;
+            match.endFrame = t.bestEnd;
+            match.distance = t.bestCost / (t.length + (t.bestEnd - t.bestStart + 1));
+            matches.push_back( match );
+
+            for(UINT i=0; i<t.length; i++){
+                if( t.starts[i] <= t.bestEnd ) t.costs[i] = INF;
+            }
+            t.bestCost = INF;
+        }
+    }
+
+    //The threshold is on the classifier's distance, the accumulated cost divided by the sum of the template and match lengths
+    const float cost = t.costs[ t.length-1 ];
+    if( cost < t.bestCost && cost < INF && cost <= t.threshold * (t.length + (frame - t.starts[ t.length-1 ] + 1)) ){
+        t.bestCost = cost;
+        t.bestStart = t.starts[ t.length-1 ];
+        t.bestEnd = frame;
+    }
+}
+
+bool ofxGrtDTWSpotter::popMatch( Match &match ){
+
+    if( nextMatch >= matches.size() ) return false;
+
+    match = matches[ nextMatch++ ];
+
+    return true;
+}
+
+bool ofxGrtDTWSpotter::reset(){
+
+    const float INF = grt_numeric_limits< float >::max();
+    for(size_t k=0; k<templates.size(); k++){
+        Template &t = templates[k];
+        t.costs.assign( t.length, INF );
+        t.starts.assign( t.length, 0 );
+        t.bestCost = INF;
+        t.bestStart = 0;
+        t.bestEnd = 0;
+    }
+
+    frameCount = 0;
+    matches.clear();
+    nextMatch = 0;
+
+    return true;
+}
+
+bool ofxGrtDTWSpotter::clear(){
+
+    numDimensions = 0;
+    maxMatchLength = 0;
+    useScaling = false;
+    offsetUsingFirstSample = false;
+    ranges.clear();
+    templates.clear();
+    history.clear();
+    offsetFrame.clear();
+
+    return reset();
+}
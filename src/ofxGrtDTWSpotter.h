@@ -0,0 +1,131 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <stdint.h>
+
+#include "ofMain.h"
+#include "ofxGrtDTW.h"
+
+using namespace GRT;
+
+/**
+ @brief spots the gestures of a trained ofxGrtDTW in a continuous stream with subsequence DTW (the SPRING algorithm, Sakurai et al., 2007).
+ Rather than re-aligning a buffer of recent samples against each template every frame, the spotter keeps one column of the accumulated cost
+ matrix per template, and each new frame updates it in O(template length). Every cell remembers the frame its warping path started at, so a
+ match can start at any frame. A match is reported as soon as no path that is still growing could overlap it with a lower cost, which is
+ usually a few frames after the gesture ends, rather than once the buffer has been filled.
+
+ As in ofxGrtDTW, the distance of a match is its accumulated cost divided by the sum of the template and match lengths, and a match is only
+ kept if this is below the null rejection threshold of its template (see ofxGrtDTW::getTemplateThreshold). Overlapping matches are
+ compared by their accumulated cost, as in SPRING. Matches are limited to maxMatchLength frames. If the classifier offsets its series
+ by their first sample, each path offsets the frames by the frame it started at, using a history of the last maxMatchLength frames.
+
+ The alignments are always exact and unconstrained. The classifier's warping band follows the diagonal from the start to the end of both
+ series, and the start and length of a match are only known once it has been found, so the band cannot be applied while the columns are
+ updated; FastDTW cannot be applied to a stream either. If the classifier constrains the warping path or uses FastDTW, its thresholds were
+ computed from distances that are never lower than the exact ones, so the spotter will accept some matches that ofxGrtDTW would reject.
+ Lower the null rejection coefficient of the classifier before setup to compensate.
+*/
+class ofxGrtDTWSpotter {
+public:
+    struct Match{
+        UINT classLabel;
+        uint64_t startFrame;    ///< The index of the first frame of the match, counted from setup or reset
+        uint64_t endFrame;      ///< The index of the last frame of the match
+        Float distance;
+    };
+
+    ofxGrtDTWSpotter();
+    ~ofxGrtDTWSpotter();
+
+    /**
+     @brief copies the templates, thresholds and scaling of a trained classifier and resets the stream
+     @param dtw: the trained classifier
+     @param maxMatchLength: the maximum length of a match in frames, if zero this is twice the length of the longest template
+     @return returns true if the spotter was setup successfully, false otherwise
+    */
+    bool setup( const ofxGrtDTW &dtw, const UINT maxMatchLength = 0 );
+
+    /**
+     @brief adds the next frame of the stream, any completed matches can then be read with popMatch
+     @param sample: the new frame, the size must match the number of dimensions of the classifier
+     @return returns the number of new matches
+    */
+    UINT update( const VectorFloat &sample );
+
+    /**
+     @brief gets the oldest match that has not been read yet
+     @param match: the match will be copied into this
+     @return returns true if a match was available, false otherwise
+    */
+    bool popMatch( Match &match );
+
+    /**
+     @brief removes the partial matches and any unread matches, the frames are counted from zero again
+     @return returns true if the spotter was reset successfully, false otherwise
+    */
+    bool reset();
+
+    /**
+     @brief removes the templates
+     @return returns true if the spotter was cleared successfully, false otherwise
+    */
+    bool clear();
+
+    UINT getNumTemplates() const { return (UINT)templates.size(); }
+    UINT getNumDimensions() const { return numDimensions; }
+    UINT getMaxMatchLength() const { return maxMatchLength; }
+    UINT getNumMatchesAvailable() const { return (UINT)(matches.size() - nextMatch); }
+    uint64_t getFrameCount() const { return frameCount; }
+
+protected:
+    struct Template{
+        UINT classLabel;
+        UINT length;
+        vector< float > data;       ///< [length x numDimensions]
+        float threshold;            ///< The largest distance of a match
+        vector< float > costs;      ///< The accumulated cost of the best path ending at each template frame and the current stream frame
+        vector< uint64_t > starts;  ///< The stream frame each of these paths started at
+        float bestCost;             ///< The best match found that has not been reported yet
+        uint64_t bestStart;
+        uint64_t bestEnd;
+    };
+
+    void updateTemplate( Template &t, const float *x );
+
+    UINT numDimensions;
+    UINT maxMatchLength;
+    bool useScaling;
+    bool offsetUsingFirstSample;
+    Vector< MinMax > ranges;
+    vector< Template > templates;
+    uint64_t frameCount;
+
+    //The last maxMatchLength scaled frames, as a ring [maxMatchLength x numDimensions], used to offset the paths by their first frame
+    vector< float > history;
+    vector< float > offsetFrame;
+
+    vector< Match > matches;
+    size_t nextMatch;
+
+    ErrorLog errorLog;
+};
@@ -0,0 +1,500 @@
+
+#include "ofxGrtDTWTrainer.h"
+#include <chrono>
+#include <cstring>
+
+using namespace GRT;
+
+ofxGrtDTWTrainer::ofxGrtDTWTrainer(){
+    numDimensions = 0;
+    constrainWarpingPath = true;
+    warpingRadius = 0.2;
+    mode = ofxGrtDTWDistance::EXACT_DTW;
+    fastRadius = 10;
+    numComputedDistances = 0;
+    numAbandonedDistances = 0;
+    numCachedDistances = 0;
+    trainingTime = 0;
+    errorLog.setProceedingText("[ERROR ofxGrtDTWTrainer]");
+}
+
+ofxGrtDTWTrainer::~ofxGrtDTWTrainer(){
+}
+
+bool ofxGrtDTWTrainer::setup( const UINT numDimensions, const bool constrainWarpingPath, const Float warpingRadius, const ofxGrtDTWDistance::Mode mode, const UINT fastRadius ){
+
+    if( numDimensions == 0 ){
+        errorLog << "setup(...) - The number of dimensions must be greater than zero!" << endl;
+        return false;
+    }
+
+    if( warpingRadius < 0 || warpingRadius > 1 ){
+        errorLog << "setup(...) - The warping radius must be in the range [0 1]!" << endl;
+        return false;
+    }
+
+    //The cached distances are only valid for the same distance settings
+    if( numDimensions != this->numDimensions || constrainWarpingPath != this->constrainWarpingPath || warpingRadius != this->warpingRadius ||
+        mode != this->mode || fastRadius != this->fastRadius ){
+        clear();
+    }
+
+    this->numDimensions = numDimensions;
+    this->constrainWarpingPath = constrainWarpingPath;
+    this->warpingRadius = warpingRadius;
+    this->mode = mode;
+    this->fastRadius = fastRadius;
+
+    distances.resize( ofxGrtThreadPool::getSharedPool().getNumThreads() );
+    for(size_t t=0; t<distances.size(); t++){
+        distances[t].setup( numDimensions, constrainWarpingPath, warpingRadius );
+        distances[t].setMode( mode, fastRadius );
+    }
+
+    return true;
+}
+
+bool ofxGrtDTWTrainer::train( const vector< UINT > &classLabels, const vector< vector< vector< float > > > &classSamples, const UINT numTemplatesPerClass ){
+
+    numComputedDistances = 0;
+    numAbandonedDistances = 0;
+    numCachedDistances = 0;
+
+    if( numDimensions == 0 ){
+        errorLog << "train(...) - The trainer has not been setup!" << endl;
+        return false;
+    }
+
+    if( classLabels.size() != classSamples.size() || classLabels.size() == 0 ){
+        errorLog << "train(...) - There must be one label for each class, and at least one class!" << endl;
+        return false;
+    }
+
+    for(size_t k=0; k<classSamples.size(); k++){
+        if( classSamples[k].size() == 0 ){
+            errorLog << "train(...) - Class " << classLabels[k] << " has no samples!" << endl;
+            return false;
+        }
+        for(size_t i=0; i<classSamples[k].size(); i++){
+            if( classSamples[k][i].size() == 0 || classSamples[k][i].size() % numDimensions != 0 ){
+                errorLog << "train(...) - Sample " << i << " of class " << classLabels[k] << " does not have a whole number of frames!" << endl;
+                return false;
+            }
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Keep the cached distances of the samples that are still in the training data, matching the classes by label
+    vector< ClassCache > oldClasses;
+    std::swap( oldClasses, classes );
+    classes.resize( classLabels.size() );
+    for(size_t k=0; k<classLabels.size(); k++){
+        ClassCache empty;
+        empty.numSamples = 0;
+        ClassCache *old = &empty;
+        for(size_t c=0; c<oldClasses.size(); c++){
+            if( oldClasses[c].classLabel == classLabels[k] ) old = &oldClasses[c];
+        }
+        std::swap( classes[k], *old );
+        updateCache( classes[k], classLabels[k], classSamples[k] );
+    }
+
+    //Clustering needs every distance, which also makes every row of the medoid search below complete
+    if( numTemplatesPerClass != 1 ){
+        completeDistances( classSamples );
+    }
+
+    //Find the medoid of every class best first, several rows of each class per round
+    const size_t K = classes.size();
+    const UINT maxRowsPerRound = ofxGrtThreadPool::getSharedPool().getNumThreads();
+    vector< vector< char > > rowDone( K );
+    vector< double > bestSums( K, grt_numeric_limits< double >::max() );
+    vector< int > bestRows( K, -1 );
+    vector< bool > finished( K, false );
+    vector< RowJob > jobs;
+
+    for(size_t k=0; k<K; k++){
+        rowDone[k].assign( classes[k].numSamples, 0 );
+        if( classes[k].numSamples == 1 ){
+            bestRows[k] = 0;
+            bestSums[k] = 0;
+            finished[k] = true;
+        }
+    }
+
+    while( true ){
+        jobs.clear();
+
+        for(size_t k=0; k<K; k++){
+            if( finished[k] ) continue;
+            ClassCache &cache = classes[k];
+            const UINT n = cache.numSamples;
+
+            //The lower bound of each row sum, missing distances count as zero
+            vector< std::pair< double, UINT > > candidates;
+            for(UINT i=0; i<n; i++){
+                if( rowDone[k][i] ) continue;
+                double bound = 0;
+                for(UINT j=0; j<n; j++) bound += cache.distances[ (size_t)i*n + j ];
+                candidates.push_back( std::make_pair( bound, i ) );
+            }
+            std::sort( candidates.begin(), candidates.end() );
+
+            UINT numJobs = 0;
+            for(size_t c=0; c<candidates.size() && numJobs < maxRowsPerRound; c++){
+                const double bound = candidates[c].first;
+                const UINT row = candidates[c].second;
+                //Candidates are sorted by (bound, row), and ties go to the lowest row as in the full matrix
+                if( bound > bestSums[k] || (bound == bestSums[k] && (int)row > bestRows[k]) ) break;
+
+                bool complete = true;
+                for(UINT j=0; j<n && complete; j++){
+                    if( j != row && cache.states[ (size_t)row*n + j ] != EXACT_DISTANCE ) complete = false;
+                }
+
+                //Rows whose distances are all known need no job
+                if( complete ){
+                    rowDone[k][row] = 1;
+                    if( bound < bestSums[k] || (bound == bestSums[k] && (int)row < bestRows[k]) ){
+                        bestSums[k] = bound;
+                        bestRows[k] = row;
+                    }
+                    continue;
+                }
+
+                RowJob job;
+                job.classIndex = (UINT)k;
+                job.row = row;
+                job.rowBound = bound;
+                job.abandoned = false;
+                jobs.push_back( job );
+                numJobs++;
+            }
+
+            if( numJobs == 0 ) finished[k] = true;
+        }
+
+        if( jobs.size() == 0 ) break;
+
+        //Each job walks its row, keeping the lower bound of the row sum up to date, and stops at the first abandoned distance
+        ofxGrtThreadPool::getSharedPool().parallelFor( 0, jobs.size(), 1, [&]( const size_t i, const unsigned int threadIndex ){
+            RowJob &job = jobs[i];
+            const ClassCache &cache = classes[ job.classIndex ];
+            const UINT n = cache.numSamples;
+            const double bestSum = bestSums[ job.classIndex ];
+            const bool bounded = bestRows[ job.classIndex ] >= 0;
+            const vector< float > &a = classSamples[ job.classIndex ][ job.row ];
+            double rowBound = job.rowBound;
+
+            for(UINT j=0; j<n; j++){
+                const size_t index = (size_t)job.row*n + j;
+                if( j == job.row || cache.states[ index ] == EXACT_DISTANCE ) continue;
+                const float threshold = bounded ? (float)(bestSum - (rowBound - cache.distances[ index ])) : grt_numeric_limits< float >::max();
+                const vector< float > &b = classSamples[ job.classIndex ][j];
+                bool abandoned = false;
+                const float value = distances[ threadIndex ].compute( &a[0], (UINT)(a.size() / numDimensions), &b[0], (UINT)(b.size() / numDimensions), threshold, &abandoned );
+                job.columns.push_back( j );
+                job.values.push_back( value );
+                if( abandoned ){
+                    job.abandoned = true;
+                    break;
+                }
+                rowBound += value - cache.distances[ index ];
+            }
+        });
+
+        //Store the distances in both halves of the matrix, lower bounds never replace exact distances
+        for(size_t i=0; i<jobs.size(); i++){
+            const RowJob &job = jobs[i];
+            ClassCache &cache = classes[ job.classIndex ];
+            const UINT n = cache.numSamples;
+            for(size_t c=0; c<job.columns.size(); c++){
+                const size_t a = (size_t)job.row*n + job.columns[c];
+                const size_t b = (size_t)job.columns[c]*n + job.row;
+                const bool abandoned = job.abandoned && c+1 == job.columns.size();
+                if( abandoned ){
+                    numAbandonedDistances++;
+                    if( cache.states[a] != EXACT_DISTANCE && job.values[c] > cache.distances[a] ){
+                        cache.distances[a] = cache.distances[b] = job.values[c];
+                        cache.states[a] = cache.states[b] = LOWER_BOUND_DISTANCE;
+                    }
+                }else{
+                    cache.distances[a] = cache.distances[b] = job.values[c];
+                    cache.states[a] = cache.states[b] = EXACT_DISTANCE;
+                }
+                numComputedDistances++;
+            }
+        }
+
+        //The rows that were not abandoned now have exact sums
+        for(size_t i=0; i<jobs.size(); i++){
+            const RowJob &job = jobs[i];
+            const UINT k = job.classIndex;
+            rowDone[k][ job.row ] = 1;
+            if( job.abandoned ) continue;
+            const UINT n = classes[k].numSamples;
+            double sum = 0;
+            for(UINT j=0; j<n; j++) sum += classes[k].distances[ (size_t)job.row*n + j ];
+            if( sum < bestSums[k] || (sum == bestSums[k] && (int)job.row < bestRows[k]) ){
+                bestSums[k] = sum;
+                bestRows[k] = job.row;
+            }
+        }
+    }
+
+    for(size_t k=0; k<K; k++){
+        ClassCache &cache = classes[k];
+        if( numTemplatesPerClass == 1 ){
+            cache.templateIndices.assign( 1, (UINT)bestRows[k] );
+            cache.clusters.assign( cache.numSamples, 0 );
+        }else findMedoids( cache, numTemplatesPerClass == 0 ? cache.numSamples : numTemplatesPerClass );
+        computeStatistics( cache );
+    }
+
+    trainingTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+
+    return true;
+}
+
+bool ofxGrtDTWTrainer::clear(){
+    classes.clear();
+    return true;
+}
+
+MatrixFloat ofxGrtDTWTrainer::getDistanceMatrix( const UINT classIndex ) const {
+
+    if( classIndex >= classes.size() ) return MatrixFloat();
+
+    const ClassCache &cache = classes[ classIndex ];
+    MatrixFloat matrix( cache.numSamples, cache.numSamples );
+    for(UINT i=0; i<cache.numSamples; i++){
+        for(UINT j=0; j<cache.numSamples; j++){
+            matrix[i][j] = cache.distances[ (size_t)i*cache.numSamples + j ];
+        }
+    }
+
+    return matrix;
+}
+
+uint64_t ofxGrtDTWTrainer::getKey( const vector< float > &sample ){
+
+    //64 bit FNV-1a over the values
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i=0; i<sample.size(); i++){
+        uint32_t bits = 0;
+        memcpy( &bits, &sample[i], sizeof(bits) );
+        for(UINT b=0; b<4; b++){
+            hash ^= (bits >> (b*8)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    }
+    hash ^= sample.size();
+    hash *= 1099511628211ULL;
+
+    return hash;
+}
+
+void ofxGrtDTWTrainer::updateCache( ClassCache &cache, const UINT classLabel, const vector< vector< float > > &samples ){
+
+    const UINT n = (UINT)samples.size();
+
+    //Match each sample to an unused cached sample with the same content
+    vector< int > oldIndex( n, -1 );
+    vector< bool > used( cache.numSamples, false );
+    vector< uint64_t > keys( n );
+    for(UINT i=0; i<n; i++){
+        keys[i] = getKey( samples[i] );
+        for(UINT j=0; j<cache.numSamples; j++){
+            if( !used[j] && cache.keys[j] == keys[i] ){
+                oldIndex[i] = (int)j;
+                used[j] = true;
+                break;
+            }
+        }
+    }
+
+    vector< float > distances( (size_t)n*n, 0 );
+    vector< unsigned char > states( (size_t)n*n, MISSING_DISTANCE );
+    for(UINT i=0; i<n; i++){
+        states[ (size_t)i*n + i ] = EXACT_DISTANCE;
+        if( oldIndex[i] < 0 ) continue;
+        for(UINT j=0; j<n; j++){
+            if( j == i || oldIndex[j] < 0 ) continue;
+            const size_t old = (size_t)oldIndex[i]*cache.numSamples + oldIndex[j];
+            distances[ (size_t)i*n + j ] = cache.distances[ old ];
+            states[ (size_t)i*n + j ] = cache.states[ old ];
+            if( j > i && cache.states[ old ] == EXACT_DISTANCE ) numCachedDistances++;
+        }
+    }
+
+    cache.classLabel = classLabel;
+    cache.numSamples = n;
+    cache.keys = keys;
+    cache.distances = distances;
+    cache.states = states;
+    cache.templateIndices.clear();
+    cache.clusters.clear();
+    cache.trainingMu.clear();
+    cache.trainingSigma.clear();
+}
+
+void ofxGrtDTWTrainer::completeDistances( const vector< vector< vector< float > > > &classSamples ){
+
+    //Every pair without an exact distance is one task, each task writes its own two entries of the matrix
+    vector< std::pair< UINT, size_t > > pairs;
+    for(size_t k=0; k<classes.size(); k++){
+        const ClassCache &cache = classes[k];
+        const UINT n = cache.numSamples;
+        for(UINT i=0; i<n; i++){
+            for(UINT j=i+1; j<n; j++){
+                if( cache.states[ (size_t)i*n + j ] != EXACT_DISTANCE ) pairs.push_back( std::make_pair( (UINT)k, (size_t)i*n + j ) );
+            }
+        }
+    }
+
+    ofxGrtThreadPool::getSharedPool().parallelFor( 0, pairs.size(), 1, [&]( const size_t p, const unsigned int threadIndex ){
+        ClassCache &cache = classes[ pairs[p].first ];
+        const UINT n = cache.numSamples;
+        const UINT i = (UINT)(pairs[p].second / n);
+        const UINT j = (UINT)(pairs[p].second % n);
+        const vector< float > &a = classSamples[ pairs[p].first ][i];
+        const vector< float > &b = classSamples[ pairs[p].first ][j];
+        const float value = distances[ threadIndex ].compute( &a[0], (UINT)(a.size() / numDimensions), &b[0], (UINT)(b.size() / numDimensions) );
+        cache.distances[ (size_t)i*n + j ] = cache.distances[ (size_t)j*n + i ] = value;
+        cache.states[ (size_t)i*n + j ] = cache.states[ (size_t)j*n + i ] = EXACT_DISTANCE;
+    });
+
+    numComputedDistances += (UINT)pairs.size();
+}
+
+void ofxGrtDTWTrainer::findMedoids( ClassCache &cache, const UINT numTemplates ) const {
+
+    const UINT n = cache.numSamples;
+    const float *D = &cache.distances[0];
+
+    if( numTemplates >= n ){
+        cache.templateIndices.resize( n );
+        cache.clusters.resize( n );
+        for(UINT i=0; i<n; i++) cache.templateIndices[i] = cache.clusters[i] = i;
+        return;
+    }
+
+    //Start from the medoid of the class, then greedily add the sample that reduces the distances to the nearest medoid the most
+    vector< float > nearest( n, grt_numeric_limits< float >::max() );
+    vector< bool > isMedoid( n, false );
+    cache.templateIndices.clear();
+    while( cache.templateIndices.size() < numTemplates ){
+        UINT best = 0;
+        double bestGain = -grt_numeric_limits< double >::max();
+        for(UINT c=0; c<n; c++){
+            if( isMedoid[c] ) continue;
+            double gain = 0;
+            for(UINT j=0; j<n; j++){
+                const float d = D[ (size_t)c*n + j ];
+                if( cache.templateIndices.size() == 0 ) gain -= d;
+                else if( d < nearest[j] ) gain += nearest[j] - d;
+            }
+            if( gain > bestGain ){
+                bestGain = gain;
+                best = c;
+            }
+        }
+        isMedoid[ best ] = true;
+        cache.templateIndices.push_back( best );
+        for(UINT j=0; j<n; j++) nearest[j] = std::min( nearest[j], D[ (size_t)best*n + j ] );
+    }
+
+    //Assign each sample to its nearest medoid and move each medoid to the center of its cluster, until no medoid moves
+    cache.clusters.resize( n );
+    const UINT maxNumIterations = 100;
+    for(UINT iter=0; iter<maxNumIterations; iter++){
+        for(UINT j=0; j<n; j++){
+            UINT cluster = 0;
+            for(UINT t=1; t<numTemplates; t++){
+                if( D[ (size_t)cache.templateIndices[t]*n + j ] < D[ (size_t)cache.templateIndices[ cluster ]*n + j ] ) cluster = t;
+            }
+            cache.clusters[j] = cluster;
+        }
+        for(UINT t=0; t<numTemplates; t++) cache.clusters[ cache.templateIndices[t] ] = t;
+
+        bool moved = false;
+        for(UINT t=0; t<numTemplates; t++){
+            UINT best = cache.templateIndices[t];
+            double bestSum = grt_numeric_limits< double >::max();
+            for(UINT c=0; c<n; c++){
+                if( cache.clusters[c] != t ) continue;
+                double sum = 0;
+                for(UINT j=0; j<n; j++){
+                    if( cache.clusters[j] == t ) sum += D[ (size_t)c*n + j ];
+                }
+                if( sum < bestSum ){
+                    bestSum = sum;
+                    best = c;
+                }
+            }
+            if( best != cache.templateIndices[t] ){
+                cache.templateIndices[t] = best;
+                moved = true;
+            }
+        }
+        if( !moved ) break;
+    }
+}
+
+void ofxGrtDTWTrainer::computeStatistics( ClassCache &cache ) const {
+
+    const UINT n = cache.numSamples;
+    const UINT numTemplates = (UINT)cache.templateIndices.size();
+    cache.trainingMu.assign( numTemplates, 0 );
+    cache.trainingSigma.assign( numTemplates, 0 );
+
+    //The null rejection statistics come from the exact distances between each template and the other members of its cluster
+    bool hasEmptyCluster = false;
+    for(UINT t=0; t<numTemplates; t++){
+        const UINT best = cache.templateIndices[t];
+        UINT numMembers = 0;
+        for(UINT j=0; j<n; j++){
+            if( j == best || cache.clusters[j] != t ) continue;
+            cache.trainingMu[t] += cache.distances[ (size_t)best*n + j ];
+            numMembers++;
+        }
+        if( numMembers == 0 ){
+            hasEmptyCluster = true;
+            continue;
+        }
+        cache.trainingMu[t] /= numMembers;
+        for(UINT j=0; j<n; j++){
+            if( j == best || cache.clusters[j] != t ) continue;
+            const Float delta = cache.distances[ (size_t)best*n + j ] - cache.trainingMu[t];
+            cache.trainingSigma[t] += delta * delta;
+        }
+        cache.trainingSigma[t] = numMembers > 1 ? sqrt( cache.trainingSigma[t] / (numMembers-1) ) : 0;
+    }
+
+    //Templates without other members use the distances from each sample to its nearest neighbour, every distance is known when there are several templates
+    if( !hasEmptyCluster || n < 2 ) return;
+
+    vector< Float > nearest( n, grt_numeric_limits< Float >::max() );
+    Float mu = 0, sigma = 0;
+    for(UINT i=0; i<n; i++){
+        for(UINT j=0; j<n; j++){
+            if( j != i ) nearest[i] = std::min( nearest[i], (Float)cache.distances[ (size_t)i*n + j ] );
+        }
+        mu += nearest[i];
+    }
+    mu /= n;
+    for(UINT i=0; i<n; i++) sigma += (nearest[i] - mu) * (nearest[i] - mu);
+    sigma = sqrt( sigma / (n-1) );
+
+    for(UINT t=0; t<numTemplates; t++){
+        bool empty = true;
+        for(UINT j=0; j<n && empty; j++){
+            if( j != cache.templateIndices[t] && cache.clusters[j] == t ) empty = false;
+        }
+        if( empty ){
+            cache.trainingMu[t] = mu;
+            cache.trainingSigma[t] = sigma;
+        }
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <stdint.h>
+
+#include "ofMain.h"
+#include "ofxGrtDTWDistance.h"
+#include "ofxGrtThreadPool.h"
+
+using namespace GRT;
+
+/**
+ @brief picks a template (and null rejection statistics) for each class of a DTW classifier, this is used by ofxGrtDTW. As with the GRT DTW,
+ the template of a class is its medoid, the training sample with the smallest sum of DTW distances to the other samples of the class, and the
+ mean and standard deviation of the distances from the template to the other samples are used for the null rejection threshold.
+
+ The DTW distances between the samples of each class are kept in a cache, keyed by the content of each sample, so retraining after adding a
+ sample only computes the distances of the new sample. The medoid is found best first: each round takes (for every class) the samples with the
+ smallest lower bounds on their distance sums, and computes their missing distances in parallel on the shared ofxGrtThreadPool (one task per
+ sample), using the banded warping constraint and abandoning a sample as soon as its sum is sure to be larger than the best sum found so far.
+ Abandoned distances are cached as lower bounds, and the search stops when no sample can beat the best sum, so the same template is found as
+ when every distance is computed.
+
+ A class can also be split into several templates, for classes whose gestures are performed in a few different ways. Every distance of the
+ class is then computed (in parallel), and the samples are clustered with k-medoids: the medoids are picked greedily, each one reducing the sum
+ of the distances from the samples to their nearest medoid the most, and are then refined by moving each medoid to the member of its cluster
+ with the smallest sum of distances to the other members, until no medoid moves. The null rejection statistics of a template come from the
+ other members of its cluster, a template without any uses the distances from each sample of the class to its nearest neighbour.
+*/
+class ofxGrtDTWTrainer {
+public:
+    ofxGrtDTWTrainer();
+    ~ofxGrtDTWTrainer();
+
+    /**
+     @brief sets the size of the frames and the warping constraint, the cache is cleared if these change
+     @param numDimensions: the number of values in each frame
+     @param constrainWarpingPath: if true the warping path is constrained to a band around the diagonal
+     @param warpingRadius: the half width of the band, as a fraction of the length of the longer series
+     @param mode: how the distances are computed, see ofxGrtDTWDistance::setMode
+     @param fastRadius: the FastDTW radius, only used in FAST_DTW mode
+     @return returns true if the trainer was setup successfully, false otherwise
+    */
+    bool setup( const UINT numDimensions, const bool constrainWarpingPath, const Float warpingRadius, const ofxGrtDTWDistance::Mode mode = ofxGrtDTWDistance::EXACT_DTW, const UINT fastRadius = 10 );
+
+    /**
+     @brief picks the templates of each class
+     @param classLabels: the label of each class, the cache of each class is kept by label
+     @param classSamples: the samples of each class, each sample is a series stored row by row [length x numDimensions]
+     @param numTemplatesPerClass: the number of templates of each class (limited to the number of samples), or zero to use every sample
+     @return returns true if the templates were found successfully, false otherwise
+    */
+    bool train( const vector< UINT > &classLabels, const vector< vector< vector< float > > > &classSamples, const UINT numTemplatesPerClass = 1 );
+
+    /**
+     @brief removes all the cached distances
+     @return returns true if the cache was cleared successfully, false otherwise
+    */
+    bool clear();
+
+    UINT getNumClasses() const { return (UINT)classes.size(); }
+
+    UINT getNumTemplates( const UINT classIndex ) const { return (UINT)classes[ classIndex ].templateIndices.size(); }
+
+    /**
+     @brief gets the index (within its class) of the sample picked as a template of a class
+    */
+    UINT getTemplateIndex( const UINT classIndex, const UINT templateIndex = 0 ) const { return classes[ classIndex ].templateIndices[ templateIndex ]; }
+    Float getTrainingMu( const UINT classIndex, const UINT templateIndex = 0 ) const { return classes[ classIndex ].trainingMu[ templateIndex ]; }
+    Float getTrainingSigma( const UINT classIndex, const UINT templateIndex = 0 ) const { return classes[ classIndex ].trainingSigma[ templateIndex ]; }
+
+    /**
+     @brief gets the template (in the range [0 getNumTemplates(classIndex)-1]) whose cluster a sample of a class belongs to
+    */
+    UINT getCluster( const UINT classIndex, const UINT sampleIndex ) const { return classes[ classIndex ].clusters[ sampleIndex ]; }
+
+    /**
+     @brief gets the cached distances between the samples of a class. Distances that were abandoned hold their lower bound, and distances that
+     were never needed are zero.
+    */
+    MatrixFloat getDistanceMatrix( const UINT classIndex ) const;
+
+    /**
+     @brief gets the number of distances computed by the last call to train, including the abandoned ones
+    */
+    UINT getNumComputedDistances() const { return numComputedDistances; }
+
+    /**
+     @brief gets the number of distances that were abandoned by the last call to train
+    */
+    UINT getNumAbandonedDistances() const { return numAbandonedDistances; }
+
+    /**
+     @brief gets the number of distances that were reused from the cache by the last call to train
+    */
+    UINT getNumCachedDistances() const { return numCachedDistances; }
+
+    /**
+     @brief gets the time taken by the last call to train
+     @return returns the training time in milliseconds
+    */
+    double getTrainingTime() const { return trainingTime; }
+
+protected:
+    enum DistanceState{ MISSING_DISTANCE=0, LOWER_BOUND_DISTANCE, EXACT_DISTANCE };
+
+    struct ClassCache{
+        UINT classLabel;
+        UINT numSamples;
+        vector< uint64_t > keys;            ///< The hash of each sample
+        vector< float > distances;          ///< [numSamples x numSamples]
+        vector< unsigned char > states;     ///< The DistanceState of each distance
+        vector< UINT > templateIndices;     ///< The sample used as each template
+        vector< UINT > clusters;            ///< The template each sample is closest to
+        vector< Float > trainingMu;         ///< The null rejection statistics of each template
+        vector< Float > trainingSigma;
+    };
+
+    struct RowJob{
+        UINT classIndex;
+        UINT row;
+        double rowBound;                ///< The lower bound of the row sum when the round started
+        vector< UINT > columns;         ///< The distances computed by the job, in order
+        vector< float > values;
+        bool abandoned;                 ///< True if the last distance was abandoned, which proves the row can not be the medoid
+    };
+
+    static uint64_t getKey( const vector< float > &sample );
+    void updateCache( ClassCache &cache, const UINT classLabel, const vector< vector< float > > &samples );
+    void completeDistances( const vector< vector< vector< float > > > &classSamples );
+    void findMedoids( ClassCache &cache, const UINT numTemplates ) const;
+    void computeStatistics( ClassCache &cache ) const;
+
+    UINT numDimensions;
+    bool constrainWarpingPath;
+    Float warpingRadius;
+    ofxGrtDTWDistance::Mode mode;
+    UINT fastRadius;
+    vector< ClassCache > classes;
+    vector< ofxGrtDTWDistance > distances;  ///< One per thread
+    UINT numComputedDistances;
+    UINT numAbandonedDistances;
+    UINT numCachedDistances;
+    double trainingTime;
+    ErrorLog errorLog;
+};
@@ -0,0 +1,264 @@
+
+#include "ofxGrtDatagramSocket.h"
+#include <cstring>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace GRT;
+
+#if defined(_WIN32)
+static const uintptr_t INVALID_HANDLE = (uintptr_t)INVALID_SOCKET;
+
+//Winsock has to be started once per process before any socket is opened
+static bool startWinsock(){
+    static const bool started = []{
+        WSADATA wsaData;
+        return WSAStartup( MAKEWORD(2,2), &wsaData ) == 0;
+    }();
+    return started;
+}
+#else
+static const int INVALID_HANDLE = -1;
+#endif
+
+ofxGrtDatagramSocket::ofxGrtDatagramSocket(){
+    handle = INVALID_HANDLE;
+    isUnix = false;
+    errorLog.setProceedingText("[ERROR ofxGrtDatagramSocket]");
+}
+
+ofxGrtDatagramSocket::~ofxGrtDatagramSocket(){
+    close();
+}
+
+bool ofxGrtDatagramSocket::bindUdp( const unsigned short port, const std::string &host ){
+
+    close();
+
+    Address address;
+    if( !getUdpAddress( host.size() > 0 ? host : "0.0.0.0", port, address ) ){
+        errorLog << "bindUdp(const unsigned short port, const std::string &host) - Invalid host: " << host << endl;
+        return false;
+    }
+
+    if( !openSocket( AF_INET ) ) return false;
+
+    if( ::bind( handle, (const sockaddr*)address.data, address.length ) != 0 ){
+        errorLog << "bindUdp(const unsigned short port, const std::string &host) - Failed to bind to port " << port << endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool ofxGrtDatagramSocket::bindUnix( const std::string &path ){
+
+    close();
+
+#if defined(_WIN32)
+    errorLog << "bindUnix(const std::string &path) - Unix domain sockets are not supported on this platform!" << endl;
+    return false;
+#else
+    Address address;
+    if( !getUnixAddress( path, address ) ){
+        errorLog << "bindUnix(const std::string &path) - Invalid path: " << path << endl;
+        return false;
+    }
+
+    //A socket file left behind by a process that did not close it would stop the bind, anything else at the path is left alone
+    struct stat status;
+    if( ::lstat( path.c_str(), &status ) == 0 ){
+        if( !S_ISSOCK( status.st_mode ) ){
+            errorLog << "bindUnix(const std::string &path) - The path exists and is not a socket: " << path << endl;
+            return false;
+        }
+        ::unlink( path.c_str() );
+    }
+
+    if( !openSocket( AF_UNIX ) ) return false;
+
+    if( ::bind( handle, (const sockaddr*)address.data, address.length ) != 0 ){
+        errorLog << "bindUnix(const std::string &path) - Failed to bind to path: " << path << endl;
+        close();
+        return false;
+    }
+
+    isUnix = true;
+    unixPath = path;
+
+    return true;
+#endif
+}
+
+bool ofxGrtDatagramSocket::openUnix(){
+
+    close();
+
+#if defined(_WIN32)
+    errorLog << "openUnix() - Unix domain sockets are not supported on this platform!" << endl;
+    return false;
+#else
+    if( !openSocket( AF_UNIX ) ) return false;
+    isUnix = true;
+
+    return true;
+#endif
+}
+
+void ofxGrtDatagramSocket::close(){
+    if( handle != INVALID_HANDLE ){
+#if defined(_WIN32)
+        closesocket( (SOCKET)handle );
+#else
+        ::close( handle );
+        if( unixPath.size() > 0 ) ::unlink( unixPath.c_str() );
+#endif
+    }
+    handle = INVALID_HANDLE;
+    isUnix = false;
+    unixPath.clear();
+}
+
+bool ofxGrtDatagramSocket::send( const void *data, const size_t size, const Address &to ){
+
+    if( handle == INVALID_HANDLE ){
+        errorLog << "send(...) - The socket is not open!" << endl;
+        return false;
+    }
+
+    if( !to.getIsValid() ){
+        errorLog << "send(...) - The address is not valid!" << endl;
+        return false;
+    }
+
+#if defined(_WIN32)
+    const int sent = ::sendto( (SOCKET)handle, (const char*)data, (int)size, 0, (const sockaddr*)to.data, (int)to.length );
+#else
+    const ssize_t sent = ::sendto( handle, data, size, 0, (const sockaddr*)to.data, (socklen_t)to.length );
+#endif
+
+    return sent == (int)size;
+}
+
+int ofxGrtDatagramSocket::receive( void *buffer, const size_t size, Address &from, const UINT timeoutMs ){
+
+    from.length = 0;
+
+    if( handle == INVALID_HANDLE ){
+        errorLog << "receive(...) - The socket is not open!" << endl;
+        return -1;
+    }
+
+    fd_set readSet;
+    FD_ZERO( &readSet );
+    FD_SET( handle, &readSet );
+    timeval timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+
+    const int ready = ::select( (int)handle + 1, &readSet, NULL, NULL, &timeout );
+    if( ready == 0 ) return 0;
+    if( ready < 0 ){
+#if !defined(_WIN32)
+        if( errno == EINTR ) return 0;
+#endif
+        return -1;
+    }
+
+#if defined(_WIN32)
+    int fromLength = (int)sizeof( from.data );
+    const int received = ::recvfrom( (SOCKET)handle, (char*)buffer, (int)size, 0, (sockaddr*)from.data, &fromLength );
+    //A packet larger than the buffer is truncated, and an ICMP port unreachable from an earlier send is reported here, neither is fatal
+    if( received < 0 ) return WSAGetLastError() == WSAEMSGSIZE ? (int)size : 0;
+#else
+    socklen_t fromLength = (socklen_t)sizeof( from.data );
+    const ssize_t received = ::recvfrom( handle, buffer, size, 0, (sockaddr*)from.data, &fromLength );
+    if( received < 0 ) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ECONNREFUSED ? 0 : -1;
+#endif
+    from.length = (uint32_t)fromLength;
+
+    return (int)received;
+}
+
+bool ofxGrtDatagramSocket::getIsOpen() const {
+    return handle != INVALID_HANDLE;
+}
+
+unsigned short ofxGrtDatagramSocket::getPort() const {
+    if( handle == INVALID_HANDLE || isUnix ) return 0;
+    sockaddr_in address;
+#if defined(_WIN32)
+    int length = (int)sizeof( address );
+    if( ::getsockname( (SOCKET)handle, (sockaddr*)&address, &length ) != 0 ) return 0;
+#else
+    socklen_t length = (socklen_t)sizeof( address );
+    if( ::getsockname( handle, (sockaddr*)&address, &length ) != 0 ) return 0;
+#endif
+    return ntohs( address.sin_port );
+}
+
+bool ofxGrtDatagramSocket::getUdpAddress( const std::string &host, const unsigned short port, Address &address ){
+#if defined(_WIN32)
+    startWinsock();
+#endif
+    sockaddr_in in;
+    memset( &in, 0, sizeof( in ) );
+    in.sin_family = AF_INET;
+    in.sin_port = htons( port );
+    if( inet_pton( AF_INET, host == "localhost" ? "127.0.0.1" : host.c_str(), &in.sin_addr ) != 1 ){
+        address.length = 0;
+        return false;
+    }
+    memcpy( address.data, &in, sizeof( in ) );
+    address.length = (uint32_t)sizeof( in );
+    return true;
+}
+
+bool ofxGrtDatagramSocket::getUnixAddress( const std::string &path, Address &address ){
+#if defined(_WIN32)
+    address.length = 0;
+    return false;
+#else
+    sockaddr_un un;
+    memset( &un, 0, sizeof( un ) );
+    if( path.size() == 0 || path.size() >= sizeof( un.sun_path ) || sizeof( un ) > sizeof( address.data ) ){
+        address.length = 0;
+        return false;
+    }
+    un.sun_family = AF_UNIX;
+    memcpy( un.sun_path, path.c_str(), path.size() );
+    memcpy( address.data, &un, sizeof( un ) );
+    address.length = (uint32_t)sizeof( un );
+    return true;
+#endif
+}
+
+bool ofxGrtDatagramSocket::openSocket( const int family ){
+#if defined(_WIN32)
+    if( !startWinsock() ){
+        errorLog << "openSocket(const int family) - Failed to start winsock!" << endl;
+        return false;
+    }
+    handle = (uintptr_t)::socket( family, SOCK_DGRAM, 0 );
+#else
+    handle = ::socket( family, SOCK_DGRAM, 0 );
+#endif
+    if( handle == INVALID_HANDLE ){
+        errorLog << "openSocket(const int family) - Failed to create socket!" << endl;
+        return false;
+    }
+    return true;
+}
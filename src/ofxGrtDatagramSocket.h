@@ -0,0 +1,139 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <cstring>
+#include <stdint.h>
+
+#include "ofMain.h"
+
+using namespace GRT;
+
+/**
+ @brief a minimal non-blocking datagram socket, either UDP (IPv4) or a unix domain socket, used by the ofxGrt inference server and OSC
+ output to exchange OSC packets with other processes on the same machine or network. Unix domain sockets skip the network stack, so
+ they have a lower latency between local processes, but are not available on Windows.
+
+ Addresses are kept as opaque values so the caller can reply to whoever sent a packet without knowing what kind of socket it is.
+*/
+class ofxGrtDatagramSocket {
+public:
+    struct Address{
+        uint8_t data[128];              ///< Large enough for a sockaddr_in or a sockaddr_un
+        uint32_t length;
+
+        Address() : length(0) {}
+        bool getIsValid() const { return length > 0; }
+        bool operator==( const Address &rhs ) const { return length == rhs.length && memcmp( data, rhs.data, length ) == 0; }
+        bool operator!=( const Address &rhs ) const { return !(*this == rhs); }
+    };
+
+    ofxGrtDatagramSocket();
+    ~ofxGrtDatagramSocket();
+
+    /**
+     @brief opens a UDP socket bound to a port
+     @param port: the port to receive on, or 0 to let the system choose one (for a socket that only sends and receives replies)
+     @param host: the IPv4 address of the interface to bind to, if empty the socket receives on all interfaces
+     @return returns true if the socket was opened successfully, false otherwise
+    */
+    bool bindUdp( const unsigned short port, const std::string &host = "" );
+
+    /**
+     @brief opens a unix domain datagram socket bound to a path, any existing socket file at the path is removed first. The bind
+     fails if the path exists and is not a socket
+     @param path: the path of the socket file
+     @return returns true if the socket was opened successfully, false otherwise
+    */
+    bool bindUnix( const std::string &path );
+
+    /**
+     @brief opens a unix domain datagram socket that is not bound to a path, it can send to other unix domain sockets but can not receive
+     @return returns true if the socket was opened successfully, false otherwise
+    */
+    bool openUnix();
+
+    /**
+     @brief closes the socket, removing the socket file of a unix domain socket
+    */
+    void close();
+
+    /**
+     @brief sends a packet
+     @param data: the packet
+     @param size: the size of the packet in bytes
+     @param to: the address to send to
+     @return returns true if the whole packet was sent, false otherwise
+    */
+    bool send( const void *data, const size_t size, const Address &to );
+
+    /**
+     @brief receives a packet, waiting up to a timeout for one to arrive
+     @param buffer: the packet is written to this
+     @param size: the size of the buffer, larger packets are truncated
+     @param from: set to the address of the sender
+     @param timeoutMs: the longest time to wait in milliseconds, 0 returns straight away
+     @return returns the size of the packet, 0 if no packet arrived in time, or -1 on error
+    */
+    int receive( void *buffer, const size_t size, Address &from, const UINT timeoutMs );
+
+    bool getIsOpen() const;
+    bool getIsUnix() const { return isUnix; }
+
+    /**
+     @brief gets the port the socket is bound to, which is useful when bindUdp was called with port 0
+     @return returns the port, or 0 if this is not an open UDP socket
+    */
+    unsigned short getPort() const;
+
+    /**
+     @brief gets the address of a UDP socket
+     @param host: the IPv4 address (or "localhost")
+     @param port: the port
+     @param address: set to the address
+     @return returns true if the address is valid, false otherwise
+    */
+    static bool getUdpAddress( const std::string &host, const unsigned short port, Address &address );
+
+    /**
+     @brief gets the address of a unix domain socket
+     @param path: the path of the socket file
+     @param address: set to the address
+     @return returns true if the address is valid, false otherwise
+    */
+    static bool getUnixAddress( const std::string &path, Address &address );
+
+protected:
+    ofxGrtDatagramSocket( const ofxGrtDatagramSocket &rhs );
+    ofxGrtDatagramSocket &operator=( const ofxGrtDatagramSocket &rhs );
+
+    bool openSocket( const int family );
+
+#if defined(_WIN32)
+    uintptr_t handle;
+#else
+    int handle;
+#endif
+    bool isUnix;
+    std::string unixPath;
+
+    ErrorLog errorLog;
+};
@@ -0,0 +1,107 @@
+
+#include "ofxGrtDecisionTree.h"
+
+using namespace GRT;
+
+//Register the ofxGrtDecisionTree module with the Classifier base class
+RegisterClassifierModule< ofxGrtDecisionTree > ofxGrtDecisionTree::registerModule("ofxGrtDecisionTree");
+
+ofxGrtDecisionTree::ofxGrtDecisionTree(){
+    numBins = 64;
+    trainingTime = 0;
+    classType = "ofxGrtDecisionTree";
+    classifierType = classType;
+    debugLog.setProceedingText("[DEBUG ofxGrtDecisionTree]");
+    errorLog.setProceedingText("[ERROR ofxGrtDecisionTree]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtDecisionTree]");
+    warningLog.setProceedingText("[WARNING ofxGrtDecisionTree]");
+}
+
+ofxGrtDecisionTree::ofxGrtDecisionTree( const ofxGrtDecisionTree &rhs ) : DecisionTree( rhs ) {
+    classType = "ofxGrtDecisionTree";
+    classifierType = classType;
+    debugLog.setProceedingText("[DEBUG ofxGrtDecisionTree]");
+    errorLog.setProceedingText("[ERROR ofxGrtDecisionTree]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtDecisionTree]");
+    warningLog.setProceedingText("[WARNING ofxGrtDecisionTree]");
+    numBins = rhs.numBins;
+    trainingTime = rhs.trainingTime;
+}
+
+ofxGrtDecisionTree::~ofxGrtDecisionTree(){
+}
+
+ofxGrtDecisionTree &ofxGrtDecisionTree::operator=( const ofxGrtDecisionTree &rhs ){
+    if( this != &rhs ){
+        DecisionTree::operator=( rhs );
+        this->numBins = rhs.numBins;
+        this->trainingTime = rhs.trainingTime;
+    }
+    return *this;
+}
+
+bool ofxGrtDecisionTree::deepCopyFrom( const Classifier *classifier ){
+
+    if( classifier == NULL ) return false;
+
+    const ofxGrtDecisionTree *ptr = dynamic_cast< const ofxGrtDecisionTree* >( classifier );
+    if( ptr == NULL ) return false;
+
+    *this = *ptr;
+
+    return true;
+}
+
+bool ofxGrtDecisionTree::train_( ClassificationData &trainingData ){
+
+    //Null rejection, validation and other node types need the DecisionTree trainer
+    if( useNullRejection || useValidationSet || !ofxGrtForestTrainer::getIsNodeTypeSupported( decisionTreeNode ) ){
+        warningLog << "train_(ClassificationData &trainingData) - Null rejection, validation sets and custom node types are not supported by the parallel trainer, using the DecisionTree trainer" << endl;
+        return DecisionTree::train_( trainingData );
+    }
+
+    clear();
+
+    const UINT M = trainingData.getNumSamples();
+    const UINT N = trainingData.getNumDimensions();
+    const UINT K = trainingData.getNumClasses();
+
+    if( M == 0 ){
+        errorLog << "train_(ClassificationData &trainingData) - Training data has zero samples!" << endl;
+        return false;
+    }
+
+    //A single tree trained on all the samples
+    ofxGrtForestTrainer trainer;
+    if( !trainer.setup( 1, maxDepth, minNumSamplesPerNode, 0 ) || !trainer.setNumBins( numBins ) ) return false;
+
+    Vector< DecisionTreeNode* > trees;
+    if( !trainer.train( trainingData, useScaling, *decisionTreeNode, trees ) || trees.size() != 1 ){
+        errorLog << "train_(ClassificationData &trainingData) - Failed to build the tree!" << endl;
+        return false;
+    }
+
+    tree = trees[0];
+    numInputDimensions = N;
+    numOutputDimensions = K;
+    numClasses = K;
+    classLabels = trainingData.getClassLabels();
+    ranges = trainingData.getRanges();
+    classLikelihoods.resize( K, 0 );
+    classDistances.resize( K, 0 );
+    trainingTime = trainer.getTrainingTime();
+    trained = true;
+
+    trainingLog << "Built the tree in " << trainingTime << "ms" << endl;
+
+    return true;
+}
+
+bool ofxGrtDecisionTree::setNumBins( const UINT numBins ){
+    if( numBins < 2 || numBins > 256 ){
+        errorLog << "setNumBins(const UINT numBins) - The number of bins must be in the range [2 256]!" << endl;
+        return false;
+    }
+    this->numBins = numBins;
+    return true;
+}
@@ -0,0 +1,70 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+#include "ofxGrtForestTrainer.h"
+
+using namespace GRT;
+
+/**
+ @brief a GRT DecisionTree classifier that is trained in parallel by ofxGrtForestTrainer. The top of the tree is split with the features searched in
+ parallel, then the subtrees are built concurrently, using histogram binned split finding. The tree is stored as a normal GRT tree, so prediction,
+ saving and loading are exactly the same as DecisionTree. The maximum depth, minimum number of samples per node, scaling and node type are taken
+ from the DecisionTree settings. Each node searches every split between the bins of every feature, so the number of splitting steps is not used,
+ and features are not removed at each split.
+
+ If null rejection or a validation set is enabled, or the node type is not a cluster or threshold node, the tree is trained by DecisionTree instead.
+*/
+class ofxGrtDecisionTree : public DecisionTree {
+public:
+    ofxGrtDecisionTree();
+    ofxGrtDecisionTree( const ofxGrtDecisionTree &rhs );
+    virtual ~ofxGrtDecisionTree();
+
+    ofxGrtDecisionTree &operator=( const ofxGrtDecisionTree &rhs );
+
+    virtual bool deepCopyFrom( const Classifier *classifier );
+    virtual bool train_( ClassificationData &trainingData );
+
+    /**
+     @brief sets the maximum number of bins each feature is split into when searching for splits, in the range [2 256]
+    */
+    bool setNumBins( const UINT numBins );
+
+    UINT getNumBins() const { return numBins; }
+
+    /**
+     @brief gets the time taken to build the tree by the last call to train
+     @return returns the training time in milliseconds
+    */
+    double getTrainingTime() const { return trainingTime; }
+
+    using MLBase::train_;
+
+protected:
+    UINT numBins;
+    double trainingTime;
+
+private:
+    static RegisterClassifierModule< ofxGrtDecisionTree > registerModule;
+};
@@ -0,0 +1,299 @@
+
+#include "ofxGrtFeatureSchema.h"
+
+using namespace GRT;
+
+ofxGrtFeatureSchema::ofxGrtFeatureSchema(){
+    errorLog.setProceedingText("[ERROR ofxGrtFeatureSchema]");
+    clear();
+}
+
+ofxGrtFeatureSchema::~ofxGrtFeatureSchema(){
+}
+
+bool ofxGrtFeatureSchema::addSource( const std::string &name, const Float *data, const UINT size ){
+
+    if( data == NULL || size == 0 ){
+        errorLog << "addSource(const std::string &name, const Float *data, const UINT size) - The source " << name << " has no data!" << endl;
+        return false;
+    }
+
+    vector< const Float* > channels( size );
+    for(UINT i=0; i<size; i++){
+        channels[i] = data + i;
+    }
+
+    return addSource( name, channels );
+}
+
+bool ofxGrtFeatureSchema::addSource( const std::string &name, const vector< const Float* > &channels ){
+
+    if( getSourceIndex( name ) >= 0 ){
+        errorLog << "addSource(...) - A source called " << name << " has already been added!" << endl;
+        return false;
+    }
+
+    if( channels.size() == 0 ){
+        errorLog << "addSource(...) - The source " << name << " has no channels!" << endl;
+        return false;
+    }
+
+    for(size_t i=0; i<channels.size(); i++){
+        if( channels[i] == NULL ){
+            errorLog << "addSource(...) - Channel " << i << " of the source " << name << " is NULL!" << endl;
+            return false;
+        }
+    }
+
+    Source source;
+    source.name = name;
+    source.channels = channels;
+    sources.push_back( source );
+    compiled = false;
+
+    return true;
+}
+
+bool ofxGrtFeatureSchema::addFeature( const std::string &source ){
+
+    const int index = getSourceIndex( source );
+    if( index < 0 ){
+        errorLog << "addFeature(const std::string &source) - Unknown source: " << source << endl;
+        return false;
+    }
+
+    Feature feature;
+    feature.type = COPY_FEATURE;
+    feature.sourceA = index;
+    feature.sourceB = -1;
+    feature.channel = -1;
+    features.push_back( feature );
+    compiled = false;
+
+    return true;
+}
+
+bool ofxGrtFeatureSchema::addFeature( const std::string &source, const UINT channel ){
+
+    const int index = getSourceIndex( source );
+    if( index < 0 ){
+        errorLog << "addFeature(const std::string &source, const UINT channel) - Unknown source: " << source << endl;
+        return false;
+    }
+
+    if( channel >= sources[index].channels.size() ){
+        errorLog << "addFeature(const std::string &source, const UINT channel) - The channel " << channel << " is out of range for the source " << source << endl;
+        return false;
+    }
+
+    Feature feature;
+    feature.type = COPY_FEATURE;
+    feature.sourceA = index;
+    feature.sourceB = -1;
+    feature.channel = (int)channel;
+    features.push_back( feature );
+    compiled = false;
+
+    return true;
+}
+
+bool ofxGrtFeatureSchema::addDistanceFeature( const std::string &sourceA, const std::string &sourceB ){
+
+    const int indexA = getSourceIndex( sourceA );
+    const int indexB = getSourceIndex( sourceB );
+    if( indexA < 0 || indexB < 0 ){
+        errorLog << "addDistanceFeature(...) - Unknown source: " << (indexA < 0 ? sourceA : sourceB) << endl;
+        return false;
+    }
+
+    if( sources[indexA].channels.size() != sources[indexB].channels.size() ){
+        errorLog << "addDistanceFeature(...) - The sources " << sourceA << " and " << sourceB << " have a different number of channels!" << endl;
+        return false;
+    }
+
+    Feature feature;
+    feature.type = DISTANCE_FEATURE;
+    feature.sourceA = indexA;
+    feature.sourceB = indexB;
+    feature.channel = -1;
+    features.push_back( feature );
+    compiled = false;
+
+    return true;
+}
+
+bool ofxGrtFeatureSchema::addMagnitudeFeature( const std::string &source ){
+
+    const int index = getSourceIndex( source );
+    if( index < 0 ){
+        errorLog << "addMagnitudeFeature(const std::string &source) - Unknown source: " << source << endl;
+        return false;
+    }
+
+    Feature feature;
+    feature.type = MAGNITUDE_FEATURE;
+    feature.sourceA = index;
+    feature.sourceB = -1;
+    feature.channel = -1;
+    features.push_back( feature );
+    compiled = false;
+
+    return true;
+}
+
+bool ofxGrtFeatureSchema::compile(){
+
+    gatherList.clear();
+    derivedList.clear();
+    derivedChannels.clear();
+    numDimensions = 0;
+    compiled = false;
+
+    if( features.size() == 0 ){
+        errorLog << "compile() - No features have been added!" << endl;
+        return false;
+    }
+
+    for(size_t i=0; i<features.size(); i++){
+        const Feature &feature = features[i];
+        const Source &sourceA = sources[ feature.sourceA ];
+
+        switch( feature.type ){
+            case COPY_FEATURE:
+                if( feature.channel >= 0 ){
+                    GatherEntry entry = { sourceA.channels[ feature.channel ], numDimensions++ };
+                    gatherList.push_back( entry );
+                }else{
+                    for(size_t j=0; j<sourceA.channels.size(); j++){
+                        GatherEntry entry = { sourceA.channels[j], numDimensions++ };
+                        gatherList.push_back( entry );
+                    }
+                }
+                break;
+            case DISTANCE_FEATURE:
+            case MAGNITUDE_FEATURE:
+            {
+                DerivedEntry entry;
+                entry.type = feature.type;
+                entry.begin = (UINT)derivedChannels.size();
+                entry.size = (UINT)sourceA.channels.size();
+                entry.slot = numDimensions++;
+                derivedChannels.insert( derivedChannels.end(), sourceA.channels.begin(), sourceA.channels.end() );
+                if( feature.type == DISTANCE_FEATURE ){
+                    const Source &sourceB = sources[ feature.sourceB ];
+                    derivedChannels.insert( derivedChannels.end(), sourceB.channels.begin(), sourceB.channels.end() );
+                }
+                derivedList.push_back( entry );
+            }
+                break;
+        }
+    }
+
+    featureVector.resize( numDimensions, 0 );
+    compiled = true;
+
+    return true;
+}
+
+bool ofxGrtFeatureSchema::update(){
+
+    if( !compiled ){
+        errorLog << "update() - The schema has not been compiled!" << endl;
+        return false;
+    }
+
+    fill( &featureVector[0] );
+
+    return true;
+}
+
+bool ofxGrtFeatureSchema::update( VectorFloat &featureVector ){
+
+    if( !compiled ){
+        errorLog << "update(VectorFloat &featureVector) - The schema has not been compiled!" << endl;
+        return false;
+    }
+
+    if( featureVector.size() != numDimensions ){
+        errorLog << "update(VectorFloat &featureVector) - The size of the feature vector (" << featureVector.size() << ") does not match the schema (" << numDimensions << ")" << endl;
+        return false;
+    }
+
+    fill( &featureVector[0] );
+
+    return true;
+}
+
+bool ofxGrtFeatureSchema::clear(){
+    compiled = false;
+    numDimensions = 0;
+    sources.clear();
+    features.clear();
+    gatherList.clear();
+    derivedList.clear();
+    derivedChannels.clear();
+    featureVector.clear();
+    return true;
+}
+
+vector< std::string > ofxGrtFeatureSchema::getFeatureNames() const {
+
+    vector< std::string > names;
+    for(size_t i=0; i<features.size(); i++){
+        const Feature &feature = features[i];
+        const Source &sourceA = sources[ feature.sourceA ];
+        switch( feature.type ){
+            case COPY_FEATURE:
+                if( feature.channel >= 0 ){
+                    names.push_back( sourceA.name + "[" + ofToString( feature.channel ) + "]" );
+                }else{
+                    for(size_t j=0; j<sourceA.channels.size(); j++){
+                        names.push_back( sourceA.name + "[" + ofToString( j ) + "]" );
+                    }
+                }
+                break;
+            case DISTANCE_FEATURE:
+                names.push_back( "distance(" + sourceA.name + "," + sources[ feature.sourceB ].name + ")" );
+                break;
+            case MAGNITUDE_FEATURE:
+                names.push_back( "magnitude(" + sourceA.name + ")" );
+                break;
+        }
+    }
+
+    return names;
+}
+
+int ofxGrtFeatureSchema::getSourceIndex( const std::string &name ) const {
+    for(size_t i=0; i<sources.size(); i++){
+        if( sources[i].name == name ) return (int)i;
+    }
+    return -1;
+}
+
+void ofxGrtFeatureSchema::fill( Float *featureVector ) const {
+
+    const GatherEntry *gather = gatherList.size() > 0 ? &gatherList[0] : NULL;
+    const size_t numGather = gatherList.size();
+    for(size_t i=0; i<numGather; i++){
+        featureVector[ gather[i].slot ] = *gather[i].source;
+    }
+
+    for(size_t i=0; i<derivedList.size(); i++){
+        const DerivedEntry &entry = derivedList[i];
+        const Float *const *a = &derivedChannels[ entry.begin ];
+        Float sum = 0;
+        if( entry.type == DISTANCE_FEATURE ){
+            const Float *const *b = a + entry.size;
+            for(UINT j=0; j<entry.size; j++){
+                const Float d = *a[j] - *b[j];
+                sum += d * d;
+            }
+        }else{
+            for(UINT j=0; j<entry.size; j++){
+                sum += *a[j] * *a[j];
+            }
+        }
+        featureVector[ entry.slot ] = sqrt( sum );
+    }
+}
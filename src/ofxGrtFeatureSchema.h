@@ -0,0 +1,164 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+
+using namespace GRT;
+
+/**
+ @brief builds a feature vector from named sensor sources. Sensors register their data as named sources (for example "leftHand.body" for the
+ body space coordinates of the left hand joint, or "acc" for an accelerometer), each made up of one or more channels that the sensor keeps
+ up to date. You then describe the feature vector as a list of sources, single channels and derived features (such as the distance between
+ two joints). compile() resolves the names once into a flat list of (source channel, feature slot) pairs, so each update() fills the
+ preallocated feature vector in a single pass without any intermediate vectors or name lookups.
+
+ The source data is read through pointers, so the registered memory must stay valid (and must not be reallocated) while the schema is in use.
+*/
+class ofxGrtFeatureSchema {
+public:
+    enum FeatureType{ COPY_FEATURE=0, DISTANCE_FEATURE, MAGNITUDE_FEATURE };
+
+    ofxGrtFeatureSchema();
+    ~ofxGrtFeatureSchema();
+
+    /**
+     @brief registers a source whose channels are stored contiguously, such as a VectorFloat that is updated in place
+     @param name: the unique name of the source, for example "acc" or "leftHand.world"
+     @param data: a pointer to the first channel
+     @param size: the number of channels
+     @return returns true if the source was added successfully, false otherwise
+    */
+    bool addSource( const std::string &name, const Float *data, const UINT size );
+
+    /**
+     @brief registers a source whose channels are stored in separate variables, such as the x, y and z members of a struct
+     @param name: the unique name of the source
+     @param channels: a pointer to each channel
+     @return returns true if the source was added successfully, false otherwise
+    */
+    bool addSource( const std::string &name, const vector< const Float* > &channels );
+
+    /**
+     @brief adds all the channels of a source to the feature vector
+     @param source: the name of the source
+     @return returns true if the feature was added successfully, false otherwise
+    */
+    bool addFeature( const std::string &source );
+
+    /**
+     @brief adds one channel of a source to the feature vector
+     @param source: the name of the source
+     @param channel: the index of the channel in the source
+     @return returns true if the feature was added successfully, false otherwise
+    */
+    bool addFeature( const std::string &source, const UINT channel );
+
+    /**
+     @brief adds the euclidean distance between two sources with the same number of channels to the feature vector, for example the distance between the hands
+     @param sourceA: the name of the first source
+     @param sourceB: the name of the second source
+     @return returns true if the feature was added successfully, false otherwise
+    */
+    bool addDistanceFeature( const std::string &sourceA, const std::string &sourceB );
+
+    /**
+     @brief adds the magnitude of a source to the feature vector, for example the magnitude of the acceleration
+     @param source: the name of the source
+     @return returns true if the feature was added successfully, false otherwise
+    */
+    bool addMagnitudeFeature( const std::string &source );
+
+    /**
+     @brief resolves the feature list into the gather list and allocates the feature vector. This must be called after the sources and features
+     have been added (or changed), and before update().
+     @return returns true if the schema was compiled successfully, false otherwise
+    */
+    bool compile();
+
+    /**
+     @brief fills the feature vector from the current source data
+     @return returns true if the feature vector was updated successfully, false otherwise
+    */
+    bool update();
+
+    /**
+     @brief fills an external buffer from the current source data, for example the input vector of an ofxGrtPredictor
+     @param featureVector: the buffer to fill, the size must match getNumDimensions()
+     @return returns true if the buffer was updated successfully, false otherwise
+    */
+    bool update( VectorFloat &featureVector );
+
+    /**
+     @brief removes all the sources and features
+     @return returns true if the schema was cleared successfully, false otherwise
+    */
+    bool clear();
+
+    bool getCompiled() const { return compiled; }
+    UINT getNumSources() const { return (UINT)sources.size(); }
+    UINT getNumDimensions() const { return numDimensions; }
+    const VectorFloat &getFeatureVector() const { return featureVector; }
+
+    /**
+     @brief gets a name for each dimension of the feature vector, such as "leftHand.body[0]" or "distance(leftHand.body,rightHand.body)"
+    */
+    vector< std::string > getFeatureNames() const;
+
+protected:
+    struct Source{
+        std::string name;
+        vector< const Float* > channels;
+    };
+
+    struct Feature{
+        FeatureType type;
+        int sourceA;
+        int sourceB;
+        int channel;    ///< The channel to copy, or -1 for all channels
+    };
+
+    struct GatherEntry{
+        const Float *source;
+        UINT slot;
+    };
+
+    struct DerivedEntry{
+        FeatureType type;
+        UINT begin;     ///< The first pointer in derivedChannels, distance features use [begin begin+size) and [begin+size begin+2*size)
+        UINT size;
+        UINT slot;
+    };
+
+    int getSourceIndex( const std::string &name ) const;
+    void fill( Float *featureVector ) const;
+
+    bool compiled;
+    UINT numDimensions;
+    vector< Source > sources;
+    vector< Feature > features;
+    vector< GatherEntry > gatherList;
+    vector< DerivedEntry > derivedList;
+    vector< const Float* > derivedChannels;
+    VectorFloat featureVector;
+    ErrorLog errorLog;
+};
@@ -0,0 +1,466 @@
+
+#include "ofxGrtForestTrainer.h"
+#include <chrono>
+
+using namespace GRT;
+
+ofxGrtForestTrainer::ofxGrtForestTrainer(){
+    errorLog.setProceedingText("[ERROR ofxGrtForestTrainer]");
+    warningLog.setProceedingText("[WARNING ofxGrtForestTrainer]");
+    numTrees = 10;
+    maxDepth = 10;
+    minNumSamplesPerNode = 5;
+    bootstrapWeight = 0.8;
+    numBins = 64;
+    numFeaturesPerSplit = 0;
+    seed = 0;
+    trainingTime = 0;
+    numSamples = 0;
+    numDimensions = 0;
+    numClasses = 0;
+}
+
+ofxGrtForestTrainer::~ofxGrtForestTrainer(){
+}
+
+bool ofxGrtForestTrainer::setup( const UINT numTrees, const UINT maxDepth, const UINT minNumSamplesPerNode, const Float bootstrapWeight ){
+
+    if( numTrees == 0 ){
+        errorLog << "setup(...) - The number of trees must be greater than zero!" << endl;
+        return false;
+    }
+
+    if( bootstrapWeight < 0 || bootstrapWeight > 1 ){
+        errorLog << "setup(...) - The bootstrap weight must be in the range [0 1]!" << endl;
+        return false;
+    }
+
+    this->numTrees = numTrees;
+    this->maxDepth = maxDepth;
+    this->minNumSamplesPerNode = minNumSamplesPerNode;
+    this->bootstrapWeight = bootstrapWeight;
+
+    return true;
+}
+
+bool ofxGrtForestTrainer::setNumBins( const UINT numBins ){
+    if( numBins < 2 || numBins > 256 ){
+        errorLog << "setNumBins(const UINT numBins) - The number of bins must be in the range [2 256]!" << endl;
+        return false;
+    }
+    this->numBins = numBins;
+    return true;
+}
+
+bool ofxGrtForestTrainer::setNumFeaturesPerSplit( const UINT numFeaturesPerSplit ){
+    this->numFeaturesPerSplit = numFeaturesPerSplit;
+    return true;
+}
+
+bool ofxGrtForestTrainer::setSeed( const uint64_t seed ){
+    this->seed = seed;
+    return true;
+}
+
+bool ofxGrtForestTrainer::train( const ClassificationData &trainingData, const bool useScaling, const DecisionTreeNode &nodeType, Vector< DecisionTreeNode* > &trees ){
+
+    auto start = std::chrono::high_resolution_clock::now();
+    trainingTime = 0;
+
+    if( !getIsNodeTypeSupported( &nodeType ) ){
+        errorLog << "train(...) - Only DecisionTreeClusterNode and DecisionTreeThresholdNode trees are supported!" << endl;
+        return false;
+    }
+
+    numSamples = trainingData.getNumSamples();
+    numDimensions = trainingData.getNumDimensions();
+    numClasses = trainingData.getNumClasses();
+
+    if( numSamples == 0 || numDimensions == 0 || numClasses == 0 ){
+        errorLog << "train(...) - The training data is empty!" << endl;
+        return false;
+    }
+
+    //Store the (scaled) training data feature by feature, the same way the GRT scales it
+    const Vector< MinMax > ranges = trainingData.getRanges();
+    vector< Float > values( (size_t)numSamples * numDimensions );
+    labels.resize( numSamples );
+    for(UINT i=0; i<numSamples; i++){
+        labels[i] = trainingData.getClassLabelIndexValue( trainingData[i].getClassLabel() );
+        for(UINT d=0; d<numDimensions; d++){
+            Float x = trainingData[i][d];
+            if( useScaling ){
+                const Float minValue = ranges[d].minValue;
+                const Float maxValue = ranges[d].maxValue;
+                x = minValue == maxValue ? 0 : (((x-minValue)*(1.0-0.0))/(maxValue-minValue))+0.0;
+            }
+            values[ (size_t)d*numSamples + i ] = x;
+        }
+    }
+
+    ofxGrtThreadPool &pool = ofxGrtThreadPool::getSharedPool();
+
+    edges.assign( numDimensions, vector< Float >() );
+    bins.resize( (size_t)numSamples * numDimensions );
+    pool.parallelFor( 0, numDimensions, 1, [&]( const size_t d, const unsigned int threadIndex ){
+        binFeature( (UINT)d, values );
+    });
+
+    //Build each tree of a forest as a separate task, or split a single tree into subtrees
+    vector< Tree > builtTrees( numTrees );
+    if( numTrees == 1 ){
+        vector< UINT > indices;
+        buildParallelTree( indices, builtTrees[0] );
+    }else{
+        //parallelFor runs the trees in order on this thread if the forest is itself trained inside a pool task (for example a cross validation fold)
+        pool.parallelFor( 0, numTrees, 1, [this,&builtTrees]( const size_t t, const unsigned int threadIndex ){
+            vector< UINT > indices;
+            buildTree( (UINT)t, indices, builtTrees[t] );
+        });
+    }
+
+    const bool clusterNodes = dynamic_cast< const DecisionTreeClusterNode* >( &nodeType ) != NULL;
+    for(UINT t=0; t<numTrees; t++){
+        if( clusterNodes ) trees.push_back( createTree< DecisionTreeClusterNode >( builtTrees[t] ) );
+        else trees.push_back( createTree< DecisionTreeThresholdNode >( builtTrees[t] ) );
+    }
+
+    //Free the binned data
+    vector< UINT >().swap( labels );
+    vector< unsigned char >().swap( bins );
+    vector< vector< Float > >().swap( edges );
+
+    trainingTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+
+    return true;
+}
+
+bool ofxGrtForestTrainer::getIsNodeTypeSupported( const DecisionTreeNode *nodeType ){
+    return dynamic_cast< const DecisionTreeClusterNode* >( nodeType ) != NULL || dynamic_cast< const DecisionTreeThresholdNode* >( nodeType ) != NULL;
+}
+
+void ofxGrtForestTrainer::binFeature( const UINT feature, const vector< Float > &values ){
+
+    const Float *x = &values[ (size_t)feature*numSamples ];
+    vector< Float > sorted( x, x + numSamples );
+    std::sort( sorted.begin(), sorted.end() );
+
+    //Use every gap between distinct values if there are few enough, otherwise the gaps at the quantiles
+    vector< Float > &e = edges[ feature ];
+    vector< Float > distinct;
+    std::unique_copy( sorted.begin(), sorted.end(), std::back_inserter( distinct ) );
+    if( distinct.size() <= numBins ){
+        for(size_t i=1; i<distinct.size(); i++){
+            const Float edge = (distinct[i-1] + distinct[i]) / 2;
+            if( e.empty() || edge > e.back() ) e.push_back( edge );
+        }
+    }else{
+        for(UINT b=1; b<numBins; b++){
+            const size_t position = (size_t)b * numSamples / numBins;
+            if( position == 0 ) continue;
+            const Float lower = sorted[ position-1 ];
+            vector< Float >::const_iterator upper = std::upper_bound( sorted.begin(), sorted.end(), lower );
+            if( upper == sorted.end() ) continue;
+            const Float edge = (lower + *upper) / 2;
+            if( e.empty() || edge > e.back() ) e.push_back( edge );
+        }
+    }
+
+    //A value is in bin b if it is >= the first b edges, so bin > b is the same as x >= e[b]
+    unsigned char *b = &bins[ (size_t)feature*numSamples ];
+    for(UINT i=0; i<numSamples; i++){
+        b[i] = (unsigned char)( std::upper_bound( e.begin(), e.end(), x[i] ) - e.begin() );
+    }
+}
+
+void ofxGrtForestTrainer::buildTree( const UINT treeIndex, vector< UINT > &indices, Tree &tree ) const {
+
+    Scratch scratch;
+    initScratch( scratch );
+
+    NodeTask root;
+    root.begin = 0;
+    root.end = getSampleIndices( treeIndex, indices );
+    root.depth = 0;
+    root.seed = getTreeSeed( treeIndex );
+    root.parent = -1;
+    root.isRight = false;
+
+    buildSubtree( root, indices, tree, scratch );
+}
+
+void ofxGrtForestTrainer::buildParallelTree( vector< UINT > &indices, Tree &tree ) const {
+
+    Scratch scratch;
+    initScratch( scratch );
+
+    NodeTask root;
+    root.begin = 0;
+    root.end = getSampleIndices( 0, indices );
+    root.depth = 0;
+    root.seed = getTreeSeed( 0 );
+    root.parent = -1;
+    root.isRight = false;
+
+    //Split the top of the tree breadth first, searching the features of each split in parallel
+    std::deque< NodeTask > openNodes( 1, root );
+    while( !openNodes.empty() && openNodes.size() < NUM_SUBTREE_TASKS ){
+        const NodeTask task = openNodes.front();
+        openNodes.pop_front();
+        NodeTask children[2];
+        if( splitNode( task, indices, tree, scratch, children, true ) ){
+            openNodes.push_back( children[0] );
+            openNodes.push_back( children[1] );
+        }
+    }
+
+    //Build the remaining subtrees as separate tasks, each subtree works on its own range of the sample indices
+    const vector< NodeTask > subtreeRoots( openNodes.begin(), openNodes.end() );
+    vector< Tree > subtrees( subtreeRoots.size() );
+    ofxGrtThreadPool &pool = ofxGrtThreadPool::getSharedPool();
+    pool.parallelFor( 0, subtreeRoots.size(), 1, [this,&subtreeRoots,&subtrees,&indices]( const size_t s, const unsigned int threadIndex ){
+        Scratch subtreeScratch;
+        initScratch( subtreeScratch );
+        NodeTask subtreeRoot = subtreeRoots[s];
+        subtreeRoot.parent = -1;
+        buildSubtree( subtreeRoot, indices, subtrees[s], subtreeScratch );
+    });
+
+    //Append the subtrees to the tree and link them to their parents
+    for(size_t s=0; s<subtrees.size(); s++){
+        const int offset = (int)tree.nodes.size();
+        for(size_t i=0; i<subtrees[s].nodes.size(); i++){
+            TreeNode node = subtrees[s].nodes[i];
+            if( node.left >= 0 ){
+                node.left += offset;
+                node.right += offset;
+            }
+            tree.nodes.push_back( node );
+        }
+        tree.probabilities.insert( tree.probabilities.end(), subtrees[s].probabilities.begin(), subtrees[s].probabilities.end() );
+
+        TreeNode &parent = tree.nodes[ subtreeRoots[s].parent ];
+        if( subtreeRoots[s].isRight ) parent.right = offset;
+        else parent.left = offset;
+    }
+}
+
+void ofxGrtForestTrainer::buildSubtree( const NodeTask &root, vector< UINT > &indices, Tree &tree, Scratch &scratch ) const {
+
+    vector< NodeTask > stack( 1, root );
+    while( !stack.empty() ){
+        const NodeTask task = stack.back();
+        stack.pop_back();
+        NodeTask children[2];
+        if( splitNode( task, indices, tree, scratch, children, false ) ){
+            stack.push_back( children[1] );
+            stack.push_back( children[0] );
+        }
+    }
+}
+
+bool ofxGrtForestTrainer::splitNode( const NodeTask &task, vector< UINT > &indices, Tree &tree, Scratch &scratch, NodeTask children[2], const bool parallel ) const {
+
+    const UINT index = (UINT)tree.nodes.size();
+    const UINT n = task.end - task.begin;
+
+    std::fill( scratch.counts.begin(), scratch.counts.end(), 0 );
+    for(UINT j=task.begin; j<task.end; j++){
+        scratch.counts[ labels[ indices[j] ] ]++;
+    }
+
+    TreeNode node;
+    node.feature = 0;
+    node.threshold = 0;
+    node.left = -1;
+    node.right = -1;
+    node.size = n;
+    node.depth = task.depth;
+    tree.nodes.push_back( node );
+
+    if( task.parent >= 0 ){
+        if( task.isRight ) tree.nodes[ task.parent ].right = index;
+        else tree.nodes[ task.parent ].left = index;
+    }
+
+    bool pure = false;
+    for(UINT k=0; k<numClasses; k++){
+        tree.probabilities.push_back( n > 0 ? scratch.counts[k] / Float(n) : 0 );
+        if( scratch.counts[k] == n ) pure = true;
+    }
+
+    if( task.depth >= maxDepth || n <= minNumSamplesPerNode || pure ) return false;
+
+    //Pick the features to search, either all of them or a random subset seeded by the node
+    const UINT numFeatures = numFeaturesPerSplit > 0 && numFeaturesPerSplit < numDimensions ? numFeaturesPerSplit : numDimensions;
+    for(UINT d=0; d<numDimensions; d++) scratch.features[d] = d;
+    if( numFeatures < numDimensions ){
+        uint64_t state = task.seed;
+        for(UINT i=0; i<numFeatures; i++){
+            std::swap( scratch.features[i], scratch.features[ i + next( state ) % (numDimensions - i) ] );
+        }
+    }
+
+    if( parallel && numFeatures > 1 && (size_t)n * numFeatures >= MIN_PARALLEL_SPLIT_SIZE ){
+        ofxGrtThreadPool &pool = ofxGrtThreadPool::getSharedPool();
+        vector< Scratch > threadScratch( pool.getNumThreads() );
+        for(size_t t=0; t<threadScratch.size(); t++) initScratch( threadScratch[t] );
+        pool.parallelFor( 0, numFeatures, 1, [&]( const size_t i, const unsigned int threadIndex ){
+            Scratch &s = threadScratch[ threadIndex ];
+            scratch.splits[i] = findSplit( scratch.features[i], task, indices, scratch.counts, s.histogram, s.leftCounts );
+        });
+    }else{
+        for(UINT i=0; i<numFeatures; i++){
+            scratch.splits[i] = findSplit( scratch.features[i], task, indices, scratch.counts, scratch.histogram, scratch.leftCounts );
+        }
+    }
+
+    //Keep the first best split, so the result does not depend on how the search was run
+    Split best;
+    best.score = -1;
+    best.bin = 0;
+    UINT bestFeature = 0;
+    for(UINT i=0; i<numFeatures; i++){
+        if( scratch.splits[i].score > best.score ){
+            best = scratch.splits[i];
+            bestFeature = scratch.features[i];
+        }
+    }
+
+    if( best.score < 0 ) return false;
+
+    const unsigned char *b = &bins[ (size_t)bestFeature*numSamples ];
+    const UINT bestBin = best.bin;
+    const UINT mid = (UINT)( std::stable_partition( indices.begin() + task.begin, indices.begin() + task.end, [b,bestBin]( const UINT i ){ return b[i] <= bestBin; } ) - indices.begin() );
+
+    tree.nodes[ index ].feature = bestFeature;
+    tree.nodes[ index ].threshold = edges[ bestFeature ][ bestBin ];
+
+    for(UINT c=0; c<2; c++){
+        children[c].begin = c == 0 ? task.begin : mid;
+        children[c].end = c == 0 ? mid : task.end;
+        children[c].depth = task.depth + 1;
+        children[c].seed = mix( task.seed * 2 + c + 1 );
+        children[c].parent = (int)index;
+        children[c].isRight = c == 1;
+    }
+
+    return true;
+}
+
+ofxGrtForestTrainer::Split ofxGrtForestTrainer::findSplit( const UINT feature, const NodeTask &task, const vector< UINT > &indices, const vector< UINT > &counts, vector< UINT > &histogram, vector< UINT > &leftCounts ) const {
+
+    Split best;
+    best.score = -1;
+    best.bin = 0;
+
+    const UINT numEdges = (UINT)edges[ feature ].size();
+    if( numEdges == 0 ) return best;
+
+    //Count the classes in each bin
+    const UINT K = numClasses;
+    const unsigned char *b = &bins[ (size_t)feature*numSamples ];
+    std::fill( histogram.begin(), histogram.begin() + (numEdges+1)*K, 0 );
+    for(UINT j=task.begin; j<task.end; j++){
+        const UINT i = indices[j];
+        histogram[ b[i]*K + labels[i] ]++;
+    }
+
+    //Move one bin at a time from the right to the left child, the Gini impurity is lowest when sum_k(l_k^2)/nL + sum_k(r_k^2)/nR is highest
+    const UINT n = task.end - task.begin;
+    int64_t sumLeft = 0;
+    int64_t sumRight = 0;
+    for(UINT k=0; k<K; k++){
+        leftCounts[k] = 0;
+        sumRight += (int64_t)counts[k] * counts[k];
+    }
+
+    UINT numLeft = 0;
+    for(UINT bin=0; bin<numEdges; bin++){
+        const UINT *row = &histogram[ bin*K ];
+        for(UINT k=0; k<K; k++){
+            const int64_t h = row[k];
+            if( h == 0 ) continue;
+            const int64_t l = leftCounts[k];
+            const int64_t r = counts[k] - l;
+            sumLeft += (2*l + h) * h;
+            sumRight -= (2*r - h) * h;
+            leftCounts[k] += (UINT)h;
+            numLeft += (UINT)h;
+        }
+        if( numLeft == 0 ) continue;
+        if( numLeft == n ) break;
+
+        const double score = sumLeft / double(numLeft) + sumRight / double(n - numLeft);
+        if( score > best.score ){
+            best.score = score;
+            best.bin = bin;
+        }
+    }
+
+    return best;
+}
+
+void ofxGrtForestTrainer::initScratch( Scratch &scratch ) const {
+    scratch.histogram.resize( (size_t)numBins * numClasses );
+    scratch.counts.resize( numClasses );
+    scratch.leftCounts.resize( numClasses );
+    scratch.features.resize( numDimensions );
+    scratch.splits.resize( numDimensions );
+}
+
+UINT ofxGrtForestTrainer::getSampleIndices( const UINT treeIndex, vector< UINT > &indices ) const {
+
+    if( bootstrapWeight <= 0 ){
+        indices.resize( numSamples );
+        for(UINT i=0; i<numSamples; i++) indices[i] = i;
+        return numSamples;
+    }
+
+    const UINT size = std::max( 1u, (UINT)(numSamples * bootstrapWeight) );
+    uint64_t state = getTreeSeed( treeIndex );
+    indices.resize( size );
+    for(UINT i=0; i<size; i++){
+        indices[i] = (UINT)( next( state ) % numSamples );
+    }
+    return size;
+}
+
+uint64_t ofxGrtForestTrainer::getTreeSeed( const UINT treeIndex ) const {
+    return mix( seed ^ mix( treeIndex + 1 ) );
+}
+
+uint64_t ofxGrtForestTrainer::mix( uint64_t x ){
+    //The splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+template< class NodeType >
+DecisionTreeNode *ofxGrtForestTrainer::createTree( const Tree &tree ) const {
+
+    vector< NodeType* > nodes( tree.nodes.size() );
+    for(size_t i=0; i<nodes.size(); i++){
+        nodes[i] = new NodeType();
+    }
+
+    VectorFloat classProbabilities( numClasses );
+    for(size_t i=0; i<nodes.size(); i++){
+        const TreeNode &node = tree.nodes[i];
+        std::copy( tree.probabilities.begin() + i*numClasses, tree.probabilities.begin() + (i+1)*numClasses, classProbabilities.begin() );
+        if( node.left < 0 ){
+            nodes[i]->setLeafNode( node.size, classProbabilities );
+        }else{
+            nodes[i]->set( node.size, node.feature, node.threshold, classProbabilities );
+            nodes[i]->setLeftChild( nodes[ node.left ] );
+            nodes[i]->setRightChild( nodes[ node.right ] );
+            nodes[ node.left ]->setParent( nodes[i] );
+            nodes[ node.right ]->setParent( nodes[i] );
+        }
+        nodes[i]->setDepth( node.depth );
+        nodes[i]->setNodeID( (UINT)i );
+    }
+
+    return nodes.size() > 0 ? nodes[0] : NULL;
+}
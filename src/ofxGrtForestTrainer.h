@@ -0,0 +1,176 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <stdint.h>
+
+#include "ofMain.h"
+#include "ofxGrtThreadPool.h"
+
+using namespace GRT;
+
+/**
+ @brief builds GRT decision trees in parallel, this is used by ofxGrtRandomForests and ofxGrtDecisionTree to train their trees. Before training,
+ each feature is split into at most numBins bins at the quantiles of the training data and each sample is replaced by its bin index. A node is
+ then split by building a class histogram of its samples for each feature and scanning the bins for the split with the lowest Gini impurity, so
+ finding a split costs one pass over the samples in the node rather than a sort. Thresholds are placed half way between neighbouring training values.
+
+ The trees of a forest are built as separate tasks on the shared work stealing ofxGrtThreadPool. A single tree is split breadth first on the calling
+ thread (with the features of each split searched in parallel) until it has enough open nodes, and the subtrees are then built as separate tasks.
+ When the trainer itself runs inside a pool task (such as a cross validation fold), the trees are built one after another on that task's thread.
+ All the random choices (the bootstrap sample of each tree and the features tried at each node) are seeded from the trainer seed, the tree index
+ and the position of the node in the tree, so the same data and seed always give the same trees, whatever the number of threads.
+*/
+class ofxGrtForestTrainer {
+public:
+    ofxGrtForestTrainer();
+    ~ofxGrtForestTrainer();
+
+    /**
+     @brief sets the size of the trees
+     @param numTrees: the number of trees to build
+     @param maxDepth: nodes at this depth become leaves
+     @param minNumSamplesPerNode: nodes with this many samples or less become leaves
+     @param bootstrapWeight: each tree is trained on a bootstrap sample (drawn with replacement) of this fraction of the training data,
+     if zero then every tree is trained on all the training data
+     @return returns true if the parameters were set successfully, false otherwise
+    */
+    bool setup( const UINT numTrees, const UINT maxDepth, const UINT minNumSamplesPerNode, const Float bootstrapWeight );
+
+    /**
+     @brief sets the maximum number of bins each feature is split into, in the range [2 256]
+    */
+    bool setNumBins( const UINT numBins );
+
+    /**
+     @brief sets the number of randomly chosen features searched at each node, if zero (the default) every feature is searched
+    */
+    bool setNumFeaturesPerSplit( const UINT numFeaturesPerSplit );
+
+    /**
+     @brief sets the seed used for the bootstrap samples and the random features
+    */
+    bool setSeed( const uint64_t seed );
+
+    /**
+     @brief builds the trees. The nodes have the same type as nodeType and split the samples the same way as the GRT (samples with
+     x[feature] >= threshold go to the right child), so the trees can be used by a GRT DecisionTree or RandomForests model.
+     @param trainingData: the training data
+     @param useScaling: if true the training data is scaled to [0 1] with its ranges before training, as the GRT does
+     @param nodeType: the type of node to create, this must be a DecisionTreeClusterNode or a DecisionTreeThresholdNode
+     @param trees: the root node of each tree will be added to this vector, the caller owns the trees
+     @return returns true if the trees were built successfully, false otherwise
+    */
+    bool train( const ClassificationData &trainingData, const bool useScaling, const DecisionTreeNode &nodeType, Vector< DecisionTreeNode* > &trees );
+
+    UINT getNumTrees() const { return numTrees; }
+    UINT getMaxDepth() const { return maxDepth; }
+    UINT getMinNumSamplesPerNode() const { return minNumSamplesPerNode; }
+    UINT getNumBins() const { return numBins; }
+    UINT getNumFeaturesPerSplit() const { return numFeaturesPerSplit; }
+    uint64_t getSeed() const { return seed; }
+    Float getBootstrapWeight() const { return bootstrapWeight; }
+
+    /**
+     @brief gets the time taken by the last call to train
+     @return returns the training time in milliseconds
+    */
+    double getTrainingTime() const { return trainingTime; }
+
+    /**
+     @brief returns true if the trainer can create nodes of the same type as nodeType
+    */
+    static bool getIsNodeTypeSupported( const DecisionTreeNode *nodeType );
+
+protected:
+    static const UINT NUM_SUBTREE_TASKS = 64;       ///< The number of open nodes a single tree is split into before the subtrees are built in parallel
+    static const UINT MIN_PARALLEL_SPLIT_SIZE = 4096;  ///< The minimum number of samples x features for a split to be searched in parallel
+
+    struct TreeNode{
+        UINT feature;
+        Float threshold;
+        int left;           ///< The index of the left child, or -1 if the node is a leaf
+        int right;
+        UINT size;
+        UINT depth;
+    };
+
+    struct Tree{
+        vector< TreeNode > nodes;
+        vector< Float > probabilities;  ///< The class probabilities of each node [numNodes x numClasses]
+    };
+
+    struct NodeTask{
+        UINT begin;         ///< The range of the node's samples in the sample index array
+        UINT end;
+        UINT depth;
+        uint64_t seed;
+        int parent;         ///< The index of the parent in the tree, or -1 for the root of a (sub)tree
+        bool isRight;
+    };
+
+    struct Split{
+        double score;       ///< The sum over both children of sum_k(count_k^2)/size, larger is a lower Gini impurity, negative if there is no split
+        UINT bin;
+    };
+
+    struct Scratch{
+        vector< UINT > histogram;
+        vector< UINT > counts;
+        vector< UINT > leftCounts;
+        vector< UINT > features;
+        vector< Split > splits;
+    };
+
+    void binFeature( const UINT feature, const vector< Float > &values );
+    void buildTree( const UINT treeIndex, vector< UINT > &indices, Tree &tree ) const;
+    void buildParallelTree( vector< UINT > &indices, Tree &tree ) const;
+    void buildSubtree( const NodeTask &root, vector< UINT > &indices, Tree &tree, Scratch &scratch ) const;
+    bool splitNode( const NodeTask &task, vector< UINT > &indices, Tree &tree, Scratch &scratch, NodeTask children[2], const bool parallel ) const;
+    Split findSplit( const UINT feature, const NodeTask &task, const vector< UINT > &indices, const vector< UINT > &counts, vector< UINT > &histogram, vector< UINT > &leftCounts ) const;
+    void initScratch( Scratch &scratch ) const;
+    UINT getSampleIndices( const UINT treeIndex, vector< UINT > &indices ) const;
+    uint64_t getTreeSeed( const UINT treeIndex ) const;
+    template< class NodeType > DecisionTreeNode *createTree( const Tree &tree ) const;
+
+    static uint64_t mix( uint64_t x );
+    static uint64_t next( uint64_t &state ) { state += 0x9E3779B97F4A7C15ULL; return mix( state ); }
+
+    UINT numTrees;
+    UINT maxDepth;
+    UINT minNumSamplesPerNode;
+    UINT numBins;
+    UINT numFeaturesPerSplit;
+    uint64_t seed;
+    Float bootstrapWeight;
+    double trainingTime;
+
+    //The binned training data, used while training
+    UINT numSamples;
+    UINT numDimensions;
+    UINT numClasses;
+    vector< UINT > labels;              ///< The class index of each sample
+    vector< unsigned char > bins;       ///< The bin of each sample, feature by feature [numDimensions x numSamples]
+    vector< vector< Float > > edges;    ///< The thresholds between the bins of each feature, bin b holds the values in [edges[b-1] edges[b])
+
+    ErrorLog errorLog;
+    WarningLog warningLog;
+};
@@ -0,0 +1,366 @@
+
+#include "ofxGrtGaussianEvaluator.h"
+
+using namespace GRT;
+using namespace ofxGrtSimd;
+
+ofxGrtGaussianEvaluator::ofxGrtGaussianEvaluator(){
+    errorLog.setProceedingText("[ERROR ofxGrtGaussianEvaluator]");
+    clear();
+}
+
+ofxGrtGaussianEvaluator::~ofxGrtGaussianEvaluator(){
+}
+
+bool ofxGrtGaussianEvaluator::setup( const ANBC &anbc ){
+
+    clear();
+
+    if( !anbc.getTrained() ){
+        errorLog << "setup(const ANBC &anbc) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    const Vector< ANBC_Model > models = anbc.getModels();
+    if( models.size() == 0 ){
+        errorLog << "setup(const ANBC &anbc) - The model has no classes!" << endl;
+        return false;
+    }
+
+    numInputDimensions = anbc.getNumInputDimensions();
+    numClasses = (UINT)models.size();
+    numTerms = numInputDimensions;
+    fullCovariance = false;
+    logDistances = true;
+    useScaling = anbc.getScalingEnabled();
+    useNullRejection = anbc.getNullRejectionEnabled();
+    ranges = anbc.getRanges();
+
+    //log(gauss(x,mu,sigma)*w) = log(w) - log(sigma*sqrt(2PI)) - (x-mu)^2/(2*sigma^2), dimensions with a zero sigma are skipped as in the GRT
+    const double sqrtTwoPI = sqrt( 2.0 * PI );
+    vector< float > mu( numInputDimensions );
+    vector< float > precision( numInputDimensions );
+    for(UINT k=0; k<numClasses; k++){
+        double logNormalizer = 0;
+        for(UINT d=0; d<numInputDimensions; d++){
+            const double sigma = models[k].sigma[d];
+            mu[d] = (float)models[k].mu[d];
+            if( sigma > 0 ){
+                logNormalizer += log( models[k].weights[d] ) - log( sigma * sqrtTwoPI );
+                precision[d] = (float)(-1.0 / (2.0 * sigma * sigma));
+            }else precision[d] = 0;
+        }
+        classGaussians.push_back( numGaussians );
+        classLabels.push_back( models[k].classLabel );
+        rejectionThresholds.push_back( (float)models[k].threshold );
+        addGaussian( mu, precision, (float)logNormalizer );
+    }
+    classGaussians.push_back( numGaussians );
+
+    trained = true;
+    return true;
+}
+
+bool ofxGrtGaussianEvaluator::setup( const GMM &gmm ){
+
+    clear();
+
+    if( !gmm.getTrained() ){
+        errorLog << "setup(const GMM &gmm) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    //Copy the mixture models, as the GRT only gives access to the Gaussians through non const functions
+    Vector< MixtureModel > models = ofxGrtModelAccess::getMixtureModels( gmm );
+    const UINT numMixtureModels = ofxGrtModelAccess::getNumMixtureModels( gmm );
+    const UINT N = gmm.getNumInputDimensions();
+    numInputDimensions = N;
+    numClasses = (UINT)models.size();
+    numTerms = N*(N+1)/2;
+    fullCovariance = true;
+    logDistances = false;
+    useScaling = gmm.getScalingEnabled();
+    useNullRejection = gmm.getNullRejectionEnabled();
+    ranges = gmm.getRanges();
+
+    if( numClasses == 0 || numMixtureModels == 0 ){
+        errorLog << "setup(const GMM &gmm) - The model has no classes!" << endl;
+        clear();
+        return false;
+    }
+
+    //log(gauss(x)) = -0.5*log((2PI)^N * det(sigma)) - 0.5*(x-mu)^T inv(sigma) (x-mu)
+    const double logTwoPI = log( 2.0 * PI );
+    vector< float > mu( N );
+    vector< float > precision( numTerms );
+    for(UINT k=0; k<numClasses; k++){
+        classGaussians.push_back( numGaussians );
+        classLabels.push_back( models[k].getClassLabel() );
+        const Float threshold = models[k].getNullRejectionThreshold();
+        rejectionThresholds.push_back( threshold > 0 ? (float)log( threshold ) : -grt_numeric_limits< float >::max() );
+
+        for(UINT j=0; j<numMixtureModels; j++){
+            const GuassModel &gaussian = models[k][j];
+            if( gaussian.det <= 0 || gaussian.mu.size() != N || gaussian.invSigma.getNumRows() != N || gaussian.invSigma.getNumCols() != N ){
+                errorLog << "setup(const GMM &gmm) - Gaussian " << j << " of class " << k << " is not valid!" << endl;
+                clear();
+                return false;
+            }
+            UINT t = 0;
+            for(UINT a=0; a<N; a++){
+                mu[a] = (float)gaussian.mu[a];
+                precision[t++] = (float)(-0.5 * gaussian.invSigma[a][a]);
+                for(UINT b=a+1; b<N; b++){
+                    precision[t++] = (float)(-0.5 * (gaussian.invSigma[a][b] + gaussian.invSigma[b][a]));
+                }
+            }
+            addGaussian( mu, precision, (float)(-0.5 * (N * logTwoPI + log( gaussian.det ))) );
+        }
+    }
+    classGaussians.push_back( numGaussians );
+    trained = true;
+
+    //The GRT divides each mixture by a normalization factor, which is not exposed, so measure it at the mean of the first Gaussian of each class
+    //and check it at the mean of the last one. If the two disagree the mixture is not a sum of the Gaussians above, so it is not supported.
+    VectorFloat x( N );
+    vector< float > xf( N );
+    for(UINT k=0; k<numClasses; k++){
+        Float logOffset = 0;
+        for(UINT pass=0; pass<2; pass++){
+            const UINT j = pass == 0 ? 0 : numMixtureModels-1;
+            for(UINT d=0; d<N; d++){
+                x[d] = models[k][j].mu[d];
+                xf[d] = (float)x[d];
+            }
+            computeLogLikelihoods( &xf[0], &deltas[0], &gaussianLogLikelihoods[0], &classLogLikelihoods[0] );
+            const Float likelihood = models[k].computeMixtureLikelihood( x );
+            if( !(likelihood > 0) || grt_isinf( likelihood ) ){
+                errorLog << "setup(const GMM &gmm) - The likelihood of class " << k << " at its mean is not valid: " << likelihood << endl;
+                clear();
+                return false;
+            }
+            const Float offset = log( likelihood ) - classLogLikelihoods[k];
+            if( pass == 0 ){
+                logOffset = offset;
+            }else if( fabs( offset - logOffset ) > 1.0e-3 ){
+                errorLog << "setup(const GMM &gmm) - The mixture model of class " << k << " does not match the precomputed Gaussians!" << endl;
+                clear();
+                return false;
+            }
+        }
+        for(UINT c=classGaussians[k]; c<classGaussians[k+1]; c++){
+            logNormalizers[c] += (float)logOffset;
+        }
+    }
+
+    return true;
+}
+
+bool ofxGrtGaussianEvaluator::predict( const VectorFloat &inputVector ){
+
+    if( !trained ){
+        errorLog << "predict(const VectorFloat &inputVector) - The evaluator has not been setup!" << endl;
+        return false;
+    }
+
+    if( inputVector.size() != numInputDimensions ){
+        errorLog << "predict(const VectorFloat &inputVector) - The size of the input vector (" << inputVector.size() << ") does not match the number of input dimensions (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    if( useScaling ){
+        scale( &inputVector[0], &scaledInput[0] );
+    }else{
+        for(UINT d=0; d<numInputDimensions; d++) scaledInput[d] = (float)inputVector[d];
+    }
+
+    computeLogLikelihoods( &scaledInput[0], &deltas[0], &gaussianLogLikelihoods[0], &classLogLikelihoods[0] );
+
+    for(UINT k=0; k<numClasses; k++){
+        classDistances[k] = logDistances ? classLogLikelihoods[k] : exp( (Float)classLogLikelihoods[k] );
+    }
+    const UINT bestIndex = getLabelIndex( &classLogLikelihoods[0], &classLikelihoods[0], maximumLikelihood );
+    const bool accept = !useNullRejection || classLogLikelihoods[ bestIndex ] >= rejectionThresholds[ bestIndex ];
+    predictedClassLabel = accept ? classLabels[ bestIndex ] : GRT_DEFAULT_NULL_CLASS_LABEL;
+
+    return true;
+}
+
+bool ofxGrtGaussianEvaluator::predict( const Float *inputs, const UINT numSamples, UINT *predictedClassLabels, Float *maximumLikelihoods, Float *classLikelihoods ) const {
+
+    if( !trained ){
+        errorLog << "predict(const Float *inputs, ...) - The evaluator has not been setup!" << endl;
+        return false;
+    }
+
+    if( inputs == NULL || predictedClassLabels == NULL ){
+        errorLog << "predict(const Float *inputs, ...) - The inputs and predicted class labels can not be NULL!" << endl;
+        return false;
+    }
+
+    const UINT N = numInputDimensions;
+    const UINT K = numClasses;
+    vector< float > x( N );
+    vector< float > deltaScratch( deltas.size() );
+    vector< float > gaussianScratch( gaussianLogLikelihoods.size() );
+    vector< float > classScratch( K );
+
+    for(UINT s=0; s<numSamples; s++){
+        const Float *input = inputs + (size_t)s * N;
+        if( useScaling ){
+            scale( input, &x[0] );
+        }else{
+            for(UINT d=0; d<N; d++) x[d] = (float)input[d];
+        }
+
+        computeLogLikelihoods( &x[0], &deltaScratch[0], &gaussianScratch[0], &classScratch[0] );
+
+        Float maxLikelihood = 0;
+        const UINT bestIndex = getLabelIndex( &classScratch[0], classLikelihoods ? classLikelihoods + (size_t)s * K : NULL, maxLikelihood );
+        const bool accept = !useNullRejection || classScratch[ bestIndex ] >= rejectionThresholds[ bestIndex ];
+        predictedClassLabels[s] = accept ? classLabels[ bestIndex ] : GRT_DEFAULT_NULL_CLASS_LABEL;
+        if( maximumLikelihoods ) maximumLikelihoods[s] = maxLikelihood;
+    }
+
+    return true;
+}
+
+bool ofxGrtGaussianEvaluator::clear(){
+    trained = false;
+    useScaling = false;
+    useNullRejection = false;
+    fullCovariance = false;
+    logDistances = true;
+    numInputDimensions = 0;
+    numClasses = 0;
+    numGaussians = 0;
+    numTerms = 0;
+    ranges.clear();
+    classLabels.clear();
+    rejectionThresholds.clear();
+    classGaussians.clear();
+    means.clear();
+    precisions.clear();
+    logNormalizers.clear();
+    predictedClassLabel = 0;
+    maximumLikelihood = 0;
+    scaledInput.clear();
+    deltas.clear();
+    gaussianLogLikelihoods.clear();
+    classLogLikelihoods.clear();
+    classLikelihoods.clear();
+    classDistances.clear();
+    return true;
+}
+
+void ofxGrtGaussianEvaluator::addGaussian( const vector< float > &mu, const vector< float > &precision, const float logNormalizer ){
+
+    const UINT N = numInputDimensions;
+    const UINT lane = numGaussians % WIDTH;
+
+    //Start a new block, with the unused lanes set so they never win
+    if( lane == 0 ){
+        means.resize( means.size() + N*WIDTH, 0 );
+        precisions.resize( precisions.size() + numTerms*WIDTH, 0 );
+        logNormalizers.resize( logNormalizers.size() + WIDTH, -grt_numeric_limits< float >::max() );
+    }
+
+    const UINT block = numGaussians / WIDTH;
+    for(UINT d=0; d<N; d++){
+        means[ (block*N + d)*WIDTH + lane ] = mu[d];
+    }
+    for(UINT t=0; t<numTerms; t++){
+        precisions[ (block*numTerms + t)*WIDTH + lane ] = precision[t];
+    }
+    logNormalizers[ numGaussians ] = logNormalizer;
+    numGaussians++;
+
+    scaledInput.resize( N );
+    deltas.resize( N*WIDTH );
+    gaussianLogLikelihoods.resize( logNormalizers.size() );
+    classLogLikelihoods.resize( numClasses );
+    classLikelihoods.resize( numClasses );
+    classDistances.resize( numClasses );
+}
+
+void ofxGrtGaussianEvaluator::scale( const Float *input, float *scaledInput ) const {
+    for(UINT d=0; d<numInputDimensions; d++){
+        const Float minValue = ranges[d].minValue;
+        const Float maxValue = ranges[d].maxValue;
+        scaledInput[d] = (float)(minValue == maxValue ? 0 : (((input[d]-minValue)*(1.0-0.0))/(maxValue-minValue))+0.0);
+    }
+}
+
+void ofxGrtGaussianEvaluator::computeLogLikelihoods( const float *x, float *deltas, float *gaussianLogLikelihoods, float *classLogLikelihoods ) const {
+
+    const UINT N = numInputDimensions;
+    const UINT numBlocks = (UINT)logNormalizers.size() / WIDTH;
+
+    //The log likelihood of four Gaussians at a time, logNormalizer + sum of the precision terms
+    for(UINT b=0; b<numBlocks; b++){
+        const float *mu = &means[ b*N*WIDTH ];
+        const float *precision = &precisions[ b*numTerms*WIDTH ];
+        float4 logLikelihood = load( &logNormalizers[ b*WIDTH ] );
+
+        if( fullCovariance ){
+            for(UINT d=0; d<N; d++){
+                store( deltas + d*WIDTH, sub( set1( x[d] ), load( mu + d*WIDTH ) ) );
+            }
+            //Row a of the upper triangle, delta_a * sum_{b>=a} precision_ab * delta_b
+            for(UINT a=0; a<N; a++){
+                float4 row = set1( 0 );
+                for(UINT c=a; c<N; c++){
+                    row = madd( load( precision ), load( deltas + c*WIDTH ), row );
+                    precision += WIDTH;
+                }
+                logLikelihood = madd( load( deltas + a*WIDTH ), row, logLikelihood );
+            }
+        }else{
+            for(UINT d=0; d<N; d++){
+                const float4 delta = sub( set1( x[d] ), load( mu + d*WIDTH ) );
+                logLikelihood = madd( mul( delta, delta ), load( precision + d*WIDTH ), logLikelihood );
+            }
+        }
+
+        store( gaussianLogLikelihoods + b*WIDTH, logLikelihood );
+    }
+
+    //Combine the Gaussians of each class, log(sum(exp(l))) is only needed for mixtures
+    for(UINT k=0; k<numClasses; k++){
+        const UINT begin = classGaussians[k];
+        const UINT end = classGaussians[k+1];
+        if( end - begin == 1 ){
+            classLogLikelihoods[k] = gaussianLogLikelihoods[ begin ];
+            continue;
+        }
+        float maxValue = gaussianLogLikelihoods[ begin ];
+        for(UINT c=begin+1; c<end; c++) maxValue = std::max( maxValue, gaussianLogLikelihoods[c] );
+        float sum = 0;
+        for(UINT c=begin; c<end; c++) sum += exp( gaussianLogLikelihoods[c] - maxValue );
+        classLogLikelihoods[k] = maxValue + log( sum );
+    }
+}
+
+UINT ofxGrtGaussianEvaluator::getLabelIndex( const float *classLogLikelihoods, Float *classLikelihoods, Float &maximumLikelihood ) const {
+
+    //The first class with the highest likelihood wins, as in the GRT
+    UINT bestIndex = 0;
+    for(UINT k=1; k<numClasses; k++){
+        if( classLogLikelihoods[k] > classLogLikelihoods[ bestIndex ] ) bestIndex = k;
+    }
+
+    //The normalized likelihood of class k is exp(l_k - l_best) / sum(exp(l_j - l_best))
+    const float bestLogLikelihood = classLogLikelihoods[ bestIndex ];
+    Float sum = 0;
+    for(UINT k=0; k<numClasses; k++){
+        const Float likelihood = exp( (Float)(classLogLikelihoods[k] - bestLogLikelihood) );
+        if( classLikelihoods ) classLikelihoods[k] = likelihood;
+        sum += likelihood;
+    }
+    if( classLikelihoods ){
+        for(UINT k=0; k<numClasses; k++) classLikelihoods[k] /= sum;
+    }
+    maximumLikelihood = 1.0 / sum;
+
+    return bestIndex;
+}
@@ -0,0 +1,135 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+#include "ofxGrtModelAccess.h"
+#include "ofxGrtSimd.h"
+
+using namespace GRT;
+
+/**
+ @brief a precomputed copy of a trained ANBC or GMM model for fast prediction. The GRT evaluates each class with a scalar loop of gauss()
+ calls, each with its own exp and log. The evaluator folds the weights, sigmas and determinants into one log normalizer per Gaussian at
+ setup, and stores the means and inverse (co)variances of four Gaussians side by side, so the log likelihood of every Gaussian of every
+ class is computed in one SIMD pass with no exp or log. The log likelihoods are only exponentiated to report the normalized class likelihoods
+ (and, for GMM, the class distances, which the GRT reports as likelihoods rather than log likelihoods).
+
+ The class labels, likelihoods, distances and null rejection match the GRT model, up to float rounding. The likelihoods are normalized in log
+ space, so they stay valid for inputs far from every class, where the GRT's exp underflows to zero. The evaluator is independent of the
+ original model, so it needs to be setup again if the model is retrained.
+*/
+class ofxGrtGaussianEvaluator {
+public:
+    ofxGrtGaussianEvaluator();
+    ~ofxGrtGaussianEvaluator();
+
+    /**
+     @brief precomputes a trained ANBC model
+     @param anbc: the trained model
+     @return returns true if the model was setup successfully, false otherwise
+    */
+    bool setup( const ANBC &anbc );
+
+    /**
+     @brief precomputes a trained GMM model, each class has one full covariance Gaussian per mixture model
+     @param gmm: the trained model
+     @return returns true if the model was setup successfully, false otherwise
+    */
+    bool setup( const GMM &gmm );
+
+    /**
+     @brief predicts the class of one sample, the results can be accessed with getPredictedClassLabel, getClassLikelihoods and getClassDistances
+     @param inputVector: the input sample, the size must match the number of input dimensions
+     @return returns true if the prediction was successful, false otherwise
+    */
+    bool predict( const VectorFloat &inputVector );
+
+    /**
+     @brief predicts the class of a batch of samples. This does not change the evaluator, so it can be called from several threads at once.
+     @param inputs: the samples, stored sample by sample with getNumInputDimensions() values per sample
+     @param numSamples: the number of samples
+     @param predictedClassLabels: the predicted class label of each sample, this must have room for numSamples values
+     @param maximumLikelihoods: the likelihood of the predicted class of each sample, this must have room for numSamples values (or be NULL)
+     @param classLikelihoods: the likelihood of each class for each sample, stored sample by sample, this must have room for numSamples*getNumClasses() values (or be NULL)
+     @return returns true if the predictions were successful, false otherwise
+    */
+    bool predict( const Float *inputs, const UINT numSamples, UINT *predictedClassLabels, Float *maximumLikelihoods = NULL, Float *classLikelihoods = NULL ) const;
+
+    /**
+     @brief removes the precomputed model
+     @return returns true if the evaluator was cleared successfully, false otherwise
+    */
+    bool clear();
+
+    bool getTrained() const { return trained; }
+    UINT getNumInputDimensions() const { return numInputDimensions; }
+    UINT getNumClasses() const { return numClasses; }
+    UINT getNumGaussians() const { return numGaussians; }
+    UINT getPredictedClassLabel() const { return predictedClassLabel; }
+    Float getMaximumLikelihood() const { return maximumLikelihood; }
+    const VectorFloat &getClassLikelihoods() const { return classLikelihoods; }
+    const VectorFloat &getClassDistances() const { return classDistances; }
+
+protected:
+    /**
+     @brief adds a Gaussian to the evaluator, the Gaussians of each class must be added together
+     @param mu: the mean
+     @param precision: the terms of -0.5*(x-mu)^T inv(sigma) (x-mu), one per dimension for diagonal Gaussians, or the upper triangle row by row
+     (with the off diagonal terms doubled) for full covariance Gaussians
+     @param logNormalizer: the log of the constant factor of the Gaussian
+    */
+    void addGaussian( const vector< float > &mu, const vector< float > &precision, const float logNormalizer );
+    void scale( const Float *input, float *scaledInput ) const;
+    void computeLogLikelihoods( const float *x, float *deltas, float *gaussianLogLikelihoods, float *classLogLikelihoods ) const;
+    UINT getLabelIndex( const float *classLogLikelihoods, Float *classLikelihoods, Float &maximumLikelihood ) const;
+
+    bool trained;
+    bool useScaling;
+    bool useNullRejection;
+    bool fullCovariance;
+    bool logDistances;                      ///< True if the class distances are log likelihoods (ANBC), false if they are likelihoods (GMM)
+    UINT numInputDimensions;
+    UINT numClasses;
+    UINT numGaussians;
+    UINT numTerms;                          ///< The number of precision terms per Gaussian
+    Vector< MinMax > ranges;
+    Vector< UINT > classLabels;
+    vector< float > rejectionThresholds;    ///< The log likelihood null rejection threshold of each class
+    vector< UINT > classGaussians;          ///< The index of the first Gaussian of each class, with one extra entry for the end
+
+    //Four Gaussians are stored side by side in each block, so the lanes of a SIMD vector evaluate four Gaussians at once
+    vector< float > means;                  ///< [numBlocks x numInputDimensions x WIDTH]
+    vector< float > precisions;             ///< [numBlocks x numTerms x WIDTH]
+    vector< float > logNormalizers;         ///< [numBlocks x WIDTH], unused lanes are -max float
+
+    UINT predictedClassLabel;
+    Float maximumLikelihood;
+    vector< float > scaledInput;
+    vector< float > deltas;
+    vector< float > gaussianLogLikelihoods;
+    vector< float > classLogLikelihoods;
+    VectorFloat classLikelihoods;
+    VectorFloat classDistances;
+
+    ErrorLog errorLog;
+};
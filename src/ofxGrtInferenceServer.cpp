@@ -0,0 +1,695 @@
+
+#include "ofxGrtInferenceServer.h"
+
+using namespace GRT;
+
+//The most samples that can wait for a batch, samples arriving when the queue is full are dropped
+static const size_t MAX_QUEUED_REQUESTS = 8192;
+
+//Results are split into several bundles rather than sending a packet larger than this
+static const size_t MAX_BUNDLE_SIZE = 8192;
+
+static const size_t MAX_PACKET_SIZE = 65536;
+
+//The client forgets the send time of samples whose results never arrive once this many are waiting
+static const size_t MAX_PENDING_SAMPLES = 4096;
+
+static double getMilliseconds( const std::chrono::steady_clock::duration &duration ){
+    return std::chrono::duration< double, std::milli >( duration ).count();
+}
+
+ofxGrtInferenceServer::ofxGrtInferenceServer( const unsigned int numThreads ) : pool( numThreads ) {
+    maxBatchSize = 64;
+    maxBatchDelay = 1;
+    maxNumClients = 64;
+    clientTimeout = 0;
+    maxNumResults = 1024;
+    running = false;
+    stopping = false;
+    numBatches = 0;
+    numBatchedRequests = 0;
+    numDropped = 0;
+    errorLog.setProceedingText("[ERROR ofxGrtInferenceServer]");
+    warningLog.setProceedingText("[WARNING ofxGrtInferenceServer]");
+}
+
+ofxGrtInferenceServer::~ofxGrtInferenceServer(){
+    stop();
+}
+
+bool ofxGrtInferenceServer::setup( const GestureRecognitionPipeline &pipeline ){
+
+    if( !pipeline.getTrained() ){
+        errorLog << "setup(const GestureRecognitionPipeline &pipeline) - The pipeline has not been trained!" << endl;
+        return false;
+    }
+
+    stop();
+
+    std::unique_lock< std::mutex > lock( clientMutex );
+    this->pipeline = pipeline;
+    clients.clear();
+    numBatches = 0;
+    numBatchedRequests = 0;
+    numDropped = 0;
+
+    return true;
+}
+
+bool ofxGrtInferenceServer::start( const unsigned short port, const std::string &host ){
+
+    if( !getIsSetup() ){
+        errorLog << "start(const unsigned short port, const std::string &host) - The server has not been setup!" << endl;
+        return false;
+    }
+
+    stop();
+
+    if( !socket.bindUdp( port, host ) ){
+        errorLog << "start(const unsigned short port, const std::string &host) - Failed to receive on port " << port << endl;
+        return false;
+    }
+
+    return startThreads();
+}
+
+bool ofxGrtInferenceServer::startUnix( const std::string &path ){
+
+    if( !getIsSetup() ){
+        errorLog << "startUnix(const std::string &path) - The server has not been setup!" << endl;
+        return false;
+    }
+
+    stop();
+
+    if( !socket.bindUnix( path ) ){
+        errorLog << "startUnix(const std::string &path) - Failed to receive on path: " << path << endl;
+        return false;
+    }
+
+    return startThreads();
+}
+
+bool ofxGrtInferenceServer::start(){
+
+    if( !getIsSetup() ){
+        errorLog << "start() - The server has not been setup!" << endl;
+        return false;
+    }
+
+    stop();
+
+    return startThreads();
+}
+
+bool ofxGrtInferenceServer::stop(){
+
+    if( !running ) return false;
+
+    {
+        std::unique_lock< std::mutex > lock( requestMutex );
+        stopping = true;
+    }
+    requestCondition.notify_all();
+
+    if( receiveThread.joinable() ) receiveThread.join();
+    if( batchThread.joinable() ) batchThread.join();
+    socket.close();
+
+    std::unique_lock< std::mutex > lock( requestMutex );
+    requests.clear();
+    running = false;
+
+    return true;
+}
+
+bool ofxGrtInferenceServer::submit( const std::string &clientId, const VectorFloat &sample, const UINT sequence ){
+
+    Request request;
+    request.clientId = clientId;
+    request.sequence = sequence;
+    request.reset = false;
+    request.sample = sample;
+    request.arrived = Clock::now();
+
+    return queueRequest( request );
+}
+
+UINT ofxGrtInferenceServer::getResults( vector< Result > &results ){
+    std::unique_lock< std::mutex > lock( resultMutex );
+    const UINT numResults = (UINT)this->results.size();
+    results.insert( results.end(), this->results.begin(), this->results.end() );
+    this->results.clear();
+    return numResults;
+}
+
+bool ofxGrtInferenceServer::resetClient( const std::string &clientId ){
+
+    Request request;
+    request.clientId = clientId;
+    request.sequence = 0;
+    request.reset = true;
+    request.arrived = Clock::now();
+
+    return queueRequest( request );
+}
+
+bool ofxGrtInferenceServer::removeClient( const std::string &clientId ){
+    std::unique_lock< std::mutex > lock( clientMutex );
+    return clients.erase( clientId ) > 0;
+}
+
+bool ofxGrtInferenceServer::setMaxBatchSize( const UINT maxBatchSize ){
+    if( maxBatchSize == 0 ){
+        errorLog << "setMaxBatchSize(const UINT maxBatchSize) - The batch size must be greater than zero!" << endl;
+        return false;
+    }
+    std::unique_lock< std::mutex > lock( requestMutex );
+    this->maxBatchSize = maxBatchSize;
+    return true;
+}
+
+bool ofxGrtInferenceServer::setMaxBatchDelay( const double maxBatchDelay ){
+    if( maxBatchDelay < 0 ){
+        errorLog << "setMaxBatchDelay(const double maxBatchDelay) - The delay must not be negative!" << endl;
+        return false;
+    }
+    std::unique_lock< std::mutex > lock( requestMutex );
+    this->maxBatchDelay = maxBatchDelay;
+    return true;
+}
+
+bool ofxGrtInferenceServer::setMaxNumClients( const UINT maxNumClients ){
+    if( maxNumClients == 0 ){
+        errorLog << "setMaxNumClients(const UINT maxNumClients) - The number of clients must be greater than zero!" << endl;
+        return false;
+    }
+    std::unique_lock< std::mutex > lock( clientMutex );
+    this->maxNumClients = maxNumClients;
+    return true;
+}
+
+bool ofxGrtInferenceServer::setClientTimeout( const double clientTimeout ){
+    if( clientTimeout < 0 ){
+        errorLog << "setClientTimeout(const double clientTimeout) - The timeout must not be negative!" << endl;
+        return false;
+    }
+    std::unique_lock< std::mutex > lock( clientMutex );
+    this->clientTimeout = clientTimeout;
+    return true;
+}
+
+bool ofxGrtInferenceServer::setMaxNumResults( const UINT maxNumResults ){
+    std::unique_lock< std::mutex > lock( resultMutex );
+    this->maxNumResults = maxNumResults;
+    while( results.size() > maxNumResults ) results.pop_front();
+    return true;
+}
+
+UINT ofxGrtInferenceServer::getNumClients() const {
+    std::unique_lock< std::mutex > lock( clientMutex );
+    return (UINT)clients.size();
+}
+
+UINT ofxGrtInferenceServer::getNumBatches() const {
+    std::unique_lock< std::mutex > lock( clientMutex );
+    return numBatches;
+}
+
+UINT ofxGrtInferenceServer::getNumDropped() const {
+    return numDropped;
+}
+
+double ofxGrtInferenceServer::getMeanBatchSize() const {
+    std::unique_lock< std::mutex > lock( clientMutex );
+    return numBatches > 0 ? numBatchedRequests / double( numBatches ) : 0;
+}
+
+vector< ofxGrtInferenceServer::ClientStats > ofxGrtInferenceServer::getClientStats() const {
+    std::unique_lock< std::mutex > lock( clientMutex );
+    vector< ClientStats > stats;
+    stats.reserve( clients.size() );
+    for(auto iter = clients.begin(); iter != clients.end(); ++iter){
+        stats.push_back( iter->second->stats );
+    }
+    return stats;
+}
+
+bool ofxGrtInferenceServer::getClientStats( const std::string &clientId, ClientStats &stats ) const {
+    std::unique_lock< std::mutex > lock( clientMutex );
+    auto iter = clients.find( clientId );
+    if( iter == clients.end() ) return false;
+    stats = iter->second->stats;
+    return true;
+}
+
+bool ofxGrtInferenceServer::startThreads(){
+    stopping = false;
+    running = true;
+    batchThread = std::thread( &ofxGrtInferenceServer::batchFunction, this );
+    if( socket.getIsOpen() ){
+        receiveThread = std::thread( &ofxGrtInferenceServer::receiveFunction, this );
+    }
+    return true;
+}
+
+void ofxGrtInferenceServer::receiveFunction(){
+
+    vector< uint8_t > buffer( MAX_PACKET_SIZE );
+    vector< ofxGrtOscReader::Message > messages;
+    ofxGrtOscReader reader;
+    ofxGrtDatagramSocket::Address from;
+    Request request;
+
+    //The timeout only bounds how long stop() waits for this thread
+    while( !stopping ){
+        const int size = socket.receive( &buffer[0], buffer.size(), from, 50 );
+        if( size <= 0 ) continue;
+
+        messages.clear();
+        reader.parse( &buffer[0], (size_t)size, messages );
+        for(size_t i=0; i<messages.size(); i++){
+            if( decodeMessage( messages[i], from, request ) ){
+                queueRequest( request );
+            }
+        }
+    }
+}
+
+void ofxGrtInferenceServer::batchFunction(){
+
+    vector< Request > batch;
+
+    while( true ){
+        {
+            std::unique_lock< std::mutex > lock( requestMutex );
+            requestCondition.wait( lock, [&]{ return stopping || requests.size() > 0; } );
+            if( stopping ) return;
+
+            //Give the batch until the oldest sample has waited maxBatchDelay to fill up
+            const Clock::time_point deadline = requests.front().arrived + std::chrono::duration_cast< Clock::duration >( std::chrono::duration< double, std::milli >( maxBatchDelay ) );
+            requestCondition.wait_until( lock, deadline, [&]{ return stopping || requests.size() >= maxBatchSize; } );
+            if( stopping ) return;
+
+            const size_t batchSize = requests.size() < maxBatchSize ? requests.size() : maxBatchSize;
+            batch.clear();
+            for(size_t i=0; i<batchSize; i++){
+                batch.push_back( std::move( requests.front() ) );
+                requests.pop_front();
+            }
+        }
+
+        runBatch( batch );
+    }
+}
+
+void ofxGrtInferenceServer::runBatch( vector< Request > &batch ){
+
+    const Clock::time_point now = Clock::now();
+
+    //Group the requests by client, keeping the order each client sent them in
+    vector< std::shared_ptr< Client > > batchClients;
+    {
+        std::unique_lock< std::mutex > lock( clientMutex );
+        for(size_t i=0; i<batch.size(); i++){
+            std::shared_ptr< Client > client = getClient( batch[i].clientId, now );
+            if( !client ){
+                numDropped++;
+                continue;
+            }
+            if( client->requests.size() == 0 ) batchClients.push_back( client );
+            client->requests.push_back( &batch[i] );
+            client->lastSeen = now;
+            if( batch[i].replyTo.getIsValid() ) client->replyTo = batch[i].replyTo;
+        }
+    }
+
+    //Each client's pipeline is only used by one thread, so the clients can run in parallel. The client lock is not held here, so the
+    //statistics can be read while the batch runs.
+    pool.parallelFor( 0, batchClients.size(), 1, [&]( const size_t i, const unsigned int threadIndex ){
+        runClient( *batchClients[i] );
+    } );
+
+    {
+        std::unique_lock< std::mutex > resultLock( resultMutex );
+        for(size_t i=0; i<batchClients.size(); i++){
+            const vector< Result > &clientResults = batchClients[i]->results;
+            results.insert( results.end(), clientResults.begin(), clientResults.end() );
+        }
+        while( results.size() > maxNumResults ) results.pop_front();
+    }
+
+    for(size_t i=0; i<batchClients.size(); i++){
+        sendResults( *batchClients[i] );
+    }
+
+    std::unique_lock< std::mutex > lock( clientMutex );
+    for(size_t i=0; i<batchClients.size(); i++){
+        Client &client = *batchClients[i];
+        for(size_t j=0; j<client.results.size(); j++){
+            client.stats.update( client.results[j].latency, client.succeeded[j] );
+        }
+        client.requests.clear();
+    }
+
+    numBatches++;
+    numBatchedRequests += (UINT)batch.size();
+
+    removeTimedOutClients( now );
+}
+
+void ofxGrtInferenceServer::runClient( Client &client ){
+
+    client.results.clear();
+    client.succeeded.clear();
+
+    for(size_t i=0; i<client.requests.size(); i++){
+        const Request &request = *client.requests[i];
+
+        if( request.reset ){
+            client.pipeline.reset();
+            continue;
+        }
+
+        Result result;
+        result.clientId = request.clientId;
+        result.sequence = request.sequence;
+
+        const bool success = client.predictor.predict( request.sample );
+        if( success ){
+            result.predictedClassLabel = client.predictor.getPredictedClassLabel();
+            result.maximumLikelihood = client.predictor.getMaximumLikelihood();
+            if( client.predictor.getIsRegressifier() ) result.regressionData = client.predictor.getRegressionData();
+            else result.classLikelihoods = client.predictor.getClassLikelihoods();
+        }
+
+        result.latency = getMilliseconds( Clock::now() - request.arrived );
+        client.results.push_back( result );
+        client.succeeded.push_back( success );
+    }
+}
+
+void ofxGrtInferenceServer::sendResults( const Client &client ){
+
+    if( !socket.getIsOpen() || !client.replyTo.getIsValid() || client.results.size() == 0 ) return;
+
+    writer.clear();
+    writer.beginBundle();
+    for(size_t i=0; i<client.results.size(); i++){
+        const Result &result = client.results[i];
+        const bool regression = client.predictor.getIsRegressifier();
+        writer.beginMessage( regression ? "/grt/regression" : "/grt/result" );
+        writer.addString( result.clientId );
+        writer.addInt( (int32_t)result.sequence );
+        writer.addFloat( (float)result.latency );
+        if( regression ){
+            writer.addFloats( result.regressionData );
+        }else{
+            writer.addInt( (int32_t)result.predictedClassLabel );
+            writer.addFloat( (float)result.maximumLikelihood );
+            writer.addFloats( result.classLikelihoods );
+        }
+        writer.endMessage();
+
+        //Keep each packet well under the datagram size limit
+        if( writer.getSize() >= MAX_BUNDLE_SIZE && i+1 < client.results.size() ){
+            writer.endBundle();
+            socket.send( writer.getData(), writer.getSize(), client.replyTo );
+            writer.clear();
+            writer.beginBundle();
+        }
+    }
+    writer.endBundle();
+
+    if( !socket.send( writer.getData(), writer.getSize(), client.replyTo ) ){
+        warningLog << "sendResults(const Client &client) - Failed to send the results of client " << client.stats.clientId << endl;
+    }
+}
+
+bool ofxGrtInferenceServer::queueRequest( Request &request ){
+
+    {
+        std::unique_lock< std::mutex > lock( requestMutex );
+        if( !running || stopping ){
+            errorLog << "queueRequest(Request &request) - The server is not running!" << endl;
+            return false;
+        }
+        if( requests.size() >= MAX_QUEUED_REQUESTS ){
+            numDropped++;
+            return false;
+        }
+        requests.push_back( std::move( request ) );
+    }
+    requestCondition.notify_one();
+
+    return true;
+}
+
+bool ofxGrtInferenceServer::decodeMessage( const ofxGrtOscReader::Message &message, const ofxGrtDatagramSocket::Address &from, Request &request ){
+
+    const bool reset = message.address == "/grt/reset";
+    if( !reset && message.address != "/grt/sample" ){
+        warningLog << "decodeMessage(...) - Unknown address: " << message.address << endl;
+        return false;
+    }
+
+    if( !message.getIsString( 0 ) ){
+        warningLog << "decodeMessage(...) - The first argument of " << message.address << " must be the client id!" << endl;
+        return false;
+    }
+
+    request.clientId = message.getString( 0 );
+    request.sequence = 0;
+    request.reset = reset;
+    request.arrived = Clock::now();
+    request.replyTo = from;
+    request.sample.clear();
+
+    if( reset ) return true;
+
+    //An integer after the id is the sequence number, the sample values are floats
+    UINT first = 1;
+    if( message.getNumArguments() > 1 && (message.types[1] == 'i' || message.types[1] == 'h') ){
+        request.sequence = (UINT)message.getNumber( 1 );
+        first = 2;
+    }
+
+    if( first >= message.getNumArguments() ){
+        warningLog << "decodeMessage(...) - The sample from client " << request.clientId << " is empty!" << endl;
+        return false;
+    }
+
+    request.sample.resize( message.getNumArguments() - first );
+    for(UINT i=first; i<message.getNumArguments(); i++){
+        if( message.types[i] != 'f' && message.types[i] != 'd' ){
+            warningLog << "decodeMessage(...) - The sample values from client " << request.clientId << " must be floats!" << endl;
+            return false;
+        }
+        request.sample[i-first] = message.getNumber( i );
+    }
+
+    return true;
+}
+
+std::shared_ptr< ofxGrtInferenceServer::Client > ofxGrtInferenceServer::getClient( const std::string &clientId, const Clock::time_point &now ){
+
+    auto iter = clients.find( clientId );
+    if( iter != clients.end() ) return iter->second;
+
+    if( clients.size() >= maxNumClients ){
+        removeTimedOutClients( now );
+        if( clients.size() >= maxNumClients ){
+            warningLog << "getClient(...) - The server already has " << maxNumClients << " clients, dropping the sample from client " << clientId << endl;
+            return std::shared_ptr< Client >();
+        }
+    }
+
+    std::shared_ptr< Client > client( new Client );
+    client->pipeline = pipeline;
+    client->stats.clientId = clientId;
+    client->lastSeen = now;
+    if( !client->predictor.setup( client->pipeline ) ){
+        errorLog << "getClient(...) - Failed to setup the pipeline of client " << clientId << endl;
+        return std::shared_ptr< Client >();
+    }
+
+    clients[ clientId ] = client;
+
+    return client;
+}
+
+void ofxGrtInferenceServer::removeTimedOutClients( const Clock::time_point &now ){
+
+    if( clientTimeout <= 0 ) return;
+
+    for(auto iter = clients.begin(); iter != clients.end(); ){
+        if( getMilliseconds( now - iter->second->lastSeen ) > clientTimeout * 1000 ) iter = clients.erase( iter );
+        else ++iter;
+    }
+}
+
+ofxGrtInferenceClient::ofxGrtInferenceClient(){
+    sequence = 0;
+    numSent = 0;
+    numReceived = 0;
+    meanRoundTripLatency = 0;
+    maxRoundTripLatency = 0;
+    errorLog.setProceedingText("[ERROR ofxGrtInferenceClient]");
+}
+
+ofxGrtInferenceClient::~ofxGrtInferenceClient(){
+    close();
+}
+
+bool ofxGrtInferenceClient::connect( const std::string &clientId, const std::string &host, const unsigned short port ){
+
+    close();
+
+    if( !ofxGrtDatagramSocket::getUdpAddress( host, port, server ) ){
+        errorLog << "connect(...) - Invalid server address: " << host << endl;
+        return false;
+    }
+
+    //Any free port will do, the server replies to the port the samples come from
+    if( !socket.bindUdp( 0 ) ){
+        errorLog << "connect(...) - Failed to open a socket!" << endl;
+        return false;
+    }
+
+    this->clientId = clientId;
+    buffer.resize( MAX_PACKET_SIZE );
+
+    return true;
+}
+
+bool ofxGrtInferenceClient::connectUnix( const std::string &clientId, const std::string &serverPath, const std::string &clientPath ){
+
+    close();
+
+    if( !ofxGrtDatagramSocket::getUnixAddress( serverPath, server ) ){
+        errorLog << "connectUnix(...) - Invalid server path: " << serverPath << endl;
+        return false;
+    }
+
+    if( !socket.bindUnix( clientPath ) ){
+        errorLog << "connectUnix(...) - Failed to open a socket at path: " << clientPath << endl;
+        return false;
+    }
+
+    this->clientId = clientId;
+    buffer.resize( MAX_PACKET_SIZE );
+
+    return true;
+}
+
+void ofxGrtInferenceClient::close(){
+    socket.close();
+    server = ofxGrtDatagramSocket::Address();
+    sendTimes.clear();
+    sequence = 0;
+    numSent = 0;
+    numReceived = 0;
+    meanRoundTripLatency = 0;
+    maxRoundTripLatency = 0;
+}
+
+bool ofxGrtInferenceClient::send( const VectorFloat &sample ){
+
+    if( !socket.getIsOpen() ){
+        errorLog << "send(const VectorFloat &sample) - The client is not connected!" << endl;
+        return false;
+    }
+
+    writer.clear();
+    writer.beginMessage( "/grt/sample" );
+    writer.addString( clientId );
+    writer.addInt( (int32_t)sequence );
+    writer.addFloats( sample );
+    writer.endMessage();
+
+    if( sendTimes.size() >= MAX_PENDING_SAMPLES ) sendTimes.erase( sendTimes.begin() );
+    sendTimes[ sequence ] = Clock::now();
+    sequence++;
+
+    if( !sendPacket() ) return false;
+    numSent++;
+
+    return true;
+}
+
+bool ofxGrtInferenceClient::reset(){
+
+    if( !socket.getIsOpen() ){
+        errorLog << "reset() - The client is not connected!" << endl;
+        return false;
+    }
+
+    writer.clear();
+    writer.beginMessage( "/grt/reset" );
+    writer.addString( clientId );
+    writer.endMessage();
+
+    return sendPacket();
+}
+
+UINT ofxGrtInferenceClient::update( vector< ofxGrtInferenceServer::Result > &results, const UINT timeoutMs ){
+
+    if( !socket.getIsOpen() ) return 0;
+
+    UINT numResults = 0;
+    ofxGrtDatagramSocket::Address from;
+
+    //Wait for the first packet, then read whatever else has already arrived
+    int size = 0;
+    UINT timeout = timeoutMs;
+    while( (size = socket.receive( &buffer[0], buffer.size(), from, timeout )) > 0 ){
+        timeout = 0;
+        const Clock::time_point now = Clock::now();
+
+        messages.clear();
+        reader.parse( &buffer[0], (size_t)size, messages );
+        for(size_t i=0; i<messages.size(); i++){
+            const ofxGrtOscReader::Message &message = messages[i];
+            const bool regression = message.address == "/grt/regression";
+            const UINT first = regression ? 3 : 5;
+            if( (!regression && message.address != "/grt/result") || message.getNumArguments() < first || !message.getIsString( 0 ) ) continue;
+
+            ofxGrtInferenceServer::Result result;
+            result.clientId = message.getString( 0 );
+            result.sequence = (UINT)message.getNumber( 1 );
+            result.latency = message.getNumber( 2 );
+            if( !regression ){
+                result.predictedClassLabel = (UINT)message.getNumber( 3 );
+                result.maximumLikelihood = message.getNumber( 4 );
+            }
+            VectorFloat &values = regression ? result.regressionData : result.classLikelihoods;
+            values.resize( message.getNumArguments() - first );
+            for(UINT j=first; j<message.getNumArguments(); j++){
+                values[j-first] = message.getNumber( j );
+            }
+
+            auto iter = sendTimes.find( result.sequence );
+            if( iter != sendTimes.end() ){
+                result.roundTripLatency = std::chrono::duration< double, std::milli >( now - iter->second ).count();
+                sendTimes.erase( iter );
+            }
+
+            numReceived++;
+            meanRoundTripLatency += (result.roundTripLatency - meanRoundTripLatency) / numReceived;
+            if( result.roundTripLatency > maxRoundTripLatency ) maxRoundTripLatency = result.roundTripLatency;
+
+            results.push_back( result );
+            numResults++;
+        }
+    }
+
+    return numResults;
+}
+
+bool ofxGrtInferenceClient::sendPacket(){
+    if( !socket.send( writer.getData(), writer.getSize(), server ) ){
+        errorLog << "sendPacket() - Failed to send to the server!" << endl;
+        return false;
+    }
+    return true;
+}
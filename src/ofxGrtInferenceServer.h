@@ -0,0 +1,360 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ofMain.h"
+#include "ofxGrtDatagramSocket.h"
+#include "ofxGrtOsc.h"
+#include "ofxGrtPredictor.h"
+#include "ofxGrtThreadPool.h"
+
+using namespace GRT;
+
+/**
+ @brief serves predictions from one trained pipeline to many clients (for example one per performer, phone or sensor) over UDP or a unix
+ domain socket, using OSC messages:
+
+   /grt/sample  s:clientId [i:sequence] f:value ...     predicts a sample, the values must be floats (or doubles)
+   /grt/reset   s:clientId                               resets the client's pipeline, clearing its filters and buffers
+
+ Each client gets its own copy of the pipeline, so stateful modules (filters, feature extraction windows, DTW buffers) see only that
+ client's stream. Requests are collected into micro batches, a batch is closed once it holds maxBatchSize samples or its oldest sample has
+ waited maxBatchDelay milliseconds. The clients in a batch are then run in parallel on the server's own ofxGrtThreadPool, so training on
+ the shared pool does not stall the clients, while the samples of one client are always run in the order they arrived. The results are
+ sent back to the address each client last sent from, as one OSC bundle per client per batch of:
+
+   /grt/result      s:clientId i:sequence f:latency i:predictedClassLabel f:maximumLikelihood f:classLikelihood ...
+   /grt/regression  s:clientId i:sequence f:latency f:regressionValue ...
+
+ where the latency is the time in milliseconds from the sample arriving to its result being ready. The latency of each client is also
+ recorded in its ClientStats. Samples can be submitted from inside the process too (see submit), and every result is also kept in a bounded
+ queue which can be read with getResults.
+*/
+class ofxGrtInferenceServer {
+public:
+    struct Result{
+        Result(){ sequence = 0; predictedClassLabel = 0; maximumLikelihood = 0; latency = 0; roundTripLatency = 0; }
+        std::string clientId;
+        UINT sequence;
+        UINT predictedClassLabel;
+        Float maximumLikelihood;
+        VectorFloat classLikelihoods;       ///< The likelihood of each class, empty for regression pipelines
+        VectorFloat regressionData;         ///< The regression output, empty for classification pipelines
+        double latency;                     ///< The time (in milliseconds) from the sample arriving at the server to its result being ready
+        double roundTripLatency;            ///< The time (in milliseconds) from the client sending the sample to receiving the result, only set by ofxGrtInferenceClient
+    };
+
+    struct ClientStats{
+        ClientStats(){ clear(); }
+        void clear(){ numSamples = 0; numFailed = 0; meanLatency = 0; maxLatency = 0; lastLatency = 0; }
+        void update( const double latency, const bool success ){
+            numSamples++;
+            if( !success ) numFailed++;
+            meanLatency += (latency - meanLatency) / numSamples;
+            if( latency > maxLatency ) maxLatency = latency;
+            lastLatency = latency;
+        }
+        std::string clientId;
+        UINT numSamples;        ///< The number of samples predicted for the client
+        UINT numFailed;         ///< The number of those samples the pipeline failed to predict
+        double meanLatency;     ///< The mean latency in milliseconds
+        double maxLatency;      ///< The largest latency in milliseconds
+        double lastLatency;     ///< The latency of the latest sample in milliseconds
+    };
+
+    /**
+     @brief creates the server
+     @param numThreads: the number of threads used to run the clients of a batch, if zero then the number of hardware threads is used
+    */
+    ofxGrtInferenceServer( const unsigned int numThreads = 0 );
+    ~ofxGrtInferenceServer();
+
+    /**
+     @brief sets the pipeline the clients are served with, the pipeline is copied for each client. This stops the server and removes all the clients.
+     @param pipeline: a trained pipeline
+     @return returns true if the server was setup successfully, false otherwise
+    */
+    bool setup( const GestureRecognitionPipeline &pipeline );
+
+    /**
+     @brief starts serving clients over UDP
+     @param port: the port to receive samples on
+     @param host: the IPv4 address of the interface to receive on, if empty the server receives on all interfaces
+     @return returns true if the server was started successfully, false otherwise
+    */
+    bool start( const unsigned short port, const std::string &host = "" );
+
+    /**
+     @brief starts serving clients over a unix domain socket, which has a lower latency than UDP for clients on the same machine
+     @param path: the path of the socket file
+     @return returns true if the server was started successfully, false otherwise
+    */
+    bool startUnix( const std::string &path );
+
+    /**
+     @brief starts the server without a socket, so samples can only be added with submit
+     @return returns true if the server was started successfully, false otherwise
+    */
+    bool start();
+
+    /**
+     @brief stops the server, any samples that have not been predicted yet are dropped. The clients and their pipelines are kept.
+     @return returns true if the server was stopped, false if it was not running
+    */
+    bool stop();
+
+    /**
+     @brief adds a sample from inside the process, its result is only added to the results queue
+     @param clientId: the client the sample belongs to, a new client is created the first time an id is seen
+     @param sample: the sample
+     @param sequence: a number passed back in the result
+     @return returns true if the sample was queued, false if the server is not running
+    */
+    bool submit( const std::string &clientId, const VectorFloat &sample, const UINT sequence = 0 );
+
+    /**
+     @brief moves the results that are ready into a vector, the queue keeps the newest maxNumResults results if it is not read
+     @param results: the results are added to the end of this
+     @return returns the number of results added
+    */
+    UINT getResults( vector< Result > &results );
+
+    /**
+     @brief resets the pipeline of a client, the reset happens in order with the client's queued samples
+     @return returns true if the reset was queued, false if the server is not running
+    */
+    bool resetClient( const std::string &clientId );
+
+    /**
+     @brief removes a client and its pipeline
+     @return returns true if the client was removed, false if there is no such client
+    */
+    bool removeClient( const std::string &clientId );
+
+    /**
+     @brief sets the largest number of samples in a batch
+    */
+    bool setMaxBatchSize( const UINT maxBatchSize );
+
+    /**
+     @brief sets the longest time (in milliseconds) a sample waits for its batch to fill, 0 runs each batch as soon as a sample arrives
+    */
+    bool setMaxBatchDelay( const double maxBatchDelay );
+
+    /**
+     @brief sets the largest number of clients, samples from new clients are dropped once the limit is reached
+    */
+    bool setMaxNumClients( const UINT maxNumClients );
+
+    /**
+     @brief sets how long (in seconds) a client can be silent before it is removed, 0 keeps clients until they are removed
+    */
+    bool setClientTimeout( const double clientTimeout );
+
+    /**
+     @brief sets the number of results kept in the results queue
+    */
+    bool setMaxNumResults( const UINT maxNumResults );
+
+    bool getIsSetup() const { return pipeline.getTrained(); }
+    bool getIsRunning() const { return running; }
+    UINT getMaxBatchSize() const { return maxBatchSize; }
+    double getMaxBatchDelay() const { return maxBatchDelay; }
+    UINT getMaxNumClients() const { return maxNumClients; }
+    double getClientTimeout() const { return clientTimeout; }
+    UINT getNumClients() const;
+    UINT getNumBatches() const;
+    UINT getNumDropped() const;
+
+    /**
+     @brief gets the mean number of samples in a batch
+    */
+    double getMeanBatchSize() const;
+
+    /**
+     @brief gets the statistics of every client
+    */
+    vector< ClientStats > getClientStats() const;
+
+    /**
+     @brief gets the statistics of one client
+     @return returns true if the client exists, false otherwise
+    */
+    bool getClientStats( const std::string &clientId, ClientStats &stats ) const;
+
+    /**
+     @brief gets the port the server is receiving on, this is 0 if it is not serving UDP
+    */
+    unsigned short getPort() const { return socket.getPort(); }
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Request{
+        std::string clientId;
+        UINT sequence;
+        bool reset;
+        VectorFloat sample;
+        Clock::time_point arrived;
+        ofxGrtDatagramSocket::Address replyTo;
+    };
+
+    struct Client{
+        GestureRecognitionPipeline pipeline;
+        ofxGrtPredictor predictor;
+        ClientStats stats;
+        Clock::time_point lastSeen;
+        ofxGrtDatagramSocket::Address replyTo;
+        vector< const Request* > requests;      ///< The client's requests in the current batch
+        vector< Result > results;               ///< The client's results in the current batch
+        vector< bool > succeeded;               ///< If each result in the current batch was predicted, the stats are updated from these once the batch is done
+    };
+
+    bool startThreads();
+    void receiveFunction();
+    void batchFunction();
+    void runBatch( vector< Request > &batch );
+    void runClient( Client &client );
+    void sendResults( const Client &client );
+    bool queueRequest( Request &request );
+    bool decodeMessage( const ofxGrtOscReader::Message &message, const ofxGrtDatagramSocket::Address &from, Request &request );
+    std::shared_ptr< Client > getClient( const std::string &clientId, const Clock::time_point &now );
+    void removeTimedOutClients( const Clock::time_point &now );
+
+    GestureRecognitionPipeline pipeline;
+    UINT maxBatchSize;
+    double maxBatchDelay;
+    UINT maxNumClients;
+    double clientTimeout;
+    UINT maxNumResults;
+
+    ofxGrtDatagramSocket socket;
+    std::thread receiveThread;
+    std::thread batchThread;
+    std::atomic< bool > running;
+    std::atomic< bool > stopping;
+
+    mutable std::mutex requestMutex;            ///< Guards the queued requests
+    std::condition_variable requestCondition;
+    std::deque< Request > requests;
+
+    mutable std::mutex clientMutex;             ///< Guards the clients and the statistics
+    std::map< std::string, std::shared_ptr< Client > > clients;     ///< A batch keeps its clients alive, so they can be removed while it runs
+    UINT numBatches;
+    UINT numBatchedRequests;
+    std::atomic< UINT > numDropped;             ///< The number of samples dropped because the queue or the clients were full
+
+    std::mutex resultMutex;
+    std::deque< Result > results;
+
+    ofxGrtOscWriter writer;                     ///< Only used by the batch thread
+    ofxGrtThreadPool pool;                      ///< Runs the clients of a batch
+
+    ErrorLog errorLog;
+    WarningLog warningLog;
+};
+
+/**
+ @brief a client of ofxGrtInferenceServer, for testing a server from inside the same process or for a process that streams samples to
+ a server. The client sends samples with an increasing sequence number and measures the round trip latency of each result.
+*/
+class ofxGrtInferenceClient {
+public:
+    ofxGrtInferenceClient();
+    ~ofxGrtInferenceClient();
+
+    /**
+     @brief connects to a server over UDP, the client receives its results on a port chosen by the system
+     @param clientId: the id the server knows the client by
+     @param host: the IPv4 address of the server
+     @param port: the port of the server
+     @return returns true if the client was connected successfully, false otherwise
+    */
+    bool connect( const std::string &clientId, const std::string &host, const unsigned short port );
+
+    /**
+     @brief connects to a server over a unix domain socket
+     @param clientId: the id the server knows the client by
+     @param serverPath: the path of the server's socket file
+     @param clientPath: the path of the client's socket file, the server sends the results to this
+     @return returns true if the client was connected successfully, false otherwise
+    */
+    bool connectUnix( const std::string &clientId, const std::string &serverPath, const std::string &clientPath );
+
+    void close();
+
+    /**
+     @brief sends a sample to the server
+     @return returns true if the sample was sent, false otherwise
+    */
+    bool send( const VectorFloat &sample );
+
+    /**
+     @brief asks the server to reset the client's pipeline
+     @return returns true if the request was sent, false otherwise
+    */
+    bool reset();
+
+    /**
+     @brief receives the results the server has sent
+     @param results: the results are added to the end of this
+     @param timeoutMs: the longest time to wait for the first result in milliseconds
+     @return returns the number of results added
+    */
+    UINT update( vector< ofxGrtInferenceServer::Result > &results, const UINT timeoutMs = 0 );
+
+    bool getIsConnected() const { return socket.getIsOpen(); }
+    const std::string &getClientId() const { return clientId; }
+    UINT getNumSent() const { return numSent; }
+    UINT getNumReceived() const { return numReceived; }
+    double getMeanRoundTripLatency() const { return meanRoundTripLatency; }
+    double getMaxRoundTripLatency() const { return maxRoundTripLatency; }
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    bool sendPacket();
+
+    std::string clientId;
+    ofxGrtDatagramSocket socket;
+    ofxGrtDatagramSocket::Address server;
+    ofxGrtOscWriter writer;
+    ofxGrtOscReader reader;
+    vector< uint8_t > buffer;
+    vector< ofxGrtOscReader::Message > messages;
+    UINT sequence;
+    std::map< UINT, Clock::time_point > sendTimes;     ///< The time each sample still waiting for a result was sent
+    UINT numSent;
+    UINT numReceived;
+    double meanRoundTripLatency;
+    double maxRoundTripLatency;
+
+    ErrorLog errorLog;
+};
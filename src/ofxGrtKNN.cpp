@@ -0,0 +1,694 @@
+
+#include "ofxGrtKNN.h"
+
+using namespace GRT;
+
+//Register the classifier with the classifier base class, so pipelines can create and copy it
+RegisterClassifierModule< ofxGrtKNN > ofxGrtKNN::registerModule("ofxGrtKNN");
+
+ofxGrtKNN::ofxGrtKNN( const UINT K, const bool useScaling, const bool useNullRejection, const Float nullRejectionCoeff, const UINT leafSize ){
+    this->K = K;
+    this->leafSize = leafSize > 0 ? leafSize : 1;
+    this->useScaling = useScaling;
+    this->useNullRejection = useNullRejection;
+    this->nullRejectionCoeff = nullRejectionCoeff;
+    supportsNullRejection = true;
+    searchMode = KD_TREE_SEARCH;
+    root = -1;
+    numNeighbours = 0;
+    searchK = 0;
+    searchClassIndexFilter = -1;
+    searchExcludeId = 0;
+    classType = "ofxGrtKNN";
+    classifierType = classType;
+    classifierMode = STANDARD_CLASSIFIER_MODE;
+    debugLog.setProceedingText("[DEBUG ofxGrtKNN]");
+    errorLog.setProceedingText("[ERROR ofxGrtKNN]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtKNN]");
+    warningLog.setProceedingText("[WARNING ofxGrtKNN]");
+}
+
+ofxGrtKNN::ofxGrtKNN( const ofxGrtKNN &rhs ){
+    root = -1;
+    numNeighbours = 0;
+    searchK = 0;
+    searchClassIndexFilter = -1;
+    searchExcludeId = 0;
+    classType = "ofxGrtKNN";
+    classifierType = classType;
+    classifierMode = STANDARD_CLASSIFIER_MODE;
+    debugLog.setProceedingText("[DEBUG ofxGrtKNN]");
+    errorLog.setProceedingText("[ERROR ofxGrtKNN]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtKNN]");
+    warningLog.setProceedingText("[WARNING ofxGrtKNN]");
+    *this = rhs;
+}
+
+ofxGrtKNN::~ofxGrtKNN(){
+}
+
+ofxGrtKNN &ofxGrtKNN::operator=( const ofxGrtKNN &rhs ){
+    if( this != &rhs ){
+        this->K = rhs.K;
+        this->leafSize = rhs.leafSize;
+        this->searchMode = rhs.searchMode;
+        this->samples = rhs.samples;
+        this->sampleLabels = rhs.sampleLabels;
+        this->sampleClassIndices = rhs.sampleClassIndices;
+        this->nodes = rhs.nodes;
+        this->leaves = rhs.leaves;
+        this->root = rhs.root;
+        this->trainingMu = rhs.trainingMu;
+        this->trainingSigma = rhs.trainingSigma;
+
+        //The search state is scratch memory, but predict needs the query buffer sized for the input
+        this->query = rhs.query;
+        this->neighbours.clear();
+        this->neighbourIndices = rhs.neighbourIndices;
+        this->numNeighbours = 0;
+        this->searchK = 0;
+        this->searchClassIndexFilter = -1;
+        this->searchExcludeId = 0;
+
+        //Copy the base classifier variables
+        copyBaseVariables( (Classifier*)&rhs );
+    }
+    return *this;
+}
+
+bool ofxGrtKNN::deepCopyFrom( const Classifier *classifier ){
+
+    if( classifier == NULL ) return false;
+
+    const ofxGrtKNN *ptr = dynamic_cast< const ofxGrtKNN* >( classifier );
+    if( ptr == NULL ) return false;
+
+    *this = *ptr;
+
+    return true;
+}
+
+bool ofxGrtKNN::train_( ClassificationData &trainingData ){
+
+    //Clear any previous models
+    clear();
+
+    const UINT M = trainingData.getNumSamples();
+    const UINT N = trainingData.getNumDimensions();
+
+    if( M == 0 ){
+        errorLog << "train_(ClassificationData &trainingData) - Training data has zero samples!" << endl;
+        return false;
+    }
+
+    if( K == 0 ){
+        errorLog << "train_(ClassificationData &trainingData) - K must be greater than zero!" << endl;
+        return false;
+    }
+
+    numInputDimensions = N;
+    numClasses = trainingData.getNumClasses();
+    ranges = trainingData.getRanges();
+
+    const Vector< ClassTracker > classTracker = trainingData.getClassTracker();
+    classLabels.resize( numClasses );
+    for(UINT k=0; k<numClasses; k++){
+        classLabels[k] = classTracker[k].classLabel;
+    }
+
+    //Copy the (scaled) samples, the training data is left untouched
+    samples.resize( M * N );
+    sampleLabels.resize( M );
+    sampleClassIndices.resize( M );
+    for(UINT i=0; i<M; i++){
+        const UINT classLabel = trainingData[i].getClassLabel();
+        sampleLabels[i] = classLabel;
+        sampleClassIndices[i] = (UINT)getClassIndex( classLabel );
+        for(UINT j=0; j<N; j++){
+            Float value = trainingData[i][j];
+            if( useScaling ) value = scale( value, ranges[j].minValue, ranges[j].maxValue, 0, 1 );
+            samples[ i*N + j ] = (float)value;
+        }
+    }
+
+    //Build the tree
+    vector< UINT > ids( M );
+    for(UINT i=0; i<M; i++) ids[i] = i;
+    root = buildTree( ids, 0, M );
+
+    query.resize( N );
+    classLikelihoods.resize( numClasses, 0 );
+    classDistances.resize( numClasses, 0 );
+    trained = true;
+
+    //Compute the null rejection thresholds from the neighbour distances of the training samples
+    computeTrainingDistances();
+    recomputeNullRejectionThresholds();
+
+    return true;
+}
+
+bool ofxGrtKNN::predict_( VectorFloat &inputVector ){
+
+    predictedClassLabel = 0;
+    maxLikelihood = 0;
+
+    if( !trained ){
+        errorLog << "predict_(VectorFloat &inputVector) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    if( inputVector.size() != numInputDimensions ){
+        errorLog << "predict_(VectorFloat &inputVector) - The size of the input vector (" << inputVector.size() << ") does not match the num features in the model (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    for(UINT j=0; j<numInputDimensions; j++){
+        if( useScaling ) inputVector[j] = scale( inputVector[j], ranges[j].minValue, ranges[j].maxValue, 0, 1 );
+        query[j] = (float)inputVector[j];
+    }
+
+    const UINT numFound = search( &query[0], K, -1, (UINT)sampleLabels.size() );
+
+    std::fill( classLikelihoods.begin(), classLikelihoods.end(), 0 );
+    std::fill( classDistances.begin(), classDistances.end(), 0 );
+    neighbourIndices.resize( numFound );
+    for(UINT i=0; i<numFound; i++){
+        const UINT classIndex = sampleClassIndices[ neighbours[i].id ];
+        classLikelihoods[ classIndex ] += 1;
+        classDistances[ classIndex ] += sqrt( (Float)neighbours[i].distance );
+        neighbourIndices[i] = neighbours[i].id;
+    }
+
+    //The predicted class is the class with the most neighbours, the first class wins a tie
+    UINT maxIndex = 0;
+    Float maxCount = 0;
+    for(UINT k=0; k<numClasses; k++){
+        if( classLikelihoods[k] > maxCount ){
+            maxCount = classLikelihoods[k];
+            maxIndex = k;
+        }
+    }
+
+    for(UINT k=0; k<numClasses; k++){
+        if( classLikelihoods[k] > 0 ) classDistances[k] /= classLikelihoods[k];
+        else classDistances[k] = grt_numeric_limits< Float >::max();
+        classLikelihoods[k] /= numFound;
+    }
+
+    maxLikelihood = classLikelihoods[ maxIndex ];
+    bestDistance = classDistances[ maxIndex ];
+    predictedClassLabel = classLabels[ maxIndex ];
+
+    if( useNullRejection && bestDistance > nullRejectionThresholds[ maxIndex ] ){
+        predictedClassLabel = GRT_DEFAULT_NULL_CLASS_LABEL;
+    }
+
+    return true;
+}
+
+bool ofxGrtKNN::clear(){
+
+    //Clear the base class
+    Classifier::clear();
+
+    samples.clear();
+    sampleLabels.clear();
+    sampleClassIndices.clear();
+    nodes.clear();
+    leaves.clear();
+    root = -1;
+    trainingMu.clear();
+    trainingSigma.clear();
+    neighbours.clear();
+    numNeighbours = 0;
+    neighbourIndices.clear();
+
+    return true;
+}
+
+bool ofxGrtKNN::save( std::fstream &file ) const {
+
+    if( !file.is_open() ){
+        errorLog << "save(fstream &file) - Could not open file to save model!" << endl;
+        return false;
+    }
+
+    file << "GRT_OFXGRTKNN_MODEL_FILE_V1.0\n";
+
+    if( !Classifier::saveBaseSettingsToFile( file ) ){
+        errorLog << "save(fstream &file) - Failed to save classifier base settings to file!" << endl;
+        return false;
+    }
+
+    file << "K: " << K << endl;
+    file << "LeafSize: " << leafSize << endl;
+    file << "SearchMode: " << searchMode << endl;
+
+    if( trained ){
+        //Write the samples with enough digits to read back the exact float values
+        const std::streamsize precision = file.precision( 9 );
+
+        file << "NumSamples: " << sampleLabels.size() << endl;
+        file << "TrainingMu:";
+        for(UINT k=0; k<numClasses; k++) file << " " << trainingMu[k];
+        file << endl;
+        file << "TrainingSigma:";
+        for(UINT k=0; k<numClasses; k++) file << " " << trainingSigma[k];
+        file << endl;
+        file << "Samples:\n";
+        for(size_t i=0; i<sampleLabels.size(); i++){
+            file << sampleLabels[i];
+            for(UINT j=0; j<numInputDimensions; j++) file << " " << samples[ i*numInputDimensions + j ];
+            file << endl;
+        }
+
+        file.precision( precision );
+    }
+
+    return true;
+}
+
+bool ofxGrtKNN::load( std::fstream &file ){
+
+    clear();
+
+    if( !file.is_open() ){
+        errorLog << "load(fstream &file) - Could not open file to load model!" << endl;
+        return false;
+    }
+
+    std::string word;
+    file >> word;
+    if( word != "GRT_OFXGRTKNN_MODEL_FILE_V1.0" ){
+        errorLog << "load(fstream &file) - Could not find Model File Header!" << endl;
+        return false;
+    }
+
+    if( !Classifier::loadBaseSettingsFromFile( file ) ){
+        errorLog << "load(fstream &file) - Failed to load base settings from file!" << endl;
+        return false;
+    }
+
+    UINT mode = 0;
+    file >> word;
+    if( word != "K:" ){ errorLog << "load(fstream &file) - Could not find K!" << endl; return false; }
+    file >> K;
+    file >> word;
+    if( word != "LeafSize:" ){ errorLog << "load(fstream &file) - Could not find LeafSize!" << endl; return false; }
+    file >> leafSize;
+    file >> word;
+    if( word != "SearchMode:" ){ errorLog << "load(fstream &file) - Could not find SearchMode!" << endl; return false; }
+    file >> mode;
+    searchMode = mode == BRUTE_FORCE_SEARCH ? BRUTE_FORCE_SEARCH : KD_TREE_SEARCH;
+
+    if( !trained ) return true;
+
+    UINT M = 0;
+    file >> word;
+    if( word != "NumSamples:" ){ errorLog << "load(fstream &file) - Could not find NumSamples!" << endl; return false; }
+    file >> M;
+
+    trainingMu.resize( numClasses );
+    trainingSigma.resize( numClasses );
+    file >> word;
+    if( word != "TrainingMu:" ){ errorLog << "load(fstream &file) - Could not find TrainingMu!" << endl; return false; }
+    for(UINT k=0; k<numClasses; k++) file >> trainingMu[k];
+    file >> word;
+    if( word != "TrainingSigma:" ){ errorLog << "load(fstream &file) - Could not find TrainingSigma!" << endl; return false; }
+    for(UINT k=0; k<numClasses; k++) file >> trainingSigma[k];
+
+    file >> word;
+    if( word != "Samples:" ){ errorLog << "load(fstream &file) - Could not find Samples!" << endl; return false; }
+    samples.resize( M * numInputDimensions );
+    sampleLabels.resize( M );
+    sampleClassIndices.resize( M );
+    for(UINT i=0; i<M; i++){
+        file >> sampleLabels[i];
+        for(UINT j=0; j<numInputDimensions; j++) file >> samples[ i*numInputDimensions + j ];
+        const int classIndex = getClassIndex( sampleLabels[i] );
+        if( classIndex < 0 ){
+            errorLog << "load(fstream &file) - Unknown class label " << sampleLabels[i] << " for sample " << i << endl;
+            clear();
+            return false;
+        }
+        sampleClassIndices[i] = (UINT)classIndex;
+    }
+
+    vector< UINT > ids( M );
+    for(UINT i=0; i<M; i++) ids[i] = i;
+    root = buildTree( ids, 0, M );
+
+    query.resize( numInputDimensions );
+    classLikelihoods.resize( numClasses, 0 );
+    classDistances.resize( numClasses, 0 );
+
+    return recomputeNullRejectionThresholds();
+}
+
+bool ofxGrtKNN::recomputeNullRejectionThresholds(){
+
+    if( !trained ) return false;
+
+    nullRejectionThresholds.resize( numClasses );
+    for(UINT k=0; k<numClasses; k++){
+        nullRejectionThresholds[k] = trainingMu[k] + trainingSigma[k] * nullRejectionCoeff;
+    }
+
+    return true;
+}
+
+bool ofxGrtKNN::addSample( const UINT classLabel, const VectorFloat &sample ){
+
+    if( !trained ){
+        errorLog << "addSample(const UINT classLabel, const VectorFloat &sample) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    if( sample.size() != numInputDimensions ){
+        errorLog << "addSample(const UINT classLabel, const VectorFloat &sample) - The size of the sample (" << sample.size() << ") does not match the num features in the model (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    if( classLabel == GRT_DEFAULT_NULL_CLASS_LABEL ){
+        errorLog << "addSample(const UINT classLabel, const VectorFloat &sample) - The class label can not be the null class label!" << endl;
+        return false;
+    }
+
+    int classIndex = getClassIndex( classLabel );
+    if( classIndex < 0 ){
+        //A new class, which is never rejected until the model is retrained
+        classLabels.push_back( classLabel );
+        classIndex = (int)numClasses++;
+        classLikelihoods.resize( numClasses, 0 );
+        classDistances.resize( numClasses, 0 );
+        trainingMu.resize( numClasses, 0 );
+        trainingSigma.resize( numClasses, 0 );
+        nullRejectionThresholds.resize( numClasses, grt_numeric_limits< Float >::max() );
+    }
+
+    const UINT id = (UINT)sampleLabels.size();
+    sampleLabels.push_back( classLabel );
+    sampleClassIndices.push_back( (UINT)classIndex );
+    for(UINT j=0; j<numInputDimensions; j++){
+        Float value = sample[j];
+        if( useScaling ) value = scale( value, ranges[j].minValue, ranges[j].maxValue, 0, 1 );
+        samples.push_back( (float)value );
+    }
+
+    insert( id );
+
+    return true;
+}
+
+bool ofxGrtKNN::setK( const UINT K ){
+    if( K == 0 ){
+        errorLog << "setK(const UINT K) - K must be greater than zero!" << endl;
+        return false;
+    }
+    this->K = K;
+    return true;
+}
+
+bool ofxGrtKNN::setLeafSize( const UINT leafSize ){
+    if( leafSize == 0 ){
+        errorLog << "setLeafSize(const UINT leafSize) - The leaf size must be greater than zero!" << endl;
+        return false;
+    }
+
+    this->leafSize = leafSize;
+
+    //Rebuild the tree with the new leaf size
+    if( trained ){
+        nodes.clear();
+        leaves.clear();
+        vector< UINT > ids( sampleLabels.size() );
+        for(UINT i=0; i<ids.size(); i++) ids[i] = i;
+        root = buildTree( ids, 0, (UINT)ids.size() );
+    }
+
+    return true;
+}
+
+bool ofxGrtKNN::setSearchMode( const SearchMode searchMode ){
+    this->searchMode = searchMode;
+    return true;
+}
+
+UINT ofxGrtKNN::getTreeDepth() const {
+    return root >= 0 ? getDepth( root ) : 0;
+}
+
+int ofxGrtKNN::buildTree( vector< UINT > &ids, const UINT begin, const UINT end ){
+
+    const UINT N = numInputDimensions;
+
+    if( end - begin <= leafSize ){
+        return createLeaf( ids, begin, end );
+    }
+
+    //Split the dimension with the largest spread
+    UINT splitDimension = 0;
+    float maxSpread = 0;
+    for(UINT j=0; j<N; j++){
+        float minValue = samples[ ids[begin]*N + j ];
+        float maxValue = minValue;
+        for(UINT i=begin+1; i<end; i++){
+            const float value = samples[ ids[i]*N + j ];
+            minValue = std::min( minValue, value );
+            maxValue = std::max( maxValue, value );
+        }
+        if( maxValue - minValue > maxSpread ){
+            maxSpread = maxValue - minValue;
+            splitDimension = j;
+        }
+    }
+
+    //All the samples are identical, so they can not be split
+    if( maxSpread <= 0 ){
+        return createLeaf( ids, begin, end );
+    }
+
+    //Split at the median, ordering equal values by id so the split is deterministic
+    const UINT mid = begin + (end - begin) / 2;
+    const float *values = &samples[ splitDimension ];
+    std::nth_element( ids.begin() + begin, ids.begin() + mid, ids.begin() + end, [values,N]( const UINT a, const UINT b ){
+        const float va = values[ a*N ];
+        const float vb = values[ b*N ];
+        return va < vb || (va == vb && a < b);
+    } );
+
+    Node node;
+    node.left = -1;
+    node.right = -1;
+    node.leaf = -1;
+    node.splitDimension = splitDimension;
+    node.splitValue = values[ ids[mid]*N ];
+    nodes.push_back( node );
+    const int nodeIndex = (int)nodes.size()-1;
+
+    const int left = buildTree( ids, begin, mid );
+    const int right = buildTree( ids, mid, end );
+    nodes[ nodeIndex ].left = left;
+    nodes[ nodeIndex ].right = right;
+
+    return nodeIndex;
+}
+
+int ofxGrtKNN::createLeaf( const vector< UINT > &ids, const UINT begin, const UINT end ){
+
+    Leaf leaf;
+    leaf.numSamples = 0;
+    for(UINT i=begin; i<end; i++){
+        appendToLeaf( leaf, ids[i] );
+    }
+    leaves.push_back( leaf );
+
+    Node node;
+    node.left = -1;
+    node.right = -1;
+    node.leaf = (int)leaves.size()-1;
+    node.splitDimension = 0;
+    node.splitValue = 0;
+    nodes.push_back( node );
+
+    return (int)nodes.size()-1;
+}
+
+void ofxGrtKNN::appendToLeaf( Leaf &leaf, const UINT id ){
+
+    const UINT N = numInputDimensions;
+    const UINT W = ofxGrtSimd::WIDTH;
+
+    if( leaf.numSamples % W == 0 ){
+        leaf.blocks.resize( leaf.blocks.size() + N*W, 0 );
+        leaf.ids.resize( leaf.ids.size() + W, 0 );
+    }
+
+    const UINT block = leaf.numSamples / W;
+    const UINT lane = leaf.numSamples % W;
+    for(UINT j=0; j<N; j++){
+        leaf.blocks[ (block*N + j)*W + lane ] = samples[ id*N + j ];
+    }
+    leaf.ids[ leaf.numSamples ] = id;
+    leaf.numSamples++;
+}
+
+void ofxGrtKNN::insert( const UINT id ){
+
+    const UINT N = numInputDimensions;
+    const float *sample = &samples[ id*N ];
+
+    int nodeIndex = root;
+    while( nodes[ nodeIndex ].leaf < 0 ){
+        const Node &node = nodes[ nodeIndex ];
+        nodeIndex = sample[ node.splitDimension ] < node.splitValue ? node.left : node.right;
+    }
+
+    const int leafIndex = nodes[ nodeIndex ].leaf;
+    appendToLeaf( leaves[ leafIndex ], id );
+
+    //Split the leaf once it has grown well past the leaf size
+    const UINT numSamples = leaves[ leafIndex ].numSamples;
+    if( numSamples > 2*leafSize && numSamples % leafSize == 0 ){
+        vector< UINT > ids( leaves[ leafIndex ].ids.begin(), leaves[ leafIndex ].ids.begin() + numSamples );
+        const int subtree = buildTree( ids, 0, numSamples );
+        if( nodes[ subtree ].leaf >= 0 ){
+            //The samples could not be split, so keep the original leaf
+            nodes.pop_back();
+            leaves.pop_back();
+            return;
+        }
+        nodes[ nodeIndex ] = nodes[ subtree ];
+        Leaf empty;
+        empty.numSamples = 0;
+        leaves[ leafIndex ] = empty;
+    }
+}
+
+UINT ofxGrtKNN::search( const float *query, const UINT K, const int classIndexFilter, const UINT excludeId ){
+
+    searchK = K;
+    searchClassIndexFilter = classIndexFilter;
+    searchExcludeId = excludeId;
+    numNeighbours = 0;
+    if( neighbours.size() < K ) neighbours.resize( K );
+
+    if( root >= 0 ){
+        searchNode( root, query, searchMode == KD_TREE_SEARCH );
+    }
+
+    return numNeighbours;
+}
+
+void ofxGrtKNN::searchNode( const int nodeIndex, const float *query, const bool prune ){
+
+    const Node &node = nodes[ nodeIndex ];
+
+    if( node.leaf >= 0 ){
+        scanLeaf( leaves[ node.leaf ], query );
+        return;
+    }
+
+    //Search the side of the split containing the query first
+    const float diff = query[ node.splitDimension ] - node.splitValue;
+    searchNode( diff < 0 ? node.left : node.right, query, prune );
+
+    //Every sample on the other side is at least diff away, only skip it if that is strictly further than the current Kth neighbour
+    if( prune && numNeighbours == searchK && diff*diff > neighbours[ searchK-1 ].distance ) return;
+
+    searchNode( diff < 0 ? node.right : node.left, query, prune );
+}
+
+void ofxGrtKNN::scanLeaf( const Leaf &leaf, const float *query ){
+
+    const UINT N = numInputDimensions;
+    const UINT W = ofxGrtSimd::WIDTH;
+    float distances[ ofxGrtSimd::WIDTH ];
+
+    for(UINT i=0; i<leaf.numSamples; i+=W){
+        const float *block = &leaf.blocks[ (i/W) * N * W ];
+        ofxGrtSimd::float4 acc = ofxGrtSimd::set1( 0.0f );
+        for(UINT j=0; j<N; j++){
+            const ofxGrtSimd::float4 d = ofxGrtSimd::sub( ofxGrtSimd::set1( query[j] ), ofxGrtSimd::load( block + j*W ) );
+            acc = ofxGrtSimd::madd( d, d, acc );
+        }
+        ofxGrtSimd::store( distances, acc );
+
+        const UINT numLanes = std::min( W, leaf.numSamples - i );
+        for(UINT lane=0; lane<numLanes; lane++){
+            insertNeighbour( distances[lane], leaf.ids[ i + lane ] );
+        }
+    }
+}
+
+void ofxGrtKNN::insertNeighbour( const float distance, const UINT id ){
+
+    if( id == searchExcludeId ) return;
+    if( searchClassIndexFilter >= 0 && sampleClassIndices[ id ] != (UINT)searchClassIndexFilter ) return;
+
+    //Neighbours are ordered by distance, then by id, so the result does not depend on the order the samples are scanned
+    UINT position = numNeighbours;
+    if( numNeighbours == searchK ){
+        const Neighbour &worst = neighbours[ searchK-1 ];
+        if( !(distance < worst.distance || (distance == worst.distance && id < worst.id)) ) return;
+        position = searchK-1;
+    }else numNeighbours++;
+
+    while( position > 0 ){
+        const Neighbour &previous = neighbours[ position-1 ];
+        if( !(distance < previous.distance || (distance == previous.distance && id < previous.id)) ) break;
+        neighbours[ position ] = previous;
+        position--;
+    }
+    neighbours[ position ].distance = distance;
+    neighbours[ position ].id = id;
+}
+
+bool ofxGrtKNN::computeTrainingDistances(){
+
+    const UINT N = numInputDimensions;
+    const UINT M = (UINT)sampleLabels.size();
+
+    //For each class, find the mean distance from each training sample to its K nearest neighbours in the same class
+    trainingMu.assign( numClasses, 0 );
+    trainingSigma.assign( numClasses, 0 );
+    VectorFloat counts( numClasses, 0 );
+    VectorFloat sumSquares( numClasses, 0 );
+    for(UINT i=0; i<M; i++){
+        const UINT classIndex = sampleClassIndices[i];
+        const UINT numFound = search( &samples[ i*N ], K, (int)classIndex, i );
+        if( numFound == 0 ) continue;
+
+        Float meanDistance = 0;
+        for(UINT k=0; k<numFound; k++){
+            meanDistance += sqrt( (Float)neighbours[k].distance );
+        }
+        meanDistance /= numFound;
+
+        trainingMu[ classIndex ] += meanDistance;
+        sumSquares[ classIndex ] += meanDistance * meanDistance;
+        counts[ classIndex ]++;
+    }
+
+    for(UINT k=0; k<numClasses; k++){
+        if( counts[k] == 0 ) continue;
+        trainingMu[k] /= counts[k];
+        trainingSigma[k] = sqrt( std::max( sumSquares[k] / counts[k] - trainingMu[k] * trainingMu[k], (Float)0 ) );
+    }
+
+    return true;
+}
+
+UINT ofxGrtKNN::getDepth( const int nodeIndex ) const {
+    const Node &node = nodes[ nodeIndex ];
+    if( node.leaf >= 0 ) return 1;
+    return 1 + std::max( getDepth( node.left ), getDepth( node.right ) );
+}
+
+int ofxGrtKNN::getClassIndex( const UINT classLabel ) const {
+    for(UINT k=0; k<classLabels.size(); k++){
+        if( classLabels[k] == classLabel ) return (int)k;
+    }
+    return -1;
+}
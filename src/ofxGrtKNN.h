@@ -0,0 +1,156 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+#include "ofxGrtSimd.h"
+
+using namespace GRT;
+
+/**
+ @brief a K nearest neighbour classifier that can be used in a GestureRecognitionPipeline (like the GRT KNN), but finds the neighbours
+ with a KD-tree instead of scanning every training sample. The training samples are stored in the tree leaves in blocks of four, dimension
+ by dimension, so each leaf is scanned with ofxGrtSimd four samples at a time.
+
+ Ties between neighbours at the same distance are broken by the order the samples were added, and the distances are computed by the
+ same leaf scan whether or not the tree is used, so the KD-tree search returns exactly the same neighbours (and predictions) as the brute
+ force search (see setSearchMode). Samples can be added to a trained model with addSample, for example while recording, without retraining.
+
+ The class likelihoods are the fraction of the K neighbours that belong to each class, and the class distances are the mean euclidean
+ distance of those neighbours, as with the GRT KNN. If null rejection is enabled, the predicted class is rejected if its mean distance is above
+ the class threshold, which is set from the neighbour distances of the training samples.
+*/
+class ofxGrtKNN : public Classifier {
+public:
+    enum SearchMode{ KD_TREE_SEARCH=0, BRUTE_FORCE_SEARCH };
+
+    /**
+     @brief creates the classifier
+     @param K: the number of neighbours used for each prediction
+     @param useScaling: if true the training and input data are scaled to [0 1] using the training data ranges
+     @param useNullRejection: if true predictions too far from the training data are rejected
+     @param nullRejectionCoeff: the number of standard deviations above the mean training distance used for the rejection thresholds
+     @param leafSize: the number of samples in each leaf of the KD-tree
+    */
+    ofxGrtKNN( const UINT K = 10, const bool useScaling = false, const bool useNullRejection = false, const Float nullRejectionCoeff = 10.0, const UINT leafSize = 16 );
+    ofxGrtKNN( const ofxGrtKNN &rhs );
+    virtual ~ofxGrtKNN();
+
+    ofxGrtKNN &operator=( const ofxGrtKNN &rhs );
+
+    virtual bool deepCopyFrom( const Classifier *classifier );
+    virtual bool train_( ClassificationData &trainingData );
+    virtual bool predict_( VectorFloat &inputVector );
+    virtual bool clear();
+    virtual bool save( std::fstream &file ) const;
+    virtual bool load( std::fstream &file );
+    virtual bool recomputeNullRejectionThresholds();
+
+    /**
+     @brief adds a sample to a trained model, the sample is scaled with the training ranges (if scaling is enabled) and inserted into the tree.
+     New class labels are added as new classes. The null rejection thresholds are not updated, call train to recompute them.
+     @param classLabel: the class label of the sample, this can not be the null class label
+     @param sample: the sample, the size must match the number of input dimensions
+     @return returns true if the sample was added successfully, false otherwise
+    */
+    bool addSample( const UINT classLabel, const VectorFloat &sample );
+
+    bool setK( const UINT K );
+    bool setLeafSize( const UINT leafSize );
+
+    /**
+     @brief sets how the neighbours are found, both modes return the same neighbours. BRUTE_FORCE_SEARCH scans every sample and is useful to check or benchmark the tree.
+    */
+    bool setSearchMode( const SearchMode searchMode );
+
+    UINT getK() const { return K; }
+    UINT getLeafSize() const { return leafSize; }
+    SearchMode getSearchMode() const { return searchMode; }
+    UINT getNumSamples() const { return (UINT)sampleLabels.size(); }
+    UINT getTreeDepth() const;
+
+    /**
+     @brief gets the index (in the order the samples were added) of each neighbour found by the last prediction, nearest first
+    */
+    const vector< UINT > &getNeighbourIndices() const { return neighbourIndices; }
+
+    using MLBase::save;
+    using MLBase::load;
+    using MLBase::train_;
+    using MLBase::predict_;
+
+protected:
+    struct Node{
+        int left;               ///< The index of the left child, or -1 if the node is a leaf
+        int right;
+        int leaf;               ///< The index of the leaf, or -1 if the node is not a leaf
+        UINT splitDimension;
+        float splitValue;       ///< Samples in the left subtree are <= splitValue, samples in the right subtree are >= splitValue
+    };
+
+    struct Leaf{
+        UINT numSamples;
+        vector< UINT > ids;     ///< The sample ids, padded to a multiple of four with unused ids
+        vector< float > blocks; ///< Blocks of four samples, stored dimension by dimension, padded with samples that are never the nearest
+    };
+
+    struct Neighbour{
+        float distance;         ///< The squared distance
+        UINT id;
+    };
+
+    int buildTree( vector< UINT > &ids, const UINT begin, const UINT end );
+    int createLeaf( const vector< UINT > &ids, const UINT begin, const UINT end );
+    void appendToLeaf( Leaf &leaf, const UINT id );
+    void insert( const UINT id );
+    UINT search( const float *query, const UINT K, const int classIndexFilter, const UINT excludeId );
+    void searchNode( const int nodeIndex, const float *query, const bool prune );
+    void scanLeaf( const Leaf &leaf, const float *query );
+    void insertNeighbour( const float distance, const UINT id );
+    bool computeTrainingDistances();
+    UINT getDepth( const int nodeIndex ) const;
+    int getClassIndex( const UINT classLabel ) const;
+
+    UINT K;
+    UINT leafSize;
+    SearchMode searchMode;
+    vector< float > samples;            ///< The (scaled) training samples, in the order they were added
+    vector< UINT > sampleLabels;
+    vector< UINT > sampleClassIndices;
+    vector< Node > nodes;
+    vector< Leaf > leaves;
+    int root;
+    VectorFloat trainingMu;
+    VectorFloat trainingSigma;
+
+    //Search state, reused by each prediction
+    vector< Neighbour > neighbours;
+    UINT numNeighbours;
+    UINT searchK;
+    int searchClassIndexFilter;
+    UINT searchExcludeId;
+    vector< float > query;
+    vector< UINT > neighbourIndices;
+
+private:
+    static RegisterClassifierModule< ofxGrtKNN > registerModule;
+};
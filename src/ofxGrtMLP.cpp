@@ -0,0 +1,636 @@
+
+#include "ofxGrtMLP.h"
+
+using namespace GRT;
+
+//Register the ofxGrtMLP module with the Regressifier base class
+RegisterRegressifierModule< ofxGrtMLP > ofxGrtMLP::registerModule("ofxGrtMLP");
+
+ofxGrtMLP::ofxGrtMLP( const UINT numHiddenNeurons, const ActivationFunction hiddenLayerActivationFunction, const ActivationFunction outputLayerActivationFunction, const bool useScaling ){
+    this->numHiddenNeurons = numHiddenNeurons;
+    this->hiddenLayerActivationFunction = hiddenLayerActivationFunction;
+    this->outputLayerActivationFunction = outputLayerActivationFunction;
+    this->useScaling = useScaling;
+    expectedNumInputs = 0;
+    expectedNumOutputs = 0;
+    numRandomTrainingIterations = 10;
+    batchSize = 16;
+    momentum = 0.5;
+    seed = 0;
+    trainingError = 0;
+    minNumEpochs = 10;
+    maxNumEpochs = 100;
+    minChange = 1.0e-5;
+    learningRate = 0.1;
+    useValidationSet = false;
+    validationSetSize = 20;
+    randomiseTrainingOrder = true;
+    classType = "ofxGrtMLP";
+    regressifierType = classType;
+    debugLog.setProceedingText("[DEBUG ofxGrtMLP]");
+    errorLog.setProceedingText("[ERROR ofxGrtMLP]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtMLP]");
+    warningLog.setProceedingText("[WARNING ofxGrtMLP]");
+}
+
+ofxGrtMLP::ofxGrtMLP( const ofxGrtMLP &rhs ){
+    classType = "ofxGrtMLP";
+    regressifierType = classType;
+    debugLog.setProceedingText("[DEBUG ofxGrtMLP]");
+    errorLog.setProceedingText("[ERROR ofxGrtMLP]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtMLP]");
+    warningLog.setProceedingText("[WARNING ofxGrtMLP]");
+    *this = rhs;
+}
+
+ofxGrtMLP::~ofxGrtMLP(){
+}
+
+ofxGrtMLP &ofxGrtMLP::operator=( const ofxGrtMLP &rhs ){
+    if( this != &rhs ){
+        this->numHiddenNeurons = rhs.numHiddenNeurons;
+        this->expectedNumInputs = rhs.expectedNumInputs;
+        this->expectedNumOutputs = rhs.expectedNumOutputs;
+        this->hiddenLayerActivationFunction = rhs.hiddenLayerActivationFunction;
+        this->outputLayerActivationFunction = rhs.outputLayerActivationFunction;
+        this->numRandomTrainingIterations = rhs.numRandomTrainingIterations;
+        this->batchSize = rhs.batchSize;
+        this->momentum = rhs.momentum;
+        this->seed = rhs.seed;
+        this->trainingError = rhs.trainingError;
+        this->network = rhs.network;
+        this->outputWeightsTransposed = rhs.outputWeightsTransposed;
+        this->input = rhs.input;
+        this->output = rhs.output;
+
+        //Copy the base regressifier variables
+        copyBaseVariables( (Regressifier*)&rhs );
+    }
+    return *this;
+}
+
+bool ofxGrtMLP::deepCopyFrom( const Regressifier *regressifier ){
+
+    if( regressifier == NULL ) return false;
+
+    const ofxGrtMLP *ptr = dynamic_cast< const ofxGrtMLP* >( regressifier );
+    if( ptr == NULL ) return false;
+
+    *this = *ptr;
+
+    return true;
+}
+
+bool ofxGrtMLP::train_( RegressionData &trainingData ){
+
+    clear();
+
+    const UINT M = trainingData.getNumSamples();
+    const UINT N = trainingData.getNumInputDimensions();
+    const UINT T = trainingData.getNumTargetDimensions();
+
+    if( M == 0 ){
+        errorLog << "train_(RegressionData &trainingData) - Training data has zero samples!" << endl;
+        return false;
+    }
+
+    if( (expectedNumInputs > 0 && N != expectedNumInputs) || (expectedNumOutputs > 0 && T != expectedNumOutputs) ){
+        errorLog << "train_(RegressionData &trainingData) - The training data has " << N << " inputs and " << T << " targets, but the network has " << expectedNumInputs << " inputs and " << expectedNumOutputs << " outputs" << endl;
+        return false;
+    }
+
+    if( numHiddenNeurons == 0 ){
+        errorLog << "train_(RegressionData &trainingData) - The number of hidden neurons must be greater than zero!" << endl;
+        return false;
+    }
+
+    numInputDimensions = N;
+    numOutputDimensions = T;
+    inputVectorRanges = trainingData.getInputRanges();
+    targetVectorRanges = trainingData.getTargetRanges();
+
+    //Copy the (scaled) training data into contiguous float matrices, the targets are scaled to the range of the output activation
+    float minTarget = 0, maxTarget = 1;
+    getTargetRange( minTarget, maxTarget );
+    vector< float > inputs( (size_t)M * N );
+    vector< float > targets( (size_t)M * T );
+    for(UINT i=0; i<M; i++){
+        const VectorFloat &x = trainingData[i].getInputVector();
+        const VectorFloat &y = trainingData[i].getTargetVector();
+        for(UINT j=0; j<N; j++){
+            inputs[ (size_t)i*N + j ] = (float)( useScaling ? scale( x[j], inputVectorRanges[j].minValue, inputVectorRanges[j].maxValue, 0, 1 ) : x[j] );
+        }
+        for(UINT j=0; j<T; j++){
+            targets[ (size_t)i*T + j ] = (float)( useScaling ? scale( y[j], targetVectorRanges[j].minValue, targetVectorRanges[j].maxValue, minTarget, maxTarget ) : y[j] );
+        }
+    }
+
+    //Hold out the validation samples, the same split is used by every restart
+    vector< UINT > trainingIndices( M );
+    for(UINT i=0; i<M; i++) trainingIndices[i] = i;
+    vector< UINT > validationIndices;
+    if( useValidationSet && M > 1 ){
+        uint64_t state = seed;
+        for(UINT i=M-1; i>0; i--){
+            std::swap( trainingIndices[i], trainingIndices[ next( state ) % (i+1) ] );
+        }
+        const UINT numValidationSamples = std::min( M-1, std::max( 1u, (UINT)(M * validationSetSize / 100.0) ) );
+        validationIndices.assign( trainingIndices.end() - numValidationSamples, trainingIndices.end() );
+        trainingIndices.resize( M - numValidationSamples );
+    }
+    const vector< UINT > &errorIndices = validationIndices.size() > 0 ? validationIndices : trainingIndices;
+
+    //Train each random restart in parallel
+    const UINT numRestarts = std::max( 1u, numRandomTrainingIterations );
+    vector< Network > networks( numRestarts );
+    vector< UINT > numEpochs( numRestarts, 0 );
+    vector< double > errors( numRestarts, 0 );
+    vector< char > converged( numRestarts, 0 );
+    ofxGrtThreadPool::getSharedPool().parallelFor( 0, numRestarts, 1, [&]( const size_t r, const unsigned int threadIndex ){
+        converged[r] = trainNetwork( (UINT)r, inputs, targets, trainingIndices, networks[r], numEpochs[r] );
+        if( converged[r] ){
+            Batch batch;
+            initBatch( batch );
+            errors[r] = computeError( networks[r], inputs, targets, errorIndices, batch );
+        }
+    });
+
+    //Keep the first restart with the lowest error
+    int best = -1;
+    for(UINT r=0; r<numRestarts; r++){
+        if( converged[r] && !grt_isnan( errors[r] ) && !grt_isinf( errors[r] ) && (best < 0 || errors[r] < errors[best]) ) best = (int)r;
+    }
+
+    if( best < 0 ){
+        errorLog << "train_(RegressionData &trainingData) - The training diverged on every restart, try a smaller learning rate!" << endl;
+        clear();
+        return false;
+    }
+
+    network = networks[ best ];
+    trainingError = sqrt( errors[ best ] / (errorIndices.size() * T) );
+    numTrainingIterationsToConverge = numEpochs[ best ];
+    updateTransposedWeights();
+    input.resize( N );
+    output.resize( T );
+    regressionData.resize( T, 0 );
+    trained = true;
+
+    trainingLog << "Restart " << best << " of " << numRestarts << " kept, epochs: " << numEpochs[ best ] << " RMS error: " << trainingError << endl;
+
+    return true;
+}
+
+bool ofxGrtMLP::predict_( VectorFloat &inputVector ){
+
+    if( !trained ){
+        errorLog << "predict_(VectorFloat &inputVector) - Model Not Trained!" << endl;
+        return false;
+    }
+
+    if( inputVector.size() != numInputDimensions ){
+        errorLog << "predict_(VectorFloat &inputVector) - The size of the input vector (" << inputVector.size() << ") does not match the num features in the model (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    const UINT N = numInputDimensions;
+    const UINT H = numHiddenNeurons;
+    const UINT T = numOutputDimensions;
+
+    for(UINT j=0; j<N; j++){
+        input[j] = (float)( useScaling ? scale( inputVector[j], inputVectorRanges[j].minValue, inputVectorRanges[j].maxValue, 0, 1 ) : inputVector[j] );
+    }
+
+    //Compute each hidden neuron and add its weighted activation straight into the outputs
+    std::copy( network.outputBias.begin(), network.outputBias.end(), output.begin() );
+    for(UINT h=0; h<H; h++){
+        const float a = activate( ofxGrtSimd::dot( &network.hiddenWeights[ h*N ], &input[0], N ) + network.hiddenBias[h], hiddenLayerActivationFunction );
+        ofxGrtSimd::axpy( &output[0], a, &outputWeightsTransposed[ h*T ], T );
+    }
+    activate( &output[0], T, outputLayerActivationFunction );
+
+    float minTarget = 0, maxTarget = 1;
+    getTargetRange( minTarget, maxTarget );
+    for(UINT j=0; j<T; j++){
+        regressionData[j] = useScaling ? scale( output[j], minTarget, maxTarget, targetVectorRanges[j].minValue, targetVectorRanges[j].maxValue ) : output[j];
+    }
+
+    return true;
+}
+
+bool ofxGrtMLP::clear(){
+
+    Regressifier::clear();
+
+    network = Network();
+    outputWeightsTransposed.clear();
+    input.clear();
+    output.clear();
+    trainingError = 0;
+
+    return true;
+}
+
+bool ofxGrtMLP::save( std::fstream &file ) const {
+
+    if( !file.is_open() ){
+        errorLog << "save(fstream &file) - Could not open file to save model!" << endl;
+        return false;
+    }
+
+    file << "GRT_OFXGRTMLP_MODEL_FILE_V1.0\n";
+
+    if( !Regressifier::saveBaseSettingsToFile( file ) ){
+        errorLog << "save(fstream &file) - Failed to save regressifier base settings to file!" << endl;
+        return false;
+    }
+
+    file << "NumHiddenNeurons: " << numHiddenNeurons << endl;
+    file << "HiddenLayerActivationFunction: " << hiddenLayerActivationFunction << endl;
+    file << "OutputLayerActivationFunction: " << outputLayerActivationFunction << endl;
+    file << "NumRandomTrainingIterations: " << numRandomTrainingIterations << endl;
+    file << "BatchSize: " << batchSize << endl;
+    file << "Momentum: " << momentum << endl;
+
+    if( trained ){
+        //Write the weights with enough digits to read back the exact float values
+        const std::streamsize precision = file.precision( 9 );
+
+        file << "HiddenWeights:";
+        for(size_t i=0; i<network.hiddenWeights.size(); i++) file << " " << network.hiddenWeights[i];
+        file << endl;
+        file << "HiddenBias:";
+        for(size_t i=0; i<network.hiddenBias.size(); i++) file << " " << network.hiddenBias[i];
+        file << endl;
+        file << "OutputWeights:";
+        for(size_t i=0; i<network.outputWeights.size(); i++) file << " " << network.outputWeights[i];
+        file << endl;
+        file << "OutputBias:";
+        for(size_t i=0; i<network.outputBias.size(); i++) file << " " << network.outputBias[i];
+        file << endl;
+
+        file.precision( precision );
+    }
+
+    return true;
+}
+
+bool ofxGrtMLP::load( std::fstream &file ){
+
+    clear();
+
+    if( !file.is_open() ){
+        errorLog << "load(fstream &file) - Could not open file to load model!" << endl;
+        return false;
+    }
+
+    std::string word;
+    file >> word;
+    if( word != "GRT_OFXGRTMLP_MODEL_FILE_V1.0" ){
+        errorLog << "load(fstream &file) - Could not find Model File Header!" << endl;
+        return false;
+    }
+
+    if( !Regressifier::loadBaseSettingsFromFile( file ) ){
+        errorLog << "load(fstream &file) - Failed to load base settings from file!" << endl;
+        return false;
+    }
+
+    UINT hiddenActivation = 0, outputActivation = 0;
+    file >> word;
+    if( word != "NumHiddenNeurons:" ){ errorLog << "load(fstream &file) - Could not find NumHiddenNeurons!" << endl; return false; }
+    file >> numHiddenNeurons;
+    file >> word;
+    if( word != "HiddenLayerActivationFunction:" ){ errorLog << "load(fstream &file) - Could not find HiddenLayerActivationFunction!" << endl; return false; }
+    file >> hiddenActivation;
+    file >> word;
+    if( word != "OutputLayerActivationFunction:" ){ errorLog << "load(fstream &file) - Could not find OutputLayerActivationFunction!" << endl; return false; }
+    file >> outputActivation;
+    file >> word;
+    if( word != "NumRandomTrainingIterations:" ){ errorLog << "load(fstream &file) - Could not find NumRandomTrainingIterations!" << endl; return false; }
+    file >> numRandomTrainingIterations;
+    file >> word;
+    if( word != "BatchSize:" ){ errorLog << "load(fstream &file) - Could not find BatchSize!" << endl; return false; }
+    file >> batchSize;
+    file >> word;
+    if( word != "Momentum:" ){ errorLog << "load(fstream &file) - Could not find Momentum!" << endl; return false; }
+    file >> momentum;
+
+    if( hiddenActivation > TANH || outputActivation > TANH ){
+        errorLog << "load(fstream &file) - Unknown activation function!" << endl;
+        return false;
+    }
+    hiddenLayerActivationFunction = (ActivationFunction)hiddenActivation;
+    outputLayerActivationFunction = (ActivationFunction)outputActivation;
+
+    if( !trained ) return true;
+
+    const UINT N = numInputDimensions;
+    const UINT H = numHiddenNeurons;
+    const UINT T = numOutputDimensions;
+    network.hiddenWeights.resize( H*N );
+    network.hiddenBias.resize( H );
+    network.outputWeights.resize( T*H );
+    network.outputBias.resize( T );
+
+    file >> word;
+    if( word != "HiddenWeights:" ){ errorLog << "load(fstream &file) - Could not find HiddenWeights!" << endl; clear(); return false; }
+    for(size_t i=0; i<network.hiddenWeights.size(); i++) file >> network.hiddenWeights[i];
+    file >> word;
+    if( word != "HiddenBias:" ){ errorLog << "load(fstream &file) - Could not find HiddenBias!" << endl; clear(); return false; }
+    for(size_t i=0; i<network.hiddenBias.size(); i++) file >> network.hiddenBias[i];
+    file >> word;
+    if( word != "OutputWeights:" ){ errorLog << "load(fstream &file) - Could not find OutputWeights!" << endl; clear(); return false; }
+    for(size_t i=0; i<network.outputWeights.size(); i++) file >> network.outputWeights[i];
+    file >> word;
+    if( word != "OutputBias:" ){ errorLog << "load(fstream &file) - Could not find OutputBias!" << endl; clear(); return false; }
+    for(size_t i=0; i<network.outputBias.size(); i++) file >> network.outputBias[i];
+
+    updateTransposedWeights();
+    input.resize( N );
+    output.resize( T );
+    regressionData.resize( T, 0 );
+
+    return true;
+}
+
+bool ofxGrtMLP::init( const UINT numInputNeurons, const UINT numHiddenNeurons, const UINT numOutputNeurons, const ActivationFunction hiddenLayerActivationFunction, const ActivationFunction outputLayerActivationFunction ){
+
+    if( numInputNeurons == 0 || numHiddenNeurons == 0 || numOutputNeurons == 0 ){
+        errorLog << "init(...) - The number of input, hidden and output neurons must be greater than zero!" << endl;
+        return false;
+    }
+
+    clear();
+
+    this->expectedNumInputs = numInputNeurons;
+    this->numHiddenNeurons = numHiddenNeurons;
+    this->expectedNumOutputs = numOutputNeurons;
+    this->hiddenLayerActivationFunction = hiddenLayerActivationFunction;
+    this->outputLayerActivationFunction = outputLayerActivationFunction;
+
+    return true;
+}
+
+bool ofxGrtMLP::setNumRandomTrainingIterations( const UINT numRandomTrainingIterations ){
+    if( numRandomTrainingIterations == 0 ){
+        errorLog << "setNumRandomTrainingIterations(const UINT numRandomTrainingIterations) - The number of iterations must be greater than zero!" << endl;
+        return false;
+    }
+    this->numRandomTrainingIterations = numRandomTrainingIterations;
+    return true;
+}
+
+bool ofxGrtMLP::setBatchSize( const UINT batchSize ){
+    if( batchSize == 0 ){
+        errorLog << "setBatchSize(const UINT batchSize) - The batch size must be greater than zero!" << endl;
+        return false;
+    }
+    this->batchSize = batchSize;
+    return true;
+}
+
+bool ofxGrtMLP::setMomentum( const Float momentum ){
+    if( momentum < 0 || momentum >= 1 ){
+        errorLog << "setMomentum(const Float momentum) - The momentum must be in the range [0 1)!" << endl;
+        return false;
+    }
+    this->momentum = momentum;
+    return true;
+}
+
+bool ofxGrtMLP::setSeed( const uint64_t seed ){
+    this->seed = seed;
+    return true;
+}
+
+bool ofxGrtMLP::trainNetwork( const UINT restart, const vector< float > &inputs, const vector< float > &targets, const vector< UINT > &trainingIndices, Network &network, UINT &numEpochs ) const {
+
+    const UINT N = numInputDimensions;
+    const UINT H = numHiddenNeurons;
+    const UINT T = numOutputDimensions;
+    const UINT M = (UINT)trainingIndices.size();
+    const float rate = (float)learningRate;
+    const float alpha = (float)momentum;
+    uint64_t state = seed + 0x9E3779B97F4A7C15ULL * (restart + 1);
+
+    //Initialize the weights uniformly in +-1/sqrt(fanIn)
+    network.hiddenWeights.resize( H*N );
+    network.hiddenBias.resize( H );
+    network.outputWeights.resize( T*H );
+    network.outputBias.resize( T );
+    const float hiddenRange = 1.0f / sqrt( (float)N );
+    const float outputRange = 1.0f / sqrt( (float)H );
+    for(size_t i=0; i<network.hiddenWeights.size(); i++) network.hiddenWeights[i] = hiddenRange * ((next( state ) >> 40) / 8388608.0f - 1.0f);
+    for(size_t i=0; i<network.hiddenBias.size(); i++) network.hiddenBias[i] = hiddenRange * ((next( state ) >> 40) / 8388608.0f - 1.0f);
+    for(size_t i=0; i<network.outputWeights.size(); i++) network.outputWeights[i] = outputRange * ((next( state ) >> 40) / 8388608.0f - 1.0f);
+    for(size_t i=0; i<network.outputBias.size(); i++) network.outputBias[i] = outputRange * ((next( state ) >> 40) / 8388608.0f - 1.0f);
+
+    Network gradient = network;
+    Network velocity = network;
+    std::fill( velocity.hiddenWeights.begin(), velocity.hiddenWeights.end(), 0.0f );
+    std::fill( velocity.hiddenBias.begin(), velocity.hiddenBias.end(), 0.0f );
+    std::fill( velocity.outputWeights.begin(), velocity.outputWeights.end(), 0.0f );
+    std::fill( velocity.outputBias.begin(), velocity.outputBias.end(), 0.0f );
+
+    Batch batch;
+    initBatch( batch );
+    vector< UINT > order( trainingIndices );
+    double lastError = 0;
+    numEpochs = 0;
+
+    for(UINT epoch=0; epoch<maxNumEpochs; epoch++){
+
+        if( randomiseTrainingOrder ){
+            for(UINT i=M-1; i>0; i--){
+                std::swap( order[i], order[ next( state ) % (i+1) ] );
+            }
+        }
+
+        double error = 0;
+        for(UINT start=0; start<M; start+=batchSize){
+            const UINT n = std::min( batchSize, M - start );
+            error += forward( network, inputs, targets, &order[ start ], n, batch );
+
+            //The output layer gradients, sum_b delta_b * hidden_b
+            std::fill( gradient.outputWeights.begin(), gradient.outputWeights.end(), 0.0f );
+            std::fill( gradient.outputBias.begin(), gradient.outputBias.end(), 0.0f );
+            for(UINT b=0; b<n; b++){
+                const float *delta = &batch.outputDeltas[ b*T ];
+                for(UINT k=0; k<T; k++){
+                    ofxGrtSimd::axpy( &gradient.outputWeights[ k*H ], delta[k], &batch.hidden[ b*H ], H );
+                    gradient.outputBias[k] += delta[k];
+                }
+            }
+
+            //Back propagate the deltas to the hidden layer, then the hidden layer gradients, sum_b delta_b * input_b
+            std::fill( gradient.hiddenWeights.begin(), gradient.hiddenWeights.end(), 0.0f );
+            std::fill( gradient.hiddenBias.begin(), gradient.hiddenBias.end(), 0.0f );
+            for(UINT b=0; b<n; b++){
+                float *hiddenDelta = &batch.hiddenDeltas[ b*H ];
+                const float *hidden = &batch.hidden[ b*H ];
+                std::fill( hiddenDelta, hiddenDelta + H, 0.0f );
+                for(UINT k=0; k<T; k++){
+                    ofxGrtSimd::axpy( hiddenDelta, batch.outputDeltas[ b*T + k ], &network.outputWeights[ k*H ], H );
+                }
+                for(UINT h=0; h<H; h++){
+                    hiddenDelta[h] *= getDerivative( hidden[h], hiddenLayerActivationFunction );
+                    ofxGrtSimd::axpy( &gradient.hiddenWeights[ h*N ], hiddenDelta[h], &batch.inputs[ b*N ], N );
+                    gradient.hiddenBias[h] += hiddenDelta[h];
+                }
+            }
+
+            //Gradient descent with momentum on the mean gradient of the batch
+            const float step = rate / n;
+            vector< float > *weights[4] = { &network.hiddenWeights, &network.hiddenBias, &network.outputWeights, &network.outputBias };
+            vector< float > *gradients[4] = { &gradient.hiddenWeights, &gradient.hiddenBias, &gradient.outputWeights, &gradient.outputBias };
+            vector< float > *velocities[4] = { &velocity.hiddenWeights, &velocity.hiddenBias, &velocity.outputWeights, &velocity.outputBias };
+            for(UINT l=0; l<4; l++){
+                float *w = &(*weights[l])[0];
+                const float *g = &(*gradients[l])[0];
+                float *v = &(*velocities[l])[0];
+                const size_t size = weights[l]->size();
+                for(size_t i=0; i<size; i++){
+                    v[i] = alpha * v[i] - step * g[i];
+                    w[i] += v[i];
+                }
+            }
+        }
+
+        if( grt_isnan( error ) || grt_isinf( error ) ) return false;
+
+        numEpochs = epoch + 1;
+        if( epoch > 0 && epoch+1 >= minNumEpochs && fabs( lastError - error ) <= minChange ) break;
+        lastError = error;
+    }
+
+    return true;
+}
+
+double ofxGrtMLP::computeError( const Network &network, const vector< float > &inputs, const vector< float > &targets, const vector< UINT > &indices, Batch &batch ) const {
+    double error = 0;
+    for(UINT start=0; start<indices.size(); start+=batchSize){
+        const UINT n = std::min( batchSize, (UINT)indices.size() - start );
+        error += forward( network, inputs, targets, &indices[ start ], n, batch );
+    }
+    return error;
+}
+
+double ofxGrtMLP::forward( const Network &network, const vector< float > &inputs, const vector< float > &targets, const UINT *indices, const UINT n, Batch &batch ) const {
+
+    const UINT N = numInputDimensions;
+    const UINT H = numHiddenNeurons;
+    const UINT T = numOutputDimensions;
+
+    //Gather the batch into contiguous rows
+    for(UINT b=0; b<n; b++){
+        std::copy( inputs.begin() + (size_t)indices[b]*N, inputs.begin() + (size_t)(indices[b]+1)*N, batch.inputs.begin() + b*N );
+        std::copy( targets.begin() + (size_t)indices[b]*T, targets.begin() + (size_t)(indices[b]+1)*T, batch.targets.begin() + b*T );
+    }
+
+    multiplyTransposed( &batch.inputs[0], &network.hiddenWeights[0], &network.hiddenBias[0], &batch.hidden[0], n, H, N );
+    activate( &batch.hidden[0], n*H, hiddenLayerActivationFunction );
+    multiplyTransposed( &batch.hidden[0], &network.outputWeights[0], &network.outputBias[0], &batch.outputs[0], n, T, H );
+    activate( &batch.outputs[0], n*T, outputLayerActivationFunction );
+
+    //The squared error, and the output deltas for the backward pass
+    double error = 0;
+    for(UINT i=0; i<n*T; i++){
+        const float e = batch.outputs[i] - batch.targets[i];
+        error += e * e;
+        batch.outputDeltas[i] = e * getDerivative( batch.outputs[i], outputLayerActivationFunction );
+    }
+
+    return error;
+}
+
+void ofxGrtMLP::initBatch( Batch &batch ) const {
+    batch.inputs.resize( batchSize * numInputDimensions );
+    batch.targets.resize( batchSize * numOutputDimensions );
+    batch.hidden.resize( batchSize * numHiddenNeurons );
+    batch.outputs.resize( batchSize * numOutputDimensions );
+    batch.outputDeltas.resize( batchSize * numOutputDimensions );
+    batch.hiddenDeltas.resize( batchSize * numHiddenNeurons );
+}
+
+void ofxGrtMLP::updateTransposedWeights(){
+    const UINT H = numHiddenNeurons;
+    const UINT T = numOutputDimensions;
+    outputWeightsTransposed.resize( H*T );
+    for(UINT k=0; k<T; k++){
+        for(UINT h=0; h<H; h++){
+            outputWeightsTransposed[ h*T + k ] = network.outputWeights[ k*H + h ];
+        }
+    }
+}
+
+void ofxGrtMLP::getTargetRange( float &minTarget, float &maxTarget ) const {
+    minTarget = outputLayerActivationFunction == TANH ? -1.0f : 0.0f;
+    maxTarget = 1.0f;
+}
+
+void ofxGrtMLP::multiplyTransposed( const float *A, const float *B, const float *bias, float *C, const UINT M, const UINT N, const UINT K ){
+
+    //C = A * B^T + bias, four rows of A at a time so each row of B is loaded once per block
+    const UINT W = ofxGrtSimd::WIDTH;
+    for(UINT i=0; i<M; i+=4){
+        const UINT numRows = std::min( 4u, M - i );
+        for(UINT j=0; j<N; j++){
+            const float *b = B + (size_t)j*K;
+            ofxGrtSimd::float4 acc[4] = { ofxGrtSimd::set1( 0 ), ofxGrtSimd::set1( 0 ), ofxGrtSimd::set1( 0 ), ofxGrtSimd::set1( 0 ) };
+            UINT k = 0;
+            for(; k+W<=K; k+=W){
+                const ofxGrtSimd::float4 bv = ofxGrtSimd::load( b + k );
+                for(UINT r=0; r<numRows; r++){
+                    acc[r] = ofxGrtSimd::madd( ofxGrtSimd::load( A + (size_t)(i+r)*K + k ), bv, acc[r] );
+                }
+            }
+            for(UINT r=0; r<numRows; r++){
+                const float *a = A + (size_t)(i+r)*K;
+                float sum = ofxGrtSimd::sum( acc[r] );
+                for(UINT t=k; t<K; t++) sum += a[t] * b[t];
+                C[ (size_t)(i+r)*N + j ] = sum + bias[j];
+            }
+        }
+    }
+}
+
+void ofxGrtMLP::activate( float *x, const UINT n, const ActivationFunction activationFunction ){
+    if( activationFunction == LINEAR ) return;
+    for(UINT i=0; i<n; i++){
+        x[i] = activate( x[i], activationFunction );
+    }
+}
+
+float ofxGrtMLP::activate( const float x, const ActivationFunction activationFunction ){
+    switch( activationFunction ){
+        case SIGMOID:
+            //Clamp the input to stop exp overflowing, as the GRT Neuron does
+            if( x < -45.0f ) return 0.0f;
+            if( x > 45.0f ) return 1.0f;
+            return 1.0f / (1.0f + exp( -x ));
+        case TANH:
+            return tanh( x );
+        default:
+            break;
+    }
+    return x;
+}
+
+float ofxGrtMLP::getDerivative( const float y, const ActivationFunction activationFunction ){
+    //The derivative as a function of the activation output
+    switch( activationFunction ){
+        case SIGMOID: return y * (1.0f - y);
+        case TANH: return 1.0f - y * y;
+        default: break;
+    }
+    return 1.0f;
+}
+
+uint64_t ofxGrtMLP::next( uint64_t &state ){
+    //splitmix64
+    uint64_t x = (state += 0x9E3779B97F4A7C15ULL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
@@ -0,0 +1,156 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <stdint.h>
+
+#include "ofMain.h"
+#include "ofxGrtSimd.h"
+#include "ofxGrtThreadPool.h"
+
+using namespace GRT;
+
+/**
+ @brief a multilayer perceptron regressifier with one hidden layer that can be used in a GestureRecognitionPipeline or a MultidimensionalRegression
+ (like the GRT MLP). The weights of each layer are stored as one contiguous float matrix. Training uses mini-batch gradient descent with momentum:
+ each batch of samples is run forward and backward through the network with blocked SIMD matrix products, and the random restarts (see
+ setNumRandomTrainingIterations) are trained in parallel on the shared ofxGrtThreadPool. The restart with the lowest error on the validation
+ set (or the training set if no validation set is used) is kept. Prediction computes each hidden neuron with one SIMD dot product and adds its
+ contribution straight into the outputs, so no hidden layer buffer is needed.
+
+ The gradients of a batch are averaged, so the learning rate does not depend on the batch size, and a batch size of 1 gives the per-sample updates of the GRT MLP.
+ The weights are initialized and the samples are shuffled with random numbers seeded from setSeed and the restart index, so training is reproducible.
+*/
+class ofxGrtMLP : public Regressifier {
+public:
+    enum ActivationFunction{ LINEAR=0, SIGMOID, TANH };
+
+    /**
+     @brief creates the MLP
+     @param numHiddenNeurons: the number of neurons in the hidden layer
+     @param hiddenLayerActivationFunction: the activation function of the hidden layer
+     @param outputLayerActivationFunction: the activation function of the output layer
+     @param useScaling: if true the inputs are scaled to [0 1] and the targets to the range of the output activation function
+    */
+    ofxGrtMLP( const UINT numHiddenNeurons = 10, const ActivationFunction hiddenLayerActivationFunction = SIGMOID, const ActivationFunction outputLayerActivationFunction = SIGMOID, const bool useScaling = true );
+    ofxGrtMLP( const ofxGrtMLP &rhs );
+    virtual ~ofxGrtMLP();
+
+    ofxGrtMLP &operator=( const ofxGrtMLP &rhs );
+
+    virtual bool deepCopyFrom( const Regressifier *regressifier );
+    virtual bool train_( RegressionData &trainingData );
+    virtual bool predict_( VectorFloat &inputVector );
+    virtual bool clear();
+    virtual bool save( std::fstream &file ) const;
+    virtual bool load( std::fstream &file );
+
+    /**
+     @brief sets the size of the network, the number of inputs and outputs must match the training data (use one output inside a MultidimensionalRegression)
+     @return returns true if the network was initialized successfully, false otherwise
+    */
+    bool init( const UINT numInputNeurons, const UINT numHiddenNeurons, const UINT numOutputNeurons, const ActivationFunction hiddenLayerActivationFunction = SIGMOID, const ActivationFunction outputLayerActivationFunction = SIGMOID );
+
+    bool setNumRandomTrainingIterations( const UINT numRandomTrainingIterations );
+    bool setBatchSize( const UINT batchSize );
+    bool setMomentum( const Float momentum );
+    bool setSeed( const uint64_t seed );
+
+    UINT getNumHiddenNeurons() const { return numHiddenNeurons; }
+    UINT getNumRandomTrainingIterations() const { return numRandomTrainingIterations; }
+    UINT getBatchSize() const { return batchSize; }
+    Float getMomentum() const { return momentum; }
+    uint64_t getSeed() const { return seed; }
+
+    /**
+     @brief gets the root mean squared error of the network that was kept, on the validation set if one was used or the training set otherwise
+    */
+    Float getTrainingError() const { return trainingError; }
+
+    ActivationFunction getHiddenLayerActivationFunction() const { return hiddenLayerActivationFunction; }
+    ActivationFunction getOutputLayerActivationFunction() const { return outputLayerActivationFunction; }
+
+    /**
+     @brief gets the weights of the trained network, the hidden layer is [numHiddenNeurons x numInputDimensions] and the output layer is [numOutputDimensions x numHiddenNeurons]
+    */
+    const vector< float > &getHiddenWeights() const { return network.hiddenWeights; }
+    const vector< float > &getHiddenBias() const { return network.hiddenBias; }
+    const vector< float > &getOutputWeights() const { return network.outputWeights; }
+    const vector< float > &getOutputBias() const { return network.outputBias; }
+
+    /**
+     @brief gets the range of the output activation function, which the targets are scaled to when scaling is enabled
+    */
+    void getTargetRange( float &minTarget, float &maxTarget ) const;
+
+    using MLBase::save;
+    using MLBase::load;
+    using MLBase::train_;
+    using MLBase::predict_;
+
+protected:
+    struct Network{
+        vector< float > hiddenWeights;      ///< [numHiddenNeurons x numInputDimensions]
+        vector< float > hiddenBias;
+        vector< float > outputWeights;      ///< [numOutputDimensions x numHiddenNeurons]
+        vector< float > outputBias;
+    };
+
+    struct Batch{
+        vector< float > inputs;             ///< [batchSize x numInputDimensions]
+        vector< float > targets;            ///< [batchSize x numOutputDimensions]
+        vector< float > hidden;             ///< The hidden activations [batchSize x numHiddenNeurons]
+        vector< float > outputs;            ///< [batchSize x numOutputDimensions]
+        vector< float > outputDeltas;
+        vector< float > hiddenDeltas;
+    };
+
+    bool trainNetwork( const UINT restart, const vector< float > &inputs, const vector< float > &targets, const vector< UINT > &trainingIndices, Network &network, UINT &numEpochs ) const;
+    double computeError( const Network &network, const vector< float > &inputs, const vector< float > &targets, const vector< UINT > &indices, Batch &batch ) const;
+    double forward( const Network &network, const vector< float > &inputs, const vector< float > &targets, const UINT *indices, const UINT n, Batch &batch ) const;
+    void initBatch( Batch &batch ) const;
+    void updateTransposedWeights();
+
+    static void multiplyTransposed( const float *A, const float *B, const float *bias, float *C, const UINT M, const UINT N, const UINT K );
+    static void activate( float *x, const UINT n, const ActivationFunction activationFunction );
+    static float activate( const float x, const ActivationFunction activationFunction );
+    static float getDerivative( const float y, const ActivationFunction activationFunction );
+    static uint64_t next( uint64_t &state );
+
+    UINT numHiddenNeurons;
+    UINT expectedNumInputs;
+    UINT expectedNumOutputs;
+    ActivationFunction hiddenLayerActivationFunction;
+    ActivationFunction outputLayerActivationFunction;
+    UINT numRandomTrainingIterations;
+    UINT batchSize;
+    Float momentum;
+    uint64_t seed;
+    Float trainingError;
+
+    Network network;
+    vector< float > outputWeightsTransposed;  ///< [numHiddenNeurons x numOutputDimensions], used by predict
+    vector< float > input;
+    vector< float > output;
+
+private:
+    static RegisterRegressifierModule< ofxGrtMLP > registerModule;
+};
@@ -0,0 +1,649 @@
+
+#include "ofxGrtMapEvaluator.h"
+#include "ofxGrtModelAccess.h"
+#include "ofxGrtSimd.h"
+#include <chrono>
+
+using namespace GRT;
+using namespace ofxGrtSimd;
+
+ofxGrtMapEvaluator::ofxGrtMapEvaluator( const unsigned int numThreads ) : pool( numThreads ) {
+    errorLog.setProceedingText("[ERROR ofxGrtMapEvaluator]");
+    warningLog.setProceedingText("[WARNING ofxGrtMapEvaluator]");
+    clear();
+}
+
+ofxGrtMapEvaluator::~ofxGrtMapEvaluator(){
+}
+
+bool ofxGrtMapEvaluator::setup( const GestureRecognitionPipeline &pipeline ){
+
+    //Keep the current grid so the map can be rebuilt straight after the pipeline is retrained
+    const unsigned int lastWidth = width;
+    const unsigned int lastHeight = height;
+    VectorFloat origin( gridOrigin.size() ), xAxis( gridOrigin.size() ), yAxis( gridOrigin.size() );
+    for(size_t d=0; d<gridOrigin.size(); d++){
+        origin[d] = gridOrigin[d];
+        xAxis[d] = gridXStep[d] * lastWidth;
+        yAxis[d] = gridYStep[d] * lastHeight;
+    }
+
+    clear();
+
+    if( !pipeline.getTrained() ){
+        errorLog << "setup(const GestureRecognitionPipeline &pipeline) - The pipeline has not been trained!" << endl;
+        return false;
+    }
+
+    numInputDimensions = pipeline.getInputVectorDimensionsSize();
+    isClassifier = pipeline.getIsPipelineInClassificationMode();
+    isRegressifier = pipeline.getIsPipelineInRegressionMode();
+
+    //Any pre processing, feature extraction or post processing changes the decision function, so use the generic evaluator
+    const bool hasOtherModules = pipeline.getNumPreProcessingModules() > 0 || pipeline.getNumFeatureExtractionModules() > 0 || pipeline.getNumPostProcessingModules() > 0;
+
+    bool closedForm = false;
+    if( !hasOtherModules && isClassifier ){
+        const Classifier *classifier = pipeline.getClassifier();
+        numClasses = classifier->getNumClasses();
+        numOutputDimensions = 1;
+        useNullRejection = classifier->getNullRejectionEnabled();
+
+        if( const MinDist *minDist = dynamic_cast< const MinDist* >( classifier ) ){
+            closedForm = setupMinDist( *minDist );
+        }else if( const ANBC *anbc = dynamic_cast< const ANBC* >( classifier ) ){
+            closedForm = setupANBC( *anbc );
+        }else if( const Softmax *softmax = dynamic_cast< const Softmax* >( classifier ) ){
+            closedForm = setupSoftmax( *softmax );
+        }else if( const RandomForests *forest = dynamic_cast< const RandomForests* >( classifier ) ){
+            closedForm = setupForest( *forest );
+        }else if( const GMM *gmm = dynamic_cast< const GMM* >( classifier ) ){
+            closedForm = setupGMM( *gmm );
+        }else if( const ofxGrtSVM *svm = dynamic_cast< const ofxGrtSVM* >( classifier ) ){
+            closedForm = setupSVM( *svm );
+        }
+    }else if( !hasOtherModules && isRegressifier ){
+        closedForm = setupRegression( *pipeline.getRegressifier() );
+    }
+
+    if( closedForm && (modelType == FOREST_MODEL || modelType == GMM_MODEL || modelType == SVM_MODEL) ){
+        threadInputs.resize( pool.getNumThreads() );
+    }else if( closedForm ){
+        //Each thread needs the row start and step, the inputs for 4 pixels, and 4 values per class
+        const unsigned int scratchSize = numInputDimensions*(2+WIDTH) + (numClasses > numOutputDimensions ? numClasses : numOutputDimensions)*WIDTH;
+        threadScratch.resize( pool.getNumThreads(), vector< float >( scratchSize, 0 ) );
+    }else if( !setupGeneric( pipeline ) ){
+        return false;
+    }
+
+    if( lastWidth > 0 && lastHeight > 0 && origin.size() == numInputDimensions ){
+        return setGrid( lastWidth, lastHeight, origin, xAxis, yAxis );
+    }
+
+    return true;
+}
+
+bool ofxGrtMapEvaluator::setGrid( const unsigned int width, const unsigned int height ){
+
+    if( numInputDimensions != 2 ){
+        errorLog << "setGrid(const unsigned int width, const unsigned int height) - The model must have 2 input dimensions, use the setGrid function with an origin and axes for other models" << endl;
+        return false;
+    }
+
+    VectorFloat origin(2,0);
+    VectorFloat xAxis(2,0);
+    VectorFloat yAxis(2,0);
+    xAxis[0] = 1;
+    yAxis[1] = 1;
+
+    return setGrid( width, height, origin, xAxis, yAxis );
+}
+
+bool ofxGrtMapEvaluator::setGrid( const unsigned int width, const unsigned int height, const VectorFloat &origin, const VectorFloat &xAxis, const VectorFloat &yAxis ){
+
+    if( modelType == GENERIC_MODEL && pipelines.size() == 0 ){
+        errorLog << "setGrid(...) - The evaluator has not been setup with a trained pipeline!" << endl;
+        return false;
+    }
+
+    if( width == 0 || height == 0 ){
+        errorLog << "setGrid(...) - The width and height must be greater than zero!" << endl;
+        return false;
+    }
+
+    if( origin.size() != numInputDimensions || xAxis.size() != numInputDimensions || yAxis.size() != numInputDimensions ){
+        errorLog << "setGrid(...) - The size of the origin and axes (" << origin.size() << ") does not match the number of input dimensions (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    this->width = width;
+    this->height = height;
+
+    gridOrigin.resize( numInputDimensions );
+    gridXStep.resize( numInputDimensions );
+    gridYStep.resize( numInputDimensions );
+    for(unsigned int d=0; d<numInputDimensions; d++){
+        gridOrigin[d] = (float)origin[d];
+        gridXStep[d] = (float)(xAxis[d] / width);
+        gridYStep[d] = (float)(yAxis[d] / height);
+    }
+
+    const size_t numPixels = (size_t)width * height;
+    if( isClassifier ){
+        predictedClassLabels.resize( numPixels, 0 );
+        maximumLikelihoods.resize( numPixels, 0 );
+    }
+    if( isRegressifier ){
+        regressionData.resize( numPixels * numOutputDimensions, 0 );
+    }
+
+    return true;
+}
+
+bool ofxGrtMapEvaluator::evaluate(){
+
+    if( width == 0 || height == 0 ){
+        errorLog << "evaluate() - The grid has not been set!" << endl;
+        return false;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    pool.parallelFor( 0, height, 1, [this]( const size_t row, const unsigned int threadIndex ){
+        evaluateRow( (unsigned int)row, threadIndex );
+    });
+
+    evaluationTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+
+    return true;
+}
+
+bool ofxGrtMapEvaluator::clear(){
+    modelType = GENERIC_MODEL;
+    isClassifier = false;
+    isRegressifier = false;
+    useNullRejection = false;
+    numInputDimensions = 0;
+    numOutputDimensions = 0;
+    numClasses = 0;
+    evaluationTime = 0;
+    inputScale.clear();
+    inputOffset.clear();
+    classLabels.clear();
+    rejectionThresholds.clear();
+    classBias.clear();
+    classCenters.clear();
+    classWeights.clear();
+    classCenterIndex.clear();
+    outputScale.clear();
+    outputOffset.clear();
+    compiledForest.clear();
+    gaussianEvaluator.clear();
+    svm.clear();
+    threadInputs.clear();
+    pipelines.clear();
+    inputVectors.clear();
+    threadScratch.clear();
+    predictedClassLabels.clear();
+    maximumLikelihoods.clear();
+    regressionData.clear();
+    width = 0;
+    height = 0;
+    return true;
+}
+
+std::string ofxGrtMapEvaluator::getModelTypeAsString() const {
+    switch( modelType ){
+        case MINDIST_MODEL: return "MinDist";
+        case ANBC_MODEL: return "ANBC";
+        case SOFTMAX_MODEL: return "Softmax";
+        case LINEAR_REGRESSION_MODEL: return "LinearRegression";
+        case LOGISTIC_REGRESSION_MODEL: return "LogisticRegression";
+        case FOREST_MODEL: return "RandomForests";
+        case GMM_MODEL: return "GMM";
+        case SVM_MODEL: return "SVM";
+        default: break;
+    }
+    return "Generic";
+}
+
+bool ofxGrtMapEvaluator::setupMinDist( const MinDist &minDist ){
+
+    const Vector< MinDistModel > models = minDist.getModels();
+    if( numClasses == 0 || models.size() != numClasses ) return false;
+
+    for(unsigned int k=0; k<numClasses; k++){
+        const MatrixFloat clusters = models[k].getClusters();
+        classLabels.push_back( models[k].getClassLabel() );
+        rejectionThresholds.push_back( (float)models[k].getRejectionThreshold() );
+        classCenterIndex.push_back( (unsigned int)(classCenters.size() / numInputDimensions) );
+        for(unsigned int c=0; c<clusters.getNumRows(); c++){
+            for(unsigned int d=0; d<numInputDimensions; d++){
+                classCenters.push_back( (float)clusters[c][d] );
+            }
+        }
+    }
+    classCenterIndex.push_back( (unsigned int)(classCenters.size() / numInputDimensions) );
+
+    modelType = MINDIST_MODEL;
+    return setInputScaling( minDist.getRanges(), minDist.getScalingEnabled() );
+}
+
+bool ofxGrtMapEvaluator::setupANBC( const ANBC &anbc ){
+
+    const Vector< ANBC_Model > models = anbc.getModels();
+    if( numClasses == 0 || models.size() != numClasses ) return false;
+
+    //log(gauss(x,mu,sigma)*w) = log(w) - log(sigma*sqrt(2PI)) - (x-mu)^2/(2*sigma^2), so fold the constant terms into one bias per class
+    const double sqrtTwoPI = sqrt( 2.0 * PI );
+    for(unsigned int k=0; k<numClasses; k++){
+        double bias = 0;
+        classLabels.push_back( models[k].classLabel );
+        rejectionThresholds.push_back( (float)models[k].threshold );
+        for(unsigned int d=0; d<numInputDimensions; d++){
+            const double sigma = models[k].sigma[d];
+            classCenters.push_back( (float)models[k].mu[d] );
+            if( sigma > 0 ){
+                bias += log( models[k].weights[d] ) - log( sigma * sqrtTwoPI );
+                classWeights.push_back( (float)(1.0 / (2.0 * sigma * sigma)) );
+            }else classWeights.push_back( 0 );
+        }
+        classBias.push_back( (float)bias );
+    }
+
+    modelType = ANBC_MODEL;
+    return setInputScaling( anbc.getRanges(), anbc.getScalingEnabled() );
+}
+
+bool ofxGrtMapEvaluator::setupSoftmax( const Softmax &softmax ){
+
+    //Softmax null rejection depends on internal thresholds that are not exposed, so leave it to the generic evaluator
+    if( useNullRejection ) return false;
+
+    const Vector< SoftmaxModel > models = softmax.getModels();
+    if( numClasses == 0 || models.size() != numClasses ) return false;
+
+    for(unsigned int k=0; k<numClasses; k++){
+        classLabels.push_back( models[k].classLabel );
+        classBias.push_back( (float)models[k].w0 );
+        for(unsigned int d=0; d<numInputDimensions; d++){
+            classWeights.push_back( (float)models[k].w[d] );
+        }
+    }
+
+    modelType = SOFTMAX_MODEL;
+    return setInputScaling( softmax.getRanges(), softmax.getScalingEnabled() );
+}
+
+bool ofxGrtMapEvaluator::setupRegression( const Regressifier &regressifier ){
+
+    //A single linear or logistic model, or a MultidimensionalRegression with one linear or logistic model per output
+    Vector< const Regressifier* > models;
+    const MultidimensionalRegression *mdr = dynamic_cast< const MultidimensionalRegression* >( &regressifier );
+    if( mdr ){
+        const Vector< Regressifier* > &regressifiers = ofxGrtModelAccess::getRegressifiers( *mdr );
+        for(size_t i=0; i<regressifiers.size(); i++) models.push_back( regressifiers[i] );
+    }else models.push_back( &regressifier );
+
+    if( models.size() == 0 ) return false;
+
+    numOutputDimensions = (unsigned int)models.size();
+    const bool logistic = dynamic_cast< const LogisticRegression* >( models[0] ) != NULL;
+
+    //The outer MultidimensionalRegression scales the inputs to [0 1] and the outputs back from [0 1]
+    const bool mdrScaling = mdr && mdr->getScalingEnabled();
+    const Vector< MinMax > mdrInputRanges = mdr ? mdr->getInputRanges() : Vector< MinMax >();
+    const Vector< MinMax > mdrOutputRanges = mdr ? mdr->getOutputRanges() : Vector< MinMax >();
+
+    for(unsigned int n=0; n<numOutputDimensions; n++){
+        Float w0 = 0;
+        VectorFloat w;
+        const LinearRegression *linear = dynamic_cast< const LinearRegression* >( models[n] );
+        const LogisticRegression *logisticModel = dynamic_cast< const LogisticRegression* >( models[n] );
+        if( linear && !logistic ) ofxGrtModelAccess::getWeights( *linear, w0, w );
+        else if( logisticModel && logistic ) ofxGrtModelAccess::getWeights( *logisticModel, w0, w );
+        else return false;
+
+        if( w.size() != numInputDimensions ) return false;
+
+        //Compose the outer and inner input scaling into one affine map per input, then fold it into the weights
+        const bool innerScaling = models[n]->getScalingEnabled();
+        const Vector< MinMax > innerInputRanges = models[n]->getInputRanges();
+        const Vector< MinMax > innerOutputRanges = models[n]->getOutputRanges();
+        double bias = w0;
+        for(unsigned int d=0; d<numInputDimensions; d++){
+            double s = 1, o = 0;
+            if( mdrScaling ){
+                const double range = mdrInputRanges[d].maxValue - mdrInputRanges[d].minValue;
+                s = range != 0 ? 1.0 / range : 0;
+                o = range != 0 ? -mdrInputRanges[d].minValue / range : 0;
+            }
+            if( innerScaling ){
+                const double range = innerInputRanges[d].maxValue - innerInputRanges[d].minValue;
+                const double innerS = range != 0 ? 1.0 / range : 0;
+                const double innerO = range != 0 ? -innerInputRanges[d].minValue / range : 0;
+                s = innerS * s;
+                o = innerS * o + innerO;
+            }
+            classWeights.push_back( (float)(w[d] * s) );
+            bias += w[d] * o;
+        }
+        classBias.push_back( (float)bias );
+
+        //Compose the inner and outer output scaling into y = a*f(x) + b
+        double a = 1, b = 0;
+        if( innerScaling ){
+            a = innerOutputRanges[0].maxValue - innerOutputRanges[0].minValue;
+            b = innerOutputRanges[0].minValue;
+        }
+        if( mdrScaling ){
+            const double range = mdrOutputRanges[n].maxValue - mdrOutputRanges[n].minValue;
+            a = a * range;
+            b = b * range + mdrOutputRanges[n].minValue;
+        }
+        outputScale.push_back( (float)a );
+        outputOffset.push_back( (float)b );
+    }
+
+    modelType = logistic ? LOGISTIC_REGRESSION_MODEL : LINEAR_REGRESSION_MODEL;
+
+    //The input scaling has already been folded into the weights
+    inputScale.assign( numInputDimensions, 1 );
+    inputOffset.assign( numInputDimensions, 0 );
+
+    return true;
+}
+
+bool ofxGrtMapEvaluator::setupForest( const RandomForests &forest ){
+
+    //Forests the compiled forest does not support (such as null rejection) fall back to the generic evaluator
+    if( !compiledForest.setup( forest ) ) return false;
+
+    modelType = FOREST_MODEL;
+    return true;
+}
+
+bool ofxGrtMapEvaluator::setupGMM( const GMM &gmm ){
+
+    //Mixtures that do not match the precomputed Gaussians fall back to the generic evaluator
+    if( !gaussianEvaluator.setup( gmm ) ) return false;
+
+    modelType = GMM_MODEL;
+    return true;
+}
+
+bool ofxGrtMapEvaluator::setupSVM( const ofxGrtSVM &svm ){
+
+    //The batch predict of the SVM is const, so one copy is shared by all the threads
+    this->svm = svm;
+
+    modelType = SVM_MODEL;
+    return true;
+}
+
+bool ofxGrtMapEvaluator::setupGeneric( const GestureRecognitionPipeline &pipeline ){
+
+    modelType = GENERIC_MODEL;
+    numClasses = isClassifier ? pipeline.getNumClasses() : 0;
+    numOutputDimensions = isRegressifier ? pipeline.getRegressifier()->getNumOutputDimensions() : 1;
+
+    //Each thread gets its own copy of the pipeline, as predict is not thread safe
+    pipelines.resize( pool.getNumThreads(), pipeline );
+    inputVectors.resize( pool.getNumThreads(), VectorFloat( numInputDimensions ) );
+
+    return true;
+}
+
+bool ofxGrtMapEvaluator::setInputScaling( const Vector< MinMax > &ranges, const bool useScaling ){
+
+    inputScale.assign( numInputDimensions, 1 );
+    inputOffset.assign( numInputDimensions, 0 );
+
+    if( !useScaling ) return true;
+
+    if( ranges.size() != numInputDimensions ) return false;
+
+    //The GRT scales each input to [0 1], x' = (x-min)/(max-min), and maps constant inputs to 0
+    for(unsigned int d=0; d<numInputDimensions; d++){
+        const double range = ranges[d].maxValue - ranges[d].minValue;
+        inputScale[d] = range != 0 ? (float)(1.0 / range) : 0;
+        inputOffset[d] = range != 0 ? (float)(-ranges[d].minValue / range) : 0;
+    }
+
+    return true;
+}
+
+void ofxGrtMapEvaluator::evaluateRow( const unsigned int row, const unsigned int threadIndex ){
+
+    if( modelType == GENERIC_MODEL ){
+        evaluateGeneric( row, threadIndex );
+        return;
+    }
+
+    if( modelType == FOREST_MODEL || modelType == GMM_MODEL || modelType == SVM_MODEL ){
+        evaluateBatch( row, threadIndex );
+        return;
+    }
+
+    //The input at pixel i of this row is rowStart + i*rowStep, in the model's scaled input space
+    float *rowStart = &threadScratch[ threadIndex ][0];
+    float *rowStep = rowStart + numInputDimensions;
+    float *laneInputs = rowStep + numInputDimensions;
+    float *scratch = laneInputs + numInputDimensions*WIDTH;
+    for(unsigned int d=0; d<numInputDimensions; d++){
+        rowStart[d] = inputScale[d] * (gridOrigin[d] + row*gridYStep[d]) + inputOffset[d];
+        rowStep[d] = inputScale[d] * gridXStep[d];
+    }
+
+    for(unsigned int i=0; i<width; i+=WIDTH){
+        for(unsigned int d=0; d<numInputDimensions; d++){
+            const float4 lane = set( (float)i, (float)(i+1), (float)(i+2), (float)(i+3) );
+            store( laneInputs + d*WIDTH, madd( lane, set1( rowStep[d] ), set1( rowStart[d] ) ) );
+        }
+        switch( modelType ){
+            case MINDIST_MODEL:
+                evaluateMinDist( row, i, laneInputs );
+                break;
+            case ANBC_MODEL:
+                evaluateANBC( row, i, laneInputs, scratch );
+                break;
+            case SOFTMAX_MODEL:
+                evaluateSoftmax( row, i, laneInputs, scratch );
+                break;
+            default:
+                evaluateRegression( row, i, laneInputs );
+                break;
+        }
+    }
+}
+
+void ofxGrtMapEvaluator::evaluateMinDist( const unsigned int row, const unsigned int i, float *laneInputs ){
+
+    //Find the distance to the closest cluster of each class, and keep track of the best class
+    float4 bestDistance = set1( grt_numeric_limits< float >::max() );
+    float4 bestIndex = set1( 0 );
+    float4 sum = set1( 0 );
+    for(unsigned int k=0; k<numClasses; k++){
+        float4 minDistance = set1( grt_numeric_limits< float >::max() );
+        for(unsigned int c=classCenterIndex[k]; c<classCenterIndex[k+1]; c++){
+            const float *center = &classCenters[ c*numInputDimensions ];
+            float4 distance = set1( 0 );
+            for(unsigned int d=0; d<numInputDimensions; d++){
+                const float4 delta = sub( load( laneInputs + d*WIDTH ), set1( center[d] ) );
+                distance = madd( delta, delta, distance );
+            }
+            minDistance = min( minDistance, distance );
+        }
+        const float4 better = lessThan( minDistance, bestDistance );
+        bestDistance = select( better, minDistance, bestDistance );
+        bestIndex = select( better, set1( (float)k ), bestIndex );
+        sum = add( sum, div( set1( 1 ), add( minDistance, set1( 0.0001f ) ) ) );
+    }
+
+    //The likelihood of each class is 1/(distance+0.0001), normalized over all the classes
+    float best[WIDTH], index[WIDTH], likelihood[WIDTH];
+    store( best, bestDistance );
+    store( index, bestIndex );
+    store( likelihood, div( div( set1( 1 ), add( bestDistance, set1( 0.0001f ) ) ), sum ) );
+
+    const size_t offset = (size_t)row*width + i;
+    for(unsigned int l=0; l<WIDTH && i+l<width; l++){
+        const unsigned int k = (unsigned int)index[l];
+        const bool accept = !useNullRejection || best[l] <= rejectionThresholds[k];
+        predictedClassLabels[ offset+l ] = accept ? classLabels[k] : GRT_DEFAULT_NULL_CLASS_LABEL;
+        maximumLikelihoods[ offset+l ] = likelihood[l];
+    }
+}
+
+void ofxGrtMapEvaluator::evaluateANBC( const unsigned int row, const unsigned int i, float *laneInputs, float *scratch ){
+
+    //Compute the log likelihood of each class, bias - sum( (x-mu)^2 / (2*sigma^2) )
+    float4 bestLogLikelihood = set1( -grt_numeric_limits< float >::max() );
+    float4 bestIndex = set1( 0 );
+    for(unsigned int k=0; k<numClasses; k++){
+        const float *mu = &classCenters[ k*numInputDimensions ];
+        const float *invVariance = &classWeights[ k*numInputDimensions ];
+        float4 distance = set1( 0 );
+        for(unsigned int d=0; d<numInputDimensions; d++){
+            const float4 delta = sub( load( laneInputs + d*WIDTH ), set1( mu[d] ) );
+            distance = madd( mul( delta, delta ), set1( invVariance[d] ), distance );
+        }
+        const float4 logLikelihood = sub( set1( classBias[k] ), distance );
+        store( scratch + k*WIDTH, logLikelihood );
+        const float4 better = greaterThan( logLikelihood, bestLogLikelihood );
+        bestLogLikelihood = select( better, logLikelihood, bestLogLikelihood );
+        bestIndex = select( better, set1( (float)k ), bestIndex );
+    }
+
+    float best[WIDTH], index[WIDTH];
+    store( best, bestLogLikelihood );
+    store( index, bestIndex );
+
+    //The likelihoods are exp(logLikelihood) normalized over the classes, which is 1/sum(exp(ll_k - ll_best)) for the best class
+    const size_t offset = (size_t)row*width + i;
+    for(unsigned int l=0; l<WIDTH && i+l<width; l++){
+        float sum = 0;
+        for(unsigned int k=0; k<numClasses; k++){
+            sum += exp( scratch[ k*WIDTH+l ] - best[l] );
+        }
+        const unsigned int k = (unsigned int)index[l];
+        const bool accept = !useNullRejection || best[l] >= rejectionThresholds[k];
+        predictedClassLabels[ offset+l ] = accept ? classLabels[k] : GRT_DEFAULT_NULL_CLASS_LABEL;
+        maximumLikelihoods[ offset+l ] = sum > 0 ? 1.0f / sum : 0;
+    }
+}
+
+void ofxGrtMapEvaluator::evaluateSoftmax( const unsigned int row, const unsigned int i, float *laneInputs, float *scratch ){
+
+    //Compute the linear term of each class, the sigmoid is applied per lane below
+    for(unsigned int k=0; k<numClasses; k++){
+        const float *w = &classWeights[ k*numInputDimensions ];
+        float4 y = set1( classBias[k] );
+        for(unsigned int d=0; d<numInputDimensions; d++){
+            y = madd( load( laneInputs + d*WIDTH ), set1( w[d] ), y );
+        }
+        store( scratch + k*WIDTH, y );
+    }
+
+    const size_t offset = (size_t)row*width + i;
+    for(unsigned int l=0; l<WIDTH && i+l<width; l++){
+        float sum = 0;
+        float best = 0;
+        unsigned int bestIndex = 0;
+        for(unsigned int k=0; k<numClasses; k++){
+            const float p = 1.0f / (1.0f + exp( -scratch[ k*WIDTH+l ] ));
+            sum += p;
+            if( p > best ){
+                best = p;
+                bestIndex = k;
+            }
+        }
+        predictedClassLabels[ offset+l ] = classLabels[ bestIndex ];
+        maximumLikelihoods[ offset+l ] = sum > 0 ? best / sum : 0;
+    }
+}
+
+void ofxGrtMapEvaluator::evaluateRegression( const unsigned int row, const unsigned int i, float *laneInputs ){
+
+    const bool logistic = modelType == LOGISTIC_REGRESSION_MODEL;
+    const size_t offset = ((size_t)row*width + i) * numOutputDimensions;
+    for(unsigned int n=0; n<numOutputDimensions; n++){
+        const float *w = &classWeights[ n*numInputDimensions ];
+        float4 y = set1( classBias[n] );
+        for(unsigned int d=0; d<numInputDimensions; d++){
+            y = madd( load( laneInputs + d*WIDTH ), set1( w[d] ), y );
+        }
+
+        float output[WIDTH];
+        store( output, y );
+        for(unsigned int l=0; l<WIDTH && i+l<width; l++){
+            const float f = logistic ? 1.0f / (1.0f + exp( -output[l] )) : output[l];
+            regressionData[ offset + l*numOutputDimensions + n ] = outputScale[n] * f + outputOffset[n];
+        }
+    }
+}
+
+void ofxGrtMapEvaluator::evaluateBatch( const unsigned int row, const unsigned int threadIndex ){
+
+    //The inputs of the whole row, followed by the maximum likelihood of each pixel
+    VectorFloat &inputs = threadInputs[ threadIndex ];
+    if( inputs.size() != (size_t)width*(numInputDimensions+1) ) inputs.resize( (size_t)width*(numInputDimensions+1) );
+    Float *likelihoods = &inputs[ (size_t)width*numInputDimensions ];
+
+    for(unsigned int i=0; i<width; i++){
+        for(unsigned int d=0; d<numInputDimensions; d++){
+            inputs[ (size_t)i*numInputDimensions + d ] = gridOrigin[d] + i*gridXStep[d] + row*gridYStep[d];
+        }
+    }
+
+    const size_t offset = (size_t)row*width;
+    bool success = false;
+    switch( modelType ){
+        case FOREST_MODEL:
+            success = compiledForest.predict( &inputs[0], width, &predictedClassLabels[ offset ], likelihoods );
+            break;
+        case GMM_MODEL:
+            success = gaussianEvaluator.predict( &inputs[0], width, &predictedClassLabels[ offset ], likelihoods );
+            break;
+        case SVM_MODEL:
+            success = svm.predict( &inputs[0], width, &predictedClassLabels[ offset ], likelihoods );
+            break;
+        default:
+            break;
+    }
+    if( !success ){
+        std::fill( predictedClassLabels.begin() + offset, predictedClassLabels.begin() + offset + width, GRT_DEFAULT_NULL_CLASS_LABEL );
+        std::fill( maximumLikelihoods.begin() + offset, maximumLikelihoods.begin() + offset + width, 0.0f );
+        return;
+    }
+
+    for(unsigned int i=0; i<width; i++){
+        maximumLikelihoods[ offset + i ] = (float)likelihoods[i];
+    }
+}
+
+void ofxGrtMapEvaluator::evaluateGeneric( const unsigned int row, const unsigned int threadIndex ){
+
+    GestureRecognitionPipeline &pipeline = pipelines[ threadIndex ];
+    VectorFloat &inputVector = inputVectors[ threadIndex ];
+
+    for(unsigned int i=0; i<width; i++){
+        for(unsigned int d=0; d<numInputDimensions; d++){
+            inputVector[d] = gridOrigin[d] + i*gridXStep[d] + row*gridYStep[d];
+        }
+
+        const size_t index = (size_t)row*width + i;
+        const bool success = pipeline.predict( inputVector );
+
+        if( isClassifier ){
+            predictedClassLabels[ index ] = success ? pipeline.getPredictedClassLabel() : GRT_DEFAULT_NULL_CLASS_LABEL;
+            maximumLikelihoods[ index ] = success ? (float)pipeline.getMaximumLikelihood() : 0;
+        }
+        if( isRegressifier ){
+            const VectorFloat output = pipeline.getRegressionData();
+            for(unsigned int n=0; n<numOutputDimensions; n++){
+                regressionData[ index*numOutputDimensions + n ] = success && n < output.size() ? (float)output[n] : 0;
+            }
+        }
+    }
+}
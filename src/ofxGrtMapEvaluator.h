@@ -0,0 +1,189 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+#include "ofxGrtThreadPool.h"
+#include "ofxGrtCompiledForest.h"
+#include "ofxGrtGaussianEvaluator.h"
+#include "ofxGrtSVM.h"
+
+using namespace GRT;
+
+/**
+ @brief evaluates a trained pipeline over a 2D grid of inputs, for example to draw the decision map of a classifier or the output of a
+ regression model across the app window. For models with cheap closed form decision functions (MinDist, ANBC, Softmax, and
+ LinearRegression or LogisticRegression inside a MultidimensionalRegression) the model parameters are extracted once in setup and a
+ whole row of pixels is evaluated at a time with SIMD kernels. RandomForests are compiled into an ofxGrtCompiledForest, and GMMs are
+ precomputed into an ofxGrtGaussianEvaluator, and these and ofxGrtSVMs predict each row as one batch. Any other pipeline is evaluated with pipeline.predict() on each pixel,
+ using one copy of the pipeline per thread. Rows are spread across a thread pool in both cases.
+*/
+class ofxGrtMapEvaluator {
+public:
+    enum ModelType{ GENERIC_MODEL=0, MINDIST_MODEL, ANBC_MODEL, SOFTMAX_MODEL, LINEAR_REGRESSION_MODEL, LOGISTIC_REGRESSION_MODEL, FOREST_MODEL, GMM_MODEL, SVM_MODEL };
+
+    /**
+     @brief creates the evaluator
+     @param numThreads: the number of threads used to evaluate the map, if zero then the number of hardware threads is used
+    */
+    ofxGrtMapEvaluator( const unsigned int numThreads = 0 );
+    ~ofxGrtMapEvaluator();
+
+    /**
+     @brief sets up the evaluator for a trained pipeline. If the pipeline only contains a supported classifier or regressifier (with no
+     pre processing, feature extraction or post processing modules) then the closed form evaluator is used, otherwise the pipeline is copied
+     for each thread and the generic evaluator is used. Call this again after the pipeline has been retrained.
+     @param pipeline: the trained pipeline to evaluate
+     @return returns true if the evaluator was setup successfully, false otherwise
+    */
+    bool setup( const GestureRecognitionPipeline &pipeline );
+
+    /**
+     @brief sets the size of the map, pixel (i,j) will be evaluated at the input [i/width j/height]. The pipeline must have 2 input dimensions.
+     @param width: the number of pixels in each row of the map
+     @param height: the number of rows in the map
+     @return returns true if the grid was set successfully, false otherwise
+    */
+    bool setGrid( const unsigned int width, const unsigned int height );
+
+    /**
+     @brief sets the size of the map and the plane it samples in the input space, pixel (i,j) will be evaluated at the input
+     origin + (i/width)*xAxis + (j/height)*yAxis. This lets you draw a 2D slice of a model with any number of input dimensions.
+     @param width: the number of pixels in each row of the map
+     @param height: the number of rows in the map
+     @param origin: the input at pixel (0,0)
+     @param xAxis: the change in the input across one row of the map
+     @param yAxis: the change in the input down one column of the map
+     @return returns true if the grid was set successfully, false otherwise
+    */
+    bool setGrid( const unsigned int width, const unsigned int height, const VectorFloat &origin, const VectorFloat &xAxis, const VectorFloat &yAxis );
+
+    /**
+     @brief evaluates the model at every pixel of the grid, the results can be accessed with getPredictedClassLabels, getMaximumLikelihoods or getRegressionData
+     @return returns true if the map was evaluated successfully, false otherwise
+    */
+    bool evaluate();
+
+    /**
+     @brief removes the model and results from the evaluator
+     @return returns true if the evaluator was cleared successfully, false otherwise
+    */
+    bool clear();
+
+    ModelType getModelType() const { return modelType; }
+    std::string getModelTypeAsString() const;
+    bool getIsClassifier() const { return isClassifier; }
+    bool getIsRegressifier() const { return isRegressifier; }
+    unsigned int getWidth() const { return width; }
+    unsigned int getHeight() const { return height; }
+    unsigned int getNumInputDimensions() const { return numInputDimensions; }
+    unsigned int getNumOutputDimensions() const { return numOutputDimensions; }
+    unsigned int getNumThreads() const { return pool.getNumThreads(); }
+
+    /**
+     @brief gets the time taken by the last call to evaluate
+     @return returns the evaluation time in milliseconds
+    */
+    double getEvaluationTime() const { return evaluationTime; }
+
+    /**
+     @brief gets the predicted class label of each pixel, stored row by row (pixel (i,j) is at index j*width+i)
+    */
+    const vector< UINT > &getPredictedClassLabels() const { return predictedClassLabels; }
+
+    /**
+     @brief gets the maximum likelihood of each pixel, stored row by row
+    */
+    const vector< float > &getMaximumLikelihoods() const { return maximumLikelihoods; }
+
+    /**
+     @brief gets the regression output of each pixel, stored row by row with getNumOutputDimensions() values per pixel
+    */
+    const vector< float > &getRegressionData() const { return regressionData; }
+
+protected:
+    bool setupMinDist( const MinDist &minDist );
+    bool setupANBC( const ANBC &anbc );
+    bool setupSoftmax( const Softmax &softmax );
+    bool setupRegression( const Regressifier &regressifier );
+    bool setupForest( const RandomForests &forest );
+    bool setupGMM( const GMM &gmm );
+    bool setupSVM( const ofxGrtSVM &svm );
+    bool setupGeneric( const GestureRecognitionPipeline &pipeline );
+    bool setInputScaling( const Vector< MinMax > &ranges, const bool useScaling );
+
+    void evaluateRow( const unsigned int row, const unsigned int threadIndex );
+    void evaluateMinDist( const unsigned int row, const unsigned int i, float *laneInputs );
+    void evaluateANBC( const unsigned int row, const unsigned int i, float *laneInputs, float *scratch );
+    void evaluateSoftmax( const unsigned int row, const unsigned int i, float *laneInputs, float *scratch );
+    void evaluateRegression( const unsigned int row, const unsigned int i, float *laneInputs );
+    void evaluateBatch( const unsigned int row, const unsigned int threadIndex );
+    void evaluateGeneric( const unsigned int row, const unsigned int threadIndex );
+
+    ModelType modelType;
+    bool isClassifier;
+    bool isRegressifier;
+    bool useNullRejection;
+    unsigned int numInputDimensions;
+    unsigned int numOutputDimensions;
+    unsigned int numClasses;
+    unsigned int width;
+    unsigned int height;
+    double evaluationTime;
+
+    //The input scaling of the model and the grid, in the unscaled input space
+    vector< float > inputScale;
+    vector< float > inputOffset;
+    vector< float > gridOrigin;
+    vector< float > gridXStep;
+    vector< float > gridYStep;
+
+    //The closed form model parameters
+    vector< UINT > classLabels;
+    vector< float > rejectionThresholds;
+    vector< float > classBias;              ///< ANBC log normalizer or Softmax bias for each class
+    vector< float > classCenters;           ///< MinDist cluster centers or ANBC means [numCenters x numInputDimensions]
+    vector< float > classWeights;           ///< ANBC inverse variances or Softmax/regression weights [numCenters x numInputDimensions]
+    vector< unsigned int > classCenterIndex;///< The first cluster of each MinDist class, with one extra entry at the end
+    vector< float > outputScale;
+    vector< float > outputOffset;
+
+    //The compiled random forest, precomputed GMM or SVM, with the inputs and likelihoods of one row per thread
+    ofxGrtCompiledForest compiledForest;
+    ofxGrtGaussianEvaluator gaussianEvaluator;
+    ofxGrtSVM svm;
+    vector< VectorFloat > threadInputs;
+
+    //The generic fallback
+    vector< GestureRecognitionPipeline > pipelines;
+    vector< VectorFloat > inputVectors;
+
+    //Per thread scratch memory and the results
+    vector< vector< float > > threadScratch;
+    vector< UINT > predictedClassLabels;
+    vector< float > maximumLikelihoods;
+    vector< float > regressionData;
+
+    ofxGrtThreadPool pool;
+    ErrorLog errorLog;
+    WarningLog warningLog;
+};
@@ -7,6 +7,12 @@ ofxGrtMatrixPlot::ofxGrtMatrixPlot(){
     plotTitle = "";
     font = NULL;
     rows = cols = 0;
+    textureRows = textureCols = 0;
+    shadowCopyEnabled = false;
+    shadowIsSparse = false;
+    shadowIsBanded = false;
+    shadowOffset = 0.0f;
+    shadowScale = 1.0f;
     textColor[0] = 255;
     textColor[1] = 0;
     textColor[2] = 0;
@@ -28,12 +34,21 @@ bool ofxGrtMatrixPlot::resize( const unsigned int rows, const unsigned int cols
     const unsigned int height = rows;
     pixels.setFromExternalPixels(data,width,height,OF_PIXELS_GRAY);
 
-    if(!texture.isAllocated()){
+    if(!texture.isAllocated() || textureRows != rows || textureCols != cols){
         texture.allocate( pixels, false );
         texture.setRGToRGBASwizzles(true);
     }
     texture.loadData( pixels );
     texture.setTextureMinMagFilter( GL_LINEAR, GL_LINEAR );
+    textureRows = rows;
+    textureCols = cols;
+    activeSpans.clear();
+
+    if( shadowCopyEnabled ){
+        shadowData.assign( size, 0.0f );
+        shadowIsSparse = false;
+        setShadowScale( 0.0f, 1.0f );
+    }
 
     return true;
 }
@@ -44,9 +59,8 @@ void ofxGrtMatrixPlot::update( const Matrix<double> &data ){
     const unsigned int cols = data.getNumCols();
     const size_t size = rows*cols;
 
-    if( this->rows != rows || this->cols != cols ){
-        this->rows = rows;
-        this->cols = cols;
+    //The rows and cols may have been set by a sparse or external update that does not use pixelData, so check the buffer itself
+    if( pixelData.size() != size ){
         pixelData.resize( size );
     }
     
@@ -67,9 +81,8 @@ void ofxGrtMatrixPlot::update( const Matrix<float> &data ){
     const unsigned int cols = data.getNumCols();
     const size_t size = rows*cols;
 
-    if( this->rows != rows || this->cols != cols ){
-        this->rows = rows;
-        this->cols = cols;
+    //The rows and cols may have been set by a sparse or external update that does not use pixelData, so check the buffer itself
+    if( pixelData.size() != size ){
         pixelData.resize( size );
     }
     
@@ -90,9 +103,8 @@ void ofxGrtMatrixPlot::update( const MatrixFloat &data, float minValue, float ma
     const unsigned int cols = data.getNumCols();
     const size_t size = rows*cols;
 
-    if( this->rows != rows || this->cols != cols ){
-        this->rows = rows;
-        this->cols = cols;
+    //The rows and cols may have been set by a sparse or external update that does not use pixelData, so check the buffer itself
+    if( pixelData.size() != size ){
         pixelData.resize( size );
     }
     
@@ -105,6 +117,9 @@ void ofxGrtMatrixPlot::update( const MatrixFloat &data, float minValue, float ma
     float *pixelPointer = &pixelData[0];
 
     update( pixelPointer, rows, cols );
+
+    //The shadow copy holds the scaled values, so store the scale to recover the original values
+    setShadowScale( minValue, maxValue );
 }
 
 void ofxGrtMatrixPlot::update( float *data, const unsigned int rows, const unsigned int cols ){
@@ -113,36 +128,232 @@ void ofxGrtMatrixPlot::update( float *data, const unsigned int rows, const unsig
     const unsigned int height = rows;
     pixels.setFromExternalPixels(data,width,height,OF_PIXELS_GRAY);
 
-    if(!texture.isAllocated()){
+    if(!texture.isAllocated() || textureRows != rows || textureCols != cols){
         texture.allocate( pixels, false );
         texture.setRGToRGBASwizzles(true);
     }
     texture.loadData( pixels );
     texture.setTextureMinMagFilter( GL_LINEAR, GL_LINEAR );
 
+    //The full texture has been overwritten, so there are no sparse spans left to clear
+    this->rows = textureRows = rows;
+    this->cols = textureCols = cols;
+    activeSpans.clear();
+
+    if( shadowCopyEnabled ){
+        shadowData.assign( data, data + size_t(rows)*cols );
+        shadowIsSparse = false;
+        setShadowScale( 0.0f, 1.0f );
+    }
+}
+
+bool ofxGrtMatrixPlot::update( const ofxGrtSparseMatrix &data ){
+
+    if( !allocateSparseTexture( data.getNumRows(), data.getNumCols() ) ) return false;
+
+    const vector< float > &values = data.getValues();
+    return uploadSpans( data.getSpans(), values.size() > 0 ? &values[0] : NULL, values.size() );
+}
+
+bool ofxGrtMatrixPlot::update( const ofxGrtSparseMatrix &data, float minValue, float maxValue ){
+
+    if( !allocateSparseTexture( data.getNumRows(), data.getNumCols() ) ) return false;
+
+    const vector< float > &values = data.getValues();
+    const size_t size = values.size();
+    spanData.resize( size );
+    for(size_t i=0; i<size; i++){
+        spanData[i] = Util::scale(values[i],minValue,maxValue,0.0,1.0);
+    }
+
+    if( !uploadSpans( data.getSpans(), size > 0 ? &spanData[0] : NULL, size ) ) return false;
+
+    setShadowScale( minValue, maxValue );
+
+    return true;
+}
+
+bool ofxGrtMatrixPlot::allocateSparseTexture( const unsigned int rows, const unsigned int cols ){
+
+    if( rows == 0 || cols == 0 ) return false;
+
+    if( texture.isAllocated() && textureRows == rows && textureCols == cols ) return true;
+
+    texture.allocate( cols, rows, GL_R32F, false );
+    texture.setRGToRGBASwizzles(true);
+    texture.setTextureMinMagFilter( GL_LINEAR, GL_LINEAR );
+
+    //Clear the new texture once, one row at a time so we never need a dense buffer
+    vector< float > zeros( cols, 0.0f );
+    const ofTextureData &texData = texture.getTextureData();
+    glBindTexture( texData.textureTarget, texData.textureID );
+    for(unsigned int i=0; i<rows; i++){
+        glTexSubImage2D( texData.textureTarget, 0, 0, i, cols, 1, GL_RED, GL_FLOAT, &zeros[0] );
+    }
+    glBindTexture( texData.textureTarget, 0 );
+
+    this->rows = textureRows = rows;
+    this->cols = textureCols = cols;
+    activeSpans.clear();
+
+    return true;
+}
+
+bool ofxGrtMatrixPlot::uploadSpans( const vector< ofxGrtSparseMatrix::Span > &spans, const float *data, const size_t numValues ){
+
+    const ofTextureData &texData = texture.getTextureData();
+    glBindTexture( texData.textureTarget, texData.textureID );
+
+    //If the spans match the last update (e.g. a fixed band) then the new values overwrite the old ones, otherwise zero the old spans first
+    bool sameLayout = spans.size() == activeSpans.size();
+    for(size_t k=0; k<spans.size() && sameLayout; k++){
+        sameLayout = spans[k].row == activeSpans[k].row && spans[k].col == activeSpans[k].col && spans[k].length == activeSpans[k].length;
+    }
+
+    if( !sameLayout ){
+        unsigned int maxLength = 0;
+        for(size_t k=0; k<activeSpans.size(); k++){
+            maxLength = std::max( maxLength, activeSpans[k].length );
+        }
+        if( zeroData.size() < maxLength ) zeroData.resize( maxLength, 0.0f );
+        for(size_t k=0; k<activeSpans.size(); k++){
+            const ofxGrtSparseMatrix::Span &span = activeSpans[k];
+            glTexSubImage2D( texData.textureTarget, 0, span.col, span.row, span.length, 1, GL_RED, GL_FLOAT, &zeroData[0] );
+        }
+    }
+
+    for(size_t k=0; k<spans.size(); k++){
+        const ofxGrtSparseMatrix::Span &span = spans[k];
+        glTexSubImage2D( texData.textureTarget, 0, span.col, span.row, span.length, 1, GL_RED, GL_FLOAT, data + span.offset );
+    }
+
+    glBindTexture( texData.textureTarget, 0 );
+
+    activeSpans = spans;
+
+    if( shadowCopyEnabled ){
+        //Keep the uploaded values and index the first span of each row, the spans are stored in row order
+        shadowData.assign( data, data + numValues );
+        shadowRowIndex.assign( rows+1, 0 );
+        shadowIsBanded = true;
+        for(size_t k=0; k<spans.size(); k++){
+            shadowRowIndex[ spans[k].row+1 ]++;
+            if( shadowRowIndex[ spans[k].row+1 ] > 1 ) shadowIsBanded = false;
+        }
+        for(unsigned int i=0; i<rows; i++){
+            shadowRowIndex[i+1] += shadowRowIndex[i];
+        }
+        shadowIsSparse = true;
+        setShadowScale( 0.0f, 1.0f );
+    }
+
+    return true;
+}
+
+bool ofxGrtMatrixPlot::setShadowCopyEnabled( const bool enableShadowCopy ){
+
+    shadowCopyEnabled = enableShadowCopy;
+
+    //The copy will be filled on the next update, free any old copy
+    shadowData.clear();
+    shadowRowIndex.clear();
+    shadowIsSparse = false;
+    shadowIsBanded = false;
+    setShadowScale( 0.0f, 1.0f );
+
+    return true;
+}
+
+void ofxGrtMatrixPlot::setShadowScale( const float minValue, const float maxValue ){
+    shadowOffset = minValue;
+    shadowScale = maxValue - minValue;
+}
+
+bool ofxGrtMatrixPlot::getValue( const unsigned int row, const unsigned int col, float &value ) const{
+
+    if( !shadowCopyEnabled || row >= rows || col >= cols ) return false;
+
+    if( !shadowIsSparse ){
+        if( shadowData.size() != size_t(rows)*cols ) return false;
+        value = shadowData[ size_t(row)*cols + col ] * shadowScale + shadowOffset;
+        return true;
+    }
+
+    if( shadowRowIndex.size() != rows+1 ) return false;
+
+    //Cells outside of the uploaded spans are empty
+    value = 0.0f;
+
+    const unsigned int first = shadowRowIndex[row];
+    const unsigned int last = shadowRowIndex[row+1];
+    if( first == last ) return true;
+
+    //Find the last span in the row that starts at or before the column
+    unsigned int index = first;
+    if( !shadowIsBanded ){
+        auto iter = std::upper_bound( activeSpans.begin() + first, activeSpans.begin() + last, col, []( const unsigned int c, const ofxGrtSparseMatrix::Span &span ){
+            return c < span.col;
+        } );
+        if( iter == activeSpans.begin() + first ) return true;
+        index = (unsigned int)(iter - activeSpans.begin()) - 1;
+    }
+
+    const ofxGrtSparseMatrix::Span &span = activeSpans[index];
+    if( col >= span.col && col < span.col + span.length ){
+        value = shadowData[ span.offset + col - span.col ] * shadowScale + shadowOffset;
+    }
+
+    return true;
+}
+
+ofRectangle ofxGrtMatrixPlot::getDrawRectangle( const float x, const float y, const float w, const float h ) const{
+
+    if( !texture.isAllocated() ) return ofRectangle( x, y, w, h );
+
+    auto & tex = texture;
+    auto ratio = w/h;
+    auto texRatio = tex.getWidth()/tex.getHeight();
+    if(ratio > texRatio){
+        auto drawW = h*texRatio;
+        auto drawX = x+(w-drawW)/2;
+        return ofRectangle( drawX, y, drawW, h );
+    }
+    auto drawH = w/texRatio;
+    auto drawY = y+(h-drawH)/2;
+    return ofRectangle( x, drawY, w, drawH );
+}
+
+bool ofxGrtMatrixPlot::getCellAt( const float px, const float py, const float x, const float y, const float w, const float h, unsigned int &row, unsigned int &col ) const{
+
+    if( !texture.isAllocated() || rows == 0 || cols == 0 ) return false;
+
+    const ofRectangle rect = getDrawRectangle( x, y, w, h );
+    if( px < rect.x || py < rect.y || px >= rect.x + rect.width || py >= rect.y + rect.height ) return false;
+
+    col = std::min( cols-1, (unsigned int)( (px - rect.x) / rect.width * cols ) );
+    row = std::min( rows-1, (unsigned int)( (py - rect.y) / rect.height * rows ) );
+
+    return true;
+}
+
+bool ofxGrtMatrixPlot::getValueAt( const float px, const float py, const float x, const float y, const float w, const float h, float &value ) const{
+    unsigned int row = 0;
+    unsigned int col = 0;
+    if( !getCellAt( px, py, x, y, w, h, row, col ) ) return false;
+    return getValue( row, col, value );
 }
 
 bool ofxGrtMatrixPlot::draw(float x, float y) const{
-    if( pixels.size() == 0 ) return false;
+    if( !texture.isAllocated() ) return false;
     return draw(x, y, texture.getWidth(), texture.getHeight());
 }
 
 bool ofxGrtMatrixPlot::draw(float x, float y, float w, float h) const{
 
-    if( pixels.size() == 0 ) return false;
-
-	auto & tex = texture;
-	auto ratio = w/h;
-	auto texRatio = tex.getWidth()/tex.getHeight();
-	if(ratio > texRatio){
-		auto drawW = h*texRatio;
-		auto drawX = x+(w-drawW)/2;
-		tex.draw(drawX,y,drawW,h);
-	}else{
-		auto drawH = w/texRatio;
-		auto drawY = y+(h-drawH)/2;
-		tex.draw(x,drawY,w,drawH);
-	}
+    if( !texture.isAllocated() ) return false;
+
+	const ofRectangle rect = getDrawRectangle( x, y, w, h );
+	texture.draw( rect.x, rect.y, rect.width, rect.height );
 
     //Only draw the text if the font has been loaded
     if( font && plotTitle != "" ){
@@ -164,20 +375,10 @@ bool ofxGrtMatrixPlot::draw(float x, float y, float w, float h) const{
 
 bool ofxGrtMatrixPlot::draw(float x, float y, float w, float h,ofShader &shader) const{
 
-    if( pixels.size() == 0 ) return false;
-    auto & tex = texture;
-    auto ratio = w/h;
-    auto texRatio = tex.getWidth()/tex.getHeight();
+    if( !texture.isAllocated() ) return false;
+    const ofRectangle rect = getDrawRectangle( x, y, w, h );
     shader.begin();
-    if(ratio > texRatio){
-        auto drawW = h*texRatio;
-        auto drawX = x+(w-drawW)/2;
-        tex.draw(drawX,y,drawW,h);
-    }else{
-        auto drawH = w/texRatio;
-        auto drawY = y+(h-drawH)/2;
-        tex.draw(x,drawY,w,drawH);
-    }
+    texture.draw( rect.x, rect.y, rect.width, rect.height );
     shader.end();
 
     //Only draw the text if the font has been loaded
@@ -22,6 +22,7 @@
 #include <GRT/GRT.h>
 
 #include "ofMain.h"
+#include "ofxGrtSparseMatrix.h"
 
 using namespace GRT;
 
@@ -33,17 +34,83 @@ public:
     void update( const Matrix<float> &data );
     void update( const MatrixFloat &data, float minValue, float maxValue );
     void update( float *data, const unsigned int rows, const unsigned int cols );
+
+    /**
+     @brief updates the plot from a sparse matrix. The plot keeps a texture that is cleared once when the size of the matrix changes,
+     after that only the non-zero spans of the matrix are uploaded (along with zeros for any spans from the previous update that are no longer set).
+     A dense copy of the matrix is never created, so memory and upload cost are proportional to the number of non-zero values.
+     @param data: the sparse matrix to plot
+     @return returns true if the plot was updated successfully, false otherwise
+    */
+    bool update( const ofxGrtSparseMatrix &data );
+
+    /**
+     @brief updates the plot from a sparse matrix, scaling the non-zero values from [minValue maxValue] to [0 1]
+     @param data: the sparse matrix to plot
+     @param minValue: the value that will be mapped to 0
+     @param maxValue: the value that will be mapped to 1
+     @return returns true if the plot was updated successfully, false otherwise
+    */
+    bool update( const ofxGrtSparseMatrix &data, float minValue, float maxValue );
+
     bool draw(float x, float y) const;
     bool draw(float x, float y, float w, float h) const;
     bool draw(float x, float y, float w, float h,ofShader &shader) const;
     bool setFont( const ofTrueTypeFont &font ){ this->font = &font; return this->font->isLoaded(); }
     bool setTitle( const std::string &plotTitle ){ this->plotTitle = plotTitle; return true; }
 
+    /**
+     @brief controls if the plot keeps a CPU copy of the last data it uploaded, this lets you read values back from the plot (for example
+     to show the value under the mouse) without keeping your own copy of the matrix or reading back from the texture.
+     The copy is kept in the same format that was uploaded: dense updates keep a dense copy, sparse updates only keep the non-zero spans.
+     @param enableShadowCopy: if true, then the plot will keep a copy of the data from the next update
+     @return returns true if the parameter was update successfully, false otherwise
+    */
+    bool setShadowCopyEnabled( const bool enableShadowCopy );
+
+    /**
+     @brief gets the value of a cell from the CPU copy of the plot data. Lookups are O(1) for dense updates and banded sparse updates,
+     for other sparse updates the lookup is a binary search over the spans in the row. Cells that were not set by a sparse update return 0.
+     @param row: the row of the cell
+     @param col: the column of the cell
+     @param value: will be set to the value of the cell
+     @return returns true if the value was found, false if the shadow copy is disabled or the cell is out of range
+    */
+    bool getValue( const unsigned int row, const unsigned int col, float &value ) const;
+
+    /**
+     @brief finds the cell under a point (such as the mouse position), using the same letterboxing as draw(x,y,w,h)
+     @param px: the x position of the point
+     @param py: the y position of the point
+     @param x, y, w, h: the area the plot is drawn in, this should match the values passed to draw
+     @param row: will be set to the row of the cell under the point
+     @param col: will be set to the column of the cell under the point
+     @return returns true if the point is inside the drawn matrix, false otherwise
+    */
+    bool getCellAt( const float px, const float py, const float x, const float y, const float w, const float h, unsigned int &row, unsigned int &col ) const;
+
+    /**
+     @brief gets the value of the cell under a point (such as the mouse position), this combines getCellAt and getValue
+     @return returns true if the point is inside the drawn matrix and the value was found, false otherwise
+    */
+    bool getValueAt( const float px, const float py, const float x, const float y, const float w, const float h, float &value ) const;
+
+    /**
+     @brief gets the area that the matrix will be drawn in if the plot is drawn at x, y, w, h. The matrix keeps its aspect ratio and is centered in the area.
+     @return returns the area the matrix is drawn in
+    */
+    ofRectangle getDrawRectangle( const float x, const float y, const float w, const float h ) const;
+
+    bool getShadowCopyEnabled() const { return shadowCopyEnabled; }
     unsigned int getRows() const;
     unsigned int getCols() const;
     unsigned int getWidth() const;
     unsigned int getHeight() const;
 protected:
+    bool allocateSparseTexture( const unsigned int rows, const unsigned int cols );
+    bool uploadSpans( const vector< ofxGrtSparseMatrix::Span > &spans, const float *data, const size_t numValues );
+    void setShadowScale( const float minValue, const float maxValue );
+
     unsigned int rows;
     unsigned int cols;
 
@@ -52,6 +119,19 @@ protected:
     vector<float> pixelData;
     ofFloatPixels pixels;
     ofTexture texture;
+    unsigned int textureRows;
+    unsigned int textureCols;
+    vector< ofxGrtSparseMatrix::Span > activeSpans;
+    vector< float > spanData;
+    vector< float > zeroData;
+
+    bool shadowCopyEnabled;
+    bool shadowIsSparse;
+    bool shadowIsBanded;
+    float shadowOffset;
+    float shadowScale;
+    vector< float > shadowData;
+    vector< unsigned int > shadowRowIndex;
     const ofTrueTypeFont *font;
 };
 
@@ -0,0 +1,120 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+using namespace GRT;
+
+/**
+ @file
+ @brief read-only access to trained GRT model parameters that the GRT does not expose through public getters.
+ Each accessor derives from the GRT class only to name the protected member, the models themselves are never modified.
+*/
+class ofxGrtModelAccess {
+public:
+
+    /**
+     @brief gets the bias and weights of a trained LinearRegression model
+    */
+    static void getWeights( const LinearRegression &model, Float &w0, VectorFloat &w ){
+        w0 = model.*LinearRegressionAccess::bias();
+        w = model.*LinearRegressionAccess::weights();
+    }
+
+    /**
+     @brief gets the bias and weights of a trained LogisticRegression model
+    */
+    static void getWeights( const LogisticRegression &model, Float &w0, VectorFloat &w ){
+        w0 = model.*LogisticRegressionAccess::bias();
+        w = model.*LogisticRegressionAccess::weights();
+    }
+
+    /**
+     @brief gets the trained regressifiers of a MultidimensionalRegression model, there is one regressifier per output dimension
+    */
+    static const Vector< Regressifier* > &getRegressifiers( const MultidimensionalRegression &model ){
+        return model.*MultidimensionalRegressionAccess::trainedRegressifiers();
+    }
+
+    /**
+     @brief gets the mixture model of each class of a trained GMM model
+    */
+    static const Vector< MixtureModel > &getMixtureModels( const GMM &model ){
+        return model.*GMMAccess::mixtures();
+    }
+
+    /**
+     @brief gets the number of Gaussians in each mixture model of a GMM model
+    */
+    static UINT getNumMixtureModels( const GMM &model ){
+        return model.*GMMAccess::numGaussians();
+    }
+
+    /**
+     @brief gets the class likelihoods computed by the last prediction of a classifier, without copying them
+    */
+    static const VectorFloat &getClassLikelihoods( const Classifier &model ){
+        return model.*ClassifierAccess::likelihoods();
+    }
+
+    /**
+     @brief gets the class distances computed by the last prediction of a classifier, without copying them
+    */
+    static const VectorFloat &getClassDistances( const Classifier &model ){
+        return model.*ClassifierAccess::distances();
+    }
+
+    /**
+     @brief gets the output computed by the last prediction of a regressifier, without copying it
+    */
+    static const VectorFloat &getRegressionData( const Regressifier &model ){
+        return model.*RegressifierAccess::outputs();
+    }
+
+protected:
+    struct ClassifierAccess : public Classifier{
+        static VectorFloat Classifier::* likelihoods(){ return &ClassifierAccess::classLikelihoods; }
+        static VectorFloat Classifier::* distances(){ return &ClassifierAccess::classDistances; }
+    };
+
+    struct RegressifierAccess : public Regressifier{
+        static VectorFloat Regressifier::* outputs(){ return &RegressifierAccess::regressionData; }
+    };
+
+    struct LinearRegressionAccess : public LinearRegression{
+        static Float LinearRegression::* bias(){ return &LinearRegressionAccess::w0; }
+        static VectorFloat LinearRegression::* weights(){ return &LinearRegressionAccess::w; }
+    };
+
+    struct LogisticRegressionAccess : public LogisticRegression{
+        static Float LogisticRegression::* bias(){ return &LogisticRegressionAccess::w0; }
+        static VectorFloat LogisticRegression::* weights(){ return &LogisticRegressionAccess::w; }
+    };
+
+    struct GMMAccess : public GMM{
+        static Vector< MixtureModel > GMM::* mixtures(){ return &GMMAccess::models; }
+        static UINT GMM::* numGaussians(){ return &GMMAccess::numMixtureModels; }
+    };
+
+    struct MultidimensionalRegressionAccess : public MultidimensionalRegression{
+        static Vector< Regressifier* > MultidimensionalRegression::* trainedRegressifiers(){ return &MultidimensionalRegressionAccess::regressifiers; }
+    };
+};
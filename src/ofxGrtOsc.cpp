@@ -0,0 +1,337 @@
+
+#include "ofxGrtOsc.h"
+#include <chrono>
+#include <cstring>
+
+using namespace GRT;
+
+//The NTP epoch (1900) is 70 years before the unix epoch
+static const uint64_t NTP_UNIX_OFFSET = 2208988800ULL;
+
+//Bundles can be nested, but not without limit
+static const UINT MAX_BUNDLE_DEPTH = 16;
+
+ofxGrtOscWriter::ofxGrtOscWriter(){
+    errorLog.setProceedingText("[ERROR ofxGrtOscWriter]");
+    clear();
+}
+
+ofxGrtOscWriter::~ofxGrtOscWriter(){
+}
+
+bool ofxGrtOscWriter::beginBundle( const uint64_t timetag ){
+
+    if( inMessage ){
+        errorLog << "beginBundle(const uint64_t timetag) - A message is being written, end it first!" << endl;
+        return false;
+    }
+
+    if( !beginElement() ) return false;
+
+    //The size of a nested bundle is written in front of it once it is ended
+    bundleStarts.push_back( bundleStarts.size() > 0 ? data.size() - 4 : (size_t)-1 );
+    writeString( data, "#bundle" );
+    writeInt32( (uint32_t)(timetag >> 32) );
+    writeInt32( (uint32_t)(timetag & 0xFFFFFFFF) );
+
+    return true;
+}
+
+bool ofxGrtOscWriter::endBundle(){
+
+    if( inMessage || bundleStarts.size() == 0 ){
+        errorLog << "endBundle() - There is no open bundle!" << endl;
+        return false;
+    }
+
+    const size_t start = bundleStarts.back();
+    bundleStarts.pop_back();
+    if( start != (size_t)-1 ) endElement( start );
+
+    return true;
+}
+
+bool ofxGrtOscWriter::beginMessage( const std::string &address ){
+
+    if( inMessage ){
+        errorLog << "beginMessage(const std::string &address) - A message is already being written, end it first!" << endl;
+        return false;
+    }
+
+    if( address.size() == 0 || address[0] != '/' ){
+        errorLog << "beginMessage(const std::string &address) - The address must start with '/': " << address << endl;
+        return false;
+    }
+
+    if( !beginElement() ) return false;
+
+    messageStart = bundleStarts.size() > 0 ? data.size() - 4 : (size_t)-1;
+    writeString( data, address );
+    typeTags = ",";
+    arguments.clear();
+    inMessage = true;
+
+    return true;
+}
+
+bool ofxGrtOscWriter::addInt( const int32_t value ){
+    if( !inMessage ){
+        errorLog << "addInt(const int32_t value) - There is no open message!" << endl;
+        return false;
+    }
+    const uint32_t v = (uint32_t)value;
+    const uint8_t bytes[4] = { (uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v };
+    arguments.insert( arguments.end(), bytes, bytes+4 );
+    typeTags += 'i';
+    return true;
+}
+
+bool ofxGrtOscWriter::addFloat( const float value ){
+    if( !inMessage ){
+        errorLog << "addFloat(const float value) - There is no open message!" << endl;
+        return false;
+    }
+    uint32_t v;
+    memcpy( &v, &value, 4 );
+    const uint8_t bytes[4] = { (uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v };
+    arguments.insert( arguments.end(), bytes, bytes+4 );
+    typeTags += 'f';
+    return true;
+}
+
+bool ofxGrtOscWriter::addFloats( const VectorFloat &values ){
+    for(size_t i=0; i<values.size(); i++){
+        if( !addFloat( (float)values[i] ) ) return false;
+    }
+    return true;
+}
+
+bool ofxGrtOscWriter::addString( const std::string &value ){
+    if( !inMessage ){
+        errorLog << "addString(const std::string &value) - There is no open message!" << endl;
+        return false;
+    }
+    writeString( arguments, value );
+    typeTags += 's';
+    return true;
+}
+
+bool ofxGrtOscWriter::endMessage(){
+
+    if( !inMessage ){
+        errorLog << "endMessage() - There is no open message!" << endl;
+        return false;
+    }
+
+    writeString( data, typeTags );
+    data.insert( data.end(), arguments.begin(), arguments.end() );
+    if( messageStart != (size_t)-1 ) endElement( messageStart );
+    inMessage = false;
+
+    return true;
+}
+
+void ofxGrtOscWriter::clear(){
+    data.clear();
+    bundleStarts.clear();
+    messageStart = (size_t)-1;
+    inMessage = false;
+    typeTags.clear();
+    arguments.clear();
+}
+
+uint64_t ofxGrtOscWriter::getTimetag( const double delay ){
+    const double seconds = std::chrono::duration< double >( std::chrono::system_clock::now().time_since_epoch() ).count() + delay;
+    const double whole = floor( seconds );
+    const uint64_t ntpSeconds = (uint64_t)whole + NTP_UNIX_OFFSET;
+    const uint64_t fraction = (uint64_t)( (seconds - whole) * 4294967296.0 );
+    return (ntpSeconds << 32) | (fraction & 0xFFFFFFFF);
+}
+
+void ofxGrtOscWriter::writeInt32( const uint32_t value ){
+    const uint8_t bytes[4] = { (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value };
+    data.insert( data.end(), bytes, bytes+4 );
+}
+
+void ofxGrtOscWriter::writeString( vector< uint8_t > &buffer, const std::string &value ){
+    //OSC strings are null terminated and padded with nulls to a multiple of 4 bytes
+    buffer.insert( buffer.end(), value.begin(), value.end() );
+    const size_t padding = 4 - value.size() % 4;
+    buffer.insert( buffer.end(), padding, 0 );
+}
+
+bool ofxGrtOscWriter::beginElement(){
+
+    //A packet is one message or one bundle
+    if( bundleStarts.size() == 0 && data.size() > 0 ){
+        errorLog << "beginElement() - The packet is already complete, call clear() to start a new one!" << endl;
+        return false;
+    }
+
+    if( bundleStarts.size() >= MAX_BUNDLE_DEPTH ){
+        errorLog << "beginElement() - Bundles can only be nested " << MAX_BUNDLE_DEPTH << " deep!" << endl;
+        return false;
+    }
+
+    //Each element of a bundle starts with its size, which is filled in when it is ended
+    if( bundleStarts.size() > 0 ) writeInt32( 0 );
+
+    return true;
+}
+
+void ofxGrtOscWriter::endElement( const size_t start ){
+    const uint32_t size = (uint32_t)(data.size() - start - 4);
+    data[ start ] = (uint8_t)(size >> 24);
+    data[ start+1 ] = (uint8_t)(size >> 16);
+    data[ start+2 ] = (uint8_t)(size >> 8);
+    data[ start+3 ] = (uint8_t)size;
+}
+
+ofxGrtOscReader::ofxGrtOscReader(){
+    errorLog.setProceedingText("[ERROR ofxGrtOscReader]");
+}
+
+ofxGrtOscReader::~ofxGrtOscReader(){
+}
+
+bool ofxGrtOscReader::parse( const void *packet, const size_t size, vector< Message > &messages ){
+
+    if( packet == NULL || size == 0 || size % 4 != 0 ){
+        errorLog << "parse(...) - The size of an OSC packet must be a multiple of 4 bytes!" << endl;
+        return false;
+    }
+
+    return parseElement( (const uint8_t*)packet, size, ofxGrtOscWriter::IMMEDIATE, messages, 0 );
+}
+
+bool ofxGrtOscReader::parseElement( const uint8_t *packet, const size_t size, const uint64_t timetag, vector< Message > &messages, const UINT depth ){
+
+    if( size >= 16 && memcmp( packet, "#bundle\0", 8 ) == 0 ){
+        if( depth >= MAX_BUNDLE_DEPTH ){
+            errorLog << "parseElement(...) - The bundles are nested too deep!" << endl;
+            return false;
+        }
+
+        size_t position = 8;
+        uint32_t high = 0, low = 0;
+        readUInt32( packet, size, position, high );
+        readUInt32( packet, size, position, low );
+        const uint64_t bundleTimetag = ((uint64_t)high << 32) | low;
+
+        while( position < size ){
+            uint32_t elementSize = 0;
+            if( !readUInt32( packet, size, position, elementSize ) || elementSize % 4 != 0 || elementSize > size - position ){
+                errorLog << "parseElement(...) - The size of a bundle element is invalid!" << endl;
+                return false;
+            }
+            if( !parseElement( packet + position, elementSize, bundleTimetag, messages, depth+1 ) ) return false;
+            position += elementSize;
+        }
+        return true;
+    }
+
+    Message message;
+    if( !parseMessage( packet, size, timetag, message ) ) return false;
+    messages.push_back( message );
+
+    return true;
+}
+
+bool ofxGrtOscReader::parseMessage( const uint8_t *packet, const size_t size, const uint64_t timetag, Message &message ){
+
+    size_t position = 0;
+    std::string typeTags;
+    if( !readString( packet, size, position, message.address ) || message.address.size() == 0 || message.address[0] != '/' ){
+        errorLog << "parseMessage(...) - The message does not start with an address!" << endl;
+        return false;
+    }
+
+    //Very old OSC senders may leave out the type tags, such messages have no arguments we can read
+    if( position < size && !readString( packet, size, position, typeTags ) ){
+        errorLog << "parseMessage(...) - The type tags of " << message.address << " are invalid!" << endl;
+        return false;
+    }
+    if( typeTags.size() > 0 && typeTags[0] == ',' ) typeTags.erase( 0, 1 );
+
+    message.timetag = timetag;
+    message.types.clear();
+    message.numbers.clear();
+    message.strings.clear();
+
+    for(size_t i=0; i<typeTags.size(); i++){
+        const char type = typeTags[i];
+        double number = 0;
+        std::string text;
+        uint32_t a = 0, b = 0;
+        bool ok = true;
+        switch( type ){
+            case 'i':
+                ok = readUInt32( packet, size, position, a );
+                number = (int32_t)a;
+                break;
+            case 'f':{
+                ok = readUInt32( packet, size, position, a );
+                float f;
+                memcpy( &f, &a, 4 );
+                number = f;
+                }
+                break;
+            case 'h':
+                ok = readUInt32( packet, size, position, a ) && readUInt32( packet, size, position, b );
+                number = (double)(int64_t)( ((uint64_t)a << 32) | b );
+                break;
+            case 'd':{
+                ok = readUInt32( packet, size, position, a ) && readUInt32( packet, size, position, b );
+                const uint64_t bits = ((uint64_t)a << 32) | b;
+                memcpy( &number, &bits, 8 );
+                }
+                break;
+            case 's':
+            case 'S':
+                ok = readString( packet, size, position, text );
+                break;
+            case 'b':
+                //Blobs are skipped, their size is rounded up to a multiple of 4 bytes
+                ok = readUInt32( packet, size, position, a ) && a <= size - position;
+                if( ok ) position += (a + 3) / 4 * 4;
+                ok = ok && position <= size;
+                break;
+            case 'T':
+                number = 1;
+                break;
+            case 'F':
+            case 'N':
+            case 'I':
+                break;
+            default:
+                errorLog << "parseMessage(...) - Unsupported argument type '" << type << "' in " << message.address << endl;
+                return false;
+        }
+        if( !ok ){
+            errorLog << "parseMessage(...) - The arguments of " << message.address << " are truncated!" << endl;
+            return false;
+        }
+        message.types += type;
+        message.numbers.push_back( number );
+        message.strings.push_back( text );
+    }
+
+    return true;
+}
+
+bool ofxGrtOscReader::readString( const uint8_t *packet, const size_t size, size_t &position, std::string &value ){
+    const uint8_t *end = (const uint8_t*)memchr( packet + position, 0, size - position );
+    if( end == NULL ) return false;
+    const size_t length = end - (packet + position);
+    value.assign( (const char*)packet + position, length );
+    position += (length / 4 + 1) * 4;
+    return position <= size;
+}
+
+bool ofxGrtOscReader::readUInt32( const uint8_t *packet, const size_t size, size_t &position, uint32_t &value ){
+    if( position > size || size - position < 4 ) return false;
+    const uint8_t *p = packet + position;
+    value = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+    position += 4;
+    return true;
+}
@@ -0,0 +1,151 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <cstring>
+#include <stdint.h>
+
+#include "ofMain.h"
+
+using namespace GRT;
+
+/**
+ @brief writes OSC 1.0 packets (a single message, or a bundle of messages and nested bundles with a timetag) into a buffer that can be sent
+ with any datagram socket. Only int32, float32 and string arguments are written, which is all the ofxGrt servers and streams need. The
+ buffer is reused, so writing a packet every frame does not allocate once the buffer has grown to the largest packet.
+
+ A bundle is written with beginBundle, then any number of beginMessage, add..., endMessage, and finally endBundle. The timetag tells the
+ receiver when the messages should take effect, as an NTP time (see getTimetag), or IMMEDIATE.
+*/
+class ofxGrtOscWriter {
+public:
+    static const uint64_t IMMEDIATE = 1;
+
+    ofxGrtOscWriter();
+    ~ofxGrtOscWriter();
+
+    /**
+     @brief starts a bundle, either as the packet itself or nested inside the current bundle
+     @param timetag: the NTP time the bundle should take effect, or IMMEDIATE
+     @return returns true if the bundle was started, false if a message is being written or the packet is already complete
+    */
+    bool beginBundle( const uint64_t timetag = IMMEDIATE );
+
+    /**
+     @brief ends the current bundle
+     @return returns true if the bundle was ended, false if there is no open bundle
+    */
+    bool endBundle();
+
+    /**
+     @brief starts a message, either as the packet itself or inside the current bundle
+     @param address: the OSC address of the message, this must start with '/'
+     @return returns true if the message was started, false otherwise
+    */
+    bool beginMessage( const std::string &address );
+
+    bool addInt( const int32_t value );
+    bool addFloat( const float value );
+    bool addFloats( const VectorFloat &values );
+    bool addString( const std::string &value );
+
+    /**
+     @brief ends the current message, writing its type tags and arguments
+     @return returns true if the message was ended, false if there is no open message
+    */
+    bool endMessage();
+
+    /**
+     @brief removes the packet, so a new one can be written
+    */
+    void clear();
+
+    /**
+     @brief gets the packet, this is only a valid OSC packet once every message and bundle has been ended
+    */
+    const uint8_t *getData() const { return data.size() > 0 ? &data[0] : NULL; }
+    size_t getSize() const { return data.size(); }
+    bool getIsEmpty() const { return data.size() == 0; }
+    bool getIsComplete() const { return data.size() > 0 && !inMessage && bundleStarts.size() == 0; }
+
+    /**
+     @brief gets the NTP timetag of the current system time plus a delay
+     @param delay: the delay in seconds
+    */
+    static uint64_t getTimetag( const double delay = 0 );
+
+protected:
+    void writeInt32( const uint32_t value );
+    void writeString( vector< uint8_t > &buffer, const std::string &value );
+    bool beginElement();
+    void endElement( const size_t start );
+
+    vector< uint8_t > data;
+    vector< size_t > bundleStarts;      ///< The position of the size of each open bundle (or -1 for the packet itself)
+    size_t messageStart;
+    bool inMessage;
+    std::string typeTags;
+    vector< uint8_t > arguments;
+
+    ErrorLog errorLog;
+};
+
+/**
+ @brief reads the messages of an OSC 1.0 packet. Bundles are flattened, each message gets the timetag of the innermost bundle it is in.
+ int32, int64, float32, float64, string, symbol, blob, true, false, nil and impulse arguments are supported, numbers can be read as any
+ numeric type.
+*/
+class ofxGrtOscReader {
+public:
+    struct Message{
+        std::string address;
+        std::string types;              ///< One type tag per argument
+        vector< double > numbers;       ///< The value of each numeric (or true/false) argument, 0 for the others
+        vector< std::string > strings;  ///< The value of each string or symbol argument, empty for the others
+        uint64_t timetag;
+
+        UINT getNumArguments() const { return (UINT)types.size(); }
+        bool getIsNumber( const UINT i ) const { return i < types.size() && strchr( "ifhdTF", types[i] ) != NULL; }
+        bool getIsString( const UINT i ) const { return i < types.size() && (types[i] == 's' || types[i] == 'S'); }
+        double getNumber( const UINT i ) const { return i < numbers.size() ? numbers[i] : 0; }
+        const std::string &getString( const UINT i ) const { return strings[i]; }
+    };
+
+    ofxGrtOscReader();
+    ~ofxGrtOscReader();
+
+    /**
+     @brief reads a packet
+     @param packet: the packet
+     @param size: the size of the packet in bytes
+     @param messages: the messages in the packet are added to the end of this
+     @return returns true if the packet was read successfully, false if it is not a valid OSC packet (any messages before the error are kept)
+    */
+    bool parse( const void *packet, const size_t size, vector< Message > &messages );
+
+protected:
+    bool parseElement( const uint8_t *packet, const size_t size, const uint64_t timetag, vector< Message > &messages, const UINT depth );
+    bool parseMessage( const uint8_t *packet, const size_t size, const uint64_t timetag, Message &message );
+    static bool readString( const uint8_t *packet, const size_t size, size_t &position, std::string &value );
+    static bool readUInt32( const uint8_t *packet, const size_t size, size_t &position, uint32_t &value );
+
+    ErrorLog errorLog;
+};
@@ -0,0 +1,313 @@
+
+#include "ofxGrtOscOutput.h"
+
+using namespace GRT;
+
+//Frames are split into several packets rather than sending a packet larger than this
+static const size_t MAX_BUNDLE_SIZE = 8192;
+
+ofxGrtOscOutput::ofxGrtOscOutput(){
+    changeOnly = false;
+    changeThreshold = 0;
+    maxRate = 0;
+    latency = 0;
+    maxNumQueuedFrames = 256;
+    hasLastFrame = false;
+    stopping = false;
+    sendFailed = false;
+    numFrames = 0;
+    numSkipped = 0;
+    numDropped = 0;
+    numPackets = 0;
+    errorLog.setProceedingText("[ERROR ofxGrtOscOutput]");
+    warningLog.setProceedingText("[WARNING ofxGrtOscOutput]");
+}
+
+ofxGrtOscOutput::~ofxGrtOscOutput(){
+    close();
+}
+
+bool ofxGrtOscOutput::setup( const std::string &host, const unsigned short port, const std::string &prefix ){
+
+    close();
+
+    if( !ofxGrtDatagramSocket::getUdpAddress( host, port, receiver ) ){
+        errorLog << "setup(...) - Invalid receiver address: " << host << endl;
+        return false;
+    }
+
+    if( !socket.bindUdp( 0 ) ){
+        errorLog << "setup(...) - Failed to open a socket!" << endl;
+        return false;
+    }
+
+    return start( prefix );
+}
+
+bool ofxGrtOscOutput::setupUnix( const std::string &path, const std::string &prefix ){
+
+    close();
+
+    if( !ofxGrtDatagramSocket::getUnixAddress( path, receiver ) ){
+        errorLog << "setupUnix(...) - Invalid receiver path: " << path << endl;
+        return false;
+    }
+
+    if( !socket.openUnix() ){
+        errorLog << "setupUnix(...) - Failed to open a socket!" << endl;
+        return false;
+    }
+
+    return start( prefix );
+}
+
+void ofxGrtOscOutput::close(){
+
+    if( sendThread.joinable() ){
+        {
+            std::unique_lock< std::mutex > lock( mtx );
+            stopping = true;
+        }
+        frameCondition.notify_all();
+        sendThread.join();
+    }
+
+    socket.close();
+
+    std::unique_lock< std::mutex > lock( mtx );
+    while( frames.size() > 0 ){
+        spareFrames.push_back( std::move( frames.front() ) );
+        frames.pop_front();
+    }
+    hasLastFrame = false;
+}
+
+bool ofxGrtOscOutput::update( const ofxGrtPredictor &predictor ){
+    static const VectorFloat empty;
+    if( predictor.getIsRegressifier() ){
+        return update( predictor.getPredictedClassLabel(), predictor.getMaximumLikelihood(), empty, predictor.getRegressionData() );
+    }
+    return update( predictor.getPredictedClassLabel(), predictor.getMaximumLikelihood(), predictor.getClassLikelihoods(), empty );
+}
+
+bool ofxGrtOscOutput::update( const GestureRecognitionPipeline &pipeline ){
+    return update( pipeline.getPredictedClassLabel(), pipeline.getMaximumLikelihood(), pipeline.getClassLikelihoods(), pipeline.getRegressionData() );
+}
+
+bool ofxGrtOscOutput::update( const UINT predictedClassLabel, const Float maximumLikelihood, const VectorFloat &classLikelihoods, const VectorFloat &regressionData ){
+
+    if( !socket.getIsOpen() ){
+        errorLog << "update(...) - The output has not been setup!" << endl;
+        return false;
+    }
+
+    if( changeOnly ){
+        if( hasLastFrame && !getHasChanged( predictedClassLabel, maximumLikelihood, classLikelihoods, regressionData ) ){
+            numSkipped++;
+            return true;
+        }
+        lastFrame.predictedClassLabel = predictedClassLabel;
+        lastFrame.maximumLikelihood = maximumLikelihood;
+        lastFrame.classLikelihoods = classLikelihoods;
+        lastFrame.regressionData = regressionData;
+        hasLastFrame = true;
+    }
+
+    const uint64_t timetag = ofxGrtOscWriter::getTimetag( latency );
+
+    {
+        std::unique_lock< std::mutex > lock( mtx );
+
+        //With a maximum rate only the newest frame waits to be sent, otherwise the oldest frame makes room in a full queue
+        if( maxRate > 0 && frames.size() > 0 ){
+            numDropped++;
+        }else{
+            if( frames.size() >= maxNumQueuedFrames ){
+                spareFrames.push_back( std::move( frames.front() ) );
+                frames.pop_front();
+                numDropped++;
+            }
+            if( spareFrames.size() > 0 ){
+                frames.push_back( std::move( spareFrames.back() ) );
+                spareFrames.pop_back();
+            }else frames.push_back( Frame() );
+        }
+
+        Frame &frame = frames.back();
+        frame.timetag = timetag;
+        frame.predictedClassLabel = predictedClassLabel;
+        frame.maximumLikelihood = maximumLikelihood;
+        frame.classLikelihoods = classLikelihoods;
+        frame.regressionData = regressionData;
+    }
+    frameCondition.notify_one();
+    numFrames++;
+
+    return true;
+}
+
+bool ofxGrtOscOutput::setChangeOnly( const bool changeOnly, const Float threshold ){
+    if( threshold < 0 ){
+        errorLog << "setChangeOnly(const bool changeOnly, const Float threshold) - The threshold must not be negative!" << endl;
+        return false;
+    }
+    this->changeOnly = changeOnly;
+    this->changeThreshold = threshold;
+    hasLastFrame = false;
+    return true;
+}
+
+bool ofxGrtOscOutput::setMaxRate( const double maxRate ){
+    if( maxRate < 0 ){
+        errorLog << "setMaxRate(const double maxRate) - The rate must not be negative!" << endl;
+        return false;
+    }
+    std::unique_lock< std::mutex > lock( mtx );
+    this->maxRate = maxRate;
+    return true;
+}
+
+bool ofxGrtOscOutput::setLatency( const double latency ){
+    if( latency < 0 ){
+        errorLog << "setLatency(const double latency) - The latency must not be negative!" << endl;
+        return false;
+    }
+    this->latency = latency;
+    return true;
+}
+
+bool ofxGrtOscOutput::setMaxNumQueuedFrames( const UINT maxNumQueuedFrames ){
+    if( maxNumQueuedFrames == 0 ){
+        errorLog << "setMaxNumQueuedFrames(const UINT maxNumQueuedFrames) - The queue must hold at least one frame!" << endl;
+        return false;
+    }
+    std::unique_lock< std::mutex > lock( mtx );
+    this->maxNumQueuedFrames = maxNumQueuedFrames;
+    return true;
+}
+
+bool ofxGrtOscOutput::start( const std::string &prefix ){
+
+    if( prefix.size() == 0 || prefix[0] != '/' || prefix[ prefix.size()-1 ] == '/' ){
+        errorLog << "start(const std::string &prefix) - The prefix must start with '/' and not end with '/': " << prefix << endl;
+        socket.close();
+        return false;
+    }
+
+    //The addresses are built once so writing a frame does not allocate
+    this->prefix = prefix;
+    labelAddress = prefix + "/label";
+    likelihoodAddress = prefix + "/likelihood";
+    likelihoodsAddress = prefix + "/likelihoods";
+    regressionAddress = prefix + "/regression";
+
+    stopping = false;
+    sendFailed = false;
+    hasLastFrame = false;
+    lastSendTime = Clock::time_point();
+    numFrames = 0;
+    numSkipped = 0;
+    numDropped = 0;
+    numPackets = 0;
+    sendThread = std::thread( &ofxGrtOscOutput::sendFunction, this );
+
+    return true;
+}
+
+bool ofxGrtOscOutput::getHasChanged( const UINT predictedClassLabel, const Float maximumLikelihood, const VectorFloat &classLikelihoods, const VectorFloat &regressionData ) const {
+    if( predictedClassLabel != lastFrame.predictedClassLabel ) return true;
+    if( fabs( maximumLikelihood - lastFrame.maximumLikelihood ) > changeThreshold ) return true;
+    return getHasChanged( classLikelihoods, lastFrame.classLikelihoods, changeThreshold ) || getHasChanged( regressionData, lastFrame.regressionData, changeThreshold );
+}
+
+bool ofxGrtOscOutput::getHasChanged( const VectorFloat &a, const VectorFloat &b, const Float threshold ){
+    if( a.size() != b.size() ) return true;
+    for(size_t i=0; i<a.size(); i++){
+        if( fabs( a[i] - b[i] ) > threshold ) return true;
+    }
+    return false;
+}
+
+void ofxGrtOscOutput::sendFunction(){
+
+    std::unique_lock< std::mutex > lock( mtx );
+
+    while( true ){
+        frameCondition.wait( lock, [&]{ return stopping || frames.size() > 0; } );
+        if( stopping ) return;
+
+        //Hold the frames back until the rate allows another packet, update keeps replacing the newest frame meanwhile
+        if( maxRate > 0 ){
+            const Clock::time_point next = lastSendTime + std::chrono::duration_cast< Clock::duration >( std::chrono::duration< double >( 1.0 / maxRate ) );
+            if( frameCondition.wait_until( lock, next, [&]{ return stopping; } ) ) return;
+        }
+
+        sendingFrames.swap( frames );
+        lock.unlock();
+
+        if( sendingFrames.size() == 1 ){
+            writer.clear();
+            writeFrame( sendingFrames.front() );
+            sendPacket();
+        }else{
+            //Several frames are nested in one bundle, each keeping the timetag of its own prediction
+            writer.clear();
+            writer.beginBundle();
+            for(size_t i=0; i<sendingFrames.size(); i++){
+                writeFrame( sendingFrames[i] );
+                if( writer.getSize() >= MAX_BUNDLE_SIZE && i+1 < sendingFrames.size() ){
+                    writer.endBundle();
+                    sendPacket();
+                    writer.clear();
+                    writer.beginBundle();
+                }
+            }
+            writer.endBundle();
+            sendPacket();
+        }
+
+        lock.lock();
+        lastSendTime = Clock::now();
+        while( sendingFrames.size() > 0 ){
+            spareFrames.push_back( std::move( sendingFrames.front() ) );
+            sendingFrames.pop_front();
+        }
+    }
+}
+
+void ofxGrtOscOutput::writeFrame( const Frame &frame ){
+
+    writer.beginBundle( frame.timetag );
+
+    writer.beginMessage( labelAddress );
+    writer.addInt( (int32_t)frame.predictedClassLabel );
+    writer.endMessage();
+
+    writer.beginMessage( likelihoodAddress );
+    writer.addFloat( (float)frame.maximumLikelihood );
+    writer.endMessage();
+
+    if( frame.classLikelihoods.size() > 0 ){
+        writer.beginMessage( likelihoodsAddress );
+        writer.addFloats( frame.classLikelihoods );
+        writer.endMessage();
+    }
+
+    if( frame.regressionData.size() > 0 ){
+        writer.beginMessage( regressionAddress );
+        writer.addFloats( frame.regressionData );
+        writer.endMessage();
+    }
+
+    writer.endBundle();
+}
+
+void ofxGrtOscOutput::sendPacket(){
+    if( socket.send( writer.getData(), writer.getSize(), receiver ) ){
+        numPackets++;
+        sendFailed = false;
+    }else if( !sendFailed ){
+        warningLog << "sendPacket() - Failed to send to the receiver, is it running?" << endl;
+        sendFailed = true;
+    }
+}
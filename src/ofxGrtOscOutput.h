@@ -0,0 +1,191 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "ofMain.h"
+#include "ofxGrtDatagramSocket.h"
+#include "ofxGrtOsc.h"
+#include "ofxGrtPredictor.h"
+
+using namespace GRT;
+
+/**
+ @brief streams prediction results to other processes (an audio engine, a lighting desk) as OSC bundles. Each call to update adds a frame
+ which is sent as a bundle, timetagged with the time of the prediction plus an optional latency, containing:
+
+   <prefix>/label         i:predictedClassLabel
+   <prefix>/likelihood    f:maximumLikelihood
+   <prefix>/likelihoods   f:classLikelihood ...         (classification only)
+   <prefix>/regression    f:regressionValue ...         (regression only)
+
+ The frames are sent from a background thread, so update only copies the results into a recycled frame and never waits on the socket.
+ Frames that pile up while the thread is sending are sent together as bundles nested in one outer bundle, each keeping its own timetag.
+
+ In change-only mode a frame is only added when the label changes or any value moves by more than a threshold. With a maximum rate the
+ thread sends at most that many packets per second, and only the newest frame is kept in between, so a fast predictor does not flood the
+ network. The two modes can be combined.
+*/
+class ofxGrtOscOutput {
+public:
+    ofxGrtOscOutput();
+    ~ofxGrtOscOutput();
+
+    /**
+     @brief starts streaming over UDP
+     @param host: the IPv4 address of the receiver
+     @param port: the port of the receiver
+     @param prefix: the address the messages start with
+     @return returns true if the output was setup successfully, false otherwise
+    */
+    bool setup( const std::string &host, const unsigned short port, const std::string &prefix = "/grt" );
+
+    /**
+     @brief starts streaming over a unix domain socket
+     @param path: the path of the receiver's socket file
+     @param prefix: the address the messages start with
+     @return returns true if the output was setup successfully, false otherwise
+    */
+    bool setupUnix( const std::string &path, const std::string &prefix = "/grt" );
+
+    /**
+     @brief stops the sending thread and closes the socket, frames that have not been sent yet are dropped
+    */
+    void close();
+
+    /**
+     @brief adds the results of the last prediction of a predictor
+     @return returns true if the frame was added or skipped because nothing changed, false if the output is not setup
+    */
+    bool update( const ofxGrtPredictor &predictor );
+
+    /**
+     @brief adds the results of the last prediction of a pipeline
+     @return returns true if the frame was added or skipped because nothing changed, false if the output is not setup
+    */
+    bool update( const GestureRecognitionPipeline &pipeline );
+
+    /**
+     @brief adds a frame
+     @param predictedClassLabel: the predicted class label, sent for classification and regression frames
+     @param maximumLikelihood: the likelihood of the predicted class
+     @param classLikelihoods: the likelihood of each class, not sent if empty
+     @param regressionData: the regression output, not sent if empty
+     @return returns true if the frame was added or skipped because nothing changed, false if the output is not setup
+    */
+    bool update( const UINT predictedClassLabel, const Float maximumLikelihood, const VectorFloat &classLikelihoods, const VectorFloat &regressionData );
+
+    /**
+     @brief sets change-only mode
+     @param changeOnly: if true frames are only added when the label changes or a value moves by more than the threshold
+     @param threshold: the smallest change of a likelihood or regression value that counts as a change
+    */
+    bool setChangeOnly( const bool changeOnly, const Float threshold = 0 );
+
+    /**
+     @brief sets the most packets sent per second, frames added faster than this replace the frame waiting to be sent
+     @param maxRate: the rate in Hz, 0 sends every frame
+    */
+    bool setMaxRate( const double maxRate );
+
+    /**
+     @brief sets how far in the future (in seconds) the timetags are. A receiver that schedules bundles by their timetag then plays the
+     frames out with the spacing they were predicted at, hiding the network jitter, as long as the jitter is below the latency.
+     @param latency: the latency in seconds, 0 timetags each frame with the time it was predicted
+    */
+    bool setLatency( const double latency );
+
+    /**
+     @brief sets the most frames that can wait to be sent, the oldest frame is dropped when the queue is full
+    */
+    bool setMaxNumQueuedFrames( const UINT maxNumQueuedFrames );
+
+    bool getIsSetup() const { return socket.getIsOpen(); }
+    bool getChangeOnly() const { return changeOnly; }
+    Float getChangeThreshold() const { return changeThreshold; }
+    double getMaxRate() const { return maxRate; }
+    double getLatency() const { return latency; }
+    const std::string &getPrefix() const { return prefix; }
+    UINT getNumFrames() const { return numFrames; }
+    UINT getNumSkipped() const { return numSkipped; }
+    UINT getNumDropped() const { return numDropped; }      ///< The number of frames replaced by a newer frame or dropped from a full queue
+    UINT getNumPackets() const { return numPackets; }
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Frame{
+        uint64_t timetag;
+        UINT predictedClassLabel;
+        Float maximumLikelihood;
+        VectorFloat classLikelihoods;
+        VectorFloat regressionData;
+    };
+
+    bool start( const std::string &prefix );
+    bool getHasChanged( const UINT predictedClassLabel, const Float maximumLikelihood, const VectorFloat &classLikelihoods, const VectorFloat &regressionData ) const;
+    static bool getHasChanged( const VectorFloat &a, const VectorFloat &b, const Float threshold );
+    void sendFunction();
+    void writeFrame( const Frame &frame );
+    void sendPacket();
+
+    ofxGrtDatagramSocket socket;
+    ofxGrtDatagramSocket::Address receiver;
+    std::string prefix;
+    std::string labelAddress;
+    std::string likelihoodAddress;
+    std::string likelihoodsAddress;
+    std::string regressionAddress;
+    bool changeOnly;
+    Float changeThreshold;
+    double maxRate;
+    double latency;
+    UINT maxNumQueuedFrames;
+
+    //The last frame that was added, used by change-only mode (only touched by the thread calling update)
+    bool hasLastFrame;
+    Frame lastFrame;
+
+    std::thread sendThread;
+    std::mutex mtx;                         ///< Guards the frames and stopping
+    std::condition_variable frameCondition;
+    bool stopping;
+    std::deque< Frame > frames;             ///< The frames waiting to be sent
+    std::deque< Frame > sendingFrames;      ///< The frames being sent, only touched by the sending thread
+    vector< Frame > spareFrames;            ///< Sent frames kept so their vectors can be reused without allocating
+    Clock::time_point lastSendTime;
+
+    ofxGrtOscWriter writer;                 ///< Only used by the sending thread
+    bool sendFailed;                        ///< Only used by the sending thread, so a missing receiver is only reported once
+    std::atomic< UINT > numFrames;
+    std::atomic< UINT > numSkipped;
+    std::atomic< UINT > numDropped;
+    std::atomic< UINT > numPackets;
+
+    ErrorLog errorLog;
+    WarningLog warningLog;
+};
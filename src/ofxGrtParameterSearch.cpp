@@ -0,0 +1,296 @@
+
+#include "ofxGrtParameterSearch.h"
+#include <chrono>
+#include <random>
+#include <set>
+
+using namespace GRT;
+
+ofxGrtParameterSearch::ofxGrtParameterSearch(){
+    searchMode = GRID_SEARCH;
+    numRandomConfigurations = 20;
+    targetAccuracy = 0;
+    searchTime = 0;
+    crossValidation.setNumFolds( 5 );
+    errorLog.setProceedingText("[ERROR ofxGrtParameterSearch]");
+}
+
+ofxGrtParameterSearch::~ofxGrtParameterSearch(){
+}
+
+bool ofxGrtParameterSearch::addParameter( const std::string &name, const vector< Float > &values ){
+    if( values.size() == 0 ){
+        errorLog << "addParameter(const std::string &name, const vector< Float > &values) - The parameter " << name << " has no values!" << endl;
+        return false;
+    }
+    parameterNames.push_back( name );
+    parameterValues.push_back( values );
+    configurations.clear();
+    return true;
+}
+
+bool ofxGrtParameterSearch::clear(){
+    parameterNames.clear();
+    parameterValues.clear();
+    configurations.clear();
+    searchTime = 0;
+    return true;
+}
+
+bool ofxGrtParameterSearch::setConfigureFunction( const ConfigureFunction &configureFunction ){
+    this->configureFunction = configureFunction;
+    return true;
+}
+
+bool ofxGrtParameterSearch::setSearchMode( const SearchMode searchMode, const UINT numRandomConfigurations ){
+    if( searchMode == RANDOM_SEARCH && numRandomConfigurations == 0 ){
+        errorLog << "setSearchMode(...) - The number of random configurations must be greater than zero!" << endl;
+        return false;
+    }
+    this->searchMode = searchMode;
+    this->numRandomConfigurations = numRandomConfigurations;
+    return true;
+}
+
+bool ofxGrtParameterSearch::setNumFolds( const UINT numFolds ){
+    return crossValidation.setNumFolds( numFolds );
+}
+
+bool ofxGrtParameterSearch::setSeed( const uint64_t seed ){
+    return crossValidation.setSeed( seed );
+}
+
+bool ofxGrtParameterSearch::setTargetAccuracy( const Float targetAccuracy ){
+    if( targetAccuracy < 0 || targetAccuracy > 1 ){
+        errorLog << "setTargetAccuracy(const Float targetAccuracy) - The target accuracy must be in the range [0 1]!" << endl;
+        return false;
+    }
+    this->targetAccuracy = targetAccuracy;
+    return true;
+}
+
+bool ofxGrtParameterSearch::search( const GestureRecognitionPipeline &pipeline, const ClassificationData &data ){
+    return searchData( pipeline, data );
+}
+
+bool ofxGrtParameterSearch::search( const GestureRecognitionPipeline &pipeline, const TimeSeriesClassificationData &data ){
+    return searchData( pipeline, data );
+}
+
+template< class Data >
+bool ofxGrtParameterSearch::searchData( const GestureRecognitionPipeline &pipeline, const Data &data ){
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    configurations.clear();
+    searchTime = 0;
+
+    if( !configureFunction ){
+        errorLog << "search(...) - The configure function has not been set!" << endl;
+        return false;
+    }
+
+    if( !buildConfigurations() || !crossValidation.split( data ) ){
+        return false;
+    }
+
+    //Each configuration is one task, so the pool can steal the configurations of a thread that is stuck on a slow one
+    vector< GestureRecognitionPipeline > trainedPipelines( configurations.size() );
+    ofxGrtThreadPool::getSharedPool().parallelFor( 0, configurations.size(), 1, [&]( const size_t i, const unsigned int threadIndex ){
+        runConfiguration( pipeline, data, configurations[i], trainedPipelines[i] );
+    } );
+
+    //The fold prediction times include the contention with the other configurations, so time each finished configuration again on its own
+    const UINT lastFold = crossValidation.getNumFolds()-1;
+    for(size_t i=0; i<configurations.size(); i++){
+        double predictionTime = 0;
+        if( trainedPipelines[i].getTrained() && crossValidation.timeFold( trainedPipelines[i], data, lastFold, predictionTime ) ){
+            configurations[i].predictionTime = predictionTime;
+        }
+        trainedPipelines[i].clear();
+    }
+
+    findParetoFront();
+
+    searchTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+
+    return true;
+}
+
+template< class Data >
+void ofxGrtParameterSearch::runConfiguration( const GestureRecognitionPipeline &pipeline, const Data &data, Configuration &configuration, GestureRecognitionPipeline &trainedPipeline ) const {
+
+    GestureRecognitionPipeline configuredPipeline( pipeline );
+    if( !configureFunction( configuredPipeline, configuration.values ) ){
+        configuration.failed = true;
+        return;
+    }
+
+    const UINT numSamples = crossValidation.getNumSamples();
+    double totalPredictionTime = 0;
+    ofxGrtCrossValidation::FoldResult foldResult;
+    for(UINT f=0; f<crossValidation.getNumFolds(); f++){
+        //Only the trained pipeline of the last fold is kept, so only configurations that run every fold are timed again
+        GestureRecognitionPipeline *foldPipeline = f+1 == crossValidation.getNumFolds() ? &trainedPipeline : NULL;
+        if( !crossValidation.runFold( configuredPipeline, data, f, foldResult, foldPipeline ) || !foldResult.trained ){
+            configuration.failed = true;
+            return;
+        }
+
+        const UINT numFoldSamples = crossValidation.getNumFoldSamples( f );
+        configuration.numFoldsRun++;
+        configuration.numSamples += numFoldSamples;
+        configuration.numCorrect += foldResult.numCorrect;
+        configuration.trainingTime += foldResult.trainingTime;
+        totalPredictionTime += foldResult.predictionTime * numFoldSamples;
+
+        //Stop if the configuration can not reach the target even with every remaining sample right
+        if( targetAccuracy > 0 && configuration.numCorrect + (numSamples - configuration.numSamples) < targetAccuracy * numSamples ){
+            configuration.stoppedEarly = true;
+            break;
+        }
+    }
+
+    configuration.trainingTime /= configuration.numFoldsRun;
+    configuration.predictionTime = configuration.numSamples > 0 ? totalPredictionTime / configuration.numSamples : 0;
+}
+
+bool ofxGrtParameterSearch::buildConfigurations(){
+
+    const UINT numParameters = getNumParameters();
+    if( numParameters == 0 ){
+        errorLog << "search(...) - No parameters have been added!" << endl;
+        return false;
+    }
+
+    //The number of combinations, stopping at a limit so it can not overflow
+    const size_t MAX_NUM_CONFIGURATIONS = 1000000;
+    size_t numCombinations = 1;
+    for(UINT j=0; j<numParameters; j++){
+        numCombinations *= parameterValues[j].size();
+        if( numCombinations > MAX_NUM_CONFIGURATIONS ) break;
+    }
+
+    const bool useEveryCombination = searchMode == GRID_SEARCH || numCombinations <= numRandomConfigurations;
+    if( useEveryCombination && numCombinations > MAX_NUM_CONFIGURATIONS ){
+        errorLog << "search(...) - The grid has more than " << MAX_NUM_CONFIGURATIONS << " combinations, use RANDOM_SEARCH instead!" << endl;
+        return false;
+    }
+
+    //Pick the value index of each parameter for each configuration
+    vector< vector< UINT > > indices;
+    if( useEveryCombination ){
+        vector< UINT > index( numParameters, 0 );
+        for(size_t n=0; n<numCombinations; n++){
+            indices.push_back( index );
+            for(UINT j=0; j<numParameters; j++){
+                if( ++index[j] < parameterValues[j].size() ) break;
+                index[j] = 0;
+            }
+        }
+    }else{
+        std::mt19937 randomGenerator( (std::mt19937::result_type)crossValidation.getSeed() );
+        std::set< vector< UINT > > picked;
+        vector< UINT > index( numParameters );
+        while( indices.size() < numRandomConfigurations ){
+            for(UINT j=0; j<numParameters; j++){
+                index[j] = randomGenerator() % parameterValues[j].size();
+            }
+            if( picked.insert( index ).second ) indices.push_back( index );
+        }
+    }
+
+    configurations.resize( indices.size() );
+    for(size_t i=0; i<indices.size(); i++){
+        Configuration &configuration = configurations[i];
+        configuration.values.resize( numParameters );
+        for(UINT j=0; j<numParameters; j++) configuration.values[j] = parameterValues[j][ indices[i][j] ];
+        configuration.numFoldsRun = 0;
+        configuration.numSamples = 0;
+        configuration.numCorrect = 0;
+        configuration.stoppedEarly = false;
+        configuration.failed = false;
+        configuration.pareto = false;
+        configuration.trainingTime = 0;
+        configuration.predictionTime = 0;
+    }
+
+    return true;
+}
+
+void ofxGrtParameterSearch::findParetoFront(){
+
+    //Sort the finished configurations by prediction time (and most accurate first for equal times), a configuration is on the front if it
+    //is more accurate than every faster configuration
+    vector< UINT > order;
+    for(UINT i=0; i<configurations.size(); i++){
+        configurations[i].pareto = false;
+        if( !configurations[i].failed && !configurations[i].stoppedEarly ) order.push_back( i );
+    }
+    std::sort( order.begin(), order.end(), [&]( const UINT a, const UINT b ){
+        if( configurations[a].predictionTime != configurations[b].predictionTime ) return configurations[a].predictionTime < configurations[b].predictionTime;
+        return configurations[a].getAccuracy() > configurations[b].getAccuracy();
+    } );
+
+    double bestAccuracy = -1;
+    for(size_t i=0; i<order.size(); i++){
+        Configuration &configuration = configurations[ order[i] ];
+        if( configuration.getAccuracy() > bestAccuracy ){
+            configuration.pareto = true;
+            bestAccuracy = configuration.getAccuracy();
+        }
+    }
+}
+
+bool ofxGrtParameterSearch::configure( GestureRecognitionPipeline &pipeline, const UINT configurationIndex ) const {
+    if( configurationIndex >= configurations.size() || !configureFunction ){
+        errorLog << "configure(...) - Invalid configuration index, or the configure function has not been set!" << endl;
+        return false;
+    }
+    return configureFunction( pipeline, configurations[ configurationIndex ].values );
+}
+
+vector< UINT > ofxGrtParameterSearch::getParetoFront() const {
+    vector< UINT > front;
+    for(UINT i=0; i<configurations.size(); i++){
+        if( configurations[i].pareto ) front.push_back( i );
+    }
+    std::sort( front.begin(), front.end(), [&]( const UINT a, const UINT b ){ return configurations[a].predictionTime < configurations[b].predictionTime; } );
+    return front;
+}
+
+bool ofxGrtParameterSearch::getCheapestConfiguration( const Float targetAccuracy, UINT &configurationIndex ) const {
+
+    //The front is sorted fastest first, and any configuration that meets the target is matched or beaten by one on the front
+    const vector< UINT > front = getParetoFront();
+    for(size_t i=0; i<front.size(); i++){
+        if( configurations[ front[i] ].getAccuracy() >= targetAccuracy ){
+            configurationIndex = front[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+UINT ofxGrtParameterSearch::getNumStoppedEarly() const {
+    UINT numStoppedEarly = 0;
+    for(size_t i=0; i<configurations.size(); i++){
+        if( configurations[i].stoppedEarly ) numStoppedEarly++;
+    }
+    return numStoppedEarly;
+}
+
+std::string ofxGrtParameterSearch::getReport() const {
+    std::stringstream stream;
+    const vector< UINT > front = getParetoFront();
+    for(size_t i=0; i<front.size(); i++){
+        const Configuration &c = configurations[ front[i] ];
+        for(UINT j=0; j<getNumParameters(); j++){
+            stream << parameterNames[j] << "=" << c.values[j] << " ";
+        }
+        stream << "accuracy=" << ofToString( c.getAccuracy() * 100, 1 ) << "%";
+        stream << " predict=" << ofToString( c.predictionTime * 1000, 1 ) << "us";
+        stream << " train=" << ofToString( c.trainingTime, 1 ) << "ms" << endl;
+    }
+    return stream.str();
+}
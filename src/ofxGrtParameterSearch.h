@@ -0,0 +1,178 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <functional>
+#include <stdint.h>
+
+#include "ofMain.h"
+#include "ofxGrtCrossValidation.h"
+#include "ofxGrtThreadPool.h"
+
+using namespace GRT;
+
+/**
+ @brief searches classifier settings (such as the null rejection coefficient, the size of a forest or the number of hidden neurons of an MLP)
+ for a pipeline. Each parameter is given a list of values, and a configure function applies one value of every parameter to a copy of the
+ pipeline, normally by setting up a classifier and calling pipeline.setClassifier. GRID_SEARCH tries every combination of values, RANDOM_SEARCH
+ tries a number of distinct combinations picked at random.
+
+ Every configuration is scored with k-fold cross validation (see ofxGrtCrossValidation) on the same folds, and the configurations are run as tasks
+ on the shared work stealing ofxGrtThreadPool, so slow configurations (such as large forests) do not hold up the others. The folds of a configuration
+ are run one after another, and if a target accuracy is set a configuration is stopped as soon as it could no longer reach the target even if it
+ predicted every remaining sample correctly.
+
+ The configurations that were run to the end are compared by their accuracy and mean prediction time. The Pareto front holds those that no other
+ configuration beats on both, and getCheapestConfiguration picks the fastest configuration that meets an accuracy target. The folds are run while
+ other configurations are running, so the fold prediction times are not used for this. Instead, once every configuration has finished, the trained
+ pipeline of the last fold of each configuration that was run to the end predicts that fold again, one configuration at a time on an idle pool. The
+ trained pipelines are kept until then, so a search holds one trained pipeline per configuration at its peak.
+
+ The configure function is called from several threads at once, each time with a different copy of the pipeline.
+*/
+class ofxGrtParameterSearch {
+public:
+    enum SearchMode{ GRID_SEARCH=0, RANDOM_SEARCH };
+
+    typedef std::function< bool( GestureRecognitionPipeline &pipeline, const vector< Float > &values ) > ConfigureFunction;
+
+    struct Configuration{
+        vector< Float > values;     ///< The value of each parameter, in the order they were added
+        UINT numFoldsRun;
+        UINT numSamples;            ///< The number of test samples in the folds that were run
+        UINT numCorrect;
+        bool stoppedEarly;          ///< True if the configuration could not reach the target accuracy and was stopped
+        bool failed;                ///< True if the configure function or the training of a fold failed
+        bool pareto;                ///< True if the configuration is on the Pareto front
+        double trainingTime;        ///< The mean training time of the folds that were run in milliseconds
+        double predictionTime;      ///< The mean prediction time in milliseconds per sample, timed on an idle pool if the configuration was run to the end
+
+        double getAccuracy() const { return numSamples > 0 ? (double)numCorrect / numSamples : 0; }
+    };
+
+    ofxGrtParameterSearch();
+    ~ofxGrtParameterSearch();
+
+    /**
+     @brief adds a parameter to search
+     @param name: the name of the parameter, used by getReport
+     @param values: the values to try, there must be at least one
+     @return returns true if the parameter was added successfully, false otherwise
+    */
+    bool addParameter( const std::string &name, const vector< Float > &values );
+
+    /**
+     @brief removes all the parameters and results
+    */
+    bool clear();
+
+    /**
+     @brief sets the function that applies the values of one configuration to a copy of the pipeline
+    */
+    bool setConfigureFunction( const ConfigureFunction &configureFunction );
+
+    /**
+     @brief sets how the configurations are picked
+     @param searchMode: GRID_SEARCH runs every combination, RANDOM_SEARCH runs numRandomConfigurations distinct combinations (or every combination if there are fewer)
+    */
+    bool setSearchMode( const SearchMode searchMode, const UINT numRandomConfigurations = 20 );
+
+    bool setNumFolds( const UINT numFolds );
+    bool setSeed( const uint64_t seed );
+
+    /**
+     @brief sets the accuracy a configuration must be able to reach to keep running, if zero (the default) every configuration is run to the end
+     @param targetAccuracy: the target accuracy in the range [0 1]
+    */
+    bool setTargetAccuracy( const Float targetAccuracy );
+
+    /**
+     @brief runs the search, the pipeline itself is not changed
+     @param pipeline: the pipeline to copy for each configuration, with any pre processing, feature extraction and post processing modules
+     @param data: the dataset to cross validate on
+     @return returns true if the search was run successfully, false otherwise
+    */
+    bool search( const GestureRecognitionPipeline &pipeline, const ClassificationData &data );
+    bool search( const GestureRecognitionPipeline &pipeline, const TimeSeriesClassificationData &data );
+
+    /**
+     @brief applies the values of a configuration to a pipeline with the configure function, for example to train the chosen configuration
+    */
+    bool configure( GestureRecognitionPipeline &pipeline, const UINT configurationIndex ) const;
+
+    /**
+     @brief gets the indices of the configurations on the Pareto front of accuracy against prediction time, fastest first
+    */
+    vector< UINT > getParetoFront() const;
+
+    /**
+     @brief gets the fastest configuration whose accuracy is at least targetAccuracy
+     @param targetAccuracy: the accuracy the configuration must reach
+     @param configurationIndex: the index of the configuration, if one was found
+     @return returns true if a configuration reached the target, false otherwise
+    */
+    bool getCheapestConfiguration( const Float targetAccuracy, UINT &configurationIndex ) const;
+
+    /**
+     @brief gets a table of the configurations on the Pareto front, with their values, accuracy and timings
+    */
+    std::string getReport() const;
+
+    UINT getNumParameters() const { return (UINT)parameterNames.size(); }
+    const std::string &getParameterName( const UINT i ) const { return parameterNames[i]; }
+    const vector< Configuration > &getConfigurations() const { return configurations; }
+    SearchMode getSearchMode() const { return searchMode; }
+    UINT getNumRandomConfigurations() const { return numRandomConfigurations; }
+    UINT getNumFolds() const { return crossValidation.getNumFolds(); }
+    uint64_t getSeed() const { return crossValidation.getSeed(); }
+    Float getTargetAccuracy() const { return targetAccuracy; }
+
+    /**
+     @brief gets the number of configurations that were stopped early by the last search
+    */
+    UINT getNumStoppedEarly() const;
+
+    /**
+     @brief gets the time taken by the last search
+     @return returns the search time in milliseconds
+    */
+    double getSearchTime() const { return searchTime; }
+
+protected:
+    template< class Data >
+    bool searchData( const GestureRecognitionPipeline &pipeline, const Data &data );
+    template< class Data >
+    void runConfiguration( const GestureRecognitionPipeline &pipeline, const Data &data, Configuration &configuration, GestureRecognitionPipeline &trainedPipeline ) const;
+    bool buildConfigurations();
+    void findParetoFront();
+
+    vector< std::string > parameterNames;
+    vector< vector< Float > > parameterValues;
+    ConfigureFunction configureFunction;
+    SearchMode searchMode;
+    UINT numRandomConfigurations;
+    Float targetAccuracy;
+    ofxGrtCrossValidation crossValidation;
+    vector< Configuration > configurations;
+    double searchTime;
+
+    mutable ErrorLog errorLog;
+};
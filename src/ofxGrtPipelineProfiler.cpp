@@ -0,0 +1,357 @@
+
+#include "ofxGrtPipelineProfiler.h"
+
+using namespace GRT;
+
+double ofxGrtPipelineProfiler::StageStatistics::getPercentileTime( const double percentile ) const {
+    if( count == 0 ) return 0;
+    const double target = percentile * count;
+    UINT sum = 0;
+    for(UINT k=0; k<histogram.size(); k++){
+        sum += histogram[k];
+        if( sum >= target ) return std::min( (double)(1u << (k+1)), maxTime );
+    }
+    return maxTime;
+}
+
+ofxGrtPipelineProfiler::ofxGrtPipelineProfiler( const UINT maxNumTraceEvents ){
+    errorLog.setProceedingText("[ERROR ofxGrtPipelineProfiler]");
+    this->maxNumTraceEvents = maxNumTraceEvents;
+    startTime = Clock::now();
+    reset();
+}
+
+ofxGrtPipelineProfiler::~ofxGrtPipelineProfiler(){
+}
+
+bool ofxGrtPipelineProfiler::predict( GestureRecognitionPipeline &pipeline, const VectorFloat &inputVector ){
+
+    if( !pipeline.getTrained() ){
+        errorLog << "predict(GestureRecognitionPipeline &pipeline, const VectorFloat &inputVector) - The pipeline has not been trained!" << endl;
+        return false;
+    }
+
+    const Layout &layout = getLayout( pipeline );
+    data = inputVector;
+
+    for(UINT i=0; i<pipeline.getNumPreProcessingModules(); i++){
+        PreProcessing *module = pipeline.getPreProcessingModule( i );
+        const UINT stage = layout.preProcessingStages[i];
+
+        const Clock::time_point start = Clock::now();
+        const bool success = module->process( data );
+        const Clock::time_point end = Clock::now();
+
+        if( !success ){
+            errorLog << "predict(...) - Failed to run pre processing module " << i << endl;
+            return false;
+        }
+        const UINT inputSize = (UINT)data.size();
+        data = module->getProcessedData();
+        record( stage, start, end, inputSize, (UINT)data.size() );
+    }
+
+    return predictFromStage( pipeline, 0 );
+}
+
+bool ofxGrtPipelineProfiler::predict( GestureRecognitionPipeline &pipeline, const MatrixFloat &inputMatrix ){
+
+    if( !pipeline.getTrained() ){
+        errorLog << "predict(GestureRecognitionPipeline &pipeline, const MatrixFloat &inputMatrix) - The pipeline has not been trained!" << endl;
+        return false;
+    }
+
+    //Only a feature extraction module can take the matrix directly, anything else is timed as one stage
+    if( pipeline.getNumPreProcessingModules() > 0 || pipeline.getNumFeatureExtractionModules() == 0 ){
+        const UINT stage = getStageIndex( "Pipeline" );
+        const Clock::time_point start = Clock::now();
+        const bool success = pipeline.predict( inputMatrix );
+        const Clock::time_point end = Clock::now();
+        if( !success ) return false;
+        predictedClassLabel = pipeline.getPredictedClassLabel();
+        if( pipeline.getIsPipelineInRegressionMode() ) data = regressionData = pipeline.getRegressionData();
+        else data = classLikelihoods = pipeline.getClassLikelihoods();
+        record( stage, start, end, inputMatrix.getSize(), (UINT)data.size() );
+        return true;
+    }
+
+    FeatureExtraction *module = pipeline.getFeatureExtractionModule( 0 );
+    const UINT stage = getLayout( pipeline ).featureExtractionStages[0];
+
+    const Clock::time_point start = Clock::now();
+    const bool success = module->computeFeatures( inputMatrix );
+    const Clock::time_point end = Clock::now();
+
+    if( !success ){
+        errorLog << "predict(...) - Failed to run feature extraction module 0" << endl;
+        return false;
+    }
+    data = module->getFeatureVector();
+    record( stage, start, end, inputMatrix.getSize(), (UINT)data.size() );
+
+    return predictFromStage( pipeline, 1 );
+}
+
+bool ofxGrtPipelineProfiler::train( GestureRecognitionPipeline &pipeline, ClassificationData &trainingData ){
+    return trainPipeline( pipeline, trainingData, trainingData.getNumSamples() );
+}
+
+bool ofxGrtPipelineProfiler::train( GestureRecognitionPipeline &pipeline, RegressionData &trainingData ){
+    return trainPipeline( pipeline, trainingData, trainingData.getNumSamples() );
+}
+
+bool ofxGrtPipelineProfiler::train( GestureRecognitionPipeline &pipeline, TimeSeriesClassificationData &trainingData ){
+    return trainPipeline( pipeline, trainingData, trainingData.getNumSamples() );
+}
+
+bool ofxGrtPipelineProfiler::reset(){
+    predictedClassLabel = 0;
+    data.clear();
+    classLikelihoods.clear();
+    regressionData.clear();
+    stages.clear();
+    cachedLayout.modules.clear();
+    traceEvents.clear();
+    nextTraceEvent = 0;
+    return true;
+}
+
+vector< float > ofxGrtPipelineProfiler::getMeanLatencies() const {
+    vector< float > latencies( stages.size() );
+    for(size_t i=0; i<stages.size(); i++){
+        latencies[i] = (float)stages[i].getMeanTime();
+    }
+    return latencies;
+}
+
+vector< std::string > ofxGrtPipelineProfiler::getStageNames() const {
+    vector< std::string > names( stages.size() );
+    for(size_t i=0; i<stages.size(); i++){
+        names[i] = stages[i].name;
+    }
+    return names;
+}
+
+std::string ofxGrtPipelineProfiler::getReport() const {
+    std::stringstream stream;
+    for(size_t i=0; i<stages.size(); i++){
+        const StageStatistics &s = stages[i];
+        stream << s.name << ": n=" << s.count;
+        stream << " mean=" << ofToString( s.getMeanTime(), 1 ) << "us";
+        stream << " p50=" << ofToString( s.getPercentileTime( 0.5 ), 0 ) << "us";
+        stream << " p95=" << ofToString( s.getPercentileTime( 0.95 ), 0 ) << "us";
+        stream << " max=" << ofToString( s.maxTime, 1 ) << "us";
+        stream << " size=" << s.inputSize << "->" << s.outputSize << endl;
+    }
+    return stream.str();
+}
+
+bool ofxGrtPipelineProfiler::saveTrace( const std::string &filename ){
+
+    std::fstream file;
+    file.open( filename.c_str(), std::ios::out );
+    if( !file.is_open() ){
+        errorLog << "saveTrace(const std::string &filename) - Failed to open file: " << filename << endl;
+        return false;
+    }
+
+    //The trace buffer is circular, so start from the oldest event
+    const size_t numEvents = traceEvents.size();
+    const size_t first = numEvents < maxNumTraceEvents ? 0 : nextTraceEvent;
+    file << "{\"traceEvents\":[" << endl;
+    for(size_t i=0; i<numEvents; i++){
+        const TraceEvent &event = traceEvents[ (first + i) % numEvents ];
+        file << "{\"name\":\"" << stages[ event.stage ].name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":" << event.start << ",\"dur\":" << event.duration << "}";
+        file << (i+1 < numEvents ? "," : "") << endl;
+    }
+    file << "]}" << endl;
+    file.close();
+
+    return true;
+}
+
+UINT ofxGrtPipelineProfiler::getStageIndex( const std::string &name ){
+    for(UINT i=0; i<stages.size(); i++){
+        if( stages[i].name == name ) return i;
+    }
+
+    StageStatistics stage;
+    stage.name = name;
+    stage.count = 0;
+    stage.totalTime = 0;
+    stage.minTime = 0;
+    stage.maxTime = 0;
+    stage.inputSize = 0;
+    stage.outputSize = 0;
+    stage.histogram.resize( NUM_HISTOGRAM_BUCKETS, 0 );
+    stages.push_back( stage );
+
+    return (UINT)stages.size()-1;
+}
+
+const ofxGrtPipelineProfiler::Layout &ofxGrtPipelineProfiler::getLayout( GestureRecognitionPipeline &pipeline ){
+
+    const UINT numPreProcessingModules = pipeline.getNumPreProcessingModules();
+    const UINT numFeatureModules = pipeline.getNumFeatureExtractionModules();
+    const UINT numPostProcessingModules = pipeline.getNumPostProcessingModules();
+    const bool classification = pipeline.getIsPipelineInClassificationMode();
+    const bool regression = !classification && pipeline.getIsPipelineInRegressionMode();
+
+    layoutModules.clear();
+    for(UINT i=0; i<numPreProcessingModules; i++) layoutModules.push_back( pipeline.getPreProcessingModule( i ) );
+    for(UINT i=0; i<numFeatureModules; i++) layoutModules.push_back( pipeline.getFeatureExtractionModule( i ) );
+    layoutModules.push_back( classification ? (const void*)pipeline.getClassifier() : (regression ? (const void*)pipeline.getRegressifier() : NULL) );
+    for(UINT i=0; i<numPostProcessingModules; i++) layoutModules.push_back( pipeline.getPostProcessingModule( i ) );
+
+    if( layoutModules == cachedLayout.modules ) return cachedLayout;
+
+    //The pipeline has changed, so build the stage names once and find (or add) their stages
+    cachedLayout.modules = layoutModules;
+    cachedLayout.preProcessingStages.resize( numPreProcessingModules );
+    for(UINT i=0; i<numPreProcessingModules; i++){
+        cachedLayout.preProcessingStages[i] = getStageIndex( "PreProcessing[" + ofToString( i ) + "] " + pipeline.getPreProcessingModule( i )->getPreProcessingType() );
+    }
+    cachedLayout.featureExtractionStages.resize( numFeatureModules );
+    for(UINT i=0; i<numFeatureModules; i++){
+        cachedLayout.featureExtractionStages[i] = getStageIndex( "FeatureExtraction[" + ofToString( i ) + "] " + pipeline.getFeatureExtractionModule( i )->getFeatureExtractionType() );
+    }
+    cachedLayout.modelStage = 0;
+    if( classification ) cachedLayout.modelStage = getStageIndex( "Classifier " + pipeline.getClassifier()->getClassifierType() );
+    else if( regression ) cachedLayout.modelStage = getStageIndex( "Regressifier " + pipeline.getRegressifier()->getRegressifierType() );
+    cachedLayout.postProcessingStages.resize( numPostProcessingModules );
+    for(UINT i=0; i<numPostProcessingModules; i++){
+        cachedLayout.postProcessingStages[i] = getStageIndex( "PostProcessing[" + ofToString( i ) + "] " + pipeline.getPostProcessingModule( i )->getPostProcessingType() );
+    }
+
+    return cachedLayout;
+}
+
+void ofxGrtPipelineProfiler::record( const UINT stageIndex, const Clock::time_point &start, const Clock::time_point &end, const UINT inputSize, const UINT outputSize ){
+
+    const double duration = std::chrono::duration< double, std::micro >( end - start ).count();
+
+    StageStatistics &stage = stages[ stageIndex ];
+    stage.minTime = stage.count == 0 ? duration : std::min( stage.minTime, duration );
+    stage.maxTime = stage.count == 0 ? duration : std::max( stage.maxTime, duration );
+    stage.totalTime += duration;
+    stage.count++;
+    stage.inputSize = inputSize;
+    stage.outputSize = outputSize;
+
+    UINT bucket = 0;
+    while( bucket+1 < NUM_HISTOGRAM_BUCKETS && duration >= (double)(1u << (bucket+1)) ) bucket++;
+    stage.histogram[ bucket ]++;
+
+    if( maxNumTraceEvents == 0 ) return;
+
+    TraceEvent event;
+    event.stage = stageIndex;
+    event.start = std::chrono::duration< double, std::micro >( start - startTime ).count();
+    event.duration = duration;
+    if( traceEvents.size() < maxNumTraceEvents ){
+        traceEvents.push_back( event );
+    }else{
+        traceEvents[ nextTraceEvent ] = event;
+    }
+    nextTraceEvent = (nextTraceEvent + 1) % maxNumTraceEvents;
+}
+
+bool ofxGrtPipelineProfiler::predictFromStage( GestureRecognitionPipeline &pipeline, const UINT firstFeatureModule ){
+
+    const Layout &layout = getLayout( pipeline );
+    const UINT numFeatureModules = pipeline.getNumFeatureExtractionModules();
+    for(UINT i=firstFeatureModule; i<numFeatureModules; i++){
+        FeatureExtraction *module = pipeline.getFeatureExtractionModule( i );
+        const UINT stage = layout.featureExtractionStages[i];
+
+        const Clock::time_point start = Clock::now();
+        const bool success = module->computeFeatures( data );
+        const Clock::time_point end = Clock::now();
+
+        if( !success ){
+            errorLog << "predict(...) - Failed to run feature extraction module " << i << endl;
+            return false;
+        }
+        const UINT inputSize = (UINT)data.size();
+        data = module->getFeatureVector();
+        record( stage, start, end, inputSize, (UINT)data.size() );
+    }
+
+    //Some feature extraction modules need several samples before they output a feature vector
+    if( numFeatureModules > 0 && !pipeline.getFeatureExtractionModule( numFeatureModules-1 )->getFeatureDataReady() ){
+        return true;
+    }
+
+    const UINT inputSize = (UINT)data.size();
+    if( pipeline.getIsPipelineInClassificationMode() ){
+        Classifier *classifier = pipeline.getClassifier();
+        const UINT stage = layout.modelStage;
+
+        const Clock::time_point start = Clock::now();
+        const bool success = classifier->predict( data );
+        const Clock::time_point end = Clock::now();
+
+        if( !success ){
+            errorLog << "predict(...) - Failed to run the classifier" << endl;
+            return false;
+        }
+        predictedClassLabel = classifier->getPredictedClassLabel();
+        data = classLikelihoods = classifier->getClassLikelihoods();
+        record( stage, start, end, inputSize, (UINT)data.size() );
+    }else if( pipeline.getIsPipelineInRegressionMode() ){
+        Regressifier *regressifier = pipeline.getRegressifier();
+        const UINT stage = layout.modelStage;
+
+        const Clock::time_point start = Clock::now();
+        const bool success = regressifier->predict( data );
+        const Clock::time_point end = Clock::now();
+
+        if( !success ){
+            errorLog << "predict(...) - Failed to run the regressifier" << endl;
+            return false;
+        }
+        data = regressionData = regressifier->getRegressionData();
+        record( stage, start, end, inputSize, (UINT)data.size() );
+    }
+
+    //Post processing works on the class label (or the likelihoods or regression data, depending on the module)
+    for(UINT i=0; i<pipeline.getNumPostProcessingModules(); i++){
+        PostProcessing *module = pipeline.getPostProcessingModule( i );
+        const UINT stage = layout.postProcessingStages[i];
+        const bool labelMode = pipeline.getIsPipelineInClassificationMode() && module->getIsPostProcessingInputModeClassLabel();
+        VectorFloat postInput = labelMode ? VectorFloat( 1, predictedClassLabel ) : data;
+
+        const Clock::time_point start = Clock::now();
+        const bool success = module->process( postInput );
+        const Clock::time_point end = Clock::now();
+
+        if( !success ){
+            errorLog << "predict(...) - Failed to run post processing module " << i << endl;
+            return false;
+        }
+        const VectorFloat output = module->getProcessedData();
+        if( labelMode && output.size() > 0 ) predictedClassLabel = (UINT)output[0];
+        else data = output;
+        record( stage, start, end, (UINT)postInput.size(), (UINT)output.size() );
+    }
+
+    return true;
+}
+
+template< class T >
+bool ofxGrtPipelineProfiler::trainPipeline( GestureRecognitionPipeline &pipeline, T &trainingData, const UINT numSamples ){
+
+    const UINT stage = getStageIndex( "Train" );
+
+    const Clock::time_point start = Clock::now();
+    const bool success = pipeline.train( trainingData );
+    const Clock::time_point end = Clock::now();
+
+    //The outputs of the old model may not even have the same size as the new ones
+    classLikelihoods.clear();
+    regressionData.clear();
+
+    record( stage, start, end, numSamples, success ? (pipeline.getIsPipelineInRegressionMode() ? pipeline.getRegressifier()->getNumOutputDimensions() : pipeline.getNumClasses()) : 0 );
+
+    return success;
+}
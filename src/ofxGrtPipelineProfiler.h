@@ -0,0 +1,180 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <chrono>
+
+#include "ofMain.h"
+
+using namespace GRT;
+
+/**
+ @brief profiles a GestureRecognitionPipeline module by module. predict() runs the pipeline's own pre processing, feature extraction,
+ classification or regression, and post processing modules one at a time (in the same order as pipeline.predict) and times each one, so
+ you can see how long a MovingAverageFilter takes compared with an EnvelopeExtractor or an ANBC classifier. train() times pipeline.train().
+
+ Each stage keeps a latency histogram (with power of two microsecond buckets), its mean, min and max latency, and the size of its input
+ and output. The stages can be drawn with an ofxGrtBarPlot using getMeanLatencies(), printed with getReport(), and the most recent
+ events can be saved as a Chrome trace (chrome://tracing) with saveTrace().
+
+ Because the modules are run directly, the pipeline's own predicted class label is not updated by predict(), use the profiler's getters instead.
+ The stage of each module is looked up once per pipeline layout, and looked up again when the pipeline's modules change.
+*/
+class ofxGrtPipelineProfiler {
+public:
+    static const UINT NUM_HISTOGRAM_BUCKETS = 24;
+
+    struct StageStatistics{
+        std::string name;
+        UINT count;
+        double totalTime;       ///< The total time of the stage in microseconds
+        double minTime;
+        double maxTime;
+        UINT inputSize;         ///< The size of the input to the stage on its last run
+        UINT outputSize;        ///< The size of the output of the stage on its last run
+        vector< UINT > histogram;   ///< Bucket k counts the runs that took [2^k 2^(k+1)) microseconds, bucket 0 also counts runs under 1 microsecond
+
+        double getMeanTime() const { return count > 0 ? totalTime / count : 0; }
+
+        /**
+         @brief estimates a percentile of the latency from the histogram, returning the upper edge of the bucket that contains it
+         @param percentile: the percentile in the range [0 1], for example 0.95
+         @return returns the estimated latency in microseconds
+        */
+        double getPercentileTime( const double percentile ) const;
+    };
+
+    /**
+     @brief creates the profiler
+     @param maxNumTraceEvents: the number of most recent stage runs kept for saveTrace
+    */
+    ofxGrtPipelineProfiler( const UINT maxNumTraceEvents = 10000 );
+    ~ofxGrtPipelineProfiler();
+
+    /**
+     @brief runs the pipeline on a sample stage by stage, timing each module
+     @param pipeline: the trained pipeline
+     @param inputVector: the input sample
+     @return returns true if the prediction was successful, false otherwise
+    */
+    bool predict( GestureRecognitionPipeline &pipeline, const VectorFloat &inputVector );
+
+    /**
+     @brief runs the pipeline on a matrix stage by stage, timing each module. The matrix is passed to the first feature extraction module
+     (such as an FFT), pipelines that need the matrix to go through pre processing are timed as a single stage with pipeline.predict
+     @param pipeline: the trained pipeline
+     @param inputMatrix: the input matrix
+     @return returns true if the prediction was successful, false otherwise
+    */
+    bool predict( GestureRecognitionPipeline &pipeline, const MatrixFloat &inputMatrix );
+
+    /**
+     @brief trains the pipeline and records the training time
+    */
+    bool train( GestureRecognitionPipeline &pipeline, ClassificationData &trainingData );
+    bool train( GestureRecognitionPipeline &pipeline, RegressionData &trainingData );
+    bool train( GestureRecognitionPipeline &pipeline, TimeSeriesClassificationData &trainingData );
+
+    /**
+     @brief removes all the statistics and trace events
+     @return returns true if the profiler was reset successfully, false otherwise
+    */
+    bool reset();
+
+    UINT getNumStages() const { return (UINT)stages.size(); }
+    const StageStatistics &getStageStatistics( const UINT index ) const { return stages[ index ]; }
+    UINT getPredictedClassLabel() const { return predictedClassLabel; }
+
+    /**
+     @brief gets the class likelihoods of the latest sample the classifier ran on. Like the pipeline, these are kept while a feature extraction
+     module is still gathering samples, and are empty until the classifier has run since the pipeline was last trained.
+    */
+    const VectorFloat &getClassLikelihoods() const { return classLikelihoods; }
+
+    /**
+     @brief gets the regression data of the latest sample the regressifier ran on, this is empty until the regressifier has run
+    */
+    const VectorFloat &getRegressionData() const { return regressionData; }
+
+    /**
+     @brief gets the output of the last stage that ran, which is the feature vector (not the likelihoods) if the last feature extraction module was not ready
+    */
+    const VectorFloat &getOutput() const { return data; }
+
+    /**
+     @brief gets the mean latency of each stage in microseconds, in the same order as the stages
+    */
+    vector< float > getMeanLatencies() const;
+
+    /**
+     @brief gets the name of each stage
+    */
+    vector< std::string > getStageNames() const;
+
+    /**
+     @brief gets a human readable summary with one line per stage
+    */
+    std::string getReport() const;
+
+    /**
+     @brief saves the most recent stage runs as a Chrome trace event file
+     @param filename: the name of the file
+     @return returns true if the file was saved successfully, false otherwise
+    */
+    bool saveTrace( const std::string &filename );
+
+protected:
+    typedef std::chrono::high_resolution_clock Clock;
+
+    struct TraceEvent{
+        UINT stage;
+        double start;       ///< Microseconds since the profiler was created
+        double duration;
+    };
+
+    //The stage of each module of the pipeline, the modules are used to spot a change to the pipeline
+    struct Layout{
+        vector< const void* > modules;
+        vector< UINT > preProcessingStages;
+        vector< UINT > featureExtractionStages;
+        vector< UINT > postProcessingStages;
+        UINT modelStage;
+    };
+
+    UINT getStageIndex( const std::string &name );
+    const Layout &getLayout( GestureRecognitionPipeline &pipeline );
+    void record( const UINT stage, const Clock::time_point &start, const Clock::time_point &end, const UINT inputSize, const UINT outputSize );
+    bool predictFromStage( GestureRecognitionPipeline &pipeline, const UINT firstFeatureModule );
+    template< class T > bool trainPipeline( GestureRecognitionPipeline &pipeline, T &trainingData, const UINT numSamples );
+
+    UINT predictedClassLabel;
+    VectorFloat data;
+    VectorFloat classLikelihoods;
+    VectorFloat regressionData;
+    Layout cachedLayout;
+    vector< const void* > layoutModules;      ///< Only used by getLayout, kept to avoid an allocation per sample
+    vector< StageStatistics > stages;
+    vector< TraceEvent > traceEvents;
+    UINT maxNumTraceEvents;
+    UINT nextTraceEvent;
+    Clock::time_point startTime;
+    ErrorLog errorLog;
+};
@@ -0,0 +1,184 @@
+
+#include "ofxGrtPredictor.h"
+#include "ofxGrtModelAccess.h"
+
+using namespace GRT;
+
+ofxGrtPredictor::ofxGrtPredictor(){
+    errorLog.setProceedingText("[ERROR ofxGrtPredictor]");
+    warningLog.setProceedingText("[WARNING ofxGrtPredictor]");
+    pipeline = NULL;
+    classifier = NULL;
+    regressifier = NULL;
+    direct = false;
+    quantized = false;
+    predictedClassLabel = 0;
+    maximumLikelihood = 0;
+    predictedClassLabelVector.resize( 1, 0 );
+    classLikelihoods = &classLikelihoodsCopy;
+    classDistances = &classDistancesCopy;
+    regressionData = &regressionDataCopy;
+}
+
+ofxGrtPredictor::~ofxGrtPredictor(){
+}
+
+bool ofxGrtPredictor::setup( GestureRecognitionPipeline &pipeline, const UINT numInputDimensions ){
+
+    this->pipeline = &pipeline;
+    classifier = pipeline.getIsClassifierSet() ? pipeline.getClassifier() : NULL;
+    regressifier = pipeline.getIsRegressifierSet() ? pipeline.getRegressifier() : NULL;
+    direct = (classifier != NULL || regressifier != NULL) && pipeline.getNumPreProcessingModules() == 0 && pipeline.getNumFeatureExtractionModules() == 0 && pipeline.getNumPostProcessingModules() == 0;
+
+    //Keep the current input size if neither the pipeline nor the caller set one
+    UINT inputSize = pipeline.getTrained() ? pipeline.getInputVectorDimensionsSize() : numInputDimensions;
+    if( inputSize == 0 ) inputSize = (UINT)inputVector.size();
+    inputVector.resize( inputSize, 0 );
+    workVector.resize( inputSize, 0 );
+
+    //Reserve the copies so the pipeline path does not grow them on the first few frames
+    const UINT numClasses = classifier != NULL ? classifier->getNumClasses() : 0;
+    const UINT numOutputs = regressifier != NULL ? regressifier->getNumOutputDimensions() : 0;
+    classLikelihoodsCopy.reserve( numClasses );
+    classDistancesCopy.reserve( numClasses );
+    regressionDataCopy.reserve( numOutputs );
+
+    //Quantize the module if asked to, anything the quantized model does not support keeps running in float
+    quantizedModel.clear();
+    if( quantized && direct && pipeline.getTrained() ){
+        const bool quantizedOk = classifier != NULL ? quantizedModel.setup( *classifier ) : quantizedModel.setup( *regressifier );
+        if( !quantizedOk ){
+            warningLog << "setup(...) - The " << (classifier != NULL ? classifier->getClassifierType() : regressifier->getRegressifierType()) << " module can not be quantized, it will run in float" << endl;
+        }
+    }else if( quantized ){
+        warningLog << "setup(...) - Only trained pipelines with just a classifier or regressifier can be quantized, the pipeline will run in float" << endl;
+    }
+
+    if( quantizedModel.getTrained() ){
+        classLikelihoods = &quantizedModel.getClassLikelihoods();
+        classDistances = &quantizedModel.getClassDistances();
+        regressionData = &quantizedModel.getRegressionData();
+    }else if( direct ){
+        classLikelihoods = classifier != NULL ? &ofxGrtModelAccess::getClassLikelihoods( *classifier ) : &classLikelihoodsCopy;
+        classDistances = classifier != NULL ? &ofxGrtModelAccess::getClassDistances( *classifier ) : &classDistancesCopy;
+        regressionData = regressifier != NULL ? &ofxGrtModelAccess::getRegressionData( *regressifier ) : &regressionDataCopy;
+    }else{
+        classLikelihoods = &classLikelihoodsCopy;
+        classDistances = &classDistancesCopy;
+        regressionData = &regressionDataCopy;
+    }
+
+    return true;
+}
+
+bool ofxGrtPredictor::predict(){
+
+    if( pipeline == NULL ){
+        errorLog << "predict() - The predictor has not been setup!" << endl;
+        return false;
+    }
+
+    if( !pipeline->getTrained() ){
+        errorLog << "predict() - The pipeline has not been trained!" << endl;
+        return false;
+    }
+
+    //The pipeline replaces its module when setClassifier or setRegressifier is called, so follow it
+    Classifier *currentClassifier = pipeline->getIsClassifierSet() ? pipeline->getClassifier() : NULL;
+    Regressifier *currentRegressifier = pipeline->getIsRegressifierSet() ? pipeline->getRegressifier() : NULL;
+    if( currentClassifier != classifier || currentRegressifier != regressifier || inputVector.size() != pipeline->getInputVectorDimensionsSize() ){
+        if( !setup( *pipeline ) ) return false;
+    }
+
+    return direct ? predictDirect() : predictPipeline();
+}
+
+bool ofxGrtPredictor::predict( const VectorFloat &data ){
+
+    if( data.size() != inputVector.size() ){
+        errorLog << "predict(const VectorFloat &data) - The size of the data (" << data.size() << ") does not match the input vector size (" << inputVector.size() << ")" << endl;
+        return false;
+    }
+
+    std::copy( data.begin(), data.end(), inputVector.begin() );
+
+    return predict();
+}
+
+bool ofxGrtPredictor::predict( const float *data, const size_t size ){
+
+    if( size != inputVector.size() ){
+        errorLog << "predict(const float *data, const size_t size) - The size of the data (" << size << ") does not match the input vector size (" << inputVector.size() << ")" << endl;
+        return false;
+    }
+
+    for(size_t i=0; i<size; i++){
+        inputVector[i] = data[i];
+    }
+
+    return predict();
+}
+
+bool ofxGrtPredictor::setQuantized( const bool quantized ){
+
+    this->quantized = quantized;
+
+    //Quantize (or drop the quantized copy of) the current module straight away
+    if( pipeline != NULL ) return setup( *pipeline );
+
+    return true;
+}
+
+bool ofxGrtPredictor::predictDirect(){
+
+    //The quantized model does not change its input, so it runs on the input vector itself
+    if( quantizedModel.getTrained() ){
+        if( !quantizedModel.predict( inputVector ) ) return false;
+        predictedClassLabel = quantizedModel.getPredictedClassLabel();
+        maximumLikelihood = quantizedModel.getMaximumLikelihood();
+        predictedClassLabelVector[0] = predictedClassLabel;
+        return true;
+    }
+
+    std::copy( inputVector.begin(), inputVector.end(), workVector.begin() );
+
+    if( classifier != NULL ){
+        if( !classifier->predict_( workVector ) ) return false;
+        predictedClassLabel = classifier->getPredictedClassLabel();
+        maximumLikelihood = classifier->getMaximumLikelihood();
+    }else{
+        if( !regressifier->predict_( workVector ) ) return false;
+        predictedClassLabel = 0;
+        maximumLikelihood = 0;
+    }
+
+    predictedClassLabelVector[0] = predictedClassLabel;
+
+    return true;
+}
+
+bool ofxGrtPredictor::predictPipeline(){
+
+    if( !pipeline->predict( inputVector ) ) return false;
+
+    predictedClassLabel = pipeline->getPredictedClassLabel();
+    maximumLikelihood = pipeline->getMaximumLikelihood();
+    predictedClassLabelVector[0] = predictedClassLabel;
+
+    //Copy into the existing buffers so references handed out by the getters stay valid
+    if( classifier != NULL ){
+        const VectorFloat likelihoods = pipeline->getClassLikelihoods();
+        const VectorFloat distances = pipeline->getClassDistances();
+        classLikelihoodsCopy.resize( likelihoods.size() );
+        classDistancesCopy.resize( distances.size() );
+        std::copy( likelihoods.begin(), likelihoods.end(), classLikelihoodsCopy.begin() );
+        std::copy( distances.begin(), distances.end(), classDistancesCopy.begin() );
+    }
+    if( regressifier != NULL ){
+        const VectorFloat outputs = pipeline->getRegressionData();
+        regressionDataCopy.resize( outputs.size() );
+        std::copy( outputs.begin(), outputs.end(), regressionDataCopy.begin() );
+    }
+
+    return true;
+}
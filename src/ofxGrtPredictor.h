@@ -0,0 +1,153 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+#include "ofxGrtQuantizedModel.h"
+
+using namespace GRT;
+
+/**
+ @brief wraps a GestureRecognitionPipeline for real-time prediction without any per-frame heap allocations. The predictor owns a preallocated
+ input vector that you fill in place, and the results are returned by const reference instead of by value. If the pipeline only contains a
+ classifier or regressifier then the module is run directly on a preallocated copy of the input, and the results are read straight from the module.
+ Pipelines with pre processing, feature extraction or post processing modules are run through pipeline.predict(), in which case the results are
+ copied into the predictor's buffers (the GRT allocates internally on that path).
+
+ The pipeline is not owned by the predictor and must outlive it. The pipeline's own getters are not updated on the direct path, so use the
+ predictor's getters after calling predict.
+
+ On the direct path the module can also be replaced by an int8 ofxGrtQuantizedModel (see setQuantized), for Softmax, linear, logistic and
+ ofxGrtMLP models. Modules that can not be quantized keep running in float.
+*/
+class ofxGrtPredictor {
+public:
+    ofxGrtPredictor();
+    ~ofxGrtPredictor();
+
+    /**
+     @brief sets up the predictor for a pipeline, allocating the input and result buffers. Call this again if the pipeline is retrained or
+     the classifier or regressifier is changed (predict will also do this automatically if it sees the module has changed).
+     @param pipeline: the pipeline to run, this must stay valid while the predictor is in use
+     @param numInputDimensions: the size of the input vector to allocate if the pipeline has not been trained yet, once it is trained the pipeline's input size is used
+     @return returns true if the predictor was setup successfully, false otherwise
+    */
+    bool setup( GestureRecognitionPipeline &pipeline, const UINT numInputDimensions = 0 );
+
+    /**
+     @brief gets the input vector, fill this in place and then call predict()
+     @return returns a reference to the preallocated input vector
+    */
+    VectorFloat &getInputVector(){ return inputVector; }
+
+    /**
+     @brief runs the pipeline on the current contents of the input vector
+     @return returns true if the prediction was successful, false otherwise
+    */
+    bool predict();
+
+    /**
+     @brief copies the data into the input vector and runs the pipeline
+     @param data: the input data, the size must match the number of input dimensions of the pipeline
+     @return returns true if the prediction was successful, false otherwise
+    */
+    bool predict( const VectorFloat &data );
+
+    /**
+     @brief copies the data into the input vector and runs the pipeline
+     @param data: a pointer to the input data
+     @param size: the number of elements in data, this must match the number of input dimensions of the pipeline
+     @return returns true if the prediction was successful, false otherwise
+    */
+    bool predict( const float *data, const size_t size );
+
+    /**
+     @brief sets if the direct path should run an int8 quantized copy of the module instead of the module itself. The module is quantized
+     in setup, so call setup again after the pipeline has been retrained. Use getQuantizedModel().evaluate to check the accuracy of the
+     quantized model against the float module before enabling this.
+     @param quantized: if true the module is quantized if the pipeline only contains a supported classifier or regressifier
+     @return returns true if the setting was applied successfully, false otherwise
+    */
+    bool setQuantized( const bool quantized );
+
+    bool getIsSetup() const { return pipeline != NULL; }
+    bool getIsDirect() const { return direct; }
+    bool getIsClassifier() const { return classifier != NULL; }
+    bool getIsRegressifier() const { return regressifier != NULL; }
+    bool getIsQuantized() const { return quantizedModel.getTrained(); }
+    UINT getNumInputDimensions() const { return (UINT)inputVector.size(); }
+    UINT getPredictedClassLabel() const { return predictedClassLabel; }
+    Float getMaximumLikelihood() const { return maximumLikelihood; }
+
+    /**
+     @brief gets the predicted class label as a one element vector, which can be passed straight to a plot
+    */
+    const VectorFloat &getPredictedClassLabelVector() const { return predictedClassLabelVector; }
+
+    /**
+     @brief gets the likelihood of each class from the last prediction
+    */
+    const VectorFloat &getClassLikelihoods() const { return *classLikelihoods; }
+
+    /**
+     @brief gets the distance to each class from the last prediction
+    */
+    const VectorFloat &getClassDistances() const { return *classDistances; }
+
+    /**
+     @brief gets the regression output from the last prediction
+    */
+    const VectorFloat &getRegressionData() const { return *regressionData; }
+
+    /**
+     @brief gets the quantized copy of the module, this is only setup if quantization is enabled and the module is supported
+    */
+    const ofxGrtQuantizedModel &getQuantizedModel() const { return quantizedModel; }
+
+protected:
+    bool predictDirect();
+    bool predictPipeline();
+
+    GestureRecognitionPipeline *pipeline;
+    Classifier *classifier;
+    Regressifier *regressifier;
+    bool direct;
+    bool quantized;
+    UINT predictedClassLabel;
+    Float maximumLikelihood;
+
+    VectorFloat inputVector;
+    VectorFloat workVector;                 ///< The module may scale its input in place, so the direct path runs on a copy of the input
+    VectorFloat predictedClassLabelVector;
+
+    //The results point at the module's buffers on the direct path, or at the copies below on the pipeline path
+    const VectorFloat *classLikelihoods;
+    const VectorFloat *classDistances;
+    const VectorFloat *regressionData;
+    VectorFloat classLikelihoodsCopy;
+    VectorFloat classDistancesCopy;
+    VectorFloat regressionDataCopy;
+    ofxGrtQuantizedModel quantizedModel;
+
+    ErrorLog errorLog;
+    WarningLog warningLog;
+};
@@ -0,0 +1,566 @@
+
+#include "ofxGrtQuantizedModel.h"
+#include "ofxGrtModelAccess.h"
+#include "ofxGrtSimd.h"
+#include <chrono>
+#include <cstring>
+
+using namespace GRT;
+
+ofxGrtQuantizedModel::ofxGrtQuantizedModel(){
+    errorLog.setProceedingText("[ERROR ofxGrtQuantizedModel]");
+    warningLog.setProceedingText("[WARNING ofxGrtQuantizedModel]");
+    clear();
+}
+
+ofxGrtQuantizedModel::~ofxGrtQuantizedModel(){
+}
+
+bool ofxGrtQuantizedModel::setup( const Classifier &classifier ){
+
+    clear();
+
+    if( !classifier.getTrained() ){
+        errorLog << "setup(const Classifier &classifier) - The classifier has not been trained!" << endl;
+        return false;
+    }
+
+    const Softmax *softmax = dynamic_cast< const Softmax* >( &classifier );
+    if( softmax == NULL ){
+        errorLog << "setup(const Classifier &classifier) - Only Softmax classifiers can be quantized!" << endl;
+        return false;
+    }
+
+    //Softmax null rejection depends on internal thresholds that are not exposed
+    if( softmax->getNullRejectionEnabled() ){
+        errorLog << "setup(const Classifier &classifier) - Softmax classifiers with null rejection are not supported!" << endl;
+        return false;
+    }
+
+    const Vector< SoftmaxModel > models = softmax->getModels();
+    const UINT N = softmax->getNumInputDimensions();
+    const UINT K = (UINT)models.size();
+    vector< float > weights( (size_t)K * N );
+    vector< float > bias( K );
+    for(UINT k=0; k<K; k++){
+        if( models[k].w.size() != N ){
+            errorLog << "setup(const Classifier &classifier) - The size of the weights of class " << models[k].classLabel << " does not match the number of input dimensions!" << endl;
+            clear();
+            return false;
+        }
+        for(UINT j=0; j<N; j++) weights[ (size_t)k*N + j ] = (float)models[k].w[j];
+        bias[k] = (float)models[k].w0;
+        classLabels.push_back( models[k].classLabel );
+    }
+
+    numInputDimensions = N;
+    numOutputDimensions = 0;
+    layers.resize( 1 );
+    if( !setupLayer( layers[0], &weights[0], &bias[0], K, N, SIGMOID ) || !setInputScaling( softmax->getRanges(), softmax->getScalingEnabled() ) ){
+        clear();
+        return false;
+    }
+
+    classLikelihoods.resize( K, 0 );
+    classDistances.resize( K, 0 );
+    modelType = SOFTMAX_MODEL;
+
+    return true;
+}
+
+bool ofxGrtQuantizedModel::setup( const Regressifier &regressifier ){
+
+    clear();
+
+    if( !regressifier.getTrained() ){
+        errorLog << "setup(const Regressifier &regressifier) - The regressifier has not been trained!" << endl;
+        return false;
+    }
+
+    const UINT N = regressifier.getNumInputDimensions();
+
+    if( const ofxGrtMLP *mlp = dynamic_cast< const ofxGrtMLP* >( &regressifier ) ){
+        //The activation functions are in the same order as the ofxGrtMLP ones
+        const UINT H = mlp->getNumHiddenNeurons();
+        const UINT T = mlp->getNumOutputDimensions();
+        numInputDimensions = N;
+        numOutputDimensions = T;
+        layers.resize( 2 );
+        if( !setupLayer( layers[0], &mlp->getHiddenWeights()[0], &mlp->getHiddenBias()[0], H, N, (ActivationFunction)mlp->getHiddenLayerActivationFunction() ) ||
+            !setupLayer( layers[1], &mlp->getOutputWeights()[0], &mlp->getOutputBias()[0], T, H, (ActivationFunction)mlp->getOutputLayerActivationFunction() ) ||
+            !setInputScaling( mlp->getInputRanges(), mlp->getScalingEnabled() ) ){
+            clear();
+            return false;
+        }
+
+        //The targets were scaled to the range of the output activation function, so scale the outputs back
+        outputScale.assign( T, 1 );
+        outputOffset.assign( T, 0 );
+        if( mlp->getScalingEnabled() ){
+            const Vector< MinMax > targetRanges = mlp->getOutputRanges();
+            float minTarget = 0, maxTarget = 1;
+            mlp->getTargetRange( minTarget, maxTarget );
+            for(UINT n=0; n<T; n++){
+                outputScale[n] = (float)( (targetRanges[n].maxValue - targetRanges[n].minValue) / (maxTarget - minTarget) );
+                outputOffset[n] = (float)( targetRanges[n].minValue - minTarget * outputScale[n] );
+            }
+        }
+
+        regressionData.resize( T, 0 );
+        modelType = MLP_MODEL;
+        return true;
+    }
+
+    //A single linear or logistic model, or a MultidimensionalRegression with one linear or logistic model per output
+    Vector< const Regressifier* > models;
+    const MultidimensionalRegression *mdr = dynamic_cast< const MultidimensionalRegression* >( &regressifier );
+    if( mdr ){
+        const Vector< Regressifier* > &regressifiers = ofxGrtModelAccess::getRegressifiers( *mdr );
+        for(size_t i=0; i<regressifiers.size(); i++) models.push_back( regressifiers[i] );
+    }else models.push_back( &regressifier );
+
+    const bool logistic = models.size() > 0 && dynamic_cast< const LogisticRegression* >( models[0] ) != NULL;
+    const UINT T = (UINT)models.size();
+    const bool mdrScaling = mdr && mdr->getScalingEnabled();
+    const Vector< MinMax > mdrInputRanges = mdr ? mdr->getInputRanges() : Vector< MinMax >();
+    const Vector< MinMax > mdrOutputRanges = mdr ? mdr->getOutputRanges() : Vector< MinMax >();
+
+    //Compose the outer and inner input scaling of each output into one affine map per input, x' = x*s + o, and fold it into the weights
+    vector< double > weights( (size_t)T * N );
+    vector< double > bias( T );
+    vector< double > inputScales( (size_t)T * N );
+    vector< double > inputOffsets( (size_t)T * N );
+    outputScale.assign( T, 1 );
+    outputOffset.assign( T, 0 );
+    for(UINT n=0; n<T; n++){
+        Float w0 = 0;
+        VectorFloat w;
+        const LinearRegression *linear = dynamic_cast< const LinearRegression* >( models[n] );
+        const LogisticRegression *logisticModel = dynamic_cast< const LogisticRegression* >( models[n] );
+        if( linear && !logistic ) ofxGrtModelAccess::getWeights( *linear, w0, w );
+        else if( logisticModel && logistic ) ofxGrtModelAccess::getWeights( *logisticModel, w0, w );
+        else{
+            errorLog << "setup(const Regressifier &regressifier) - Only LinearRegression, LogisticRegression and ofxGrtMLP regressifiers can be quantized!" << endl;
+            clear();
+            return false;
+        }
+
+        if( w.size() != N ){
+            errorLog << "setup(const Regressifier &regressifier) - The size of the weights of output " << n << " does not match the number of input dimensions!" << endl;
+            clear();
+            return false;
+        }
+
+        const bool innerScaling = models[n]->getScalingEnabled();
+        const Vector< MinMax > innerInputRanges = models[n]->getInputRanges();
+        const Vector< MinMax > innerOutputRanges = models[n]->getOutputRanges();
+        bias[n] = w0;
+        for(UINT d=0; d<N; d++){
+            double s = 1, o = 0;
+            if( mdrScaling ){
+                const double range = mdrInputRanges[d].maxValue - mdrInputRanges[d].minValue;
+                s = range != 0 ? 1.0 / range : 0;
+                o = range != 0 ? -mdrInputRanges[d].minValue / range : 0;
+            }
+            if( innerScaling ){
+                const double range = innerInputRanges[d].maxValue - innerInputRanges[d].minValue;
+                const double innerS = range != 0 ? 1.0 / range : 0;
+                const double innerO = range != 0 ? -innerInputRanges[d].minValue / range : 0;
+                s = innerS * s;
+                o = innerS * o + innerO;
+            }
+            inputScales[ (size_t)n*N + d ] = s;
+            inputOffsets[ (size_t)n*N + d ] = o;
+            weights[ (size_t)n*N + d ] = w[d] * s;
+            bias[n] += w[d] * o;
+        }
+
+        //Compose the inner and outer output scaling into y = a*f(x) + b
+        double a = 1, b = 0;
+        if( innerScaling ){
+            a = innerOutputRanges[0].maxValue - innerOutputRanges[0].minValue;
+            b = innerOutputRanges[0].minValue;
+        }
+        if( mdrScaling ){
+            const double range = mdrOutputRanges[n].maxValue - mdrOutputRanges[n].minValue;
+            a = a * range;
+            b = b * range + mdrOutputRanges[n].minValue;
+        }
+        outputScale[n] = (float)a;
+        outputOffset[n] = (float)b;
+    }
+
+    if( T == 0 ){
+        errorLog << "setup(const Regressifier &regressifier) - The regressifier has no outputs!" << endl;
+        clear();
+        return false;
+    }
+
+    //The inputs are quantized more precisely once they are scaled to [0 1], so scale each input with the map of the first output that
+    //uses it and fold what is left of each output's map into its weights: w*(x*s + o) = (w*s/S)*(x*S + O) + w*(o - s*O/S).
+    //Inputs no output uses (constant in the training data) are set to zero, their constant term is already in the bias.
+    vector< double > scales( N, 0 );
+    vector< double > offsets( N, 0 );
+    for(UINT d=0; d<N; d++){
+        for(UINT n=0; n<T && scales[d] == 0; n++){
+            scales[d] = inputScales[ (size_t)n*N + d ];
+            offsets[d] = inputOffsets[ (size_t)n*N + d ];
+        }
+        if( scales[d] == 0 ) offsets[d] = 0;
+    }
+    vector< float > layerWeights( (size_t)T * N );
+    vector< float > layerBias( T );
+    for(UINT n=0; n<T; n++){
+        double b = bias[n];
+        for(UINT d=0; d<N; d++){
+            const double w = scales[d] != 0 ? weights[ (size_t)n*N + d ] / scales[d] : 0;
+            layerWeights[ (size_t)n*N + d ] = (float)w;
+            b -= w * offsets[d];
+        }
+        layerBias[n] = (float)b;
+    }
+    inputScale.assign( scales.begin(), scales.end() );
+    inputOffset.assign( offsets.begin(), offsets.end() );
+
+    numInputDimensions = N;
+    numOutputDimensions = T;
+    layers.resize( 1 );
+    if( !setupLayer( layers[0], &layerWeights[0], &layerBias[0], T, N, logistic ? SIGMOID : LINEAR ) ){
+        clear();
+        return false;
+    }
+
+    regressionData.resize( T, 0 );
+    modelType = logistic ? LOGISTIC_REGRESSION_MODEL : LINEAR_REGRESSION_MODEL;
+
+    return true;
+}
+
+bool ofxGrtQuantizedModel::predict( const VectorFloat &inputVector ){
+
+    if( modelType == NO_MODEL ){
+        errorLog << "predict(const VectorFloat &inputVector) - The model has not been setup!" << endl;
+        return false;
+    }
+
+    if( inputVector.size() != numInputDimensions ){
+        errorLog << "predict(const VectorFloat &inputVector) - The size of the input vector (" << inputVector.size() << ") does not match the num features in the model (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    float *input = &activations[0][0];
+    for(UINT j=0; j<numInputDimensions; j++){
+        input[j] = (float)inputVector[j] * inputScale[j] + inputOffset[j];
+    }
+
+    for(size_t l=0; l<layers.size(); l++){
+        predictLayer( layers[l], &activations[l][0], &activations[l+1][0] );
+    }
+    const float *output = &activations.back()[0];
+
+    if( modelType == SOFTMAX_MODEL ){
+        //Match the GRT Softmax: the sigmoid of each class is normalized by their sum and the best class wins
+        const UINT K = (UINT)classLabels.size();
+        Float sum = 0;
+        Float bestEstimate = -grt_numeric_limits< Float >::max();
+        UINT bestIndex = 0;
+        for(UINT k=0; k<K; k++){
+            const Float estimate = output[k];
+            if( estimate > bestEstimate ){
+                bestEstimate = estimate;
+                bestIndex = k;
+            }
+            classDistances[k] = estimate;
+            classLikelihoods[k] = estimate;
+            sum += estimate;
+        }
+
+        if( sum > 1.0e-5 ){
+            for(UINT k=0; k<K; k++) classLikelihoods[k] /= sum;
+            maximumLikelihood = classLikelihoods[ bestIndex ];
+            predictedClassLabel = classLabels[ bestIndex ];
+        }else{
+            maximumLikelihood = bestEstimate;
+            predictedClassLabel = GRT_DEFAULT_NULL_CLASS_LABEL;
+        }
+        return true;
+    }
+
+    for(UINT n=0; n<numOutputDimensions; n++){
+        regressionData[n] = output[n] * outputScale[n] + outputOffset[n];
+    }
+
+    return true;
+}
+
+bool ofxGrtQuantizedModel::evaluate( Classifier &classifier, const ClassificationData &data, Report &report ){
+
+    if( modelType != SOFTMAX_MODEL ){
+        errorLog << "evaluate(Classifier &classifier, ...) - The model has not been setup with a classifier!" << endl;
+        return false;
+    }
+
+    if( !classifier.getTrained() || classifier.getNumInputDimensions() != numInputDimensions ){
+        errorLog << "evaluate(Classifier &classifier, ...) - The classifier is not trained or does not match the quantized model!" << endl;
+        return false;
+    }
+
+    if( !checkEvaluationData( data.getNumDimensions(), data.getNumSamples(), numInputDimensions ) ) return false;
+
+    memset( &report, 0, sizeof( Report ) );
+    report.numSamples = data.getNumSamples();
+
+    VectorFloat sample( numInputDimensions );
+    for(UINT i=0; i<data.getNumSamples(); i++){
+        const UINT classLabel = data[i].getClassLabel();
+
+        //The classifier may scale its input in place, so it runs on a copy
+        sample = data[i].getSample();
+        auto floatStart = std::chrono::high_resolution_clock::now();
+        if( !classifier.predict_( sample ) ) return false;
+        report.floatPredictionTime += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - floatStart ).count();
+
+        auto quantizedStart = std::chrono::high_resolution_clock::now();
+        if( !predict( data[i].getSample() ) ) return false;
+        report.quantizedPredictionTime += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - quantizedStart ).count();
+
+        const UINT floatClassLabel = classifier.getPredictedClassLabel();
+        if( floatClassLabel == classLabel ) report.numFloatCorrect++;
+        if( predictedClassLabel == classLabel ) report.numQuantizedCorrect++;
+        if( predictedClassLabel == floatClassLabel ) report.numAgreements++;
+
+        const VectorFloat &floatLikelihoods = ofxGrtModelAccess::getClassLikelihoods( classifier );
+        for(size_t k=0; k<floatLikelihoods.size() && k<classLikelihoods.size(); k++){
+            report.maxLikelihoodError = std::max( report.maxLikelihoodError, (Float)fabs( floatLikelihoods[k] - classLikelihoods[k] ) );
+        }
+    }
+
+    this->report = report;
+
+    return true;
+}
+
+bool ofxGrtQuantizedModel::evaluate( Regressifier &regressifier, const RegressionData &data, Report &report ){
+
+    if( modelType == NO_MODEL || modelType == SOFTMAX_MODEL ){
+        errorLog << "evaluate(Regressifier &regressifier, ...) - The model has not been setup with a regressifier!" << endl;
+        return false;
+    }
+
+    if( !regressifier.getTrained() || regressifier.getNumInputDimensions() != numInputDimensions || regressifier.getNumOutputDimensions() != numOutputDimensions ){
+        errorLog << "evaluate(Regressifier &regressifier, ...) - The regressifier is not trained or does not match the quantized model!" << endl;
+        return false;
+    }
+
+    if( !checkEvaluationData( data.getNumInputDimensions(), data.getNumSamples(), numInputDimensions ) ) return false;
+
+    if( data.getNumTargetDimensions() != numOutputDimensions ){
+        errorLog << "evaluate(Regressifier &regressifier, ...) - The number of target dimensions (" << data.getNumTargetDimensions() << ") does not match the number of outputs (" << numOutputDimensions << ")" << endl;
+        return false;
+    }
+
+    memset( &report, 0, sizeof( Report ) );
+    report.numSamples = data.getNumSamples();
+
+    VectorFloat sample( numInputDimensions );
+    double floatSquaredError = 0;
+    double quantizedSquaredError = 0;
+    double outputError = 0;
+    for(UINT i=0; i<data.getNumSamples(); i++){
+        const VectorFloat &target = data[i].getTargetVector();
+
+        sample = data[i].getInputVector();
+        auto floatStart = std::chrono::high_resolution_clock::now();
+        if( !regressifier.predict_( sample ) ) return false;
+        report.floatPredictionTime += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - floatStart ).count();
+
+        auto quantizedStart = std::chrono::high_resolution_clock::now();
+        if( !predict( data[i].getInputVector() ) ) return false;
+        report.quantizedPredictionTime += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - quantizedStart ).count();
+
+        const VectorFloat &floatOutput = ofxGrtModelAccess::getRegressionData( regressifier );
+        for(UINT n=0; n<numOutputDimensions; n++){
+            const double floatError = floatOutput[n] - target[n];
+            const double quantizedError = regressionData[n] - target[n];
+            const double difference = fabs( floatOutput[n] - regressionData[n] );
+            floatSquaredError += floatError * floatError;
+            quantizedSquaredError += quantizedError * quantizedError;
+            outputError += difference;
+            report.maxOutputError = std::max( report.maxOutputError, (Float)difference );
+        }
+    }
+
+    const double numValues = (double)report.numSamples * numOutputDimensions;
+    report.floatRMSError = sqrt( floatSquaredError / numValues );
+    report.quantizedRMSError = sqrt( quantizedSquaredError / numValues );
+    report.meanOutputError = outputError / numValues;
+
+    this->report = report;
+
+    return true;
+}
+
+bool ofxGrtQuantizedModel::clear(){
+    modelType = NO_MODEL;
+    numInputDimensions = 0;
+    numOutputDimensions = 0;
+    layers.clear();
+    inputScale.clear();
+    inputOffset.clear();
+    outputScale.clear();
+    outputOffset.clear();
+    classLabels.clear();
+    activations.clear();
+    quantizedInput.clear();
+    predictedClassLabel = 0;
+    maximumLikelihood = 0;
+    classLikelihoods.clear();
+    classDistances.clear();
+    regressionData.clear();
+    memset( &report, 0, sizeof( Report ) );
+    return true;
+}
+
+std::string ofxGrtQuantizedModel::getModelTypeAsString() const {
+    switch( modelType ){
+        case SOFTMAX_MODEL: return "Softmax";
+        case LINEAR_REGRESSION_MODEL: return "LinearRegression";
+        case LOGISTIC_REGRESSION_MODEL: return "LogisticRegression";
+        case MLP_MODEL: return "MLP";
+        default: break;
+    }
+    return "None";
+}
+
+size_t ofxGrtQuantizedModel::getNumWeights() const {
+    size_t numWeights = 0;
+    for(size_t l=0; l<layers.size(); l++){
+        numWeights += (size_t)layers[l].numOutputs * layers[l].numInputs;
+    }
+    return numWeights;
+}
+
+std::string ofxGrtQuantizedModel::getReport() const {
+    std::stringstream stream;
+    if( modelType == SOFTMAX_MODEL ){
+        stream << "accuracy float=" << ofToString( report.getFloatAccuracy() * 100, 2 ) << "%";
+        stream << " int8=" << ofToString( report.getQuantizedAccuracy() * 100, 2 ) << "%";
+        stream << " delta=" << ofToString( report.getAccuracyDelta() * 100, 2 ) << "%" << endl;
+        stream << "agreement=" << ofToString( report.getAgreement() * 100, 2 ) << "%";
+        stream << " max likelihood error=" << ofToString( report.maxLikelihoodError, 4 ) << endl;
+    }else{
+        stream << "rms error float=" << ofToString( report.floatRMSError, 4 );
+        stream << " int8=" << ofToString( report.quantizedRMSError, 4 );
+        stream << " delta=" << ofToString( report.getRMSErrorDelta(), 4 ) << endl;
+        stream << "output error mean=" << ofToString( report.meanOutputError, 4 );
+        stream << " max=" << ofToString( report.maxOutputError, 4 ) << endl;
+    }
+    stream << "weights float=" << getNumWeights() * sizeof( float ) << "B int8=" << getNumWeights() << "B";
+    stream << " time float=" << ofToString( report.floatPredictionTime, 2 ) << "ms int8=" << ofToString( report.quantizedPredictionTime, 2 ) << "ms" << endl;
+    return stream.str();
+}
+
+bool ofxGrtQuantizedModel::setupLayer( Layer &layer, const float *weights, const float *bias, const UINT numOutputs, const UINT numInputs, const ActivationFunction activation ){
+
+    if( numOutputs == 0 || numInputs == 0 ){
+        errorLog << "setupLayer(...) - The model has no inputs or outputs!" << endl;
+        return false;
+    }
+
+    layer.numInputs = numInputs;
+    layer.numOutputs = numOutputs;
+    layer.stride = (numInputs + 15) / 16 * 16;
+    layer.weights.assign( (size_t)numOutputs * layer.stride, 0 );
+    layer.scales.resize( numOutputs );
+    layer.bias.assign( bias, bias + numOutputs );
+    layer.activation = activation;
+
+    //Symmetric quantization of each row, so the largest weight of the row maps to +-127
+    for(UINT o=0; o<numOutputs; o++){
+        const float *row = weights + (size_t)o * numInputs;
+        float maxValue = 0;
+        for(UINT j=0; j<numInputs; j++) maxValue = std::max( maxValue, (float)fabs( row[j] ) );
+        layer.scales[o] = maxValue / 127.0f;
+        if( maxValue == 0 ) continue;
+        const float inverseScale = 127.0f / maxValue;
+        int8_t *quantizedRow = &layer.weights[ (size_t)o * layer.stride ];
+        for(UINT j=0; j<numInputs; j++){
+            quantizedRow[j] = (int8_t)std::max( -127L, std::min( 127L, lrintf( row[j] * inverseScale ) ) );
+        }
+    }
+
+    //The input of each layer is padded with zeros to the stride, the last buffer holds the output of the model
+    activations.resize( layers.size() + 1 );
+    const size_t index = &layer - &layers[0];
+    activations[ index ].assign( layer.stride, 0 );
+    activations[ index+1 ].assign( std::max( (size_t)numOutputs, activations[ index+1 ].size() ), 0 );
+    quantizedInput.resize( std::max( quantizedInput.size(), (size_t)layer.stride ), 0 );
+
+    return true;
+}
+
+bool ofxGrtQuantizedModel::setInputScaling( const Vector< MinMax > &ranges, const bool useScaling ){
+
+    inputScale.assign( numInputDimensions, 1 );
+    inputOffset.assign( numInputDimensions, 0 );
+
+    if( !useScaling ) return true;
+
+    if( ranges.size() != numInputDimensions ){
+        errorLog << "setInputScaling(...) - The size of the ranges does not match the number of input dimensions!" << endl;
+        return false;
+    }
+
+    //The GRT scales each input to [0 1], x' = (x-min)/(max-min), and maps constant inputs to 0
+    for(UINT d=0; d<numInputDimensions; d++){
+        const double range = ranges[d].maxValue - ranges[d].minValue;
+        inputScale[d] = range != 0 ? (float)(1.0 / range) : 0;
+        inputOffset[d] = range != 0 ? (float)(-ranges[d].minValue / range) : 0;
+    }
+
+    return true;
+}
+
+void ofxGrtQuantizedModel::predictLayer( const Layer &layer, const float *input, float *output ){
+
+    //Quantize the input with one scale for the whole vector, the padding stays zero
+    float maxValue = 0;
+    for(UINT j=0; j<layer.numInputs; j++) maxValue = std::max( maxValue, (float)fabs( input[j] ) );
+    const float inputScale = maxValue / 127.0f;
+    const float inverseScale = maxValue > 0 ? 127.0f / maxValue : 0;
+    int8_t *x = &quantizedInput[0];
+    for(UINT j=0; j<layer.numInputs; j++) x[j] = (int8_t)lrintf( input[j] * inverseScale );
+    for(UINT j=layer.numInputs; j<layer.stride; j++) x[j] = 0;
+
+    for(UINT o=0; o<layer.numOutputs; o++){
+        const int32_t sum = ofxGrtSimd::dot( &layer.weights[ (size_t)o * layer.stride ], x, layer.stride );
+        const float y = (float)sum * (layer.scales[o] * inputScale) + layer.bias[o];
+        switch( layer.activation ){
+            case SIGMOID:
+                //Clamp the input to stop exp overflowing, as the GRT Neuron does
+                output[o] = y < -45.0f ? 0.0f : (y > 45.0f ? 1.0f : 1.0f / (1.0f + exp( -y )));
+                break;
+            case TANH:
+                output[o] = tanh( y );
+                break;
+            default:
+                output[o] = y;
+                break;
+        }
+    }
+}
+
+bool ofxGrtQuantizedModel::checkEvaluationData( const UINT numDimensions, const UINT numSamples, const UINT numModelInputs ) const {
+
+    if( numSamples == 0 ){
+        errorLog << "checkEvaluationData(...) - The test data is empty!" << endl;
+        return false;
+    }
+
+    if( numDimensions != numModelInputs ){
+        errorLog << "checkEvaluationData(...) - The number of dimensions of the test data (" << numDimensions << ") does not match the model (" << numModelInputs << ")" << endl;
+        return false;
+    }
+
+    return true;
+}
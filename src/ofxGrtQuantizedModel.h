@@ -0,0 +1,184 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <stdint.h>
+
+#include "ofMain.h"
+#include "ofxGrtMLP.h"
+
+using namespace GRT;
+
+/**
+ @brief an int8 quantized copy of a trained Softmax, LinearRegression, LogisticRegression (on their own or inside a MultidimensionalRegression)
+ or ofxGrtMLP model, for running many models at once with a quarter of the weight memory. Each layer of the model is a dense matrix of weights,
+ which is quantized after training with one scale per output channel (row): the largest weight of a row maps to 127. At prediction time the
+ (scaled) input of each layer is quantized with one scale per sample, each output is computed with an int8 SIMD dot product accumulated in
+ int32, and the result is converted back to float with the product of the two scales before the bias and activation function are applied.
+
+ The rounding error is usually far below the training error of the model, but it is not zero: use evaluate to compare the quantized model
+ with the float model on a test set before deploying it. The quantized model is independent of the original model, so it needs to be
+ setup again if the model is retrained. Softmax models with null rejection are not supported.
+*/
+class ofxGrtQuantizedModel {
+public:
+    enum ModelType{ NO_MODEL=0, SOFTMAX_MODEL, LINEAR_REGRESSION_MODEL, LOGISTIC_REGRESSION_MODEL, MLP_MODEL };
+    enum ActivationFunction{ LINEAR=0, SIGMOID, TANH };
+
+    //The difference between the float and quantized models on a test set
+    struct Report{
+        UINT numSamples;
+        UINT numFloatCorrect;           ///< The number of samples the float classifier labelled correctly
+        UINT numQuantizedCorrect;       ///< The number of samples the quantized classifier labelled correctly
+        UINT numAgreements;             ///< The number of samples both classifiers gave the same label
+        Float maxLikelihoodError;       ///< The largest difference between a float and quantized class likelihood
+        Float floatRMSError;            ///< The root mean squared error of the float regressifier against the targets
+        Float quantizedRMSError;        ///< The root mean squared error of the quantized regressifier against the targets
+        Float meanOutputError;          ///< The mean absolute difference between the float and quantized regression outputs
+        Float maxOutputError;           ///< The largest absolute difference between the float and quantized regression outputs
+        double floatPredictionTime;     ///< The total time taken by the float model, in milliseconds
+        double quantizedPredictionTime; ///< The total time taken by the quantized model, in milliseconds
+
+        Float getFloatAccuracy() const { return numSamples > 0 ? numFloatCorrect / Float( numSamples ) : 0; }
+        Float getQuantizedAccuracy() const { return numSamples > 0 ? numQuantizedCorrect / Float( numSamples ) : 0; }
+        Float getAccuracyDelta() const { return getQuantizedAccuracy() - getFloatAccuracy(); }
+        Float getAgreement() const { return numSamples > 0 ? numAgreements / Float( numSamples ) : 0; }
+        Float getRMSErrorDelta() const { return quantizedRMSError - floatRMSError; }
+    };
+
+    ofxGrtQuantizedModel();
+    ~ofxGrtQuantizedModel();
+
+    /**
+     @brief quantizes a trained Softmax classifier
+     @param classifier: the trained classifier
+     @return returns true if the classifier was quantized successfully, false if it is not trained or not supported
+    */
+    bool setup( const Classifier &classifier );
+
+    /**
+     @brief quantizes a trained LinearRegression, LogisticRegression, MultidimensionalRegression of either, or ofxGrtMLP
+     @param regressifier: the trained regressifier
+     @return returns true if the regressifier was quantized successfully, false if it is not trained or not supported
+    */
+    bool setup( const Regressifier &regressifier );
+
+    /**
+     @brief predicts the class or regression output of a sample, the results can be accessed with the getters
+     @param inputVector: the sample, the size must match the number of input dimensions of the model
+     @return returns true if the prediction was successful, false otherwise
+    */
+    bool predict( const VectorFloat &inputVector );
+
+    /**
+     @brief compares the quantized model with the float classifier it was quantized from on a test set
+     @param classifier: the float classifier
+     @param data: the test set
+     @param report: the accuracy of both classifiers and how often they agree
+     @return returns true if the models were compared successfully, false otherwise
+    */
+    bool evaluate( Classifier &classifier, const ClassificationData &data, Report &report );
+
+    /**
+     @brief compares the quantized model with the float regressifier it was quantized from on a test set
+     @param regressifier: the float regressifier
+     @param data: the test set
+     @param report: the error of both regressifiers and the difference between their outputs
+     @return returns true if the models were compared successfully, false otherwise
+    */
+    bool evaluate( Regressifier &regressifier, const RegressionData &data, Report &report );
+
+    /**
+     @brief removes the quantized model
+     @return returns true if the model was cleared successfully, false otherwise
+    */
+    bool clear();
+
+    bool getTrained() const { return modelType != NO_MODEL; }
+    ModelType getModelType() const { return modelType; }
+    std::string getModelTypeAsString() const;
+    UINT getNumInputDimensions() const { return numInputDimensions; }
+
+    /**
+     @brief gets the number of regression outputs, this is zero for a classifier
+    */
+    UINT getNumOutputDimensions() const { return numOutputDimensions; }
+
+    UINT getNumClasses() const { return (UINT)classLabels.size(); }
+    UINT getPredictedClassLabel() const { return predictedClassLabel; }
+    Float getMaximumLikelihood() const { return maximumLikelihood; }
+    const VectorFloat &getClassLikelihoods() const { return classLikelihoods; }
+    const VectorFloat &getClassDistances() const { return classDistances; }
+    const VectorFloat &getRegressionData() const { return regressionData; }
+
+    /**
+     @brief gets the number of weights in the model, not counting the biases
+    */
+    size_t getNumWeights() const;
+
+    /**
+     @brief gets the last report from evaluate as text
+    */
+    std::string getReport() const;
+
+protected:
+    //A dense layer, y = activation( W x + b ) with W quantized per row
+    struct Layer{
+        UINT numInputs;
+        UINT numOutputs;
+        UINT stride;                    ///< The row length of the weights, numInputs rounded up to 16 so the kernel has no tail
+        vector< int8_t > weights;       ///< [numOutputs x stride]
+        vector< float > scales;         ///< The scale of each row
+        vector< float > bias;
+        ActivationFunction activation;
+    };
+
+    bool setupLayer( Layer &layer, const float *weights, const float *bias, const UINT numOutputs, const UINT numInputs, const ActivationFunction activation );
+    bool setInputScaling( const Vector< MinMax > &ranges, const bool useScaling );
+    void predictLayer( const Layer &layer, const float *input, float *output );
+    bool checkEvaluationData( const UINT numDimensions, const UINT numSamples, const UINT numModelInputs ) const;
+
+    ModelType modelType;
+    UINT numInputDimensions;
+    UINT numOutputDimensions;
+    vector< Layer > layers;
+
+    //The input scaling, x' = x*inputScale + inputOffset, and the output scaling of regressifiers, y = f(x')*outputScale + outputOffset
+    vector< float > inputScale;
+    vector< float > inputOffset;
+    vector< float > outputScale;
+    vector< float > outputOffset;
+    vector< UINT > classLabels;
+
+    //The buffers used by predict: the float input and output of each layer, and the quantized input
+    vector< vector< float > > activations;
+    vector< int8_t > quantizedInput;
+
+    UINT predictedClassLabel;
+    Float maximumLikelihood;
+    VectorFloat classLikelihoods;
+    VectorFloat classDistances;
+    VectorFloat regressionData;
+    Report report;
+
+    ErrorLog errorLog;
+    WarningLog warningLog;
+};
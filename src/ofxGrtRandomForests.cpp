@@ -0,0 +1,128 @@
+
+#include "ofxGrtRandomForests.h"
+
+using namespace GRT;
+
+//Register the ofxGrtRandomForests module with the Classifier base class
+RegisterClassifierModule< ofxGrtRandomForests > ofxGrtRandomForests::registerModule("ofxGrtRandomForests");
+
+ofxGrtRandomForests::ofxGrtRandomForests(){
+    numBins = 64;
+    numFeaturesPerSplit = 0;
+    seed = 0;
+    trainingTime = 0;
+    classType = "ofxGrtRandomForests";
+    classifierType = classType;
+    debugLog.setProceedingText("[DEBUG ofxGrtRandomForests]");
+    errorLog.setProceedingText("[ERROR ofxGrtRandomForests]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtRandomForests]");
+    warningLog.setProceedingText("[WARNING ofxGrtRandomForests]");
+}
+
+ofxGrtRandomForests::ofxGrtRandomForests( const ofxGrtRandomForests &rhs ) : RandomForests( rhs ) {
+    classType = "ofxGrtRandomForests";
+    classifierType = classType;
+    debugLog.setProceedingText("[DEBUG ofxGrtRandomForests]");
+    errorLog.setProceedingText("[ERROR ofxGrtRandomForests]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtRandomForests]");
+    warningLog.setProceedingText("[WARNING ofxGrtRandomForests]");
+    numBins = rhs.numBins;
+    numFeaturesPerSplit = rhs.numFeaturesPerSplit;
+    seed = rhs.seed;
+    trainingTime = rhs.trainingTime;
+}
+
+ofxGrtRandomForests::~ofxGrtRandomForests(){
+}
+
+ofxGrtRandomForests &ofxGrtRandomForests::operator=( const ofxGrtRandomForests &rhs ){
+    if( this != &rhs ){
+        RandomForests::operator=( rhs );
+        this->numBins = rhs.numBins;
+        this->numFeaturesPerSplit = rhs.numFeaturesPerSplit;
+        this->seed = rhs.seed;
+        this->trainingTime = rhs.trainingTime;
+    }
+    return *this;
+}
+
+bool ofxGrtRandomForests::deepCopyFrom( const Classifier *classifier ){
+
+    if( classifier == NULL ) return false;
+
+    const ofxGrtRandomForests *ptr = dynamic_cast< const ofxGrtRandomForests* >( classifier );
+    if( ptr == NULL ) return false;
+
+    *this = *ptr;
+
+    return true;
+}
+
+bool ofxGrtRandomForests::train_( ClassificationData &trainingData ){
+
+    //Null rejection, validation and other node types need the RandomForests trainer
+    if( useNullRejection || useValidationSet || !ofxGrtForestTrainer::getIsNodeTypeSupported( decisionTreeNode ) ){
+        warningLog << "train_(ClassificationData &trainingData) - Null rejection, validation sets and custom node types are not supported by the parallel trainer, using the RandomForests trainer" << endl;
+        return RandomForests::train_( trainingData );
+    }
+
+    clear();
+
+    const UINT M = trainingData.getNumSamples();
+    const UINT N = trainingData.getNumDimensions();
+    const UINT K = trainingData.getNumClasses();
+
+    if( M == 0 ){
+        errorLog << "train_(ClassificationData &trainingData) - Training data has zero samples!" << endl;
+        return false;
+    }
+
+    if( bootstrappedDatasetWeight <= 0.0 || bootstrappedDatasetWeight > 1.0 ){
+        errorLog << "train_(ClassificationData &trainingData) - Bootstrapped Dataset Weight must be [> 0.0 and <= 1.0]" << endl;
+        return false;
+    }
+
+    ofxGrtForestTrainer trainer;
+    if( !trainer.setup( forestSize, maxDepth, minNumSamplesPerNode, bootstrappedDatasetWeight ) || !trainer.setNumBins( numBins ) ) return false;
+    trainer.setNumFeaturesPerSplit( numFeaturesPerSplit );
+    trainer.setSeed( seed );
+
+    if( !trainer.train( trainingData, useScaling, *decisionTreeNode, forest ) ){
+        errorLog << "train_(ClassificationData &trainingData) - Failed to build the trees!" << endl;
+        clear();
+        return false;
+    }
+
+    numInputDimensions = N;
+    numOutputDimensions = K;
+    numClasses = K;
+    classLabels = trainingData.getClassLabels();
+    ranges = trainingData.getRanges();
+    classLikelihoods.resize( K, 0 );
+    classDistances.resize( K, 0 );
+    trainingTime = trainer.getTrainingTime();
+    trained = true;
+
+    trainingLog << "Built " << forestSize << " trees in " << trainingTime << "ms" << endl;
+
+    return true;
+}
+
+bool ofxGrtRandomForests::setNumBins( const UINT numBins ){
+    if( numBins < 2 || numBins > 256 ){
+        errorLog << "setNumBins(const UINT numBins) - The number of bins must be in the range [2 256]!" << endl;
+        return false;
+    }
+    this->numBins = numBins;
+    return true;
+}
+
+bool ofxGrtRandomForests::setNumFeaturesPerSplit( const UINT numFeaturesPerSplit ){
+    this->numFeaturesPerSplit = numFeaturesPerSplit;
+    return true;
+}
+
+bool ofxGrtRandomForests::setSeed( const uint64_t seed ){
+    this->seed = seed;
+    return true;
+}
@@ -0,0 +1,84 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+#include "ofxGrtForestTrainer.h"
+
+using namespace GRT;
+
+/**
+ @brief a GRT RandomForests classifier that is trained in parallel by ofxGrtForestTrainer. The trees are built concurrently (one task per tree)
+ with histogram binned split finding, and are stored as normal GRT trees, so prediction, saving and loading are exactly the same as RandomForests.
+ The forest size, maximum depth, minimum number of samples per node, bootstrap weight, scaling and node type are taken from the RandomForests
+ settings. Each node searches every split between the bins of the features, so the number of random splits is not used, and features are
+ not removed at each split. The same training data and seed always give the same forest.
+
+ If null rejection or a validation set is enabled, or the node type is not a cluster or threshold node, the forest is trained by RandomForests instead.
+*/
+class ofxGrtRandomForests : public RandomForests {
+public:
+    ofxGrtRandomForests();
+    ofxGrtRandomForests( const ofxGrtRandomForests &rhs );
+    virtual ~ofxGrtRandomForests();
+
+    ofxGrtRandomForests &operator=( const ofxGrtRandomForests &rhs );
+
+    virtual bool deepCopyFrom( const Classifier *classifier );
+    virtual bool train_( ClassificationData &trainingData );
+
+    /**
+     @brief sets the maximum number of bins each feature is split into when searching for splits, in the range [2 256]
+    */
+    bool setNumBins( const UINT numBins );
+
+    /**
+     @brief sets the number of randomly chosen features searched at each node, if zero (the default) every feature is searched
+    */
+    bool setNumFeaturesPerSplit( const UINT numFeaturesPerSplit );
+
+    /**
+     @brief sets the seed used for the bootstrap samples and the random features
+    */
+    bool setSeed( const uint64_t seed );
+
+    UINT getNumBins() const { return numBins; }
+    UINT getNumFeaturesPerSplit() const { return numFeaturesPerSplit; }
+    uint64_t getSeed() const { return seed; }
+
+    /**
+     @brief gets the time taken to build the trees by the last call to train
+     @return returns the training time in milliseconds
+    */
+    double getTrainingTime() const { return trainingTime; }
+
+    using MLBase::train_;
+
+protected:
+    UINT numBins;
+    UINT numFeaturesPerSplit;
+    uint64_t seed;
+    double trainingTime;
+
+private:
+    static RegisterClassifierModule< ofxGrtRandomForests > registerModule;
+};
@@ -0,0 +1,1006 @@
+
+#include "ofxGrtSVM.h"
+#include <chrono>
+
+using namespace GRT;
+
+//Register the classifier with the classifier base class, so pipelines can create and copy it
+RegisterClassifierModule< ofxGrtSVM > ofxGrtSVM::registerModule("ofxGrtSVM");
+
+ofxGrtSVM::ofxGrtSVM( const KernelType kernelType, const bool useScaling, const bool useAutoGamma, const Float gamma, const UINT degree, const Float coef0, const Float C ){
+    this->kernelType = kernelType;
+    this->useScaling = useScaling;
+    this->useAutoGamma = useAutoGamma;
+    this->gamma = gamma;
+    this->degree = degree;
+    this->coef0 = coef0;
+    this->C = C;
+    tolerance = 0.001;
+    cacheSize = 40;
+    useShrinking = true;
+    trainingTime = 0;
+    kernelGamma = 0;
+    numSupportVectors = 0;
+    useNullRejection = false;
+    supportsNullRejection = false;
+    classType = "ofxGrtSVM";
+    classifierType = classType;
+    classifierMode = STANDARD_CLASSIFIER_MODE;
+    debugLog.setProceedingText("[DEBUG ofxGrtSVM]");
+    errorLog.setProceedingText("[ERROR ofxGrtSVM]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtSVM]");
+    warningLog.setProceedingText("[WARNING ofxGrtSVM]");
+}
+
+ofxGrtSVM::ofxGrtSVM( const ofxGrtSVM &rhs ){
+    classType = "ofxGrtSVM";
+    classifierType = classType;
+    classifierMode = STANDARD_CLASSIFIER_MODE;
+    debugLog.setProceedingText("[DEBUG ofxGrtSVM]");
+    errorLog.setProceedingText("[ERROR ofxGrtSVM]");
+    trainingLog.setProceedingText("[TRAINING ofxGrtSVM]");
+    warningLog.setProceedingText("[WARNING ofxGrtSVM]");
+    *this = rhs;
+}
+
+ofxGrtSVM::~ofxGrtSVM(){
+}
+
+ofxGrtSVM &ofxGrtSVM::operator=( const ofxGrtSVM &rhs ){
+    if( this != &rhs ){
+        this->kernelType = rhs.kernelType;
+        this->useAutoGamma = rhs.useAutoGamma;
+        this->gamma = rhs.gamma;
+        this->degree = rhs.degree;
+        this->coef0 = rhs.coef0;
+        this->C = rhs.C;
+        this->tolerance = rhs.tolerance;
+        this->cacheSize = rhs.cacheSize;
+        this->useShrinking = rhs.useShrinking;
+        this->trainingTime = rhs.trainingTime;
+        this->kernelGamma = rhs.kernelGamma;
+        this->numSupportVectors = rhs.numSupportVectors;
+        this->classSupportVectors = rhs.classSupportVectors;
+        this->supportVectors = rhs.supportVectors;
+        this->coefficients = rhs.coefficients;
+        this->rho = rhs.rho;
+        this->supportVectorBlocks = rhs.supportVectorBlocks;
+        this->linearWeights = rhs.linearWeights;
+        this->query = rhs.query;
+        this->kernelValues = rhs.kernelValues;
+        this->decisionValues = rhs.decisionValues;
+        this->votes = rhs.votes;
+
+        //Copy the base classifier variables
+        copyBaseVariables( (Classifier*)&rhs );
+    }
+    return *this;
+}
+
+bool ofxGrtSVM::deepCopyFrom( const Classifier *classifier ){
+
+    if( classifier == NULL ) return false;
+
+    const ofxGrtSVM *ptr = dynamic_cast< const ofxGrtSVM* >( classifier );
+    if( ptr == NULL ) return false;
+
+    *this = *ptr;
+
+    return true;
+}
+
+bool ofxGrtSVM::train_( ClassificationData &trainingData ){
+
+    //Clear any previous models
+    clear();
+
+    const UINT M = trainingData.getNumSamples();
+    const UINT N = trainingData.getNumDimensions();
+    const UINT K = trainingData.getNumClasses();
+
+    if( M == 0 ){
+        errorLog << "train_(ClassificationData &trainingData) - Training data has zero samples!" << endl;
+        return false;
+    }
+
+    if( K < 2 ){
+        errorLog << "train_(ClassificationData &trainingData) - The training data must have at least two classes!" << endl;
+        return false;
+    }
+
+    if( useNullRejection ){
+        warningLog << "train_(ClassificationData &trainingData) - Null rejection is not supported, it will be ignored" << endl;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    numInputDimensions = N;
+    numClasses = K;
+    ranges = trainingData.getRanges();
+    kernelGamma = (float)(useAutoGamma ? 1.0 / N : gamma);
+
+    const Vector< ClassTracker > classTracker = trainingData.getClassTracker();
+    classLabels.resize( numClasses );
+    for(UINT k=0; k<numClasses; k++){
+        classLabels[k] = classTracker[k].classLabel;
+    }
+
+    //Copy the (scaled) samples, the training data is left untouched
+    vector< float > samples( (size_t)M * N );
+    vector< UINT > sampleClassIndices( M );
+    vector< vector< UINT > > classSamples( K );
+    for(UINT i=0; i<M; i++){
+        const UINT classLabel = trainingData[i].getClassLabel();
+        UINT classIndex = 0;
+        while( classIndex < K && classLabels[ classIndex ] != classLabel ) classIndex++;
+        sampleClassIndices[i] = classIndex;
+        classSamples[ classIndex ].push_back( i );
+        for(UINT j=0; j<N; j++){
+            Float value = trainingData[i][j];
+            if( useScaling ) value = MLBase::scale( value, ranges[j].minValue, ranges[j].maxValue, 0, 1 );
+            samples[ (size_t)i*N + j ] = (float)value;
+        }
+    }
+
+    //One binary problem per pair of classes, in the same order as getPairIndex
+    vector< BinaryProblem > problems;
+    for(UINT a=0; a<K; a++){
+        for(UINT b=a+1; b<K; b++){
+            BinaryProblem problem;
+            problem.classA = a;
+            problem.classB = b;
+            problem.numSamplesA = (UINT)classSamples[a].size();
+            problem.samples = classSamples[a];
+            problem.samples.insert( problem.samples.end(), classSamples[b].begin(), classSamples[b].end() );
+            problem.rho = 0;
+            problem.numIterations = 0;
+            problems.push_back( problem );
+        }
+    }
+
+    ofxGrtThreadPool::getSharedPool().parallelFor( 0, problems.size(), 1, [&]( const size_t p, const unsigned int threadIndex ){
+        solve( problems[p], samples );
+    });
+
+    if( !buildModel( samples, sampleClassIndices, problems ) || !updateModel() ){
+        clear();
+        return false;
+    }
+
+    classLikelihoods.resize( numClasses, 0 );
+    classDistances.resize( numClasses, 0 );
+    trained = true;
+    trainingTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+
+    UINT numIterations = 0;
+    for(size_t p=0; p<problems.size(); p++) numIterations += problems[p].numIterations;
+    trainingLog << "Trained " << problems.size() << " pairs in " << trainingTime << "ms, " << numIterations << " iterations, " << numSupportVectors << " support vectors" << endl;
+
+    return true;
+}
+
+bool ofxGrtSVM::predict_( VectorFloat &inputVector ){
+
+    predictedClassLabel = 0;
+    maxLikelihood = 0;
+
+    if( !trained ){
+        errorLog << "predict_(VectorFloat &inputVector) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    if( inputVector.size() != numInputDimensions ){
+        errorLog << "predict_(VectorFloat &inputVector) - The size of the input vector (" << inputVector.size() << ") does not match the num features in the model (" << numInputDimensions << ")" << endl;
+        return false;
+    }
+
+    if( useScaling ){
+        scale( &inputVector[0], &query[0] );
+    }else{
+        for(UINT j=0; j<numInputDimensions; j++) query[j] = (float)inputVector[j];
+    }
+
+    const UINT bestIndex = predictSample( &query[0], kernelValues.size() > 0 ? &kernelValues[0] : NULL, &decisionValues[0], &votes[0], &classLikelihoods[0], &classDistances[0] );
+    predictedClassLabel = classLabels[ bestIndex ];
+    maxLikelihood = classLikelihoods[ bestIndex ];
+    bestDistance = classDistances[ bestIndex ];
+
+    return true;
+}
+
+bool ofxGrtSVM::predict( const Float *inputs, const UINT numSamples, UINT *predictedClassLabels, Float *maximumLikelihoods ) const {
+
+    if( !trained ){
+        errorLog << "predict(const Float *inputs, ...) - The model has not been trained!" << endl;
+        return false;
+    }
+
+    if( inputs == NULL || predictedClassLabels == NULL ){
+        errorLog << "predict(const Float *inputs, ...) - The inputs and predicted class labels can not be NULL!" << endl;
+        return false;
+    }
+
+    const UINT N = numInputDimensions;
+    vector< float > x( N );
+    vector< float > kernelScratch( kernelValues.size() );
+    vector< float > decisionScratch( decisionValues.size() );
+    vector< UINT > voteScratch( numClasses );
+    VectorFloat likelihoods( numClasses );
+
+    for(UINT s=0; s<numSamples; s++){
+        const Float *input = inputs + (size_t)s * N;
+        if( useScaling ){
+            scale( input, &x[0] );
+        }else{
+            for(UINT j=0; j<N; j++) x[j] = (float)input[j];
+        }
+
+        const UINT bestIndex = predictSample( &x[0], kernelScratch.size() > 0 ? &kernelScratch[0] : NULL, &decisionScratch[0], &voteScratch[0], &likelihoods[0], NULL );
+        predictedClassLabels[s] = classLabels[ bestIndex ];
+        if( maximumLikelihoods ) maximumLikelihoods[s] = likelihoods[ bestIndex ];
+    }
+
+    return true;
+}
+
+bool ofxGrtSVM::clear(){
+
+    //Clear the base class
+    Classifier::clear();
+
+    kernelGamma = 0;
+    numSupportVectors = 0;
+    classSupportVectors.clear();
+    supportVectors.clear();
+    coefficients.clear();
+    rho.clear();
+    supportVectorBlocks.clear();
+    linearWeights.clear();
+    query.clear();
+    kernelValues.clear();
+    decisionValues.clear();
+    votes.clear();
+
+    return true;
+}
+
+bool ofxGrtSVM::save( std::fstream &file ) const {
+
+    if( !file.is_open() ){
+        errorLog << "save(fstream &file) - Could not open file to save model!" << endl;
+        return false;
+    }
+
+    file << "GRT_OFXGRTSVM_MODEL_FILE_V1.0\n";
+
+    if( !Classifier::saveBaseSettingsToFile( file ) ){
+        errorLog << "save(fstream &file) - Failed to save classifier base settings to file!" << endl;
+        return false;
+    }
+
+    file << "KernelType: " << kernelType << endl;
+    file << "UseAutoGamma: " << useAutoGamma << endl;
+    file << "Gamma: " << gamma << endl;
+    file << "Degree: " << degree << endl;
+    file << "Coef0: " << coef0 << endl;
+    file << "C: " << C << endl;
+    file << "Tolerance: " << tolerance << endl;
+    file << "CacheSize: " << cacheSize << endl;
+    file << "UseShrinking: " << useShrinking << endl;
+
+    if( trained ){
+        //Write the model with enough digits to read back the exact float values
+        const std::streamsize precision = file.precision( 9 );
+
+        file << "KernelGamma: " << kernelGamma << endl;
+        file << "NumSupportVectors: " << numSupportVectors << endl;
+        file << "ClassSupportVectors:";
+        for(size_t k=0; k<classSupportVectors.size(); k++) file << " " << classSupportVectors[k];
+        file << endl;
+        file << "Rho:";
+        for(size_t p=0; p<rho.size(); p++) file << " " << rho[p];
+        file << endl;
+        file << "SupportVectors:\n";
+        for(UINT s=0; s<numSupportVectors; s++){
+            for(UINT k=0; k+1<numClasses; k++) file << coefficients[ (size_t)k*numSupportVectors + s ] << " ";
+            for(UINT j=0; j<numInputDimensions; j++) file << " " << supportVectors[ (size_t)s*numInputDimensions + j ];
+            file << endl;
+        }
+
+        file.precision( precision );
+    }
+
+    return true;
+}
+
+bool ofxGrtSVM::load( std::fstream &file ){
+
+    clear();
+
+    if( !file.is_open() ){
+        errorLog << "load(fstream &file) - Could not open file to load model!" << endl;
+        return false;
+    }
+
+    std::string word;
+    file >> word;
+    if( word != "GRT_OFXGRTSVM_MODEL_FILE_V1.0" ){
+        errorLog << "load(fstream &file) - Could not find Model File Header!" << endl;
+        return false;
+    }
+
+    if( !Classifier::loadBaseSettingsFromFile( file ) ){
+        errorLog << "load(fstream &file) - Failed to load base settings from file!" << endl;
+        return false;
+    }
+
+    UINT type = 0;
+    file >> word;
+    if( word != "KernelType:" ){ errorLog << "load(fstream &file) - Could not find KernelType!" << endl; return false; }
+    file >> type;
+    file >> word;
+    if( word != "UseAutoGamma:" ){ errorLog << "load(fstream &file) - Could not find UseAutoGamma!" << endl; return false; }
+    file >> useAutoGamma;
+    file >> word;
+    if( word != "Gamma:" ){ errorLog << "load(fstream &file) - Could not find Gamma!" << endl; return false; }
+    file >> gamma;
+    file >> word;
+    if( word != "Degree:" ){ errorLog << "load(fstream &file) - Could not find Degree!" << endl; return false; }
+    file >> degree;
+    file >> word;
+    if( word != "Coef0:" ){ errorLog << "load(fstream &file) - Could not find Coef0!" << endl; return false; }
+    file >> coef0;
+    file >> word;
+    if( word != "C:" ){ errorLog << "load(fstream &file) - Could not find C!" << endl; return false; }
+    file >> C;
+    file >> word;
+    if( word != "Tolerance:" ){ errorLog << "load(fstream &file) - Could not find Tolerance!" << endl; return false; }
+    file >> tolerance;
+    file >> word;
+    if( word != "CacheSize:" ){ errorLog << "load(fstream &file) - Could not find CacheSize!" << endl; return false; }
+    file >> cacheSize;
+    file >> word;
+    if( word != "UseShrinking:" ){ errorLog << "load(fstream &file) - Could not find UseShrinking!" << endl; return false; }
+    file >> useShrinking;
+
+    if( type > RBF_KERNEL ){
+        errorLog << "load(fstream &file) - Unknown kernel type: " << type << endl;
+        return false;
+    }
+    kernelType = (KernelType)type;
+
+    if( !trained ) return true;
+
+    file >> word;
+    if( word != "KernelGamma:" ){ errorLog << "load(fstream &file) - Could not find KernelGamma!" << endl; clear(); return false; }
+    file >> kernelGamma;
+    file >> word;
+    if( word != "NumSupportVectors:" ){ errorLog << "load(fstream &file) - Could not find NumSupportVectors!" << endl; clear(); return false; }
+    file >> numSupportVectors;
+
+    classSupportVectors.resize( numClasses+1 );
+    file >> word;
+    if( word != "ClassSupportVectors:" ){ errorLog << "load(fstream &file) - Could not find ClassSupportVectors!" << endl; clear(); return false; }
+    for(UINT k=0; k<=numClasses; k++) file >> classSupportVectors[k];
+
+    rho.resize( numClasses*(numClasses-1)/2 );
+    file >> word;
+    if( word != "Rho:" ){ errorLog << "load(fstream &file) - Could not find Rho!" << endl; clear(); return false; }
+    for(size_t p=0; p<rho.size(); p++) file >> rho[p];
+
+    file >> word;
+    if( word != "SupportVectors:" ){ errorLog << "load(fstream &file) - Could not find SupportVectors!" << endl; clear(); return false; }
+    coefficients.resize( (size_t)(numClasses-1) * numSupportVectors );
+    supportVectors.resize( (size_t)numSupportVectors * numInputDimensions );
+    for(UINT s=0; s<numSupportVectors; s++){
+        for(UINT k=0; k+1<numClasses; k++) file >> coefficients[ (size_t)k*numSupportVectors + s ];
+        for(UINT j=0; j<numInputDimensions; j++) file >> supportVectors[ (size_t)s*numInputDimensions + j ];
+    }
+
+    if( classSupportVectors[ numClasses ] != numSupportVectors || !updateModel() ){
+        errorLog << "load(fstream &file) - The support vectors are not valid!" << endl;
+        clear();
+        return false;
+    }
+
+    classLikelihoods.resize( numClasses, 0 );
+    classDistances.resize( numClasses, 0 );
+
+    return true;
+}
+
+bool ofxGrtSVM::setKernelType( const KernelType kernelType ){
+    clear();
+    this->kernelType = kernelType;
+    return true;
+}
+
+bool ofxGrtSVM::setGamma( const Float gamma ){
+    if( gamma <= 0 ){
+        errorLog << "setGamma(const Float gamma) - Gamma must be greater than zero!" << endl;
+        return false;
+    }
+    clear();
+    this->gamma = gamma;
+    this->useAutoGamma = false;
+    return true;
+}
+
+bool ofxGrtSVM::setDegree( const UINT degree ){
+    if( degree == 0 ){
+        errorLog << "setDegree(const UINT degree) - The degree must be greater than zero!" << endl;
+        return false;
+    }
+    clear();
+    this->degree = degree;
+    return true;
+}
+
+bool ofxGrtSVM::setCoef0( const Float coef0 ){
+    clear();
+    this->coef0 = coef0;
+    return true;
+}
+
+bool ofxGrtSVM::setC( const Float C ){
+    if( C <= 0 ){
+        errorLog << "setC(const Float C) - C must be greater than zero!" << endl;
+        return false;
+    }
+    clear();
+    this->C = C;
+    return true;
+}
+
+bool ofxGrtSVM::enableAutoGamma( const bool useAutoGamma ){
+    clear();
+    this->useAutoGamma = useAutoGamma;
+    return true;
+}
+
+bool ofxGrtSVM::setTolerance( const Float tolerance ){
+    if( tolerance <= 0 ){
+        errorLog << "setTolerance(const Float tolerance) - The tolerance must be greater than zero!" << endl;
+        return false;
+    }
+    this->tolerance = tolerance;
+    return true;
+}
+
+bool ofxGrtSVM::setCacheSize( const UINT cacheSize ){
+    this->cacheSize = cacheSize;
+    return true;
+}
+
+bool ofxGrtSVM::setUseShrinking( const bool useShrinking ){
+    this->useShrinking = useShrinking;
+    return true;
+}
+
+ofxGrtSVM::KernelCache::KernelCache( const ofxGrtSVM &svm, const float *samples, const signed char *y, const UINT numSamples, const size_t maxBytes ) : svm( svm ){
+    this->samples = samples;
+    this->y = y;
+    this->numSamples = numSamples;
+
+    //Keep at least two rows, as each SMO step needs the rows of both working samples at the same time
+    const size_t rowBytes = std::max( (size_t)1, (size_t)numSamples * sizeof(float) );
+    maxNumRows = (UINT)std::min( (size_t)numSamples, std::max( (size_t)2, maxBytes / rowBytes ) );
+    rowSlot.assign( numSamples, -1 );
+    rows.reserve( (size_t)maxNumRows * numSamples );   //The rows never move, so the row pointers stay valid until they are evicted
+    head = -1;
+    tail = -1;
+
+    const UINT N = svm.numInputDimensions;
+    diagonal.resize( numSamples );
+    for(UINT i=0; i<numSamples; i++){
+        diagonal[i] = svm.kernel( samples + (size_t)i*N, samples + (size_t)i*N );
+    }
+}
+
+const float *ofxGrtSVM::KernelCache::getRow( const UINT i ){
+
+    int slot = rowSlot[i];
+
+    if( slot >= 0 ){
+        //Move the row to the front of the LRU list
+        if( slot != head ){
+            next[ prev[slot] ] = next[slot];
+            if( next[slot] >= 0 ) prev[ next[slot] ] = prev[slot];
+            else tail = prev[slot];
+            prev[slot] = -1;
+            next[slot] = head;
+            prev[head] = slot;
+            head = slot;
+        }
+        return &rows[ (size_t)slot * numSamples ];
+    }
+
+    if( slotRow.size() < maxNumRows ){
+        //Grow the cache until it reaches its maximum size
+        slot = (int)slotRow.size();
+        slotRow.push_back( i );
+        prev.push_back( -1 );
+        next.push_back( head );
+        rows.resize( rows.size() + numSamples );
+        if( head >= 0 ) prev[head] = slot;
+        else tail = slot;
+        head = slot;
+    }else{
+        //Reuse the least recently used row
+        slot = tail;
+        rowSlot[ slotRow[slot] ] = -1;
+        slotRow[slot] = i;
+        if( slot != head ){
+            tail = prev[slot];
+            next[tail] = -1;
+            prev[slot] = -1;
+            next[slot] = head;
+            prev[head] = slot;
+            head = slot;
+        }
+    }
+    rowSlot[i] = slot;
+
+    const UINT N = svm.numInputDimensions;
+    const float *x = samples + (size_t)i*N;
+    float *row = &rows[ (size_t)slot * numSamples ];
+    for(UINT t=0; t<numSamples; t++){
+        const float k = svm.kernel( x, samples + (size_t)t*N );
+        row[t] = y[i] == y[t] ? k : -k;
+    }
+
+    return row;
+}
+
+bool ofxGrtSVM::solve( BinaryProblem &problem, const vector< float > &samples ) const {
+
+    //SMO with second order working set selection and shrinking (Fan, Chen and Lin 2005), following the LIBSVM solver.
+    //The dual is min 0.5*a'Qa - e'a subject to 0 <= a <= C and y'a = 0, with Q_ij = y_i*y_j*K(x_i,x_j).
+    const UINT N = numInputDimensions;
+    const UINT l = (UINT)problem.samples.size();
+    const double eps = tolerance;
+    const double upperBound = C;
+    const double TAU = 1.0e-12;
+    const UINT maxNumIterations = std::max( (UINT)10000000, l > 42949672 ? (UINT)4294967295u : 100*l );
+
+    vector< float > x( (size_t)l * N );
+    vector< signed char > y( l );
+    for(UINT t=0; t<l; t++){
+        std::copy( samples.begin() + (size_t)problem.samples[t]*N, samples.begin() + (size_t)(problem.samples[t]+1)*N, x.begin() + (size_t)t*N );
+        y[t] = t < problem.numSamplesA ? 1 : -1;
+    }
+
+    KernelCache cache( *this, &x[0], &y[0], l, (size_t)cacheSize * 1024 * 1024 );
+    vector< double > alpha( l, 0 );
+    vector< double > G( l, -1 );        ///< The gradient Qa - e
+    vector< double > Gbar( l, 0 );      ///< The part of the gradient from the samples at the upper bound, C*sum(Q_j) for a_j = C
+    vector< UINT > active( l );
+    for(UINT t=0; t<l; t++) active[t] = t;
+    bool unshrunk = false;
+
+    auto isUpperBound = [&]( const UINT t ){ return alpha[t] >= upperBound; };
+    auto isLowerBound = [&]( const UINT t ){ return alpha[t] <= 0; };
+
+    //Selects i from the maximal violating samples, then j to give the largest decrease of the objective
+    auto selectWorkingSet = [&]( int &outI, int &outJ ){
+        double Gmax = -grt_numeric_limits< double >::max();
+        double Gmax2 = -grt_numeric_limits< double >::max();
+        int maxIndex = -1;
+        int minIndex = -1;
+        double minObjective = grt_numeric_limits< double >::max();
+
+        for(size_t a=0; a<active.size(); a++){
+            const UINT t = active[a];
+            if( y[t] == 1 ){
+                if( !isUpperBound( t ) && -G[t] >= Gmax ){ Gmax = -G[t]; maxIndex = (int)t; }
+            }else{
+                if( !isLowerBound( t ) && G[t] >= Gmax ){ Gmax = G[t]; maxIndex = (int)t; }
+            }
+        }
+
+        const float *Qi = maxIndex >= 0 ? cache.getRow( (UINT)maxIndex ) : NULL;
+
+        for(size_t a=0; a<active.size(); a++){
+            const UINT t = active[a];
+            if( y[t] == 1 ){
+                if( !isLowerBound( t ) ){
+                    const double gradientDiff = Gmax + G[t];
+                    if( G[t] >= Gmax2 ) Gmax2 = G[t];
+                    if( gradientDiff > 0 && Qi ){
+                        const double quad = cache.getDiagonal( (UINT)maxIndex ) + cache.getDiagonal( t ) - 2.0 * y[ maxIndex ] * Qi[t];
+                        const double objective = -(gradientDiff * gradientDiff) / (quad > 0 ? quad : TAU);
+                        if( objective <= minObjective ){ minIndex = (int)t; minObjective = objective; }
+                    }
+                }
+            }else{
+                if( !isUpperBound( t ) ){
+                    const double gradientDiff = Gmax - G[t];
+                    if( -G[t] >= Gmax2 ) Gmax2 = -G[t];
+                    if( gradientDiff > 0 && Qi ){
+                        const double quad = cache.getDiagonal( (UINT)maxIndex ) + cache.getDiagonal( t ) + 2.0 * y[ maxIndex ] * Qi[t];
+                        const double objective = -(gradientDiff * gradientDiff) / (quad > 0 ? quad : TAU);
+                        if( objective <= minObjective ){ minIndex = (int)t; minObjective = objective; }
+                    }
+                }
+            }
+        }
+
+        if( Gmax + Gmax2 < eps || minIndex < 0 ) return false;
+
+        outI = maxIndex;
+        outJ = minIndex;
+        return true;
+    };
+
+    //Recomputes the gradient of the shrunk samples and makes every sample active again
+    auto reconstructGradient = [&](){
+        if( active.size() == l ) return;
+        vector< char > isActive( l, 0 );
+        for(size_t a=0; a<active.size(); a++) isActive[ active[a] ] = 1;
+        for(UINT t=0; t<l; t++){
+            if( !isActive[t] ) G[t] = Gbar[t] - 1;
+        }
+        for(size_t a=0; a<active.size(); a++){
+            const UINT j = active[a];
+            if( isUpperBound( j ) || isLowerBound( j ) ) continue;
+            const float *Qj = cache.getRow( j );
+            for(UINT t=0; t<l; t++){
+                if( !isActive[t] ) G[t] += alpha[j] * Qj[t];
+            }
+        }
+        active.resize( l );
+        for(UINT t=0; t<l; t++) active[t] = t;
+    };
+
+    //Removes the samples at a bound whose gradient says they will stay there
+    auto shrink = [&](){
+        double Gmax1 = -grt_numeric_limits< double >::max();
+        double Gmax2 = -grt_numeric_limits< double >::max();
+        for(size_t a=0; a<active.size(); a++){
+            const UINT t = active[a];
+            if( y[t] == 1 ){
+                if( !isUpperBound( t ) ) Gmax1 = std::max( Gmax1, -G[t] );
+                if( !isLowerBound( t ) ) Gmax2 = std::max( Gmax2, G[t] );
+            }else{
+                if( !isUpperBound( t ) ) Gmax2 = std::max( Gmax2, -G[t] );
+                if( !isLowerBound( t ) ) Gmax1 = std::max( Gmax1, G[t] );
+            }
+        }
+
+        //Close to the solution, bring every sample back once so the final shrinking decisions use the exact gradient
+        if( !unshrunk && Gmax1 + Gmax2 <= eps*10 ){
+            unshrunk = true;
+            reconstructGradient();
+        }
+
+        size_t a = 0;
+        while( a < active.size() ){
+            const UINT t = active[a];
+            bool remove = false;
+            if( isUpperBound( t ) ) remove = y[t] == 1 ? -G[t] > Gmax1 : -G[t] > Gmax2;
+            else if( isLowerBound( t ) ) remove = y[t] == 1 ? G[t] > Gmax2 : G[t] > Gmax1;
+            if( remove ){
+                active[a] = active.back();
+                active.pop_back();
+            }else a++;
+        }
+    };
+
+    UINT iteration = 0;
+    UINT counter = std::min( l, (UINT)1000 ) + 1;
+    while( iteration < maxNumIterations ){
+
+        if( --counter == 0 ){
+            counter = std::min( l, (UINT)1000 );
+            if( useShrinking ) shrink();
+        }
+
+        int i = -1, j = -1;
+        if( !selectWorkingSet( i, j ) ){
+            //Check the shrunk samples before stopping
+            reconstructGradient();
+            if( !selectWorkingSet( i, j ) ) break;
+            counter = 1;
+        }
+
+        iteration++;
+
+        //Solve the two variable sub problem analytically, then clip it to the box
+        const float *Qi = cache.getRow( (UINT)i );
+        const float *Qj = cache.getRow( (UINT)j );
+        const double oldAlphaI = alpha[i];
+        const double oldAlphaJ = alpha[j];
+        double alphaI = oldAlphaI;
+        double alphaJ = oldAlphaJ;
+
+        if( y[i] != y[j] ){
+            double quad = cache.getDiagonal( i ) + cache.getDiagonal( j ) + 2.0 * Qi[j];
+            if( quad <= 0 ) quad = TAU;
+            const double delta = (-G[i] - G[j]) / quad;
+            const double diff = alphaI - alphaJ;
+            alphaI += delta;
+            alphaJ += delta;
+            if( diff > 0 ){
+                if( alphaJ < 0 ){ alphaJ = 0; alphaI = diff; }
+            }else{
+                if( alphaI < 0 ){ alphaI = 0; alphaJ = -diff; }
+            }
+            if( diff > 0 ){
+                if( alphaI > upperBound ){ alphaI = upperBound; alphaJ = upperBound - diff; }
+            }else{
+                if( alphaJ > upperBound ){ alphaJ = upperBound; alphaI = upperBound + diff; }
+            }
+        }else{
+            double quad = cache.getDiagonal( i ) + cache.getDiagonal( j ) - 2.0 * Qi[j];
+            if( quad <= 0 ) quad = TAU;
+            const double delta = (G[i] - G[j]) / quad;
+            const double sum = alphaI + alphaJ;
+            alphaI -= delta;
+            alphaJ += delta;
+            if( sum > upperBound ){
+                if( alphaI > upperBound ){ alphaI = upperBound; alphaJ = sum - upperBound; }
+            }else{
+                if( alphaJ < 0 ){ alphaJ = 0; alphaI = sum; }
+            }
+            if( sum > upperBound ){
+                if( alphaJ > upperBound ){ alphaJ = upperBound; alphaI = sum - upperBound; }
+            }else{
+                if( alphaI < 0 ){ alphaI = 0; alphaJ = sum; }
+            }
+        }
+
+        const bool wasUpperI = isUpperBound( i );
+        const bool wasUpperJ = isUpperBound( j );
+        alpha[i] = alphaI;
+        alpha[j] = alphaJ;
+
+        //Update the gradient of the active samples
+        const double deltaI = alphaI - oldAlphaI;
+        const double deltaJ = alphaJ - oldAlphaJ;
+        for(size_t a=0; a<active.size(); a++){
+            const UINT t = active[a];
+            G[t] += Qi[t] * deltaI + Qj[t] * deltaJ;
+        }
+
+        //Keep the upper bound part of the gradient up to date for every sample, so the shrunk gradients can be reconstructed
+        if( wasUpperI != isUpperBound( i ) ){
+            const float *Q = cache.getRow( (UINT)i );
+            const double c = wasUpperI ? -upperBound : upperBound;
+            for(UINT t=0; t<l; t++) Gbar[t] += c * Q[t];
+        }
+        if( wasUpperJ != isUpperBound( j ) ){
+            const float *Q = cache.getRow( (UINT)j );
+            const double c = wasUpperJ ? -upperBound : upperBound;
+            for(UINT t=0; t<l; t++) Gbar[t] += c * Q[t];
+        }
+    }
+
+    if( iteration >= maxNumIterations ){
+        warningLog << "solve(...) - Reached the maximum number of iterations for classes " << problem.classA << " and " << problem.classB << endl;
+    }
+
+    reconstructGradient();
+
+    //The bias is the mean of y*G over the free samples, or the middle of the feasible range if there are none
+    double upper = grt_numeric_limits< double >::max();
+    double lower = -grt_numeric_limits< double >::max();
+    double sumFree = 0;
+    UINT numFree = 0;
+    for(UINT t=0; t<l; t++){
+        const double yG = y[t] * G[t];
+        if( isUpperBound( t ) ){
+            if( y[t] == -1 ) upper = std::min( upper, yG );
+            else lower = std::max( lower, yG );
+        }else if( isLowerBound( t ) ){
+            if( y[t] == 1 ) upper = std::min( upper, yG );
+            else lower = std::max( lower, yG );
+        }else{
+            numFree++;
+            sumFree += yG;
+        }
+    }
+
+    problem.rho = numFree > 0 ? sumFree / numFree : (upper + lower) / 2;
+    problem.alpha = alpha;
+    problem.numIterations = iteration;
+
+    return true;
+}
+
+bool ofxGrtSVM::buildModel( const vector< float > &samples, const vector< UINT > &sampleClassIndices, const vector< BinaryProblem > &problems ){
+
+    const UINT M = (UINT)sampleClassIndices.size();
+    const UINT N = numInputDimensions;
+    const UINT K = numClasses;
+
+    //A sample is a support vector if it has a non zero alpha in any pair
+    vector< char > isSupportVector( M, 0 );
+    for(size_t p=0; p<problems.size(); p++){
+        for(size_t t=0; t<problems[p].samples.size(); t++){
+            if( problems[p].alpha[t] > 0 ) isSupportVector[ problems[p].samples[t] ] = 1;
+        }
+    }
+
+    //Group the support vectors by class, keeping the order of the training data within each class
+    vector< int > supportVectorIndex( M, -1 );
+    classSupportVectors.assign( K+1, 0 );
+    numSupportVectors = 0;
+    for(UINT k=0; k<K; k++){
+        classSupportVectors[k] = numSupportVectors;
+        for(UINT i=0; i<M; i++){
+            if( isSupportVector[i] && sampleClassIndices[i] == k ) supportVectorIndex[i] = (int)numSupportVectors++;
+        }
+    }
+    classSupportVectors[K] = numSupportVectors;
+
+    if( numSupportVectors == 0 ){
+        errorLog << "buildModel(...) - The model has no support vectors!" << endl;
+        return false;
+    }
+
+    supportVectors.resize( (size_t)numSupportVectors * N );
+    for(UINT i=0; i<M; i++){
+        if( supportVectorIndex[i] >= 0 ){
+            std::copy( samples.begin() + (size_t)i*N, samples.begin() + (size_t)(i+1)*N, supportVectors.begin() + (size_t)supportVectorIndex[i]*N );
+        }
+    }
+
+    //In pair (a,b) the coefficients of the class a support vectors are stored in row b-1, and those of class b in row a, as in LIBSVM
+    coefficients.assign( (size_t)(K-1) * numSupportVectors, 0 );
+    rho.resize( problems.size() );
+    for(size_t p=0; p<problems.size(); p++){
+        const BinaryProblem &problem = problems[p];
+        rho[ getPairIndex( problem.classA, problem.classB ) ] = (float)problem.rho;
+        for(size_t t=0; t<problem.samples.size(); t++){
+            if( problem.alpha[t] <= 0 ) continue;
+            const size_t s = (size_t)supportVectorIndex[ problem.samples[t] ];
+            if( t < problem.numSamplesA ) coefficients[ (size_t)(problem.classB-1)*numSupportVectors + s ] = (float)problem.alpha[t];
+            else coefficients[ (size_t)problem.classA*numSupportVectors + s ] = (float)-problem.alpha[t];
+        }
+    }
+
+    return true;
+}
+
+bool ofxGrtSVM::updateModel(){
+
+    const UINT N = numInputDimensions;
+    const UINT K = numClasses;
+    const UINT W = ofxGrtSimd::WIDTH;
+    const UINT numPairs = K*(K-1)/2;
+
+    if( K < 2 || classSupportVectors.size() != K+1 || rho.size() != numPairs ) return false;
+
+    query.resize( N );
+    decisionValues.resize( numPairs );
+    votes.resize( K );
+    supportVectorBlocks.clear();
+    linearWeights.clear();
+    kernelValues.clear();
+
+    if( kernelType == LINEAR_KERNEL ){
+        //The decision function of each pair is sum(coef*sv).x - rho, so collapse the support vectors into one weight vector per pair
+        linearWeights.assign( (size_t)numPairs * N, 0 );
+        for(UINT a=0; a<K; a++){
+            for(UINT b=a+1; b<K; b++){
+                float *w = &linearWeights[ (size_t)getPairIndex( a, b ) * N ];
+                for(UINT s=classSupportVectors[a]; s<classSupportVectors[a+1]; s++){
+                    ofxGrtSimd::axpy( w, coefficients[ (size_t)(b-1)*numSupportVectors + s ], &supportVectors[ (size_t)s*N ], N );
+                }
+                for(UINT s=classSupportVectors[b]; s<classSupportVectors[b+1]; s++){
+                    ofxGrtSimd::axpy( w, coefficients[ (size_t)a*numSupportVectors + s ], &supportVectors[ (size_t)s*N ], N );
+                }
+            }
+        }
+        return true;
+    }
+
+    //Store the support vectors in blocks of four, dimension by dimension, so four kernel values are computed at once
+    const UINT numBlocks = (numSupportVectors + W - 1) / W;
+    supportVectorBlocks.assign( (size_t)numBlocks * N * W, 0 );
+    for(UINT s=0; s<numSupportVectors; s++){
+        for(UINT j=0; j<N; j++){
+            supportVectorBlocks[ ((size_t)(s/W)*N + j)*W + s%W ] = supportVectors[ (size_t)s*N + j ];
+        }
+    }
+    kernelValues.resize( (size_t)numBlocks * W );
+
+    return true;
+}
+
+float ofxGrtSVM::kernel( const float *a, const float *b ) const {
+    switch( kernelType ){
+        case POLY_KERNEL:
+            return (float)pow( kernelGamma * ofxGrtSimd::dot( a, b, numInputDimensions ) + coef0, (Float)degree );
+        case RBF_KERNEL:
+            return exp( -kernelGamma * ofxGrtSimd::squaredDistance( a, b, numInputDimensions ) );
+        default:
+            break;
+    }
+    return ofxGrtSimd::dot( a, b, numInputDimensions );
+}
+
+void ofxGrtSVM::scale( const Float *input, float *scaledInput ) const {
+    for(UINT j=0; j<numInputDimensions; j++){
+        const Float minValue = ranges[j].minValue;
+        const Float maxValue = ranges[j].maxValue;
+        scaledInput[j] = (float)(minValue == maxValue ? 0 : (((input[j]-minValue)*(1.0-0.0))/(maxValue-minValue))+0.0);
+    }
+}
+
+UINT ofxGrtSVM::predictSample( const float *x, float *kernelValues, float *decisionValues, UINT *votes, Float *classLikelihoods, Float *classDistances ) const {
+
+    using namespace ofxGrtSimd;
+
+    const UINT N = numInputDimensions;
+    const UINT K = numClasses;
+    const UINT S = numSupportVectors;
+
+    if( kernelType == LINEAR_KERNEL ){
+        for(size_t p=0; p<rho.size(); p++){
+            decisionValues[p] = dot( &linearWeights[ p*N ], x, N ) - rho[p];
+        }
+    }else{
+        //The kernel value of every support vector, four at a time
+        const UINT numBlocks = (S + WIDTH - 1) / WIDTH;
+        for(UINT b=0; b<numBlocks; b++){
+            const float *block = &supportVectorBlocks[ (size_t)b*N*WIDTH ];
+            float4 acc = set1( 0 );
+            if( kernelType == RBF_KERNEL ){
+                for(UINT j=0; j<N; j++){
+                    const float4 delta = sub( set1( x[j] ), ofxGrtSimd::load( block + j*WIDTH ) );
+                    acc = madd( delta, delta, acc );
+                }
+            }else{
+                for(UINT j=0; j<N; j++){
+                    acc = madd( set1( x[j] ), ofxGrtSimd::load( block + j*WIDTH ), acc );
+                }
+            }
+            store( kernelValues + b*WIDTH, acc );
+        }
+        for(UINT s=0; s<S; s++){
+            kernelValues[s] = kernelType == RBF_KERNEL ? exp( -kernelGamma * kernelValues[s] ) : (float)pow( kernelGamma * kernelValues[s] + coef0, (Float)degree );
+        }
+
+        //Each pair only uses the support vectors of its two classes
+        for(UINT a=0; a<K; a++){
+            const UINT beginA = classSupportVectors[a];
+            const UINT sizeA = classSupportVectors[a+1] - beginA;
+            for(UINT b=a+1; b<K; b++){
+                const UINT beginB = classSupportVectors[b];
+                const UINT sizeB = classSupportVectors[b+1] - beginB;
+                decisionValues[ getPairIndex( a, b ) ] = dot( &coefficients[ (size_t)(b-1)*S + beginA ], kernelValues + beginA, sizeA ) +
+                                                         dot( &coefficients[ (size_t)a*S + beginB ], kernelValues + beginB, sizeB ) - rho[ getPairIndex( a, b ) ];
+            }
+        }
+    }
+
+    //One vote per pair, the likelihoods are the normalized sum of the soft votes
+    for(UINT k=0; k<K; k++){
+        votes[k] = 0;
+        classLikelihoods[k] = 0;
+        if( classDistances ) classDistances[k] = 0;
+    }
+    for(UINT a=0; a<K; a++){
+        for(UINT b=a+1; b<K; b++){
+            const float f = decisionValues[ getPairIndex( a, b ) ];
+            const Float p = 1.0 / (1.0 + exp( -(Float)f ));
+            votes[ f > 0 ? a : b ]++;
+            classLikelihoods[a] += p;
+            classLikelihoods[b] += 1.0 - p;
+            if( classDistances ){
+                classDistances[a] += f;
+                classDistances[b] -= f;
+            }
+        }
+    }
+
+    const Float norm = 2.0 / (K*(K-1));
+    UINT bestIndex = 0;
+    for(UINT k=0; k<K; k++){
+        classLikelihoods[k] *= norm;
+        if( votes[k] > votes[ bestIndex ] ) bestIndex = k;
+    }
+
+    return bestIndex;
+}
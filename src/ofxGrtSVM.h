@@ -0,0 +1,192 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+#include "ofxGrtSimd.h"
+#include "ofxGrtThreadPool.h"
+
+using namespace GRT;
+
+/**
+ @brief a C-SVC support vector machine classifier that can be used in a GestureRecognitionPipeline (like the GRT SVM). Multiclass problems
+ are split into one binary problem per pair of classes (one-vs-one), and the pairs are trained in parallel on the shared ofxGrtThreadPool.
+ Each pair is solved with SMO, using second order working set selection, an LRU cache of kernel rows and shrinking (see setCacheSize and
+ setUseShrinking), as in LIBSVM.
+
+ The support vectors are stored once, grouped by class, with one coefficient per support vector for each other class. For prediction the kernel
+ value of each support vector is computed once, four support vectors at a time with ofxGrtSimd, and each pair's decision value is a SIMD dot
+ product of its coefficients with the kernel values. Linear models are collapsed into one weight vector per pair. The predicted class is the class
+ with the most pairwise votes (the first class wins a tie). The class likelihoods are the sums of 1/(1+exp(-f)) over the pairs of each class,
+ normalized to sum to one, and the class distances are the sums of the class's pairwise decision values. Null rejection is not supported.
+*/
+class ofxGrtSVM : public Classifier {
+public:
+    enum KernelType{ LINEAR_KERNEL=0, POLY_KERNEL, RBF_KERNEL };
+
+    /**
+     @brief creates the classifier
+     @param kernelType: the kernel, LINEAR_KERNEL, POLY_KERNEL (gamma*x.y + coef0)^degree or RBF_KERNEL exp(-gamma*|x-y|^2)
+     @param useScaling: if true the training and input data are scaled to [0 1] using the training data ranges
+     @param useAutoGamma: if true gamma is set to 1/numInputDimensions when the model is trained
+     @param gamma: the kernel gamma, used if useAutoGamma is false
+     @param degree: the degree of the polynomial kernel
+     @param coef0: the constant of the polynomial kernel
+     @param C: the penalty for misclassified training samples
+    */
+    ofxGrtSVM( const KernelType kernelType = LINEAR_KERNEL, const bool useScaling = true, const bool useAutoGamma = true, const Float gamma = 0.1, const UINT degree = 3, const Float coef0 = 0, const Float C = 1 );
+    ofxGrtSVM( const ofxGrtSVM &rhs );
+    virtual ~ofxGrtSVM();
+
+    ofxGrtSVM &operator=( const ofxGrtSVM &rhs );
+
+    virtual bool deepCopyFrom( const Classifier *classifier );
+    virtual bool train_( ClassificationData &trainingData );
+    virtual bool predict_( VectorFloat &inputVector );
+    virtual bool clear();
+    virtual bool save( std::fstream &file ) const;
+    virtual bool load( std::fstream &file );
+
+    /**
+     @brief predicts the class of a batch of samples. This does not change the model, so it can be called from several threads at once.
+     @param inputs: the samples, stored sample by sample with getNumInputDimensions() values per sample
+     @param numSamples: the number of samples
+     @param predictedClassLabels: the predicted class label of each sample, this must have room for numSamples values
+     @param maximumLikelihoods: the likelihood of the predicted class of each sample, this must have room for numSamples values (or be NULL)
+     @return returns true if the predictions were successful, false otherwise
+    */
+    bool predict( const Float *inputs, const UINT numSamples, UINT *predictedClassLabels, Float *maximumLikelihoods = NULL ) const;
+
+    bool setKernelType( const KernelType kernelType );
+    bool setGamma( const Float gamma );
+    bool setDegree( const UINT degree );
+    bool setCoef0( const Float coef0 );
+    bool setC( const Float C );
+    bool enableAutoGamma( const bool useAutoGamma );
+
+    /**
+     @brief sets the stopping tolerance of the solver, the maximum violation of the optimality conditions (LIBSVM's eps)
+    */
+    bool setTolerance( const Float tolerance );
+
+    /**
+     @brief sets the size of the kernel row cache used to train each pair of classes, in megabytes. Pairs are trained in parallel, so the
+     total memory can be this times the number of threads. If every row of a pair fits, the whole kernel matrix is cached.
+    */
+    bool setCacheSize( const UINT cacheSize );
+
+    /**
+     @brief if true, samples that are unlikely to change are temporarily removed from the working set while training
+    */
+    bool setUseShrinking( const bool useShrinking );
+
+    KernelType getKernelType() const { return kernelType; }
+    Float getGamma() const { return gamma; }
+    UINT getDegree() const { return degree; }
+    Float getCoef0() const { return coef0; }
+    Float getC() const { return C; }
+    Float getTolerance() const { return tolerance; }
+    UINT getCacheSize() const { return cacheSize; }
+    bool getUseShrinking() const { return useShrinking; }
+    bool getUseAutoGamma() const { return useAutoGamma; }
+    UINT getNumSupportVectors() const { return numSupportVectors; }
+    double getTrainingTime() const { return trainingTime; }
+
+    using MLBase::save;
+    using MLBase::load;
+    using MLBase::train_;
+    using MLBase::predict_;
+
+protected:
+    /**
+     @brief an LRU cache of the kernel rows of one binary problem, row i holds y_i*y_t*K(x_i,x_t) for every sample t
+    */
+    class KernelCache{
+    public:
+        KernelCache( const ofxGrtSVM &svm, const float *samples, const signed char *y, const UINT numSamples, const size_t maxBytes );
+        const float *getRow( const UINT i );
+        float getDiagonal( const UINT i ) const { return diagonal[i]; }
+
+    protected:
+        const ofxGrtSVM &svm;
+        const float *samples;
+        const signed char *y;
+        UINT numSamples;
+        UINT maxNumRows;
+        vector< float > rows;
+        vector< float > diagonal;
+        vector< int > rowSlot;          ///< The slot of each row, or -1 if the row is not cached
+        vector< UINT > slotRow;
+        vector< int > prev;             ///< The LRU list of slots, the head is the most recently used
+        vector< int > next;
+        int head;
+        int tail;
+    };
+
+    struct BinaryProblem{
+        UINT classA;
+        UINT classB;
+        UINT numSamplesA;
+        vector< UINT > samples;         ///< The training samples of both classes, class A first
+        vector< double > alpha;
+        double rho;
+        UINT numIterations;
+    };
+
+    bool solve( BinaryProblem &problem, const vector< float > &samples ) const;
+    bool buildModel( const vector< float > &samples, const vector< UINT > &sampleClassIndices, const vector< BinaryProblem > &problems );
+    bool updateModel();
+    float kernel( const float *a, const float *b ) const;
+    void scale( const Float *input, float *scaledInput ) const;
+    UINT predictSample( const float *x, float *kernelValues, float *decisionValues, UINT *votes, Float *classLikelihoods, Float *classDistances ) const;
+    UINT getPairIndex( const UINT a, const UINT b ) const { return a*numClasses - a*(a+1)/2 + (b-a-1); }
+
+    KernelType kernelType;
+    bool useAutoGamma;
+    Float gamma;
+    UINT degree;
+    Float coef0;
+    Float C;
+    Float tolerance;
+    UINT cacheSize;
+    bool useShrinking;
+    double trainingTime;
+
+    //The trained model, the support vectors are grouped by class
+    float kernelGamma;
+    UINT numSupportVectors;
+    vector< UINT > classSupportVectors;     ///< The index of the first support vector of each class, with one extra entry for the end
+    vector< float > supportVectors;         ///< [numSupportVectors x numInputDimensions]
+    vector< float > coefficients;           ///< [(numClasses-1) x numSupportVectors], as in LIBSVM
+    vector< float > rho;                    ///< The bias of each pair of classes
+
+    //Precomputed for prediction
+    vector< float > supportVectorBlocks;    ///< Blocks of four support vectors stored dimension by dimension
+    vector< float > linearWeights;          ///< One weight vector per pair, for the linear kernel
+    vector< float > query;
+    vector< float > kernelValues;
+    vector< float > decisionValues;
+    vector< UINT > votes;
+
+private:
+    static RegisterClassifierModule< ofxGrtSVM > registerModule;
+};
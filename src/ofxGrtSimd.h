@@ -0,0 +1,208 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+/**
+ @file
+ @brief a minimal 4-lane float vector type used by the ofxGrt evaluation kernels. SSE2 is used on x86, NEON on ARM, and a plain
+ scalar struct everywhere else (the compiler will often still vectorize the scalar version). Comparisons return lane masks that
+ can be passed to select(). There is also an int8 dot product with int32 accumulation for quantized models.
+*/
+
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OFX_GRT_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OFX_GRT_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace ofxGrtSimd {
+
+    const unsigned int WIDTH = 4;
+
+#if defined(OFX_GRT_SIMD_SSE2)
+
+    typedef __m128 float4;
+
+    inline float4 set1( const float x ){ return _mm_set1_ps( x ); }
+    inline float4 set( const float a, const float b, const float c, const float d ){ return _mm_setr_ps( a, b, c, d ); }
+    inline float4 load( const float *p ){ return _mm_loadu_ps( p ); }
+    inline void store( float *p, const float4 &a ){ _mm_storeu_ps( p, a ); }
+    inline float4 add( const float4 &a, const float4 &b ){ return _mm_add_ps( a, b ); }
+    inline float4 sub( const float4 &a, const float4 &b ){ return _mm_sub_ps( a, b ); }
+    inline float4 mul( const float4 &a, const float4 &b ){ return _mm_mul_ps( a, b ); }
+    inline float4 div( const float4 &a, const float4 &b ){ return _mm_div_ps( a, b ); }
+    inline float4 madd( const float4 &a, const float4 &b, const float4 &c ){ return _mm_add_ps( _mm_mul_ps( a, b ), c ); }
+    inline float4 min( const float4 &a, const float4 &b ){ return _mm_min_ps( a, b ); }
+    inline float4 max( const float4 &a, const float4 &b ){ return _mm_max_ps( a, b ); }
+    inline float4 lessThan( const float4 &a, const float4 &b ){ return _mm_cmplt_ps( a, b ); }
+    inline float4 greaterThan( const float4 &a, const float4 &b ){ return _mm_cmpgt_ps( a, b ); }
+    inline float4 select( const float4 &mask, const float4 &a, const float4 &b ){ return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) ); }
+
+#elif defined(OFX_GRT_SIMD_NEON)
+
+    typedef float32x4_t float4;
+
+    inline float4 set1( const float x ){ return vdupq_n_f32( x ); }
+    inline float4 set( const float a, const float b, const float c, const float d ){ const float v[4] = {a,b,c,d}; return vld1q_f32( v ); }
+    inline float4 load( const float *p ){ return vld1q_f32( p ); }
+    inline void store( float *p, const float4 &a ){ vst1q_f32( p, a ); }
+    inline float4 add( const float4 &a, const float4 &b ){ return vaddq_f32( a, b ); }
+    inline float4 sub( const float4 &a, const float4 &b ){ return vsubq_f32( a, b ); }
+    inline float4 mul( const float4 &a, const float4 &b ){ return vmulq_f32( a, b ); }
+#if defined(__aarch64__)
+    inline float4 div( const float4 &a, const float4 &b ){ return vdivq_f32( a, b ); }
+#else
+    inline float4 div( const float4 &a, const float4 &b ){
+        //ARMv7 NEON has no divide, so refine the reciprocal estimate with two Newton-Raphson steps
+        float32x4_t r = vrecpeq_f32( b );
+        r = vmulq_f32( vrecpsq_f32( b, r ), r );
+        r = vmulq_f32( vrecpsq_f32( b, r ), r );
+        return vmulq_f32( a, r );
+    }
+#endif
+    inline float4 madd( const float4 &a, const float4 &b, const float4 &c ){ return vmlaq_f32( c, a, b ); }
+    inline float4 min( const float4 &a, const float4 &b ){ return vminq_f32( a, b ); }
+    inline float4 max( const float4 &a, const float4 &b ){ return vmaxq_f32( a, b ); }
+    inline float4 lessThan( const float4 &a, const float4 &b ){ return vreinterpretq_f32_u32( vcltq_f32( a, b ) ); }
+    inline float4 greaterThan( const float4 &a, const float4 &b ){ return vreinterpretq_f32_u32( vcgtq_f32( a, b ) ); }
+    inline float4 select( const float4 &mask, const float4 &a, const float4 &b ){ return vbslq_f32( vreinterpretq_u32_f32( mask ), a, b ); }
+
+#else
+
+    struct float4{ float v[4]; };
+
+    inline float4 set1( const float x ){ float4 r; for(int i=0; i<4; i++) r.v[i] = x; return r; }
+    inline float4 set( const float a, const float b, const float c, const float d ){ float4 r; r.v[0] = a; r.v[1] = b; r.v[2] = c; r.v[3] = d; return r; }
+    inline float4 load( const float *p ){ float4 r; for(int i=0; i<4; i++) r.v[i] = p[i]; return r; }
+    inline void store( float *p, const float4 &a ){ for(int i=0; i<4; i++) p[i] = a.v[i]; }
+    inline float4 add( const float4 &a, const float4 &b ){ float4 r; for(int i=0; i<4; i++) r.v[i] = a.v[i] + b.v[i]; return r; }
+    inline float4 sub( const float4 &a, const float4 &b ){ float4 r; for(int i=0; i<4; i++) r.v[i] = a.v[i] - b.v[i]; return r; }
+    inline float4 mul( const float4 &a, const float4 &b ){ float4 r; for(int i=0; i<4; i++) r.v[i] = a.v[i] * b.v[i]; return r; }
+    inline float4 div( const float4 &a, const float4 &b ){ float4 r; for(int i=0; i<4; i++) r.v[i] = a.v[i] / b.v[i]; return r; }
+    inline float4 madd( const float4 &a, const float4 &b, const float4 &c ){ float4 r; for(int i=0; i<4; i++) r.v[i] = a.v[i] * b.v[i] + c.v[i]; return r; }
+    inline float4 min( const float4 &a, const float4 &b ){ float4 r; for(int i=0; i<4; i++) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return r; }
+    inline float4 max( const float4 &a, const float4 &b ){ float4 r; for(int i=0; i<4; i++) r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return r; }
+    inline float4 lessThan( const float4 &a, const float4 &b ){ float4 r; for(int i=0; i<4; i++) r.v[i] = a.v[i] < b.v[i] ? 1.0f : 0.0f; return r; }
+    inline float4 greaterThan( const float4 &a, const float4 &b ){ float4 r; for(int i=0; i<4; i++) r.v[i] = a.v[i] > b.v[i] ? 1.0f : 0.0f; return r; }
+    inline float4 select( const float4 &mask, const float4 &a, const float4 &b ){ float4 r; for(int i=0; i<4; i++) r.v[i] = mask.v[i] != 0.0f ? a.v[i] : b.v[i]; return r; }
+
+#endif
+
+    /**
+     @brief returns the sum of the four lanes
+    */
+    inline float sum( const float4 &a ){
+        float v[4];
+        store( v, a );
+        return (v[0] + v[1]) + (v[2] + v[3]);
+    }
+
+    /**
+     @brief computes the dot product of two float arrays of length n, four lanes at a time with a scalar tail
+    */
+    inline float dot( const float *a, const float *b, const unsigned int n ){
+        float4 acc = set1( 0.0f );
+        unsigned int i = 0;
+        for(; i+WIDTH<=n; i+=WIDTH){
+            acc = madd( load( a+i ), load( b+i ), acc );
+        }
+        float result = sum( acc );
+        for(; i<n; i++){
+            result += a[i] * b[i];
+        }
+        return result;
+    }
+
+    /**
+     @brief computes the dot product of two int8 arrays of length n, accumulated in int32, 16 values at a time with a scalar tail.
+     The values must be in the range [-127 127], so two products never overflow the 16 bit intermediate sums on NEON.
+    */
+    inline int32_t dot( const int8_t *a, const int8_t *b, const unsigned int n ){
+        unsigned int i = 0;
+        int32_t result = 0;
+#if defined(OFX_GRT_SIMD_SSE2)
+        //SSE2 has no 8 bit multiply, so sign extend each half to 16 bits and multiply-add adjacent pairs into 32 bits
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc = zero;
+        for(; i+16<=n; i+=16){
+            const __m128i x = _mm_loadu_si128( (const __m128i*)(a+i) );
+            const __m128i y = _mm_loadu_si128( (const __m128i*)(b+i) );
+            const __m128i xSign = _mm_cmplt_epi8( x, zero );
+            const __m128i ySign = _mm_cmplt_epi8( y, zero );
+            acc = _mm_add_epi32( acc, _mm_madd_epi16( _mm_unpacklo_epi8( x, xSign ), _mm_unpacklo_epi8( y, ySign ) ) );
+            acc = _mm_add_epi32( acc, _mm_madd_epi16( _mm_unpackhi_epi8( x, xSign ), _mm_unpackhi_epi8( y, ySign ) ) );
+        }
+        int32_t v[4];
+        _mm_storeu_si128( (__m128i*)v, acc );
+        result = (v[0] + v[1]) + (v[2] + v[3]);
+#elif defined(OFX_GRT_SIMD_NEON)
+        int32x4_t acc = vdupq_n_s32( 0 );
+        for(; i+16<=n; i+=16){
+            const int8x16_t x = vld1q_s8( a+i );
+            const int8x16_t y = vld1q_s8( b+i );
+            int16x8_t products = vmull_s8( vget_low_s8( x ), vget_low_s8( y ) );
+            products = vmlal_s8( products, vget_high_s8( x ), vget_high_s8( y ) );
+            acc = vpadalq_s16( acc, products );
+        }
+        result = (vgetq_lane_s32( acc, 0 ) + vgetq_lane_s32( acc, 1 )) + (vgetq_lane_s32( acc, 2 ) + vgetq_lane_s32( acc, 3 ));
+#endif
+        for(; i<n; i++){
+            result += (int32_t)a[i] * (int32_t)b[i];
+        }
+        return result;
+    }
+
+    /**
+     @brief computes y += a*x for float arrays of length n
+    */
+    inline void axpy( float *y, const float a, const float *x, const unsigned int n ){
+        const float4 av = set1( a );
+        unsigned int i = 0;
+        for(; i+WIDTH<=n; i+=WIDTH){
+            store( y+i, madd( av, load( x+i ), load( y+i ) ) );
+        }
+        for(; i<n; i++){
+            y[i] += a * x[i];
+        }
+    }
+
+    /**
+     @brief computes the squared euclidean distance between two float arrays of length n
+    */
+    inline float squaredDistance( const float *a, const float *b, const unsigned int n ){
+        float4 acc = set1( 0.0f );
+        unsigned int i = 0;
+        for(; i+WIDTH<=n; i+=WIDTH){
+            const float4 d = sub( load( a+i ), load( b+i ) );
+            acc = madd( d, d, acc );
+        }
+        float result = sum( acc );
+        for(; i<n; i++){
+            const float d = a[i] - b[i];
+            result += d * d;
+        }
+        return result;
+    }
+
+}
@@ -0,0 +1,268 @@
+
+#include "ofxGrtSnapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace GRT;
+
+const char *ofxGrtSnapshot::MAGIC = "ofxGrtSnapshot";
+
+ofxGrtSnapshot::ofxGrtSnapshot(){
+    data = NULL;
+    fileSize = 0;
+#if defined(_WIN32)
+    fileHandle = NULL;
+    mappingHandle = NULL;
+#endif
+    errorLog.setProceedingText("[ERROR ofxGrtSnapshot]");
+}
+
+ofxGrtSnapshot::~ofxGrtSnapshot(){
+    close();
+}
+
+bool ofxGrtSnapshot::open( const std::string &filename ){
+
+    close();
+
+    //Map the whole file read-only, the pages are shared with any other process that maps it. Sharing delete lets a writer replace the file
+    //while it is mapped, the mapping keeps the old file
+#if defined(_WIN32)
+    HANDLE file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if( file == INVALID_HANDLE_VALUE ){
+        errorLog << "open(const std::string &filename) - Failed to open file: " << filename << endl;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if( !GetFileSizeEx( file, &size ) || size.QuadPart < (LONGLONG)sizeof( Header ) ){
+        errorLog << "open(const std::string &filename) - The file is too small to be a snapshot: " << filename << endl;
+        CloseHandle( file );
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+    const void *view = mapping != NULL ? MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) : NULL;
+    if( view == NULL ){
+        errorLog << "open(const std::string &filename) - Failed to map file: " << filename << endl;
+        if( mapping != NULL ) CloseHandle( mapping );
+        CloseHandle( file );
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    fileSize = (uint64_t)size.QuadPart;
+#else
+    const int file = ::open( filename.c_str(), O_RDONLY );
+    if( file < 0 ){
+        errorLog << "open(const std::string &filename) - Failed to open file: " << filename << endl;
+        return false;
+    }
+    struct stat status;
+    if( fstat( file, &status ) != 0 || status.st_size < (off_t)sizeof( Header ) ){
+        errorLog << "open(const std::string &filename) - The file is too small to be a snapshot: " << filename << endl;
+        ::close( file );
+        return false;
+    }
+    void *view = mmap( NULL, (size_t)status.st_size, PROT_READ, MAP_SHARED, file, 0 );
+    ::close( file );
+    if( view == MAP_FAILED ){
+        errorLog << "open(const std::string &filename) - Failed to map file: " << filename << endl;
+        return false;
+    }
+    fileSize = (uint64_t)status.st_size;
+#endif
+    data = static_cast< const uint8_t* >( view );
+    this->filename = filename;
+
+    //Check the header, then the section table
+    Header header;
+    memcpy( &header, data, sizeof( Header ) );
+    if( strncmp( header.magic, MAGIC, sizeof( header.magic ) ) != 0 ){
+        errorLog << "open(const std::string &filename) - The file is not an ofxGrt snapshot: " << filename << endl;
+        close();
+        return false;
+    }
+    if( header.version != VERSION || header.byteOrder != BYTE_ORDER_MARK || header.floatSize != sizeof( Float ) ){
+        errorLog << "open(const std::string &filename) - The snapshot was written with a different version, byte order or Float type: " << filename << endl;
+        close();
+        return false;
+    }
+    if( header.tableOffset % ALIGNMENT != 0 || header.tableOffset > fileSize || (fileSize - header.tableOffset) / sizeof( Section ) < header.numSections ){
+        errorLog << "open(const std::string &filename) - The section table is outside the file: " << filename << endl;
+        close();
+        return false;
+    }
+
+    sections.resize( header.numSections );
+    for(UINT i=0; i<header.numSections; i++){
+        memcpy( &sections[i], data + header.tableOffset + i * sizeof( Section ), sizeof( Section ) );
+        Section &section = sections[i];
+        section.name[ MAX_NAME_LENGTH ] = '\0';
+        if( section.offset % ALIGNMENT != 0 || section.offset > fileSize || section.size > fileSize - section.offset ){
+            errorLog << "open(const std::string &filename) - Section " << section.name << " is outside the file: " << filename << endl;
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ofxGrtSnapshot::close(){
+    if( data != NULL ){
+#if defined(_WIN32)
+        UnmapViewOfFile( data );
+        CloseHandle( (HANDLE)mappingHandle );
+        CloseHandle( (HANDLE)fileHandle );
+        mappingHandle = NULL;
+        fileHandle = NULL;
+#else
+        munmap( const_cast< uint8_t* >( data ), (size_t)fileSize );
+#endif
+    }
+    data = NULL;
+    fileSize = 0;
+    filename = "";
+    sections.clear();
+    return true;
+}
+
+bool ofxGrtSnapshot::getHasSection( const std::string &name ) const {
+    for(size_t i=0; i<sections.size(); i++){
+        if( name == sections[i].name ) return true;
+    }
+    return false;
+}
+
+bool ofxGrtSnapshot::getSection( const std::string &name, const void *&sectionData, uint64_t &size ) const {
+    for(size_t i=0; i<sections.size(); i++){
+        if( name == sections[i].name ){
+            sectionData = data + sections[i].offset;
+            size = sections[i].size;
+            return true;
+        }
+    }
+    errorLog << "getSection(const std::string &name, ...) - The snapshot has no section named " << name << endl;
+    return false;
+}
+
+std::shared_ptr< const ofxGrtSnapshot > ofxGrtSnapshot::load( const std::string &filename ){
+    std::shared_ptr< ofxGrtSnapshot > snapshot( new ofxGrtSnapshot );
+    if( !snapshot->open( filename ) ) return std::shared_ptr< const ofxGrtSnapshot >();
+    return snapshot;
+}
+
+ofxGrtSnapshotWriter::ofxGrtSnapshotWriter(){
+    errorLog.setProceedingText("[ERROR ofxGrtSnapshotWriter]");
+}
+
+ofxGrtSnapshotWriter::~ofxGrtSnapshotWriter(){
+}
+
+bool ofxGrtSnapshotWriter::addSection( const std::string &name, const void *sectionData, const uint64_t size ){
+
+    if( name.size() == 0 || name.size() > ofxGrtSnapshot::MAX_NAME_LENGTH ){
+        errorLog << "addSection(const std::string &name, ...) - The name must have between 1 and " << (UINT)ofxGrtSnapshot::MAX_NAME_LENGTH << " characters: " << name << endl;
+        return false;
+    }
+
+    if( sectionData == NULL && size > 0 ){
+        errorLog << "addSection(const std::string &name, ...) - The data of section " << name << " is NULL!" << endl;
+        return false;
+    }
+
+    for(size_t i=0; i<sections.size(); i++){
+        if( sections[i].name == name ){
+            errorLog << "addSection(const std::string &name, ...) - There is already a section named " << name << endl;
+            return false;
+        }
+    }
+
+    PendingSection section;
+    section.name = name;
+    section.data = sectionData;
+    section.size = size;
+    sections.push_back( section );
+
+    return true;
+}
+
+bool ofxGrtSnapshotWriter::save( const std::string &filename ) const {
+
+    const uint64_t A = ofxGrtSnapshot::ALIGNMENT;
+
+    //The table follows the header, and each section starts on the next aligned offset
+    ofxGrtSnapshot::Header header;
+    memset( &header, 0, sizeof( header ) );
+    strncpy( header.magic, ofxGrtSnapshot::MAGIC, sizeof( header.magic ) );
+    header.version = ofxGrtSnapshot::VERSION;
+    header.byteOrder = ofxGrtSnapshot::BYTE_ORDER_MARK;
+    header.floatSize = sizeof( Float );
+    header.numSections = (uint32_t)sections.size();
+    header.tableOffset = sizeof( header );
+
+    vector< ofxGrtSnapshot::Section > table( sections.size() );
+    uint64_t offset = header.tableOffset + table.size() * sizeof( ofxGrtSnapshot::Section );
+    for(size_t i=0; i<sections.size(); i++){
+        memset( &table[i], 0, sizeof( table[i] ) );
+        strncpy( table[i].name, sections[i].name.c_str(), ofxGrtSnapshot::MAX_NAME_LENGTH );
+        offset = (offset + A - 1) / A * A;
+        table[i].offset = offset;
+        table[i].size = sections[i].size;
+        offset += sections[i].size;
+    }
+
+    //Write a temporary file and rename it over the target, so any process that has the old snapshot mapped keeps reading the old file
+    //rather than seeing it truncated under its mapping
+    const std::string tempFilename = filename + ".tmp";
+    std::fstream file;
+    file.open( tempFilename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+    if( !file.is_open() ){
+        errorLog << "save(const std::string &filename) - Failed to open file: " << tempFilename << endl;
+        return false;
+    }
+
+    const char padding[ ofxGrtSnapshot::ALIGNMENT ] = { 0 };
+    file.write( reinterpret_cast< const char* >( &header ), sizeof( header ) );
+    if( table.size() > 0 ) file.write( reinterpret_cast< const char* >( &table[0] ), table.size() * sizeof( ofxGrtSnapshot::Section ) );
+    uint64_t position = header.tableOffset + table.size() * sizeof( ofxGrtSnapshot::Section );
+    for(size_t i=0; i<sections.size(); i++){
+        file.write( padding, (std::streamsize)(table[i].offset - position) );
+        if( sections[i].size > 0 ) file.write( static_cast< const char* >( sections[i].data ), (std::streamsize)sections[i].size );
+        position = table[i].offset + sections[i].size;
+    }
+
+    file.close();
+    if( file.fail() ){
+        errorLog << "save(const std::string &filename) - Failed to write file: " << tempFilename << endl;
+        std::remove( tempFilename.c_str() );
+        return false;
+    }
+
+#if defined(_WIN32)
+    const bool renamed = MoveFileExA( tempFilename.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING ) != 0;
+#else
+    const bool renamed = ::rename( tempFilename.c_str(), filename.c_str() ) == 0;
+#endif
+    if( !renamed ){
+        errorLog << "save(const std::string &filename) - Failed to replace file: " << filename << endl;
+        std::remove( tempFilename.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+bool ofxGrtSnapshotWriter::clear(){
+    sections.clear();
+    return true;
+}
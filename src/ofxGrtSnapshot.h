@@ -0,0 +1,208 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+#include <memory>
+#include <stdint.h>
+
+#include "ofMain.h"
+
+using namespace GRT;
+
+/**
+ @brief a binary snapshot of trained ofxGrt models, made of named sections of raw arrays. ofxGrtSnapshotWriter collects the sections and writes
+ the file, ofxGrtSnapshot maps the file into memory read-only, so the arrays can be used straight from the mapping without parsing or copying.
+ Several processes that map the same file share one copy of it in memory.
+
+ The file starts with a 64 byte header (the magic string, the format version, the byte order and the size of Float), followed by a table with
+ one 64 byte entry per section (the name, offset and size) and then the sections, each starting on a 64 byte boundary. The arrays are stored
+ in the byte order and with the Float type of the machine that wrote them, and a snapshot written with a different byte order or Float
+ type will not open.
+
+ Models that read their parameters from the mapping keep a std::shared_ptr to the snapshot, so the file stays mapped while any model (or copy
+ of a model) is using it.
+*/
+class ofxGrtSnapshot {
+public:
+    static const UINT ALIGNMENT = 64;
+    static const UINT MAX_NAME_LENGTH = 47;
+
+    ofxGrtSnapshot();
+    ~ofxGrtSnapshot();
+
+    /**
+     @brief maps a snapshot file into memory read-only and reads its section table
+     @param filename: the snapshot file
+     @return returns true if the file was opened and is a valid snapshot, false otherwise
+    */
+    bool open( const std::string &filename );
+
+    /**
+     @brief unmaps the file, any pointers into the snapshot become invalid
+    */
+    bool close();
+
+    bool getIsOpen() const { return data != NULL; }
+    const std::string &getFilename() const { return filename; }
+    UINT getNumSections() const { return (UINT)sections.size(); }
+    uint64_t getFileSize() const { return fileSize; }
+    bool getHasSection( const std::string &name ) const;
+
+    /**
+     @brief gets a section
+     @param name: the name of the section
+     @param sectionData: set to the start of the section, which is aligned to ALIGNMENT bytes
+     @param size: set to the size of the section in bytes
+     @return returns true if the section was found, false otherwise
+    */
+    bool getSection( const std::string &name, const void *&sectionData, uint64_t &size ) const;
+
+    /**
+     @brief gets a section as an array
+     @param name: the name of the section
+     @param array: set to the first element of the array (or NULL if the array is empty)
+     @param count: set to the number of elements
+     @return returns true if the section was found and its size is a multiple of the size of T, false otherwise
+    */
+    template< class T >
+    bool getArray( const std::string &name, const T *&array, size_t &count ) const {
+        const void *sectionData = NULL;
+        uint64_t size = 0;
+        if( !getSection( name, sectionData, size ) ) return false;
+        if( size % sizeof( T ) != 0 ){
+            errorLog << "getArray(...) - The size of section " << name << " is not a multiple of the element size!" << endl;
+            return false;
+        }
+        count = (size_t)(size / sizeof( T ));
+        array = count > 0 ? static_cast< const T* >( sectionData ) : NULL;
+        return true;
+    }
+
+    /**
+     @brief gets a section that holds one value, such as a struct of model settings
+    */
+    template< class T >
+    bool getValue( const std::string &name, T &value ) const {
+        const T *array = NULL;
+        size_t count = 0;
+        if( !getArray( name, array, count ) ) return false;
+        if( count != 1 ){
+            errorLog << "getValue(...) - Section " << name << " does not hold one value!" << endl;
+            return false;
+        }
+        value = array[0];
+        return true;
+    }
+
+    /**
+     @brief opens a snapshot and returns it in a shared_ptr, ready to pass to a model's loadSnapshot
+     @return returns the snapshot, or an empty pointer if the file could not be opened
+    */
+    static std::shared_ptr< const ofxGrtSnapshot > load( const std::string &filename );
+
+protected:
+    friend class ofxGrtSnapshotWriter;
+
+    struct Header{
+        char magic[16];
+        uint32_t version;
+        uint32_t byteOrder;         ///< BYTE_ORDER_MARK as written by the machine that saved the file
+        uint32_t floatSize;         ///< sizeof( Float )
+        uint32_t numSections;
+        uint64_t tableOffset;
+        uint8_t reserved[24];
+    };
+
+    struct Section{
+        char name[ MAX_NAME_LENGTH + 1 ];
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    static const uint32_t VERSION = 1;
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static const char *MAGIC;
+
+    std::string filename;
+    const uint8_t *data;
+    uint64_t fileSize;
+    vector< Section > sections;
+#if defined(_WIN32)
+    void *fileHandle;
+    void *mappingHandle;
+#endif
+
+    mutable ErrorLog errorLog;
+};
+
+/**
+ @brief collects the sections of a snapshot and writes the file. The sections are not copied, so the arrays passed to addSection must stay
+ valid until save is called.
+*/
+class ofxGrtSnapshotWriter {
+public:
+    ofxGrtSnapshotWriter();
+    ~ofxGrtSnapshotWriter();
+
+    /**
+     @brief adds a section
+     @param name: the name of the section, at most ofxGrtSnapshot::MAX_NAME_LENGTH characters, this must be unique
+     @param sectionData: the data of the section (this can be NULL if size is zero)
+     @param size: the size of the section in bytes
+     @return returns true if the section was added successfully, false otherwise
+    */
+    bool addSection( const std::string &name, const void *sectionData, const uint64_t size );
+
+    template< class T >
+    bool addArray( const std::string &name, const T *array, const size_t count ){ return addSection( name, array, (uint64_t)count * sizeof( T ) ); }
+
+    template< class T >
+    bool addArray( const std::string &name, const vector< T > &array ){ return addSection( name, array.size() > 0 ? &array[0] : NULL, (uint64_t)array.size() * sizeof( T ) ); }
+
+    template< class T >
+    bool addValue( const std::string &name, const T &value ){ return addSection( name, &value, sizeof( T ) ); }
+
+    /**
+     @brief writes the snapshot file, replacing any existing file. The file is written next to the target (as filename + ".tmp") and then
+     renamed over it, so apps that have the old snapshot open keep their mapping of the old file until they open the new one.
+     @param filename: the file to write
+     @return returns true if the file was written successfully, false otherwise
+    */
+    bool save( const std::string &filename ) const;
+
+    /**
+     @brief removes all the sections
+    */
+    bool clear();
+
+    UINT getNumSections() const { return (UINT)sections.size(); }
+
+protected:
+    struct PendingSection{
+        std::string name;
+        const void *data;
+        uint64_t size;
+    };
+
+    vector< PendingSection > sections;
+
+    mutable ErrorLog errorLog;
+};
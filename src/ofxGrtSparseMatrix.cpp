@@ -0,0 +1,201 @@
+
+#include "ofxGrtSparseMatrix.h"
+
+using namespace GRT;
+
+ofxGrtSparseMatrix::ofxGrtSparseMatrix(){
+    rows = cols = 0;
+    errorLog.setProceedingText("[ERROR ofxGrtSparseMatrix]");
+}
+
+ofxGrtSparseMatrix::~ofxGrtSparseMatrix(){
+}
+
+bool ofxGrtSparseMatrix::clear(){
+    rows = cols = 0;
+    spans.clear();
+    values.clear();
+    return true;
+}
+
+bool ofxGrtSparseMatrix::setCSR( const unsigned int rows, const unsigned int cols, const vector< unsigned int > &rowPtr, const vector< unsigned int > &colIndex, const vector< float > &values ){
+
+    if( rowPtr.size() != rows+1 || colIndex.size() != values.size() || rowPtr[rows] != values.size() ){
+        errorLog << "setCSR(...) - The size of the row pointer, column index and value buffers do not match!" << endl;
+        return false;
+    }
+
+    for(unsigned int i=0; i<rows; i++){
+        if( rowPtr[i] > rowPtr[i+1] || rowPtr[i+1] > values.size() ){
+            errorLog << "setCSR(...) - The row pointer of row " << i << " is decreasing or out of range!" << endl;
+            return false;
+        }
+    }
+
+    if( !resize( rows, cols, values.size() ) ) return false;
+
+    for(unsigned int i=0; i<rows; i++){
+        for(unsigned int k=rowPtr[i]; k<rowPtr[i+1]; k++){
+            if( colIndex[k] >= cols ){
+                errorLog << "setCSR(...) - Column index " << colIndex[k] << " is out of range!" << endl;
+                clear();
+                return false;
+            }
+            pushValue( i, colIndex[k], values[k] );
+        }
+    }
+
+    return true;
+}
+
+bool ofxGrtSparseMatrix::setCOO( const unsigned int rows, const unsigned int cols, const vector< unsigned int > &rowIndex, const vector< unsigned int > &colIndex, const vector< float > &values ){
+
+    const size_t numValues = values.size();
+
+    if( rowIndex.size() != numValues || colIndex.size() != numValues ){
+        errorLog << "setCOO(...) - The size of the row index, column index and value buffers do not match!" << endl;
+        return false;
+    }
+
+    for(size_t k=0; k<numValues; k++){
+        if( rowIndex[k] >= rows || colIndex[k] >= cols ){
+            errorLog << "setCOO(...) - Entry " << k << " is out of range!" << endl;
+            return false;
+        }
+    }
+
+    //Sort the entries into row major order, the COO data is not modified
+    vector< unsigned int > order( numValues );
+    for(size_t k=0; k<numValues; k++) order[k] = (unsigned int)k;
+    std::sort( order.begin(), order.end(), [&]( const unsigned int a, const unsigned int b ){
+        if( rowIndex[a] != rowIndex[b] ) return rowIndex[a] < rowIndex[b];
+        return colIndex[a] < colIndex[b];
+    } );
+
+    if( !resize( rows, cols, numValues ) ) return false;
+
+    for(size_t k=0; k<numValues; k++){
+        const unsigned int n = order[k];
+
+        //Sum any duplicate entries
+        if( spans.size() > 0 ){
+            const Span &span = spans.back();
+            if( span.row == rowIndex[n] && span.col + span.length - 1 == colIndex[n] ){
+                this->values.back() += values[n];
+                continue;
+            }
+        }
+        pushValue( rowIndex[n], colIndex[n], values[n] );
+    }
+
+    return true;
+}
+
+bool ofxGrtSparseMatrix::setBanded( const unsigned int rows, const unsigned int cols, const vector< unsigned int > &bandStart, const vector< unsigned int > &bandLength, const vector< float > &values ){
+
+    if( bandStart.size() != rows || bandLength.size() != rows ){
+        errorLog << "setBanded(...) - The size of the band buffers does not match the number of rows!" << endl;
+        return false;
+    }
+
+    size_t numValues = 0;
+    for(unsigned int i=0; i<rows; i++){
+        if( bandStart[i] + bandLength[i] > cols ){
+            errorLog << "setBanded(...) - The band for row " << i << " is out of range!" << endl;
+            return false;
+        }
+        numValues += bandLength[i];
+    }
+
+    if( values.size() != numValues ){
+        errorLog << "setBanded(...) - The number of values does not match the size of the band!" << endl;
+        return false;
+    }
+
+    if( !resize( rows, cols, numValues ) ) return false;
+
+    unsigned int offset = 0;
+    for(unsigned int i=0; i<rows; i++){
+        if( bandLength[i] == 0 ) continue;
+        Span span;
+        span.row = i;
+        span.col = bandStart[i];
+        span.length = bandLength[i];
+        span.offset = offset;
+        spans.push_back( span );
+        offset += bandLength[i];
+    }
+    this->values = values;
+
+    return true;
+}
+
+bool ofxGrtSparseMatrix::setBanded( const MatrixFloat &data, const unsigned int radius ){
+
+    const unsigned int rows = data.getNumRows();
+    const unsigned int cols = data.getNumCols();
+
+    if( rows == 0 || cols == 0 ){
+        errorLog << "setBanded( const MatrixFloat &data, const unsigned int radius ) - The matrix is empty!" << endl;
+        return false;
+    }
+
+    if( !resize( rows, cols, size_t(rows) * std::min( cols, 2*radius+1 ) ) ) return false;
+
+    const float slope = cols / float(rows);
+    for(unsigned int i=0; i<rows; i++){
+        const int center = (int)floor( (i + 0.5f) * slope );
+        const unsigned int start = (unsigned int)std::max( 0, center - (int)radius );
+        const unsigned int end = (unsigned int)std::min( (int)cols, center + (int)radius + 1 );
+        if( start >= end ) continue;
+
+        Span span;
+        span.row = i;
+        span.col = start;
+        span.length = end - start;
+        span.offset = (unsigned int)values.size();
+        spans.push_back( span );
+        for(unsigned int j=start; j<end; j++){
+            values.push_back( data[i][j] );
+        }
+    }
+
+    return true;
+}
+
+bool ofxGrtSparseMatrix::resize( const unsigned int rows, const unsigned int cols, const size_t numValues ){
+
+    if( rows == 0 || cols == 0 ){
+        errorLog << "resize(...) - The number of rows and columns must be greater than zero!" << endl;
+        return false;
+    }
+
+    this->rows = rows;
+    this->cols = cols;
+    spans.clear();
+    values.clear();
+    values.reserve( numValues );
+
+    return true;
+}
+
+void ofxGrtSparseMatrix::pushValue( const unsigned int row, const unsigned int col, const float value ){
+
+    //Extend the last span if this value directly follows it, otherwise start a new span
+    if( spans.size() > 0 ){
+        Span &span = spans.back();
+        if( span.row == row && span.col + span.length == col ){
+            span.length++;
+            values.push_back( value );
+            return;
+        }
+    }
+
+    Span span;
+    span.row = row;
+    span.col = col;
+    span.length = 1;
+    span.offset = (unsigned int)values.size();
+    spans.push_back( span );
+    values.push_back( value );
+}
@@ -0,0 +1,109 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+
+using namespace GRT;
+
+/**
+ @brief stores a mostly empty matrix as a list of row spans, where each span is a run of consecutive non-zero columns in one row.
+ The matrix can be filled from CSR, COO or banded input and is used by ofxGrtMatrixPlot to upload only the non-zero parts of a matrix.
+ Memory is proportional to the number of non-zero values (plus one span per run of values).
+*/
+class ofxGrtSparseMatrix {
+public:
+    struct Span{
+        unsigned int row;       ///< The row of the span
+        unsigned int col;       ///< The first column of the span
+        unsigned int length;    ///< The number of consecutive columns in the span
+        unsigned int offset;    ///< The index of the first value of the span in the values buffer
+    };
+
+    ofxGrtSparseMatrix();
+    ~ofxGrtSparseMatrix();
+
+    /**
+     @brief removes all the values from the matrix, the size of the matrix is set to zero
+     @return returns true if the matrix was cleared successfully, false otherwise
+    */
+    bool clear();
+
+    /**
+     @brief fills the matrix from compressed sparse row (CSR) data
+     @param rows: the number of rows in the matrix
+     @param cols: the number of columns in the matrix
+     @param rowPtr: a vector of size rows+1, the values for row i are stored between rowPtr[i] and rowPtr[i+1]
+     @param colIndex: the column index of each non-zero value, this should be sorted within each row
+     @param values: the non-zero values
+     @return returns true if the matrix was set successfully, false otherwise
+    */
+    bool setCSR( const unsigned int rows, const unsigned int cols, const vector< unsigned int > &rowPtr, const vector< unsigned int > &colIndex, const vector< float > &values );
+
+    /**
+     @brief fills the matrix from coordinate (COO) data, the entries can be in any order and duplicate entries are summed
+     @param rows: the number of rows in the matrix
+     @param cols: the number of columns in the matrix
+     @param rowIndex: the row index of each non-zero value
+     @param colIndex: the column index of each non-zero value
+     @param values: the non-zero values
+     @return returns true if the matrix was set successfully, false otherwise
+    */
+    bool setCOO( const unsigned int rows, const unsigned int cols, const vector< unsigned int > &rowIndex, const vector< unsigned int > &colIndex, const vector< float > &values );
+
+    /**
+     @brief fills the matrix from banded data, where each row has a single run of values
+     @param rows: the number of rows in the matrix
+     @param cols: the number of columns in the matrix
+     @param bandStart: the first column of the band for each row
+     @param bandLength: the number of columns in the band for each row
+     @param values: the band values for each row, stored one row after the other
+     @return returns true if the matrix was set successfully, false otherwise
+    */
+    bool setBanded( const unsigned int rows, const unsigned int cols, const vector< unsigned int > &bandStart, const vector< unsigned int > &bandLength, const vector< float > &values );
+
+    /**
+     @brief fills the matrix with a diagonal band (such as a Sakoe-Chiba band) taken from a dense matrix. The band is centered on the
+     diagonal of the matrix, which is scaled by the aspect ratio of the matrix if the matrix is not square. Only the cells inside the band are read.
+     @param data: the dense matrix to copy the band from
+     @param radius: the number of columns either side of the diagonal that will be kept
+     @return returns true if the matrix was set successfully, false otherwise
+    */
+    bool setBanded( const MatrixFloat &data, const unsigned int radius );
+
+    unsigned int getNumRows() const { return rows; }
+    unsigned int getNumCols() const { return cols; }
+    unsigned int getNumNonZeros() const { return (unsigned int)values.size(); }
+    unsigned int getNumSpans() const { return (unsigned int)spans.size(); }
+    const vector< Span > &getSpans() const { return spans; }
+    const vector< float > &getValues() const { return values; }
+
+protected:
+    bool resize( const unsigned int rows, const unsigned int cols, const size_t numValues );
+    void pushValue( const unsigned int row, const unsigned int col, const float value );
+
+    unsigned int rows;
+    unsigned int cols;
+    vector< Span > spans;
+    vector< float > values;
+    ErrorLog errorLog;
+};
@@ -0,0 +1,247 @@
+
+#include "ofxGrtStreamAligner.h"
+
+using namespace GRT;
+
+ofxGrtStreamAligner::ofxGrtStreamAligner(){
+    errorLog.setProceedingText("[ERROR ofxGrtStreamAligner]");
+    warningLog.setProceedingText("[WARNING ofxGrtStreamAligner]");
+    sampleRate = 60;
+    latency = 0.05;
+    mode = LINEAR_INTERPOLATION;
+    bufferSize = 128;
+    clear();
+}
+
+ofxGrtStreamAligner::~ofxGrtStreamAligner(){
+}
+
+bool ofxGrtStreamAligner::setup( const double sampleRate, const double latency, const InterpolationMode mode, const UINT bufferSize ){
+
+    if( sampleRate <= 0 || latency < 0 || bufferSize < 2 ){
+        errorLog << "setup(...) - The sample rate must be positive, the latency must not be negative and the buffer size must be at least 2!" << endl;
+        return false;
+    }
+
+    this->sampleRate = sampleRate;
+    this->latency = latency;
+    this->mode = mode;
+    this->bufferSize = bufferSize;
+
+    for(size_t i=0; i<streams.size(); i++){
+        streams[i].timestamps.resize( bufferSize );
+        streams[i].values.resize( bufferSize * streams[i].numDimensions );
+    }
+
+    return reset();
+}
+
+int ofxGrtStreamAligner::addStream( const std::string &name, const UINT numDimensions ){
+
+    if( numDimensions == 0 ){
+        errorLog << "addStream(const std::string &name, const UINT numDimensions) - The number of dimensions must be greater than zero!" << endl;
+        return -1;
+    }
+
+    Stream stream;
+    stream.name = name;
+    stream.numDimensions = numDimensions;
+    stream.offset = this->numDimensions;
+    stream.head = 0;
+    stream.count = 0;
+    stream.timestamps.resize( bufferSize, 0 );
+    stream.values.resize( bufferSize * numDimensions, 0 );
+    streams.push_back( stream );
+
+    this->numDimensions += numDimensions;
+    nearestTimestamps.resize( streams.size(), 0 );
+    reset();
+
+    return (int)streams.size()-1;
+}
+
+bool ofxGrtStreamAligner::push( const UINT streamIndex, const double timestamp, const VectorFloat &data ){
+
+    if( streamIndex >= streams.size() ){
+        errorLog << "push(...) - Invalid stream index: " << streamIndex << endl;
+        return false;
+    }
+
+    Stream &stream = streams[ streamIndex ];
+
+    if( data.size() != stream.numDimensions ){
+        errorLog << "push(...) - The size of the data (" << data.size() << ") does not match the stream " << stream.name << " (" << stream.numDimensions << ")" << endl;
+        return false;
+    }
+
+    if( stream.count > 0 && timestamp < getTimestamp( stream, stream.count-1 ) ){
+        warningLog << "push(...) - Ignoring out of order sample for stream " << stream.name << endl;
+        return false;
+    }
+
+    //If the buffer is full then overwrite the oldest sample
+    if( stream.count == bufferSize ){
+        stream.head = (stream.head + 1) % bufferSize;
+        stream.count--;
+    }
+
+    const UINT index = (stream.head + stream.count) % bufferSize;
+    stream.timestamps[ index ] = timestamp;
+    std::copy( data.begin(), data.end(), stream.values.begin() + index * stream.numDimensions );
+    stream.count++;
+
+    return true;
+}
+
+UINT ofxGrtStreamAligner::update( const double currentTime ){
+
+    if( streams.size() == 0 ) return 0;
+
+    //Start the output grid once every stream has data, at the latest first sample so every stream can be resampled
+    if( !started ){
+        double startTime = -grt_numeric_limits< double >::max();
+        for(size_t i=0; i<streams.size(); i++){
+            if( streams[i].count == 0 ) return 0;
+            startTime = std::max( startTime, getTimestamp( streams[i], 0 ) );
+        }
+        nextTime = startTime;
+        started = true;
+    }
+
+    const double period = 1.0 / sampleRate;
+    const double emitTime = currentTime - latency;
+
+    //Bound the backlog, if the app stalled then skip ahead rather than emitting a burst of stale samples
+    const double backlog = (emitTime - nextTime) * sampleRate;
+    if( backlog > bufferSize ){
+        const UINT numSkipped = (UINT)(backlog - bufferSize);
+        nextTime += numSkipped * period;
+        numSkippedSamples += numSkipped;
+    }
+
+    UINT numNewSamples = 0;
+    while( nextTime <= emitTime ){
+
+        //If the output buffer is full then drop the oldest fused sample
+        if( outputCount == bufferSize ){
+            outputHead = (outputHead + 1) % bufferSize;
+            outputCount--;
+            numDroppedSamples++;
+        }
+
+        const UINT index = (outputHead + outputCount) % bufferSize;
+        Float *output = &outputValues[ index * numDimensions ];
+        outputTimestamps[ index ] = nextTime;
+
+        double minTimestamp = grt_numeric_limits< double >::max();
+        double maxTimestamp = -grt_numeric_limits< double >::max();
+        for(size_t i=0; i<streams.size(); i++){
+            resample( streams[i], nextTime, output + streams[i].offset, nearestTimestamps[i] );
+            minTimestamp = std::min( minTimestamp, nearestTimestamps[i] );
+            maxTimestamp = std::max( maxTimestamp, nearestTimestamps[i] );
+        }
+        interStreamStatistics.update( maxTimestamp - minTimestamp, false );
+
+        outputCount++;
+        numNewSamples++;
+        nextTime += period;
+    }
+
+    return numNewSamples;
+}
+
+bool ofxGrtStreamAligner::popSample( VectorFloat &sample, double &timestamp ){
+
+    if( outputCount == 0 ) return false;
+
+    if( sample.size() != numDimensions ) sample.resize( numDimensions );
+
+    const Float *values = &outputValues[ outputHead * numDimensions ];
+    std::copy( values, values + numDimensions, sample.begin() );
+    timestamp = outputTimestamps[ outputHead ];
+
+    outputHead = (outputHead + 1) % bufferSize;
+    outputCount--;
+
+    return true;
+}
+
+bool ofxGrtStreamAligner::clear(){
+    streams.clear();
+    nearestTimestamps.clear();
+    numDimensions = 0;
+    return reset();
+}
+
+bool ofxGrtStreamAligner::reset(){
+    for(size_t i=0; i<streams.size(); i++){
+        streams[i].head = 0;
+        streams[i].count = 0;
+    }
+    started = false;
+    nextTime = 0;
+    outputHead = 0;
+    outputCount = 0;
+    outputTimestamps.resize( bufferSize );
+    outputValues.resize( bufferSize * numDimensions );
+    return resetStatistics();
+}
+
+bool ofxGrtStreamAligner::resetStatistics(){
+    for(size_t i=0; i<streams.size(); i++){
+        streams[i].statistics.clear();
+    }
+    interStreamStatistics.clear();
+    numDroppedSamples = 0;
+    numSkippedSamples = 0;
+    return true;
+}
+
+std::string ofxGrtStreamAligner::getStatisticsAsString() const {
+    std::stringstream stream;
+    for(size_t i=0; i<streams.size(); i++){
+        const SkewStatistics &s = streams[i].statistics;
+        stream << streams[i].name << " skew mean: " << s.meanSkew*1000.0 << "ms max: " << s.maxSkew*1000.0 << "ms held: " << s.numHeld << "/" << s.numSamples << endl;
+    }
+    stream << "inter-stream skew mean: " << interStreamStatistics.meanSkew*1000.0 << "ms max: " << interStreamStatistics.maxSkew*1000.0 << "ms";
+    stream << " dropped: " << numDroppedSamples << " skipped: " << numSkippedSamples;
+    return stream.str();
+}
+
+bool ofxGrtStreamAligner::resample( Stream &stream, const double t, Float *output, double &nearestTimestamp ){
+
+    //Drop the samples that are no longer needed, keeping the last sample at or before t
+    while( stream.count > 1 && getTimestamp( stream, 1 ) <= t ){
+        stream.head = (stream.head + 1) % bufferSize;
+        stream.count--;
+    }
+
+    const double t0 = getTimestamp( stream, 0 );
+    const Float *v0 = getValues( stream, 0 );
+
+    //No sample after t (the stream is late or stopped), or t is before the first sample, so hold the closest value
+    if( stream.count == 1 || t < t0 ){
+        std::copy( v0, v0 + stream.numDimensions, output );
+        nearestTimestamp = t0;
+        stream.statistics.update( fabs( t - t0 ), t > t0 );
+        return true;
+    }
+
+    const double t1 = getTimestamp( stream, 1 );
+    const Float *v1 = getValues( stream, 1 );
+    const bool firstIsNearest = t - t0 <= t1 - t;
+    nearestTimestamp = firstIsNearest ? t0 : t1;
+    stream.statistics.update( firstIsNearest ? t - t0 : t1 - t, false );
+
+    if( mode == NEAREST_INTERPOLATION || t1 <= t0 ){
+        const Float *v = firstIsNearest ? v0 : v1;
+        std::copy( v, v + stream.numDimensions, output );
+    }else{
+        const Float w = (Float)((t - t0) / (t1 - t0));
+        for(UINT j=0; j<stream.numDimensions; j++){
+            output[j] = v0[j] + w * (v1[j] - v0[j]);
+        }
+    }
+
+    return true;
+}
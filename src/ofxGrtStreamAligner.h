@@ -0,0 +1,173 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <GRT/GRT.h>
+
+#include "ofMain.h"
+
+using namespace GRT;
+
+/**
+ @brief fuses several independently timestamped sensor streams (for example the accelerometer and gravity messages from Gyrosc) into
+ one sample stream at a fixed rate. Each stream is buffered in a fixed size ring buffer, and fused samples are emitted on a regular time grid
+ by resampling every stream at the same instant, using either the nearest sample or linear interpolation. Samples are emitted a fixed
+ latency behind the current time so that late messages can still be used, and the output never falls further behind than the latency plus
+ one buffer of samples. The aligner records how far each resampled value was from a real sample (the skew), and how far apart the streams were.
+*/
+class ofxGrtStreamAligner {
+public:
+    enum InterpolationMode{ NEAREST_INTERPOLATION=0, LINEAR_INTERPOLATION };
+
+    struct SkewStatistics{
+        SkewStatistics(){ clear(); }
+        void clear(){ numSamples = 0; numHeld = 0; meanSkew = 0; maxSkew = 0; }
+        void update( const double skew, const bool held ){
+            numSamples++;
+            if( held ) numHeld++;
+            meanSkew += (skew - meanSkew) / numSamples;
+            if( skew > maxSkew ) maxSkew = skew;
+        }
+        UINT numSamples;    ///< The number of fused samples the statistics cover
+        UINT numHeld;       ///< The number of fused samples where the stream had no newer data and the last value was held
+        double meanSkew;    ///< The mean time (in seconds) between the fused sample and the closest real sample
+        double maxSkew;     ///< The maximum time (in seconds) between the fused sample and the closest real sample
+    };
+
+    ofxGrtStreamAligner();
+    ~ofxGrtStreamAligner();
+
+    /**
+     @brief sets the output rate and latency, this also removes any buffered data
+     @param sampleRate: the rate (in Hz) of the fused samples
+     @param latency: how far (in seconds) the fused samples lag behind the current time, this should be larger than the expected message jitter
+     @param mode: the interpolation mode, NEAREST_INTERPOLATION or LINEAR_INTERPOLATION
+     @param bufferSize: the number of samples buffered for each stream
+     @return returns true if the aligner was setup successfully, false otherwise
+    */
+    bool setup( const double sampleRate, const double latency, const InterpolationMode mode = LINEAR_INTERPOLATION, const UINT bufferSize = 128 );
+
+    /**
+     @brief adds a stream, the fused sample contains the streams in the order they were added
+     @param name: the name of the stream
+     @param numDimensions: the number of values in each sample of the stream
+     @return returns the index of the stream, or -1 if the stream could not be added
+    */
+    int addStream( const std::string &name, const UINT numDimensions );
+
+    /**
+     @brief adds a new sample to a stream, samples must be pushed in time order
+     @param streamIndex: the index of the stream returned by addStream
+     @param timestamp: the time (in seconds) the sample was measured or received
+     @param data: the sample, the size must match the number of dimensions of the stream
+     @return returns true if the sample was added successfully, false otherwise
+    */
+    bool push( const UINT streamIndex, const double timestamp, const VectorFloat &data );
+
+    /**
+     @brief emits all the fused samples that are due at the current time, these can then be read with popSample
+     @param currentTime: the current time (in seconds), using the same clock as the timestamps
+     @return returns the number of new fused samples
+    */
+    UINT update( const double currentTime );
+
+    /**
+     @brief gets the oldest fused sample that has not been read yet
+     @param sample: the fused sample will be copied into this vector, it is only resized if needed
+     @param timestamp: the time of the fused sample
+     @return returns true if a sample was available, false otherwise
+    */
+    bool popSample( VectorFloat &sample, double &timestamp );
+
+    /**
+     @brief removes all the streams, buffered data and statistics
+     @return returns true if the aligner was cleared successfully, false otherwise
+    */
+    bool clear();
+
+    /**
+     @brief removes the buffered data but keeps the streams
+     @return returns true if the aligner was reset successfully, false otherwise
+    */
+    bool reset();
+
+    bool resetStatistics();
+
+    UINT getNumStreams() const { return (UINT)streams.size(); }
+    UINT getNumDimensions() const { return numDimensions; }
+    UINT getNumSamplesAvailable() const { return outputCount; }
+    UINT getNumDroppedSamples() const { return numDroppedSamples; }
+    UINT getNumSkippedSamples() const { return numSkippedSamples; }
+    double getSampleRate() const { return sampleRate; }
+    double getLatency() const { return latency; }
+
+    /**
+     @brief gets the skew statistics of one stream
+    */
+    const SkewStatistics &getSkewStatistics( const UINT streamIndex ) const { return streams[ streamIndex ].statistics; }
+
+    /**
+     @brief gets the statistics of the spread between the closest real samples of all the streams, for each fused sample
+    */
+    const SkewStatistics &getInterStreamSkewStatistics() const { return interStreamStatistics; }
+
+    /**
+     @brief gets the statistics as a human readable string, one line per stream
+    */
+    std::string getStatisticsAsString() const;
+
+protected:
+    struct Stream{
+        std::string name;
+        UINT numDimensions;
+        UINT offset;            ///< The offset of the stream in the fused sample
+        UINT head;              ///< The index of the oldest sample in the ring buffer
+        UINT count;
+        vector< double > timestamps;
+        vector< Float > values;
+        SkewStatistics statistics;
+    };
+
+    bool resample( Stream &stream, const double t, Float *output, double &nearestTimestamp );
+    double getTimestamp( const Stream &stream, const UINT i ) const { return stream.timestamps[ (stream.head + i) % bufferSize ]; }
+    const Float *getValues( const Stream &stream, const UINT i ) const { return &stream.values[ ((stream.head + i) % bufferSize) * stream.numDimensions ]; }
+
+    double sampleRate;
+    double latency;
+    double nextTime;
+    bool started;
+    InterpolationMode mode;
+    UINT bufferSize;
+    UINT numDimensions;
+    UINT numDroppedSamples;
+    UINT numSkippedSamples;
+    vector< Stream > streams;
+    vector< double > nearestTimestamps;
+    SkewStatistics interStreamStatistics;
+
+    //The fused samples waiting to be read
+    UINT outputHead;
+    UINT outputCount;
+    vector< double > outputTimestamps;
+    vector< Float > outputValues;
+
+    ErrorLog errorLog;
+    WarningLog warningLog;
+};
@@ -0,0 +1,170 @@
+
+#include "ofxGrtThreadPool.h"
+
+thread_local const ofxGrtThreadPool *ofxGrtThreadPool::runningPool = NULL;
+thread_local unsigned int ofxGrtThreadPool::runningThreadIndex = 0;
+
+ofxGrtThreadPool::ofxGrtThreadPool( const unsigned int numThreads ) : nextQueue( 0 ), numQueuedTasks( 0 ) {
+    this->numThreads = numThreads > 0 ? numThreads : std::max( 1u, std::thread::hardware_concurrency() );
+    stop = false;
+
+    //Every thread has a queue, including the calling thread which runs its tasks in wait()
+    for(unsigned int i=0; i<this->numThreads; i++){
+        queues.push_back( std::unique_ptr< TaskQueue >( new TaskQueue ) );
+    }
+
+    //The calling thread is the last thread, so only start N-1 workers
+    for(unsigned int i=0; i+1<this->numThreads; i++){
+        workers.push_back( std::thread( &ofxGrtThreadPool::workerFunction, this, i ) );
+    }
+}
+
+ofxGrtThreadPool::~ofxGrtThreadPool(){
+    {
+        std::unique_lock< std::mutex > lock( mtx );
+        stop = true;
+    }
+    taskCondition.notify_all();
+    for(size_t i=0; i<workers.size(); i++){
+        workers[i].join();
+    }
+}
+
+ofxGrtThreadPool &ofxGrtThreadPool::getSharedPool(){
+    static ofxGrtThreadPool pool;
+    return pool;
+}
+
+bool ofxGrtThreadPool::enqueue( TaskGroup &group, const Task &task ){
+    {
+        std::unique_lock< std::mutex > lock( mtx );
+        if( stop ) return false;
+    }
+
+    //Tasks added by a running task stay on its thread's queue, other tasks are spread across all the queues
+    const unsigned int queueIndex = runningPool == this ? runningThreadIndex : nextQueue.fetch_add( 1 ) % numThreads;
+
+    //Count the task before it can be taken, so the counts never drop below zero
+    group.numPending++;
+    group.numQueued++;
+    numQueuedTasks++;
+    {
+        std::unique_lock< std::mutex > lock( queues[ queueIndex ]->mtx );
+        QueuedTask queuedTask;
+        queuedTask.task = task;
+        queuedTask.group = &group;
+        queues[ queueIndex ]->tasks.push_back( queuedTask );
+    }
+
+    //Take the lock so a thread can not miss the notification between checking for tasks and going to sleep
+    {
+        std::unique_lock< std::mutex > lock( mtx );
+    }
+    taskCondition.notify_one();
+    doneCondition.notify_all();
+    return true;
+}
+
+bool ofxGrtThreadPool::wait( TaskGroup &group ){
+
+    //A task waiting on a group helps with the index of the thread running it, an outside thread needs the outside thread index
+    if( runningPool == this ) return waitForGroup( group, true );
+
+    CallerSlot slot( *this );
+    return waitForGroup( group, slot.getIsOwner() );
+}
+
+bool ofxGrtThreadPool::waitForGroup( TaskGroup &group, const bool help ){
+    const unsigned int threadIndex = runningPool == this ? runningThreadIndex : getCallerThreadIndex();
+    while( group.numPending > 0 ){
+        //Help with the group's queued tasks, otherwise wait for its running tasks to finish
+        if( help && runNextTask( threadIndex, &group ) ) continue;
+        std::unique_lock< std::mutex > lock( mtx );
+        doneCondition.wait( lock, [&](){ return group.numPending == 0 || (help && group.numQueued > 0); } );
+    }
+    return true;
+}
+
+void ofxGrtThreadPool::workerFunction( const unsigned int threadIndex ){
+    while( true ){
+        if( runNextTask( threadIndex, NULL ) ) continue;
+        std::unique_lock< std::mutex > lock( mtx );
+        taskCondition.wait( lock, [this](){ return stop || numQueuedTasks > 0; } );
+        if( stop && numQueuedTasks == 0 ) return;
+    }
+}
+
+bool ofxGrtThreadPool::runNextTask( const unsigned int threadIndex, TaskGroup *group ){
+
+    QueuedTask task;
+    if( !popTask( threadIndex, group, task ) ) return false;
+
+    {
+        RunningTask running( this, threadIndex );
+        task.task( threadIndex );
+    }
+
+    //The waiting thread may destroy the group as soon as its count reaches zero, so release the task first
+    TaskGroup *taskGroup = task.group;
+    task.task = Task();
+    if( --taskGroup->numPending == 0 ){
+        std::unique_lock< std::mutex > lock( mtx );
+        doneCondition.notify_all();
+    }
+
+    return true;
+}
+
+bool ofxGrtThreadPool::popTask( const unsigned int threadIndex, TaskGroup *group, QueuedTask &task ){
+
+    if( numQueuedTasks == 0 || (group != NULL && group->numQueued == 0) ) return false;
+
+    //Take the newest task from our own queue, then steal the oldest task from the other queues. A waiting thread only takes tasks of the group it waits for.
+    for(unsigned int i=0; i<numThreads; i++){
+        TaskQueue &queue = *queues[ (threadIndex + i) % numThreads ];
+        std::unique_lock< std::mutex > lock( queue.mtx );
+        if( queue.tasks.empty() ) continue;
+        std::deque< QueuedTask >::iterator iter = queue.tasks.end();
+        if( i == 0 ){
+            for(std::deque< QueuedTask >::iterator j = queue.tasks.end(); j != queue.tasks.begin(); ){
+                --j;
+                if( group == NULL || j->group == group ){ iter = j; break; }
+            }
+        }else{
+            for(std::deque< QueuedTask >::iterator j = queue.tasks.begin(); j != queue.tasks.end(); ++j){
+                if( group == NULL || j->group == group ){ iter = j; break; }
+            }
+        }
+        if( iter == queue.tasks.end() ) continue;
+        task = *iter;
+        queue.tasks.erase( iter );
+        task.group->numQueued--;
+        numQueuedTasks--;
+        return true;
+    }
+
+    return false;
+}
+
+ofxGrtThreadPool::RunningTask::RunningTask( const ofxGrtThreadPool *pool, const unsigned int threadIndex ){
+    previousPool = runningPool;
+    previousThreadIndex = runningThreadIndex;
+    runningPool = pool;
+    runningThreadIndex = threadIndex;
+}
+
+ofxGrtThreadPool::RunningTask::~RunningTask(){
+    runningPool = previousPool;
+    runningThreadIndex = previousThreadIndex;
+}
+
+ofxGrtThreadPool::CallerSlot::CallerSlot( ofxGrtThreadPool &pool ) : pool( pool ) {
+    if( pool.workers.empty() ){
+        pool.callerMutex.lock();
+        owner = true;
+    }else owner = pool.callerMutex.try_lock();
+}
+
+ofxGrtThreadPool::CallerSlot::~CallerSlot(){
+    if( owner ) pool.callerMutex.unlock();
+}
@@ -0,0 +1,192 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ @brief a small pool of worker threads used by the ofxGrt evaluators and trainers. A pool with N threads has N-1 background workers, and
+ the thread that calls wait() or parallelFor() also does work while it waits. Each task is passed the index of the thread running it
+ (in the range [0 getNumThreads()-1]), which can be used to index per-thread scratch memory.
+
+ Each thread has its own task queue. Tasks added from outside the pool are spread across the queues, tasks added by a running task go
+ to the queue of the thread running it. A thread runs the newest task in its own queue first, and when its queue is empty it steals the
+ oldest task from another queue, so uneven tasks (such as trees of different sizes) keep every thread busy without one shared queue.
+
+ Tasks are added to a TaskGroup, and wait() only waits for the tasks of its own group, so callers on different threads never wait for
+ each other's work. Threads outside the pool share the last thread index. Only one outside thread at a time holds that index and helps
+ run its own tasks. Any other outside thread calling at the same time hands all its work to the workers and waits without running
+ tasks, so no two threads ever run with the same index at once.
+
+ parallelFor() can be called from inside a task of the same pool (for example a classifier trained inside a task that uses the shared pool
+ itself). The nested range is then run on the thread running the task, with that thread's index, as the other threads are already busy.
+*/
+class ofxGrtThreadPool {
+public:
+    typedef std::function< void( const unsigned int threadIndex ) > Task;
+
+    /**
+     @brief a set of tasks that are waited on together, it must outlive its tasks (call wait before it goes out of scope)
+    */
+    class TaskGroup{
+    public:
+        TaskGroup() : numPending( 0 ), numQueued( 0 ) {}
+    protected:
+        friend class ofxGrtThreadPool;
+        std::atomic< size_t > numPending;      ///< The number of tasks that have been added but not finished
+        std::atomic< size_t > numQueued;       ///< The number of tasks waiting in the queues
+    };
+
+    /**
+     @brief creates the pool
+     @param numThreads: the total number of threads that will run tasks (including the calling thread), if zero then the number of hardware threads is used
+    */
+    ofxGrtThreadPool( const unsigned int numThreads = 0 );
+    ~ofxGrtThreadPool();
+
+    /**
+     @brief adds a task to the pool, the task will be run by the next free thread. Use wait() to block until the tasks of the group have finished.
+     @param group: the group the task belongs to
+     @param task: the task to run
+     @return returns true if the task was added successfully, false otherwise
+    */
+    bool enqueue( TaskGroup &group, const Task &task );
+
+    /**
+     @brief blocks until all the tasks of a group have finished, the calling thread runs tasks of the group while it waits (if it holds a thread index).
+     This can be called from inside a task, in which case the tasks of the group may run on this thread with the index of the waiting task, so the
+     waiting task must not keep using its per-thread scratch memory across the wait.
+     @param group: the group to wait for
+     @return returns true when all the tasks of the group have finished
+    */
+    bool wait( TaskGroup &group );
+
+    /**
+     @brief runs func(index,threadIndex) for each index in [begin end), splitting the range into chunks of grainSize indices. Blocks until all the indices have been run.
+     If called from inside a task of this pool, the indices are run in order on the calling thread.
+     @param begin: the first index
+     @param end: one past the last index
+     @param grainSize: the number of indices each thread takes at a time
+     @param func: the function to run for each index
+     @return returns true when all the indices have been run
+    */
+    template< class Func >
+    bool parallelFor( const size_t begin, const size_t end, const size_t grainSize, Func func ){
+        if( end <= begin ) return true;
+        if( runningPool == this ){
+            const unsigned int threadIndex = runningThreadIndex;
+            for(size_t i=begin; i<end; i++){
+                func( i, threadIndex );
+            }
+            return true;
+        }
+        const size_t grain = grainSize > 0 ? grainSize : 1;
+        const size_t numChunks = (end - begin + grain - 1) / grain;
+        std::atomic< size_t > nextChunk( 0 );
+        auto worker = [&]( const unsigned int threadIndex ){
+            size_t chunk = 0;
+            while( (chunk = nextChunk.fetch_add( 1 )) < numChunks ){
+                const size_t chunkBegin = begin + chunk * grain;
+                const size_t chunkEnd = chunkBegin + grain < end ? chunkBegin + grain : end;
+                for(size_t i=chunkBegin; i<chunkEnd; i++){
+                    func( i, threadIndex );
+                }
+            }
+        };
+
+        //A caller that does not hold the outside thread index leaves all the chunks to the workers
+        CallerSlot slot( *this );
+        TaskGroup group;
+        const size_t numHelpers = slot.getIsOwner() ? numThreads : workers.size();
+        const size_t numTasks = numChunks < numHelpers ? numChunks : numHelpers;
+        for(size_t i=slot.getIsOwner() ? 1 : 0; i<numTasks; i++){
+            enqueue( group, worker );
+        }
+        if( slot.getIsOwner() ){
+            RunningTask running( this, getCallerThreadIndex() );
+            worker( getCallerThreadIndex() );
+        }
+        return waitForGroup( group, slot.getIsOwner() );
+    }
+
+    unsigned int getNumThreads() const { return numThreads; }
+
+    /**
+     @brief gets a pool shared by the ofxGrt trainers, with one thread per hardware thread. It is created the first time it is used.
+    */
+    static ofxGrtThreadPool &getSharedPool();
+
+protected:
+    struct QueuedTask{
+        Task task;
+        TaskGroup *group;
+    };
+
+    struct TaskQueue{
+        std::mutex mtx;
+        std::deque< QueuedTask > tasks;
+    };
+
+    //Marks the calling thread as running a task of a pool until it goes out of scope
+    struct RunningTask{
+        RunningTask( const ofxGrtThreadPool *pool, const unsigned int threadIndex );
+        ~RunningTask();
+        const ofxGrtThreadPool *previousPool;
+        unsigned int previousThreadIndex;
+    };
+
+    //Gives an outside thread the outside thread index until it goes out of scope, if no other outside thread holds it. A pool without
+    //workers has nobody to hand the work to, so the caller then waits for the index.
+    struct CallerSlot{
+        CallerSlot( ofxGrtThreadPool &pool );
+        ~CallerSlot();
+        bool getIsOwner() const { return owner; }
+        ofxGrtThreadPool &pool;
+        bool owner;
+    };
+
+    void workerFunction( const unsigned int threadIndex );
+    bool waitForGroup( TaskGroup &group, const bool help );
+    bool runNextTask( const unsigned int threadIndex, TaskGroup *group );
+    bool popTask( const unsigned int threadIndex, TaskGroup *group, QueuedTask &task );
+    unsigned int getCallerThreadIndex() const { return numThreads-1; }
+
+    unsigned int numThreads;
+    std::atomic< unsigned int > nextQueue;
+    std::atomic< size_t > numQueuedTasks;      ///< The number of tasks waiting in the queues
+    bool stop;
+    std::vector< std::unique_ptr< TaskQueue > > queues;
+    std::vector< std::thread > workers;
+    std::mutex mtx;                             ///< Guards stop and the sleeping threads
+    std::mutex callerMutex;                     ///< Held by the outside thread using the outside thread index
+    std::condition_variable taskCondition;
+    std::condition_variable doneCondition;
+
+    static thread_local const ofxGrtThreadPool *runningPool;    ///< The pool whose task the current thread is running, if any
+    static thread_local unsigned int runningThreadIndex;
+};